@@ -52,12 +52,14 @@ XCAM_XCORE_SRC_FILES := \
     xcore/interface/feature_match.cpp \
     xcore/interface/geo_mapper.cpp \
     xcore/interface/stitcher.cpp \
+    xcore/interface/stitch_quality.cpp \
     $(NULL)
 
 XCAM_SOFT_SRC_FILES := \
     modules/soft/soft_blender.cpp \
     modules/soft/soft_blender_tasks_priv.cpp \
     modules/soft/soft_copy_task.cpp \
+    modules/soft/soft_feature_match.cpp \
     modules/soft/soft_geo_mapper.cpp \
     modules/soft/soft_geo_tasks_priv.cpp \
     modules/soft/soft_handler.cpp \
@@ -540,13 +540,16 @@ DnnInferenceEngine::set_inference_data (const VideoBufferList& images)
         float x_ratio = float(image_width) / float(buf_info.width);
         float y_ratio = float(image_height) / float(buf_info.height);
 
-        uint8_t* data = NULL;
+        SmartPtr<VideoBuffer> bgr_buf;
         if (buf_info.format == V4L2_PIX_FMT_NV12) {
-            data = XCamDNN::convert_NV12_to_BGR (buf, x_ratio, y_ratio);
+            uint64_t key = ((uint64_t)image_width << 32) | image_height;
+            bgr_buf = XCamDNN::convert_NV12_to_BGR (buf, x_ratio, y_ratio, _bgr_pools[key]);
         } else if (buf_info.format == V4L2_PIX_FMT_BGR24) {
-            data = buf->map ();
+            bgr_buf = buf;
         }
 
+        uint8_t* data = bgr_buf.ptr () ? bgr_buf->map () : NULL;
+
         if (data != NULL) {
             DnnInferData image;
             image.width = image_width;
@@ -564,14 +567,11 @@ DnnInferenceEngine::set_inference_data (const VideoBufferList& images)
 
             set_input_blob (idx, image);
             idx ++;
+            bgr_buf->unmap ();
         } else {
             XCAM_LOG_WARNING ("Valid input images were not found!");
             continue;
         }
-
-        if (buf_info.format != V4L2_PIX_FMT_NV12) {
-            buf->unmap ();
-        }
     }
 
     return XCAM_RETURN_NO_ERROR;
@@ -25,10 +25,12 @@
 
 #include <vector>
 #include <string>
+#include <map>
 #include <inference_engine.hpp>
 
 #include <xcam_std.h>
 #include <video_buffer.h>
+#include <buffer_pool.h>
 
 namespace XCam {
 
@@ -298,6 +300,9 @@ protected:
     std::vector<InferenceEngine::CNNLayerPtr> _layers;
 
     DnnOutputLayerType _output_layer_type;
+
+    // BGR input images converted from NV12, keyed by network input width << 32 | height
+    std::map<uint64_t, SmartPtr<BufferPool> > _bgr_pools;
 };
 
 }  // namespace XCam
@@ -23,11 +23,15 @@
 #include <limits>
 
 #include "dnn_inference_utils.h"
+#include <soft/soft_csc.h>
+#include <soft/soft_video_buf_allocator.h>
 
 #if HAVE_OPENCV
 #include "ocv/cv_std.h"
 #endif
 
+#define DNN_BGR_POOL_SIZE 2
+
 using namespace std;
 using namespace XCam;
 
@@ -394,31 +398,39 @@ save_bmp_file (const std::string name, void* data, DnnInferImageFormatType forma
     return XCAM_RETURN_NO_ERROR;
 }
 
-//std::shared_ptr<uint8_t>
-uint8_t*
-convert_NV12_to_BGR (SmartPtr<VideoBuffer>& nv12, float x_ratio, float y_ratio)
+SmartPtr<VideoBuffer>
+convert_NV12_to_BGR (
+    SmartPtr<VideoBuffer>& nv12, float x_ratio, float y_ratio,
+    SmartPtr<BufferPool>& pool)
 {
     XCAM_ASSERT (x_ratio > 0 && y_ratio);
 
     VideoBufferInfo nv12_buf_info = nv12->get_video_info ();
+    const uint32_t width = round (x_ratio * nv12_buf_info.width);
+    const uint32_t height = round (y_ratio * nv12_buf_info.height);
+
+    if (!pool.ptr () ||
+            pool->get_video_info ().width != width || pool->get_video_info ().height != height) {
+        VideoBufferInfo bgr_info;
+        bgr_info.init (V4L2_PIX_FMT_BGR24, width, height, width, height);
+        pool = new SoftVideoBufAllocator (bgr_info);
+        XCAM_ASSERT (pool.ptr ());
+        XCAM_FAIL_RETURN (
+            ERROR, pool->reserve (DNN_BGR_POOL_SIZE), NULL,
+            "reserve BGR buffers of %dx%d failed", width, height);
+    }
 
-#if HAVE_OPENCV
-    const auto src = nv12->map ();
-    cv::Mat nv12_image (nv12_buf_info.height * 3 / 2, nv12_buf_info.width, CV_8UC1, src);
-    cv::Mat temp_image;
-    cv::cvtColor (nv12_image, temp_image, cv::COLOR_YUV2BGR_NV12);
-    nv12->unmap ();
-
-    cv::Mat bgr_image;
-    cv::Size image_size (round (x_ratio * nv12_buf_info.width), round (y_ratio * nv12_buf_info.height));
-    cv::resize (temp_image, bgr_image, image_size);
-
-    //std::shared_ptr<uint8_t> bgr_ptr (bgr_image.data);
-    //return bgr_ptr;
-    return bgr_image.data;
-#else
-    return NULL;
-#endif
+    SmartPtr<VideoBuffer> bgr = pool->get_buffer (pool);
+    XCAM_ASSERT (bgr.ptr ());
+
+    // color conversion and resize in one pass
+    XCamReturn ret = soft_csc_convert (nv12, bgr);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), NULL,
+        "convert NV12(%dx%d) to BGR(%dx%d) failed",
+        nv12_buf_info.width, nv12_buf_info.height, width, height);
+
+    return bgr;
 }
 
 }  // namespace XCam
@@ -23,6 +23,7 @@
 
 #include <xcam_std.h>
 #include <video_buffer.h>
+#include <buffer_pool.h>
 #include <vec_mat.h>
 
 #include "dnn_inference_engine.h"
@@ -45,9 +46,12 @@ save_bmp_file (const std::string name,
                uint32_t width,
                uint32_t height);
 
-//std::shared_ptr<uint8_t>
-uint8_t*
-convert_NV12_to_BGR (XCam::SmartPtr<XCam::VideoBuffer>& nv12, float x_ratio, float y_ratio);
+// packed BGR24 without padding, scaled by ratio, NULL on failure
+// @pool holds BGR buffers across calls, (re)created when NULL or output size differs
+XCam::SmartPtr<XCam::VideoBuffer>
+convert_NV12_to_BGR (
+    XCam::SmartPtr<XCam::VideoBuffer>& nv12, float x_ratio, float y_ratio,
+    XCam::SmartPtr<XCam::BufferPool>& pool);
 
 }  // namespace XCamDNN
 
@@ -25,11 +25,11 @@
 #include <meta_data.h>
 #include <vec_mat.h>
 #include <image_projector.h>
+#include <motion_filter.h>
 #include <ocl/cl_image_warp_handler.h>
 
 namespace XCam {
 
-class MotionFilter;
 class ImageProjector;
 class CLVideoStabilizer;
 class CLImageWarpKernel;
@@ -122,37 +122,5 @@ private:
 SmartPtr<CLImageHandler>
 create_cl_video_stab_handler (const SmartPtr<CLContext> &context);
 
-
-class MotionFilter
-{
-public:
-    MotionFilter (uint32_t radius = 15, float stdev = 10);
-    virtual ~MotionFilter ();
-
-    void set_filters (uint32_t radius, float stdev);
-
-    uint32_t radius () const {
-        return _radius;
-    };
-    float stdev () const {
-        return _stdev;
-    };
-
-    Mat3d stabilize (int32_t index,
-                     std::list<Mat3d> &motions,
-                     int32_t max);
-
-protected:
-    Mat3d cumulate_motion (uint32_t index, uint32_t from, std::list<Mat3d> &motions);
-
-private:
-    XCAM_DEAD_COPY (MotionFilter);
-
-private:
-    int32_t            _radius;
-    float              _stdev;
-    std::vector<float> _weight;
-};
-
 }
 #endif
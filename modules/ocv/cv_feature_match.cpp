@@ -29,11 +29,19 @@
 #define XCAM_CV_FM_DEBUG 0
 #define XCAM_CV_OF_DRAW_SCALE 2
 
+#define XCAM_CV_FM_WIN_SIZE 5
+#define XCAM_CV_FM_MAX_LEVEL 3
+// corners move little between frames, tracking needs fewer pyramid levels than matching
+#define XCAM_CV_FM_TRACK_MAX_LEVEL 1
+// minimum width and height of the image corners are detected on
+#define XCAM_CV_FM_MIN_MATCH_SIZE 32
+
 namespace XCam {
 CVFeatureMatch::CVFeatureMatch ()
     : FeatureMatch ()
     , _dst_width (0)
     , _need_adjust (false)
+    , _track_corners (false)
 {
 }
 
@@ -54,6 +62,14 @@ CVFeatureMatch::enable_adjust_crop_area ()
     _need_adjust = true;
 }
 
+void
+CVFeatureMatch::enable_corner_tracking (bool enable)
+{
+    _track_corners = enable;
+    _prev_left_pyr.clear ();
+    _prev_corners.clear ();
+}
+
 void
 CVFeatureMatch::add_detected_data (
     cv::Mat image, cv::Ptr<cv::Feature2D> detector, std::vector<cv::Point2f> &corners)
@@ -189,28 +205,153 @@ CVFeatureMatch::adjust_crop_area ()
     _x_offset -= delta_offset;
 }
 
+bool
+CVFeatureMatch::track_corners (const std::vector<cv::Mat> &left_pyr, std::vector<cv::Point2f> &corners)
+{
+    if (_prev_left_pyr.empty () || (int)_prev_corners.size () < _config.min_corners)
+        return false;
+
+    // corners of last frame are relative to last crop area
+    if (_prev_left_rect.pos_x != _left_rect.pos_x || _prev_left_rect.pos_y != _left_rect.pos_y ||
+            _prev_left_rect.width != _left_rect.width || _prev_left_rect.height != _left_rect.height)
+        return false;
+
+    std::vector<cv::Point2f> tracked;
+    std::vector<uchar> status;
+    std::vector<float> err;
+    const cv::Size img_size = left_pyr[0].size ();
+    cv::Size win_size = cv::Size (XCAM_CV_FM_WIN_SIZE, XCAM_CV_FM_WIN_SIZE);
+    cv::calcOpticalFlowPyrLK (
+        _prev_left_pyr, left_pyr, _prev_corners, tracked, status, err, win_size, XCAM_CV_FM_TRACK_MAX_LEVEL,
+        cv::TermCriteria (cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 10, 0.01f));
+
+    corners.reserve (tracked.size ());
+    for (size_t i = 0; i < tracked.size (); ++i) {
+        if (!status[i] || err[i] > _config.max_track_error)
+            continue;
+        if (tracked[i].x < 0.0f || tracked[i].y < 0.0f ||
+                tracked[i].x >= img_size.width || tracked[i].y >= img_size.height)
+            continue;
+        corners.push_back (tracked[i]);
+    }
+
+    if ((int)corners.size () < _config.min_corners) {
+        corners.clear ();
+        return false;
+    }
+
+    return true;
+}
+
+void
+CVFeatureMatch::keep_tracked_corners (
+    std::vector<cv::Mat> &left_pyr, int match_level, std::vector<cv::Point2f> &corner_left,
+    std::vector<cv::Point2f> &corner_right, std::vector<uchar> &status, std::vector<float> &error)
+{
+    // corners are matched in full resolution, tracked in level @match_level
+    const float scale = 1.0f / (1 << match_level);
+
+    _prev_corners.clear ();
+    for (size_t i = 0; i < corner_left.size (); ++i) {
+        if (!status[i] || error[i] > _config.max_track_error)
+            continue;
+        if (fabs (corner_left[i].y - corner_right[i].y) >= _config.max_valid_offset_y)
+            continue;
+        _prev_corners.push_back (corner_left[i] * scale);
+    }
+
+    _prev_left_pyr.swap (left_pyr);
+    _prev_left_rect = _left_rect;
+}
+
+int
+CVFeatureMatch::get_match_level (const cv::Size &img_size)
+{
+    int level = XCAM_MAX (_config.match_level, 0);
+    while (level > 0 &&
+            ((img_size.width >> level) < XCAM_CV_FM_MIN_MATCH_SIZE ||
+             (img_size.height >> level) < XCAM_CV_FM_MIN_MATCH_SIZE))
+        --level;
+
+    return level;
+}
+
+void
+CVFeatureMatch::refine_corners (
+    cv::Mat img_left, cv::Mat img_right, int match_level,
+    std::vector<cv::Point2f> &corner_left, std::vector<cv::Point2f> &corner_right,
+    std::vector<uchar> &status, std::vector<float> &error)
+{
+    const float scale = (float)(1 << match_level);
+    std::vector<cv::Point2f> left, right;
+    left.reserve (corner_left.size ());
+    right.reserve (corner_right.size ());
+    for (size_t i = 0; i < corner_left.size (); ++i) {
+        if (!status[i] || error[i] > _config.max_track_error)
+            continue;
+        left.push_back (corner_left[i] * scale);
+        right.push_back (corner_right[i] * scale);
+    }
+
+    corner_left.swap (left);
+    corner_right.swap (right);
+    if (corner_left.empty ()) {
+        status.clear ();
+        error.clear ();
+        return;
+    }
+
+    // coarse match is the initial flow, a single level search only fixes the sub-level residual
+    cv::Size win_size = cv::Size (XCAM_CV_FM_WIN_SIZE, XCAM_CV_FM_WIN_SIZE);
+    cv::calcOpticalFlowPyrLK (
+        img_left, img_right, corner_left, corner_right, status, error, win_size, 0,
+        cv::TermCriteria (cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 10, 0.01f),
+        cv::OPTFLOW_USE_INITIAL_FLOW);
+}
+
 void
 CVFeatureMatch::detect_and_match (cv::Mat img_left, cv::Mat img_right)
 {
     std::vector<float> err;
     std::vector<uchar> status;
     std::vector<cv::Point2f> corner_left, corner_right;
-    cv::Ptr<cv::Feature2D> fast_detector;
-    cv::Size win_size = cv::Size (5, 5);
+    std::vector<cv::Mat> left_pyr, right_pyr;
+    cv::Size win_size = cv::Size (XCAM_CV_FM_WIN_SIZE, XCAM_CV_FM_WIN_SIZE);
+
+    // high resolution crops detect and match corners on a coarse level
+    const int match_level = get_match_level (img_left.size ());
+    cv::Mat match_left = img_left, match_right = img_right;
+    for (int i = 0; i < match_level; ++i) {
+        cv::pyrDown (match_left, match_left);
+        cv::pyrDown (match_right, match_right);
+    }
+
+    // left pyramid is shared by tracking and matching, and kept for next frame
+    int max_level = cv::buildOpticalFlowPyramid (match_left, left_pyr, win_size, XCAM_CV_FM_MAX_LEVEL);
+    max_level = XCAM_MIN (max_level, cv::buildOpticalFlowPyramid (match_right, right_pyr, win_size, max_level));
 
-    fast_detector = cv::FastFeatureDetector::create (20, true);
-    add_detected_data (img_left, fast_detector, corner_left);
+    if (!_track_corners || !track_corners (left_pyr, corner_left)) {
+        cv::Ptr<cv::Feature2D> fast_detector = cv::FastFeatureDetector::create (20, true);
+        add_detected_data (match_left, fast_detector, corner_left);
+    }
 
     if (corner_left.empty ()) {
+        _prev_corners.clear ();
         return;
     }
 
     cv::calcOpticalFlowPyrLK (
-        img_left, img_right, corner_left, corner_right, status, err, win_size, 3,
+        left_pyr, right_pyr, corner_left, corner_right, status, err, win_size, max_level,
         cv::TermCriteria (cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 10, 0.01f));
 
+    if (match_level > 0)
+        refine_corners (img_left, img_right, match_level, corner_left, corner_right, status, err);
+
     calc_of_match (img_left, img_right, corner_left, corner_right, status, err);
 
+    if (_track_corners)
+        keep_tracked_corners (left_pyr, match_level, corner_left, corner_right, status, err);
+
     if (_need_adjust)
         adjust_crop_area ();
 
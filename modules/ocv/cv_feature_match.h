@@ -45,6 +45,8 @@ public:
     virtual void feature_match (
         const SmartPtr<VideoBuffer> &left_buf, const SmartPtr<VideoBuffer> &right_buf);
 
+    virtual void enable_corner_tracking (bool enable);
+
 protected:
     void add_detected_data (cv::Mat image, cv::Ptr<cv::Feature2D> detector, std::vector<cv::Point2f> &corners);
 
@@ -66,6 +68,17 @@ private:
 
     void adjust_crop_area ();
 
+    int get_match_level (const cv::Size &img_size);
+    void refine_corners (
+        cv::Mat img_left, cv::Mat img_right, int match_level,
+        std::vector<cv::Point2f> &corner_left, std::vector<cv::Point2f> &corner_right,
+        std::vector<uchar> &status, std::vector<float> &error);
+
+    bool track_corners (const std::vector<cv::Mat> &left_pyr, std::vector<cv::Point2f> &corners);
+    void keep_tracked_corners (
+        std::vector<cv::Mat> &left_pyr, int match_level, std::vector<cv::Point2f> &corner_left,
+        std::vector<cv::Point2f> &corner_right, std::vector<uchar> &status, std::vector<float> &error);
+
     virtual void set_dst_width (int width);
     virtual void enable_adjust_crop_area ();
 
@@ -75,6 +88,11 @@ private:
 private:
     int         _dst_width;
     bool        _need_adjust;
+
+    bool                        _track_corners;
+    std::vector<cv::Mat>        _prev_left_pyr;
+    std::vector<cv::Point2f>    _prev_corners;
+    Rect                        _prev_left_rect;
 };
 
 }
@@ -0,0 +1,300 @@
+/*
+ * soft_3a_stats.cpp - soft 3a statistics calculator class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_3a_stats.h"
+#include "soft_3a_stats_tasks_priv.h"
+
+#define XCAM_SOFT_3A_STATS_BIT_DEPTH 8
+#define XCAM_SOFT_3A_STATS_VALID_LOW 8
+#define XCAM_SOFT_3A_STATS_VALID_HIGH 247
+
+namespace XCam {
+
+DECLARE_WORK_CALLBACK (CbStats3aTask, Soft3aStatsCalculator, stats_task_done);
+
+static bool
+get_bayer_quad_channels (uint32_t format, uint32_t *channels)
+{
+    typedef XCamSoftTasks::Stats3aBayerTask Task;
+
+    switch (format) {
+    case V4L2_PIX_FMT_SRGGB8:
+        channels[0] = Task::ChannelR;
+        channels[1] = Task::ChannelGr;
+        channels[2] = Task::ChannelGb;
+        channels[3] = Task::ChannelB;
+        break;
+    case V4L2_PIX_FMT_SGRBG8:
+        channels[0] = Task::ChannelGr;
+        channels[1] = Task::ChannelR;
+        channels[2] = Task::ChannelB;
+        channels[3] = Task::ChannelGb;
+        break;
+    case V4L2_PIX_FMT_SGBRG8:
+        channels[0] = Task::ChannelGb;
+        channels[1] = Task::ChannelB;
+        channels[2] = Task::ChannelR;
+        channels[3] = Task::ChannelGr;
+        break;
+    case V4L2_PIX_FMT_SBGGR8:
+        channels[0] = Task::ChannelB;
+        channels[1] = Task::ChannelGb;
+        channels[2] = Task::ChannelGr;
+        channels[3] = Task::ChannelR;
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+static void
+fill_histogram (XCam3AStats *stats)
+{
+    const XCam3AStatsInfo &info = stats->info;
+    XCamHistogram *hist_rgb = stats->hist_rgb;
+    uint32_t *hist_y = stats->hist_y;
+
+    memset (hist_rgb, 0, sizeof (XCamHistogram) * info.histogram_bins);
+    memset (hist_y, 0, sizeof (uint32_t) * info.histogram_bins);
+    for (uint32_t j = 0; j < info.height; ++j) {
+        const XCamGridStat *line = &stats->stats[j * info.aligned_width];
+        for (uint32_t i = 0; i < info.width; ++i) {
+            hist_rgb[line[i].avg_r].r++;
+            hist_rgb[line[i].avg_gr].gr++;
+            hist_rgb[line[i].avg_gb].gb++;
+            hist_rgb[line[i].avg_b].b++;
+            hist_y[line[i].avg_y]++;
+        }
+    }
+}
+
+Soft3aStatsCalculator::Soft3aStatsCalculator (const char *name)
+    : SoftHandler (name)
+    , _grid_size (XCAM_SOFT_3A_STATS_DEFAULT_GRID)
+    , _valid_low (XCAM_SOFT_3A_STATS_VALID_LOW)
+    , _valid_high (XCAM_SOFT_3A_STATS_VALID_HIGH)
+    , _format (0)
+{
+}
+
+Soft3aStatsCalculator::~Soft3aStatsCalculator ()
+{
+}
+
+bool
+Soft3aStatsCalculator::set_grid_size (uint32_t grid_size)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, grid_size >= 8 && grid_size <= 128 && !(grid_size % 8), false,
+        "Soft3aStatsCalculator(%s) grid size(%d) need be multiple of 8 and in range [8, 128]",
+        XCAM_STR (get_name ()), grid_size);
+
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "Soft3aStatsCalculator(%s) grid size can NOT be changed after configured",
+        XCAM_STR (get_name ()));
+
+    _grid_size = grid_size;
+    return true;
+}
+
+bool
+Soft3aStatsCalculator::set_valid_range (uint32_t low, uint32_t high)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, low <= high && high <= 255, false,
+        "Soft3aStatsCalculator(%s) invalid valid range [%d, %d]",
+        XCAM_STR (get_name ()), low, high);
+
+    _valid_low = low;
+    _valid_high = high;
+    return true;
+}
+
+XCamReturn
+Soft3aStatsCalculator::calculate (const SmartPtr<VideoBuffer> &in, SmartPtr<X3aStats> &stats)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        stats = param->out_buf.dynamic_cast_ptr<X3aStats> ();
+        XCAM_ASSERT (stats.ptr ());
+    }
+
+    return ret;
+}
+
+SmartPtr<BufferPool>
+Soft3aStatsCalculator::create_allocator ()
+{
+    SmartPtr<X3aStatsPool> pool = new X3aStatsPool ();
+    XCAM_ASSERT (pool.ptr ());
+
+    pool->set_bit_depth (XCAM_SOFT_3A_STATS_BIT_DEPTH);
+    pool->set_grid_pixel_size (_grid_size);
+    return pool;
+}
+
+XCamReturn
+Soft3aStatsCalculator::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    uint32_t channels[XCamSoftTasks::Stats3aBayerTask::ChannelCount];
+
+    XCAM_FAIL_RETURN (
+        ERROR,
+        in_info.format == V4L2_PIX_FMT_NV12 || get_bayer_quad_channels (in_info.format, channels),
+        XCAM_RETURN_ERROR_PARAM,
+        "Soft3aStatsCalculator(%s) only support NV12 and 8-bit bayer, but input format is %s",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (in_info.format));
+
+    XCAM_FAIL_RETURN (
+        ERROR, in_info.width >= _grid_size && in_info.height >= _grid_size, XCAM_RETURN_ERROR_PARAM,
+        "Soft3aStatsCalculator(%s) input size(%dx%d) is smaller than grid(%d)",
+        XCAM_STR (get_name ()), in_info.width, in_info.height, _grid_size);
+
+    // X3aStatsPool fixates stats info by input resolution
+    set_out_video_info (in_info);
+    _format = in_info.format;
+
+    XCAM_ASSERT (!_stats_task.ptr ());
+    if (_format == V4L2_PIX_FMT_NV12)
+        _stats_task = new XCamSoftTasks::Stats3aNV12Task (new CbStats3aTask (this));
+    else
+        _stats_task = new XCamSoftTasks::Stats3aBayerTask (new CbStats3aTask (this));
+    XCAM_ASSERT (_stats_task.ptr ());
+
+    set_work_size (
+        xcam_ceil (in_info.width, _grid_size) / _grid_size,
+        xcam_ceil (in_info.height, _grid_size) / _grid_size);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+Soft3aStatsCalculator::set_work_size (uint32_t grid_x, uint32_t grid_y)
+{
+    // grid rows are split into items, each item walks whole rows of grids
+    uint32_t thread_x = 1, thread_y = 8;
+
+    WorkSize global_size (grid_x, grid_y);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    _stats_task->set_local_size (local_size);
+    _stats_task->set_global_size (global_size);
+}
+
+SmartPtr<Worker::Arguments>
+Soft3aStatsCalculator::create_nv12_args (const SmartPtr<Parameters> &param, XCam3AStats *stats)
+{
+    SmartPtr<XCamSoftTasks::Stats3aNV12Task::Args> args = new XCamSoftTasks::Stats3aNV12Task::Args (param);
+    args->in_luma = new UcharImage (param->in_buf, 0);
+    args->in_uv = new Uchar2Image (param->in_buf, 1);
+    args->stats = stats;
+    args->valid_low = _valid_low;
+    args->valid_high = _valid_high;
+
+    return args;
+}
+
+SmartPtr<Worker::Arguments>
+Soft3aStatsCalculator::create_bayer_args (const SmartPtr<Parameters> &param, XCam3AStats *stats)
+{
+    SmartPtr<XCamSoftTasks::Stats3aBayerTask::Args> args = new XCamSoftTasks::Stats3aBayerTask::Args (param);
+    args->in_raw = new UcharImage (param->in_buf, 0);
+    args->stats = stats;
+    args->valid_low = _valid_low;
+    args->valid_high = _valid_high;
+    get_bayer_quad_channels (_format, args->quad_channel);
+
+    return args;
+}
+
+XCamReturn
+Soft3aStatsCalculator::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_stats_task.ptr ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    SmartPtr<X3aStats> out_stats = param->out_buf.dynamic_cast_ptr<X3aStats> ();
+    XCAM_FAIL_RETURN (
+        ERROR, out_stats.ptr () && out_stats->get_stats (), XCAM_RETURN_ERROR_PARAM,
+        "Soft3aStatsCalculator(%s) output buffer is not X3aStats", XCAM_STR (get_name ()));
+
+    XCam3AStats *stats = out_stats->get_stats ();
+    SmartPtr<Worker::Arguments> args;
+    if (_format == V4L2_PIX_FMT_NV12)
+        args = create_nv12_args (param, stats);
+    else
+        args = create_bayer_args (param, stats);
+
+    XCamReturn ret = _stats_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "Soft3aStatsCalculator(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+XCamReturn
+Soft3aStatsCalculator::terminate ()
+{
+    if (_stats_task.ptr ()) {
+        _stats_task->stop ();
+        _stats_task.release ();
+    }
+    return SoftHandler::terminate ();
+}
+
+void
+Soft3aStatsCalculator::stats_task_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _stats_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    SmartPtr<X3aStats> out_stats = param->out_buf.dynamic_cast_ptr<X3aStats> ();
+    XCAM_ASSERT (out_stats.ptr ());
+    fill_histogram (out_stats->get_stats ());
+    out_stats->set_timestamp (param->in_buf->get_timestamp ());
+
+    work_well_done (param, error);
+}
+
+SmartPtr<SoftHandler>
+create_soft_3a_stats_calculator ()
+{
+    SmartPtr<SoftHandler> calculator = new Soft3aStatsCalculator ();
+    XCAM_ASSERT (calculator.ptr ());
+
+    return calculator;
+}
+
+}
@@ -0,0 +1,85 @@
+/*
+ * soft_3a_stats.h - soft 3a statistics calculator class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_3A_STATS_H
+#define XCAM_SOFT_3A_STATS_H
+
+#include <xcam_std.h>
+#include <x3a_stats_pool.h>
+#include <soft/soft_handler.h>
+
+#define XCAM_SOFT_3A_STATS_DEFAULT_GRID 16
+
+namespace XCam {
+
+class SoftWorker;
+
+/* calculate XCam3AStats on CPU from NV12 or 8-bit bayer frames,
+ * output buffers are X3aStats allocated from X3aStatsPool
+ */
+class Soft3aStatsCalculator
+    : public SoftHandler
+{
+public:
+    explicit Soft3aStatsCalculator (const char *name = "Soft3aStatsCalculator");
+    ~Soft3aStatsCalculator ();
+
+    // grid must be multiple of 8, 8 ~ 128 pixels
+    bool set_grid_size (uint32_t grid_size);
+    uint32_t get_grid_size () const {
+        return _grid_size;
+    }
+    // pixels in [low, high] are counted in valid_wb_count
+    bool set_valid_range (uint32_t low, uint32_t high);
+
+    XCamReturn calculate (const SmartPtr<VideoBuffer> &in, SmartPtr<X3aStats> &stats);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+
+    void stats_task_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual SmartPtr<BufferPool> create_allocator ();
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    SmartPtr<Worker::Arguments> create_nv12_args (const SmartPtr<Parameters> &param, XCam3AStats *stats);
+    SmartPtr<Worker::Arguments> create_bayer_args (const SmartPtr<Parameters> &param, XCam3AStats *stats);
+    void set_work_size (uint32_t grid_x, uint32_t grid_y);
+
+    XCAM_DEAD_COPY (Soft3aStatsCalculator);
+
+private:
+    SmartPtr<SoftWorker>    _stats_task;
+    uint32_t                _grid_size;
+    uint32_t                _valid_low;
+    uint32_t                _valid_high;
+    uint32_t                _format;
+};
+
+extern SmartPtr<SoftHandler> create_soft_3a_stats_calculator ();
+
+}
+
+#endif //XCAM_SOFT_3A_STATS_H
@@ -0,0 +1,371 @@
+/*
+ * soft_3a_stats_tasks_priv.cpp - soft 3a statistics tasks
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_3a_stats_tasks_priv.h"
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// one 128-bit chunk is 16 pixels, its two 64-bit lanes sum two cells of 8 pixels
+#define STATS_CHUNK_PIXELS 16
+#define STATS_CELL_PIXELS 8
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+enum {
+    AccSum0 = 0,
+    AccSum1,
+    AccSum2,
+    AccSum3,
+    AccValid,
+    AccF1,
+    AccF2,
+    AccCount
+};
+
+// accumulators of one grid row, each cell is 8 pixels wide
+// NV12: AccSum0~2 are y/u/v; Bayer: AccSum0~3 are quad positions (0,0), (1,0), (0,1), (1,1)
+struct CellSums {
+    std::vector<uint64_t> &buf;
+    uint64_t              *acc[AccCount];
+
+    CellSums (std::vector<uint64_t> &scratch, uint32_t grids_width)
+        : buf (scratch)
+    {
+        // keep cells even for 128-bit load/store of cell pairs
+        uint32_t cells = XCAM_ALIGN_UP (grids_width, STATS_CHUNK_PIXELS) / STATS_CELL_PIXELS;
+        buf.resize (cells * AccCount);
+        for (uint32_t i = 0; i < AccCount; ++i)
+            acc[i] = &buf[cells * i];
+    }
+    void reset () {
+        memset (&buf[0], 0, buf.size () * sizeof (uint64_t));
+    }
+    uint64_t sum (uint32_t idx, uint32_t cell, uint32_t count) const {
+        uint64_t ret = 0;
+        for (uint32_t i = cell; i < cell + count; ++i)
+            ret += acc[idx][i];
+        return ret;
+    }
+};
+
+std::vector<uint64_t> *
+Stats3aTask::acquire_scratch ()
+{
+    SmartLock locker (_scratch_mutex);
+    if (_free_scratch.empty ()) {
+        _scratch.push_back (std::vector<uint64_t> ());
+        return &_scratch.back ();
+    }
+
+    std::vector<uint64_t> *scratch = _free_scratch.back ();
+    _free_scratch.pop_back ();
+    return scratch;
+}
+
+void
+Stats3aTask::release_scratch (std::vector<uint64_t> *scratch)
+{
+    SmartLock locker (_scratch_mutex);
+    _free_scratch.push_back (scratch);
+}
+
+static inline uint32_t
+abs_diff (uint32_t a, uint32_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+static inline uint32_t
+clamp_to_uchar (float value)
+{
+    return (uint32_t) XCAM_CLAMP (value + 0.5f, 0.0f, 255.0f);
+}
+
+#if defined (__SSE2__)
+static inline void
+add_cells (uint64_t *cells, const __m128i &value)
+{
+    __m128i *ptr = (__m128i *)cells;
+    _mm_storeu_si128 (ptr, _mm_add_epi64 (_mm_loadu_si128 (ptr), value));
+}
+
+static inline __m128i
+load_pixels (const Uchar *ptr)
+{
+    return _mm_loadu_si128 ((const __m128i *)ptr);
+}
+#endif
+
+// accumulate luma pixels [x0, x1) of one line, gradients read right neighbors inside image width
+static inline void
+accumulate_luma_line (
+    const Uchar *line, const uint32_t x0, const uint32_t x1, const uint32_t width,
+    const uint32_t low, const uint32_t high, CellSums &cells)
+{
+    uint32_t x = x0;
+
+#if defined (__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i one = _mm_set1_epi8 (1);
+    const __m128i low_v = _mm_set1_epi8 ((char)low);
+    const __m128i high_v = _mm_set1_epi8 ((char)high);
+
+    // _mm_sad_epu8 sums 8 pixels into each 64-bit lane, one lane per cell
+    for (; x + STATS_CHUNK_PIXELS <= x1 && x + STATS_CHUNK_PIXELS + 2 <= width; x += STATS_CHUNK_PIXELS) {
+        const uint32_t c = (x - x0) / STATS_CELL_PIXELS;
+        __m128i p = load_pixels (line + x);
+        __m128i in_range = _mm_and_si128 (
+            _mm_cmpeq_epi8 (_mm_max_epu8 (p, low_v), p),
+            _mm_cmpeq_epi8 (_mm_min_epu8 (p, high_v), p));
+
+        add_cells (cells.acc[AccSum0] + c, _mm_sad_epu8 (p, zero));
+        add_cells (cells.acc[AccValid] + c, _mm_sad_epu8 (_mm_and_si128 (in_range, one), zero));
+        add_cells (cells.acc[AccF1] + c, _mm_sad_epu8 (p, load_pixels (line + x + 1)));
+        add_cells (cells.acc[AccF2] + c, _mm_sad_epu8 (p, load_pixels (line + x + 2)));
+    }
+#endif
+
+    for (; x < x1; ++x) {
+        const uint32_t c = (x - x0) / STATS_CELL_PIXELS;
+        const uint32_t p = line[x];
+        cells.acc[AccSum0][c] += p;
+        cells.acc[AccValid][c] += (p >= low && p <= high);
+        if (x + 1 < width)
+            cells.acc[AccF1][c] += abs_diff (line[x + 1], p);
+        if (x + 2 < width)
+            cells.acc[AccF2][c] += abs_diff (line[x + 2], p);
+    }
+}
+
+// accumulate uv line, byte x of uv line is in same cell as luma pixel x
+static inline void
+accumulate_uv_line (const Uchar *line, const uint32_t x0, const uint32_t x1, CellSums &cells)
+{
+    uint32_t x = x0;
+
+#if defined (__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i low_byte = _mm_set1_epi16 (0x00FF);
+
+    for (; x + STATS_CHUNK_PIXELS <= x1; x += STATS_CHUNK_PIXELS) {
+        const uint32_t c = (x - x0) / STATS_CELL_PIXELS;
+        __m128i uv = load_pixels (line + x);
+        add_cells (cells.acc[AccSum1] + c, _mm_sad_epu8 (_mm_and_si128 (uv, low_byte), zero));
+        add_cells (cells.acc[AccSum2] + c, _mm_sad_epu8 (_mm_srli_epi16 (uv, 8), zero));
+    }
+#endif
+
+    for (; x < x1; ++x) {
+        const uint32_t c = (x - x0) / STATS_CELL_PIXELS;
+        cells.acc[(x % 2) ? AccSum2 : AccSum1][c] += line[x];
+    }
+}
+
+XCamReturn
+Stats3aNV12Task::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<Stats3aNV12Task::Args> args = base.dynamic_cast_ptr<Stats3aNV12Task::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    UcharImage *in_luma = args->in_luma.ptr ();
+    Uchar2Image *in_uv = args->in_uv.ptr ();
+    XCam3AStats *stats = args->stats;
+    XCAM_ASSERT (in_luma && in_uv && stats);
+
+    const XCam3AStatsInfo &info = stats->info;
+    const uint32_t grid = info.grid_pixel_size;
+    const uint32_t grid_cells = grid / STATS_CELL_PIXELS;
+    const uint32_t width = in_luma->get_width ();
+    const uint32_t height = in_luma->get_height ();
+    const uint32_t uv_height = in_uv->get_height ();
+    XCAM_ASSERT (grid % STATS_CELL_PIXELS == 0);
+
+    const uint32_t x0 = range.pos[0] * grid;
+    const uint32_t x1 = XCAM_MIN ((range.pos[0] + range.pos_len[0]) * grid, width);
+    std::vector<uint64_t> *scratch = acquire_scratch ();
+    CellSums cells (*scratch, range.pos_len[0] * grid);
+
+    for (uint32_t gy = range.pos[1]; gy < range.pos[1] + range.pos_len[1]; ++gy) {
+        const uint32_t y0 = gy * grid;
+        const uint32_t y1 = XCAM_MIN (y0 + grid, height);
+        const uint32_t uv_y0 = y0 / 2;
+        const uint32_t uv_y1 = XCAM_MIN ((y1 + 1) / 2, uv_height);
+
+        cells.reset ();
+        for (uint32_t y = y0; y < y1; ++y) {
+            accumulate_luma_line (
+                in_luma->get_buf_ptr (0, y), x0, x1, width, args->valid_low, args->valid_high, cells);
+        }
+        for (uint32_t y = uv_y0; y < uv_y1; ++y)
+            accumulate_uv_line ((const Uchar *)in_uv->get_buf_ptr (0, y), x0, x1, cells);
+
+        for (uint32_t gx = range.pos[0]; gx < range.pos[0] + range.pos_len[0]; ++gx) {
+            const uint32_t c0 = (gx * grid - x0) / STATS_CELL_PIXELS;
+            const uint32_t n = XCAM_MIN (grid, x1 - gx * grid);
+            const uint32_t count = n * (y1 - y0);
+            const uint32_t uv_count = XCAM_MAX ((n / 2) * (uv_y1 - uv_y0), 1u);
+
+            const float avg_y = (float)cells.sum (AccSum0, c0, grid_cells) / count;
+            const float u = (float)cells.sum (AccSum1, c0, grid_cells) / uv_count - 128.0f;
+            const float v = (float)cells.sum (AccSum2, c0, grid_cells) / uv_count - 128.0f;
+
+            XCamGridStat &grid_stat = stats->stats[gy * info.aligned_width + gx];
+            grid_stat.avg_y = clamp_to_uchar (avg_y);
+            grid_stat.avg_r = clamp_to_uchar (avg_y + 1.402f * v);
+            grid_stat.avg_gr = clamp_to_uchar (avg_y - 0.344f * u - 0.714f * v);
+            grid_stat.avg_gb = grid_stat.avg_gr;
+            grid_stat.avg_b = clamp_to_uchar (avg_y + 1.772f * u);
+            grid_stat.valid_wb_count = cells.sum (AccValid, c0, grid_cells);
+            grid_stat.f_value1 = cells.sum (AccF1, c0, grid_cells) / count;
+            grid_stat.f_value2 = cells.sum (AccF2, c0, grid_cells) / count;
+        }
+    }
+
+    release_scratch (scratch);
+
+    XCAM_LOG_DEBUG ("Stats3aNV12Task work on range:[x:%d, width:%d, y:%d, height:%d]",
+                    range.pos[0], range.pos_len[0], range.pos[1], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+// accumulate a pair of bayer lines, focus values are on same-color neighbors of first line
+static inline void
+accumulate_bayer_lines (
+    const Uchar *line0, const Uchar *line1, const uint32_t x0, const uint32_t x1, const uint32_t width,
+    const uint32_t low, const uint32_t high, CellSums &cells)
+{
+    uint32_t x = x0;
+
+#if defined (__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i low_byte = _mm_set1_epi16 (0x00FF);
+    const __m128i one = _mm_set1_epi16 (1);
+    const __m128i low_v = _mm_set1_epi16 ((int16_t)low - 1);
+    const __m128i high_v = _mm_set1_epi16 ((int16_t)high + 1);
+
+    for (; x + STATS_CHUNK_PIXELS <= x1 && x + STATS_CHUNK_PIXELS + 4 <= width; x += STATS_CHUNK_PIXELS) {
+        const uint32_t c = (x - x0) / STATS_CELL_PIXELS;
+        __m128i p0 = load_pixels (line0 + x);
+        __m128i p1 = load_pixels (line1 + x);
+
+        add_cells (cells.acc[AccSum0] + c, _mm_sad_epu8 (_mm_and_si128 (p0, low_byte), zero));
+        add_cells (cells.acc[AccSum1] + c, _mm_sad_epu8 (_mm_srli_epi16 (p0, 8), zero));
+        add_cells (cells.acc[AccSum2] + c, _mm_sad_epu8 (_mm_and_si128 (p1, low_byte), zero));
+        add_cells (cells.acc[AccSum3] + c, _mm_sad_epu8 (_mm_srli_epi16 (p1, 8), zero));
+
+        // max and min of each 2x2 quad in 16-bit lanes
+        __m128i max_p = _mm_max_epu8 (p0, p1);
+        __m128i min_p = _mm_min_epu8 (p0, p1);
+        max_p = _mm_max_epi16 (_mm_and_si128 (max_p, low_byte), _mm_srli_epi16 (max_p, 8));
+        min_p = _mm_min_epi16 (_mm_and_si128 (min_p, low_byte), _mm_srli_epi16 (min_p, 8));
+        __m128i valid = _mm_and_si128 (_mm_cmpgt_epi16 (min_p, low_v), _mm_cmpgt_epi16 (high_v, max_p));
+        add_cells (cells.acc[AccValid] + c, _mm_sad_epu8 (_mm_and_si128 (valid, one), zero));
+
+        add_cells (cells.acc[AccF1] + c, _mm_sad_epu8 (p0, load_pixels (line0 + x + 2)));
+        add_cells (cells.acc[AccF2] + c, _mm_sad_epu8 (p0, load_pixels (line0 + x + 4)));
+    }
+#endif
+
+    for (; x < x1; ++x) {
+        const uint32_t c = (x - x0) / STATS_CELL_PIXELS;
+        const uint32_t odd = x % 2;
+        cells.acc[AccSum0 + odd][c] += line0[x];
+        cells.acc[AccSum2 + odd][c] += line1[x];
+        if (!odd && x + 1 < width) {
+            uint32_t max_p = XCAM_MAX (XCAM_MAX (line0[x], line0[x + 1]), XCAM_MAX (line1[x], line1[x + 1]));
+            uint32_t min_p = XCAM_MIN (XCAM_MIN (line0[x], line0[x + 1]), XCAM_MIN (line1[x], line1[x + 1]));
+            cells.acc[AccValid][c] += (min_p >= low && max_p <= high);
+        }
+        if (x + 2 < width)
+            cells.acc[AccF1][c] += abs_diff (line0[x + 2], line0[x]);
+        if (x + 4 < width)
+            cells.acc[AccF2][c] += abs_diff (line0[x + 4], line0[x]);
+    }
+}
+
+XCamReturn
+Stats3aBayerTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<Stats3aBayerTask::Args> args = base.dynamic_cast_ptr<Stats3aBayerTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    UcharImage *in_raw = args->in_raw.ptr ();
+    XCam3AStats *stats = args->stats;
+    XCAM_ASSERT (in_raw && stats);
+
+    const XCam3AStatsInfo &info = stats->info;
+    const uint32_t grid = info.grid_pixel_size;
+    const uint32_t grid_cells = grid / STATS_CELL_PIXELS;
+    const uint32_t width = XCAM_ALIGN_DOWN (in_raw->get_width (), 2);
+    const uint32_t height = XCAM_ALIGN_DOWN (in_raw->get_height (), 2);
+    XCAM_ASSERT (grid % STATS_CELL_PIXELS == 0);
+
+    const uint32_t x0 = range.pos[0] * grid;
+    const uint32_t x1 = XCAM_MIN ((range.pos[0] + range.pos_len[0]) * grid, width);
+    std::vector<uint64_t> *scratch = acquire_scratch ();
+    CellSums cells (*scratch, range.pos_len[0] * grid);
+
+    for (uint32_t gy = range.pos[1]; gy < range.pos[1] + range.pos_len[1]; ++gy) {
+        const uint32_t y0 = gy * grid;
+        const uint32_t y1 = XCAM_MIN (y0 + grid, height);
+
+        cells.reset ();
+        for (uint32_t y = y0; y + 1 < y1; y += 2) {
+            accumulate_bayer_lines (
+                in_raw->get_buf_ptr (0, y), in_raw->get_buf_ptr (0, y + 1), x0, x1, width,
+                args->valid_low, args->valid_high, cells);
+        }
+
+        for (uint32_t gx = range.pos[0]; gx < range.pos[0] + range.pos_len[0]; ++gx) {
+            const uint32_t c0 = (gx * grid - x0) / STATS_CELL_PIXELS;
+            const uint32_t n = XCAM_MIN (grid, x1 - gx * grid);
+            const uint32_t quads = XCAM_MAX ((n / 2) * ((y1 - y0) / 2), 1u);
+
+            float avg[ChannelCount];
+            for (uint32_t i = 0; i < ChannelCount; ++i)
+                avg[args->quad_channel[i]] = (float)cells.sum (AccSum0 + i, c0, grid_cells) / quads;
+
+            const float avg_g = (avg[ChannelGr] + avg[ChannelGb]) * 0.5f;
+            XCamGridStat &grid_stat = stats->stats[gy * info.aligned_width + gx];
+            grid_stat.avg_y = clamp_to_uchar (0.299f * avg[ChannelR] + 0.587f * avg_g + 0.114f * avg[ChannelB]);
+            grid_stat.avg_r = clamp_to_uchar (avg[ChannelR]);
+            grid_stat.avg_gr = clamp_to_uchar (avg[ChannelGr]);
+            grid_stat.avg_gb = clamp_to_uchar (avg[ChannelGb]);
+            grid_stat.avg_b = clamp_to_uchar (avg[ChannelB]);
+            grid_stat.valid_wb_count = cells.sum (AccValid, c0, grid_cells);
+            grid_stat.f_value1 = cells.sum (AccF1, c0, grid_cells) / (quads * 2);
+            grid_stat.f_value2 = cells.sum (AccF2, c0, grid_cells) / (quads * 2);
+        }
+    }
+
+    release_scratch (scratch);
+
+    XCAM_LOG_DEBUG ("Stats3aBayerTask work on range:[x:%d, width:%d, y:%d, height:%d]",
+                    range.pos[0], range.pos_len[0], range.pos[1], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+}
+
+}
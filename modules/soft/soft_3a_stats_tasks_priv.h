@@ -0,0 +1,131 @@
+/*
+ * soft_3a_stats_tasks_priv.h - soft 3a statistics tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_3A_STATS_TASKS_PRIV_H
+#define XCAM_SOFT_3A_STATS_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_handler.h>
+#include <base/xcam_3a_stats.h>
+#include <xcam_mutex.h>
+#include <list>
+#include <vector>
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+// accumulator scratch of grid rows is kept by the worker and reused by all ranges,
+// one buffer is allocated for each range running at the same time
+class Stats3aTask
+    : public SoftWorker
+{
+public:
+    explicit Stats3aTask (const char *name, const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker (name, cb)
+    {}
+
+protected:
+    std::vector<uint64_t> *acquire_scratch ();
+    void release_scratch (std::vector<uint64_t> *scratch);
+
+private:
+    Mutex                                  _scratch_mutex;
+    std::list<std::vector<uint64_t> >      _scratch;
+    std::vector<std::vector<uint64_t> *>   _free_scratch;
+};
+
+// one work item covers a block of grids, range is counted in grids
+class Stats3aNV12Task
+    : public Stats3aTask
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>        in_luma;
+        SmartPtr<Uchar2Image>       in_uv;
+        XCam3AStats                *stats;
+        uint32_t                    valid_low;
+        uint32_t                    valid_high;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+            , stats (NULL)
+            , valid_low (0)
+            , valid_high (255)
+        {}
+    };
+
+public:
+    explicit Stats3aNV12Task (const SmartPtr<Worker::Callback> &cb)
+        : Stats3aTask ("Stats3aNV12Task", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+class Stats3aBayerTask
+    : public Stats3aTask
+{
+public:
+    enum {
+        ChannelR = 0,
+        ChannelGr,
+        ChannelGb,
+        ChannelB,
+        ChannelCount,
+    };
+
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>        in_raw;
+        XCam3AStats                *stats;
+        uint32_t                    valid_low;
+        uint32_t                    valid_high;
+        // channel of each 2x2 quad position, [0]:(0,0), [1]:(1,0), [2]:(0,1), [3]:(1,1)
+        uint32_t                    quad_channel[ChannelCount];
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+            , stats (NULL)
+            , valid_low (0)
+            , valid_high (255)
+        {
+            xcam_mem_clear (quad_channel);
+        }
+    };
+
+public:
+    explicit Stats3aBayerTask (const SmartPtr<Worker::Callback> &cb)
+        : Stats3aTask ("Stats3aBayerTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+}
+
+}
+
+#endif //XCAM_SOFT_3A_STATS_TASKS_PRIV_H
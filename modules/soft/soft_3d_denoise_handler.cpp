@@ -0,0 +1,261 @@
+/*
+ * soft_3d_denoise_handler.cpp - soft 3D denoise handler class implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_3d_denoise_handler.h"
+#include "soft_3d_denoise_tasks_priv.h"
+
+#define DENOISE_3D_BLOCK_PIXELS \
+    ((XCAM_SOFT_3D_DENOISE_BLOCK_RADIUS * 2 + 1) * (XCAM_SOFT_3D_DENOISE_BLOCK_RADIUS * 2 + 1))
+
+namespace XCam {
+
+DECLARE_WORK_CALLBACK (CbDenoise3DTask, Soft3DDenoiseHandler, denoise_task_done);
+
+Soft3DDenoiseHandler::Soft3DDenoiseHandler (const char *name)
+    : SoftHandler (name)
+    , _channel (XCAM_SOFT_3D_DENOISE_CHANNEL_Y | XCAM_SOFT_3D_DENOISE_CHANNEL_UV)
+    , _ref_count (XCAM_SOFT_3D_DENOISE_DEFAULT_REF_COUNT)
+    , _iir (true)
+    , _gain (1.0f)
+    , _config_changed (true)
+{
+}
+
+Soft3DDenoiseHandler::~Soft3DDenoiseHandler ()
+{
+}
+
+bool
+Soft3DDenoiseHandler::set_channel (uint32_t channel)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, !(channel & ~(XCAM_SOFT_3D_DENOISE_CHANNEL_Y | XCAM_SOFT_3D_DENOISE_CHANNEL_UV)), false,
+        "Soft3DDenoiseHandler(%s) unknown channel(%d)", XCAM_STR (get_name ()), channel);
+
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "Soft3DDenoiseHandler(%s) channel can NOT be changed after configured", XCAM_STR (get_name ()));
+
+    _channel = channel;
+    return true;
+}
+
+bool
+Soft3DDenoiseHandler::set_ref_count (uint32_t count)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, count && count <= XCAM_SOFT_3D_DENOISE_MAX_REF_COUNT, false,
+        "Soft3DDenoiseHandler(%s) ref count(%d) need be in range [1, %d]",
+        XCAM_STR (get_name ()), count, XCAM_SOFT_3D_DENOISE_MAX_REF_COUNT);
+
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "Soft3DDenoiseHandler(%s) ref count can NOT be changed after configured", XCAM_STR (get_name ()));
+
+    _ref_count = count;
+    return true;
+}
+
+bool
+Soft3DDenoiseHandler::set_iir (bool enable)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "Soft3DDenoiseHandler(%s) iir can NOT be changed after configured", XCAM_STR (get_name ()));
+
+    _iir = enable;
+    return true;
+}
+
+bool
+Soft3DDenoiseHandler::set_denoise_config (const XCam3aResultTemporalNoiseReduction &config)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, config.gain > 0.0 && config.gain <= 1.0, false,
+        "Soft3DDenoiseHandler(%s) invalid config, gain:%.3f", XCAM_STR (get_name ()), config.gain);
+
+    SmartLock locker (_config_mutex);
+    _gain = (float)config.gain;
+    _config_changed = true;
+
+    XCAM_LOG_DEBUG ("Soft3DDenoiseHandler(%s) set config, gain:%.3f", XCAM_STR (get_name ()), _gain);
+
+    return true;
+}
+
+XCamReturn
+Soft3DDenoiseHandler::denoise (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in, out);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+void
+Soft3DDenoiseHandler::update_tables ()
+{
+    float gain;
+    {
+        SmartLock locker (_config_mutex);
+        gain = _gain;
+        _config_changed = false;
+    }
+
+    _luma_table.release ();
+    _uv_table.release ();
+    if (_channel & XCAM_SOFT_3D_DENOISE_CHANNEL_Y) {
+        _luma_table = new XCamSoftTasks::Denoise3DWeightTable;
+        XCAM_ASSERT (_luma_table.ptr ());
+        _luma_table->init (gain, DENOISE_3D_BLOCK_PIXELS);
+    }
+    if (_channel & XCAM_SOFT_3D_DENOISE_CHANNEL_UV) {
+        _uv_table = new XCamSoftTasks::Denoise3DWeightTable;
+        XCAM_ASSERT (_uv_table.ptr ());
+        _uv_table->init (gain, DENOISE_3D_BLOCK_PIXELS * 2);
+    }
+}
+
+XCamReturn
+Soft3DDenoiseHandler::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        ERROR, in_info.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "Soft3DDenoiseHandler(%s) only support format(NV12) but input format is %s",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (in_info.format));
+
+    set_out_video_info (in_info);
+    // iir references stay in output pool
+    if (_enable_allocator && _iir)
+        enable_allocator (true, XCAM_DEFAULT_HANDLER_BUF_CAP + _ref_count);
+
+    XCAM_ASSERT (!_denoise_task.ptr ());
+    _denoise_task = new XCamSoftTasks::Denoise3DTask (new CbDenoise3DTask (this));
+    XCAM_ASSERT (_denoise_task.ptr ());
+    share_threads (_denoise_task);
+
+    set_work_size (in_info.height / 2);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+Soft3DDenoiseHandler::set_work_size (uint32_t uv_height)
+{
+    uint32_t thread_x = 1, thread_y = 4;
+
+    WorkSize global_size (
+        1, xcam_ceil (uv_height, XCAM_SOFT_3D_DENOISE_BAND_LINES) / XCAM_SOFT_3D_DENOISE_BAND_LINES);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    _denoise_task->set_local_size (local_size);
+    _denoise_task->set_global_size (global_size);
+}
+
+XCamReturn
+Soft3DDenoiseHandler::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_denoise_task.ptr ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    bool changed;
+    {
+        SmartLock locker (_config_mutex);
+        changed = _config_changed;
+    }
+    if (changed)
+        update_tables ();
+
+    SmartPtr<XCamSoftTasks::Denoise3DTask::Args> args = new XCamSoftTasks::Denoise3DTask::Args (param);
+    args->in_luma = new UcharImage (param->in_buf, 0);
+    args->in_uv = new Uchar2Image (param->in_buf, 1);
+    args->out_luma = new UcharImage (param->out_buf, 0);
+    args->out_uv = new Uchar2Image (param->out_buf, 1);
+    for (BufferList::iterator i = _refs.begin (); i != _refs.end (); ++i) {
+        args->ref_luma.push_back (new UcharImage (*i, 0));
+        args->ref_uv.push_back (new Uchar2Image (*i, 1));
+    }
+    args->luma_table = _luma_table;
+    args->uv_table = _uv_table;
+
+    // latest frame first, buffers are shared with their pools, not copied
+    _refs.push_front (_iir ? param->out_buf : param->in_buf);
+    if (_refs.size () > _ref_count)
+        _refs.pop_back ();
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = _denoise_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "Soft3DDenoiseHandler(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+XCamReturn
+Soft3DDenoiseHandler::terminate ()
+{
+    if (_denoise_task.ptr ()) {
+        _denoise_task->stop ();
+        _denoise_task.release ();
+    }
+    _refs.clear ();
+
+    return SoftHandler::terminate ();
+}
+
+void
+Soft3DDenoiseHandler::denoise_task_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _denoise_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    work_well_done (param, error);
+}
+
+SmartPtr<SoftHandler>
+create_soft_3d_denoise_handler (uint32_t channel, uint32_t ref_count)
+{
+    SmartPtr<Soft3DDenoiseHandler> denoise = new Soft3DDenoiseHandler ();
+    XCAM_ASSERT (denoise.ptr ());
+    XCAM_FAIL_RETURN (
+        ERROR, denoise->set_channel (channel) && denoise->set_ref_count (ref_count), NULL,
+        "create soft 3d denoise handler failed with channel(%d), ref count(%d)", channel, ref_count);
+
+    return denoise;
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+ * soft_3d_denoise_handler.h - soft 3D denoise handler class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_3D_DENOISE_HANDLER_H
+#define XCAM_SOFT_3D_DENOISE_HANDLER_H
+
+#include <xcam_std.h>
+#include <base/xcam_3a_result.h>
+#include <soft/soft_handler.h>
+#include <list>
+
+#define XCAM_SOFT_3D_DENOISE_CHANNEL_Y 1
+#define XCAM_SOFT_3D_DENOISE_CHANNEL_UV 2
+
+#define XCAM_SOFT_3D_DENOISE_MAX_REF_COUNT 3
+#define XCAM_SOFT_3D_DENOISE_DEFAULT_REF_COUNT 1
+
+namespace XCam {
+
+class SoftWorker;
+
+namespace XCamSoftTasks {
+struct Denoise3DWeightTable;
+};
+
+/* block matching 3D denoise on NV12, CPU counterpart of CL3DDenoiseImageHandler.
+ * every pixel averages candidates around it in current frame and references,
+ * weighted by block differences with same falloff as kernel_3d_denoise.
+ * references are former outputs (IIR, default) or former inputs, held by
+ * reference of their buffers instead of copies, so their pools need room for
+ * ref count more buffers. frames need be processed one after another.
+ */
+class Soft3DDenoiseHandler
+    : public SoftHandler
+{
+    typedef std::list<SmartPtr<VideoBuffer> > BufferList;
+
+public:
+    explicit Soft3DDenoiseHandler (const char *name = "Soft3DDenoiseHandler");
+    ~Soft3DDenoiseHandler ();
+
+    // channel, ref count and iir can NOT be changed after configured
+    bool set_channel (uint32_t channel);
+    bool set_ref_count (uint32_t count);
+    bool set_iir (bool enable);
+    // gain in (0, 1], thresholds are not used, thread safe
+    bool set_denoise_config (const XCam3aResultTemporalNoiseReduction &config);
+
+    XCamReturn denoise (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+
+    void denoise_task_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    void update_tables ();
+    void set_work_size (uint32_t uv_height);
+
+    XCAM_DEAD_COPY (Soft3DDenoiseHandler);
+
+private:
+    SmartPtr<SoftWorker>                            _denoise_task;
+    SmartPtr<XCamSoftTasks::Denoise3DWeightTable>   _luma_table;
+    SmartPtr<XCamSoftTasks::Denoise3DWeightTable>   _uv_table;
+    BufferList                                      _refs;
+    uint32_t                                        _channel;
+    uint32_t                                        _ref_count;
+    bool                                            _iir;
+
+    Mutex                                           _config_mutex;
+    float                                           _gain;
+    bool                                            _config_changed;
+};
+
+extern SmartPtr<SoftHandler> create_soft_3d_denoise_handler (uint32_t channel, uint32_t ref_count);
+
+}
+
+#endif //XCAM_SOFT_3D_DENOISE_HANDLER_H
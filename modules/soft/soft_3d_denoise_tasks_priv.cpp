@@ -0,0 +1,306 @@
+/*
+ * soft_3d_denoise_tasks_priv.cpp - soft 3D denoise tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_3d_denoise_tasks_priv.h"
+#include <math.h>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// weights below exp (-8) are dropped
+#define DENOISE_3D_WEIGHT_RANGE 8.0f
+#define DENOISE_3D_BLOCK_LINES (XCAM_SOFT_3D_DENOISE_BLOCK_RADIUS * 2 + 1)
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+void
+Denoise3DWeightTable::init (float gain, uint32_t block_values)
+{
+    // kernel_3d_denoise: exp (-5 / gain * ssd) on 16 values in [0, 1]
+    const float ssd_scale = 5.0f * 16.0f / (XCAM_MAX (gain, 0.0001f) * 255.0f * 255.0f * block_values);
+    index_scale = ssd_scale * XCAM_SOFT_3D_DENOISE_WEIGHT_TABLE_SIZE / DENOISE_3D_WEIGHT_RANGE;
+
+    for (uint32_t i = 0; i < XCAM_SOFT_3D_DENOISE_WEIGHT_TABLE_SIZE - 1; ++i)
+        weight[i] = expf (-(float)i * DENOISE_3D_WEIGHT_RANGE / XCAM_SOFT_3D_DENOISE_WEIGHT_TABLE_SIZE);
+    weight[XCAM_SOFT_3D_DENOISE_WEIGHT_TABLE_SIZE - 1] = 0.0f;
+}
+
+/* line @y of @plane displaced by @shift pixels into @dst,
+ * pixels out of line repeat the edge pixel.
+ */
+template <typename T>
+static void
+get_shifted_line (const SoftImage<T> &plane, int32_t y, int32_t shift, T *dst)
+{
+    const int32_t width = plane.get_width ();
+    const T *src = plane.get_buf_ptr (0, XCAM_CLAMP (y, 0, (int32_t)plane.get_height () - 1));
+
+    const int32_t begin = XCAM_MAX (-shift, 0);
+    const int32_t end = width - XCAM_MAX (shift, 0);
+    for (int32_t x = 0; x < begin; ++x)
+        dst[x] = src[0];
+    memcpy ((void *)(dst + begin), (const void *)(src + begin + shift), (end - begin) * sizeof (T));
+    for (int32_t x = end; x < width; ++x)
+        dst[x] = src[width - 1];
+}
+
+// squared differences of @count bytes
+static void
+diff_square (const uint8_t *a, const uint8_t *b, uint32_t count, uint16_t *dst)
+{
+    uint32_t x = 0;
+
+#if defined (__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    for (; x + 16 <= count; x += 16) {
+        const __m128i va = _mm_loadu_si128 ((const __m128i *)(a + x));
+        const __m128i vb = _mm_loadu_si128 ((const __m128i *)(b + x));
+        const __m128i diff = _mm_or_si128 (_mm_subs_epu8 (va, vb), _mm_subs_epu8 (vb, va));
+        const __m128i lo = _mm_unpacklo_epi8 (diff, zero);
+        const __m128i hi = _mm_unpackhi_epi8 (diff, zero);
+        // 255 * 255 still fits in 16 bits
+        _mm_storeu_si128 ((__m128i *)(dst + x), _mm_mullo_epi16 (lo, lo));
+        _mm_storeu_si128 ((__m128i *)(dst + x + 8), _mm_mullo_epi16 (hi, hi));
+    }
+#endif
+
+    for (; x < count; ++x) {
+        const int32_t diff = (int32_t)a[x] - b[x];
+        dst[x] = (uint16_t)(diff * diff);
+    }
+}
+
+// column sums move down one line, @add enters and @sub leaves
+static void
+update_column_sum (const uint16_t *add, const uint16_t *sub, uint32_t count, uint32_t *sum)
+{
+    uint32_t x = 0;
+
+#if defined (__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    for (; x + 8 <= count; x += 8) {
+        const __m128i va = _mm_loadu_si128 ((const __m128i *)(add + x));
+        const __m128i vs = _mm_loadu_si128 ((const __m128i *)(sub + x));
+        __m128i lo = _mm_loadu_si128 ((const __m128i *)(sum + x));
+        __m128i hi = _mm_loadu_si128 ((const __m128i *)(sum + x + 4));
+        lo = _mm_sub_epi32 (_mm_add_epi32 (lo, _mm_unpacklo_epi16 (va, zero)), _mm_unpacklo_epi16 (vs, zero));
+        hi = _mm_sub_epi32 (_mm_add_epi32 (hi, _mm_unpackhi_epi16 (va, zero)), _mm_unpackhi_epi16 (vs, zero));
+        _mm_storeu_si128 ((__m128i *)(sum + x), lo);
+        _mm_storeu_si128 ((__m128i *)(sum + x + 4), hi);
+    }
+#endif
+
+    for (; x < count; ++x)
+        sum[x] += (uint32_t)add[x] - sub[x];
+}
+
+struct Denoise3DScratch {
+    std::vector<float>      acc_value;
+    std::vector<float>      acc_weight;
+    std::vector<uint16_t>   square[DENOISE_3D_BLOCK_LINES];
+    std::vector<uint16_t>   entering;
+    std::vector<uint32_t>   column_sum;
+    // prefix of column sums, one entry each pixel boundary
+    std::vector<uint32_t>   prefix;
+    std::vector<uint8_t>    ref_line;
+
+    void resize (uint32_t lines, uint32_t bytes, uint32_t pixels) {
+        acc_value.resize (lines * bytes);
+        acc_weight.resize (lines * bytes);
+        for (uint32_t i = 0; i < DENOISE_3D_BLOCK_LINES; ++i)
+            square[i].resize (bytes);
+        entering.resize (bytes);
+        column_sum.resize (bytes);
+        prefix.resize (pixels + 1);
+        ref_line.resize (bytes);
+    }
+};
+
+/* squared differences of line @y between @cur and @ref displaced by (@dx, @dy)
+ * into @square, edge lines and pixels repeat.
+ */
+template <typename T>
+static void
+get_square_line (
+    const SoftImage<T> &cur, const SoftImage<T> &ref, int32_t y, int32_t dx, int32_t dy,
+    Denoise3DScratch &scratch, uint16_t *square)
+{
+    const uint32_t bytes = cur.get_width () * sizeof (T);
+    const int32_t cur_y = XCAM_CLAMP (y, 0, (int32_t)cur.get_height () - 1);
+
+    get_shifted_line (ref, cur_y + dy, dx, (T *)&scratch.ref_line[0]);
+    diff_square ((const uint8_t *)cur.get_buf_ptr (0, cur_y), &scratch.ref_line[0], bytes, square);
+}
+
+// ring slot of squared differences of line @y, lines y - radius - 1 and y + radius share one
+static inline std::vector<uint16_t> &
+get_square_slot (Denoise3DScratch &scratch, int32_t y)
+{
+    return scratch.square[(uint32_t)(y + DENOISE_3D_BLOCK_LINES * 8) % DENOISE_3D_BLOCK_LINES];
+}
+
+/* accumulates candidates of @ref displaced by (@dx, @dy) into lines [y_begin, y_end).
+ * block of a pixel covers all channels of (2 * radius + 1) square pixels.
+ */
+template <typename T>
+static void
+accumulate_candidate (
+    const SoftImage<T> &cur, const SoftImage<T> &ref, int32_t dx, int32_t dy,
+    int32_t y_begin, int32_t y_end, const Denoise3DWeightTable &table, Denoise3DScratch &scratch)
+{
+    const int32_t radius = XCAM_SOFT_3D_DENOISE_BLOCK_RADIUS;
+    const uint32_t pixels = cur.get_width ();
+    const uint32_t channels = sizeof (T);
+    const uint32_t bytes = pixels * channels;
+    uint32_t *column_sum = &scratch.column_sum[0];
+    uint32_t *prefix = &scratch.prefix[0];
+
+    std::fill (scratch.column_sum.begin (), scratch.column_sum.end (), 0);
+    for (int32_t y = y_begin - radius; y <= y_begin + radius; ++y) {
+        uint16_t *square = &get_square_slot (scratch, y)[0];
+        get_square_line (cur, ref, y, dx, dy, scratch, square);
+        for (uint32_t x = 0; x < bytes; ++x)
+            column_sum[x] += square[x];
+    }
+
+    for (int32_t y = y_begin; y < y_end; ++y) {
+        if (y > y_begin) {
+            std::vector<uint16_t> &slot = get_square_slot (scratch, y + radius);
+            get_square_line (cur, ref, y + radius, dx, dy, scratch, &scratch.entering[0]);
+            update_column_sum (&scratch.entering[0], &slot[0], bytes, column_sum);
+            slot.swap (scratch.entering);
+        }
+
+        prefix[0] = 0;
+        for (uint32_t px = 0; px < pixels; ++px) {
+            uint32_t sum = column_sum[px * channels];
+            for (uint32_t c = 1; c < channels; ++c)
+                sum += column_sum[px * channels + c];
+            prefix[px + 1] = prefix[px] + sum;
+        }
+
+        get_shifted_line (ref, XCAM_CLAMP (y, 0, (int32_t)cur.get_height () - 1) + dy, dx, (T *)&scratch.ref_line[0]);
+        const uint8_t *candidate = &scratch.ref_line[0];
+        float *acc_value = &scratch.acc_value[(y - y_begin) * bytes];
+        float *acc_weight = &scratch.acc_weight[(y - y_begin) * bytes];
+        for (uint32_t px = 0; px < pixels; ++px) {
+            const uint32_t lo = XCAM_MAX ((int32_t)px - radius, 0);
+            const uint32_t hi = XCAM_MIN (px + radius + 1, pixels);
+            // wraps around on huge lines but the difference is still right
+            const uint32_t ssd = prefix[hi] - prefix[lo];
+            const uint32_t index = (uint32_t)XCAM_MIN (
+                ssd * table.index_scale, (float)(XCAM_SOFT_3D_DENOISE_WEIGHT_TABLE_SIZE - 1));
+            const float weight = table.weight[index];
+            for (uint32_t c = 0; c < channels; ++c) {
+                acc_value[px * channels + c] += weight * candidate[px * channels + c];
+                acc_weight[px * channels + c] += weight;
+            }
+        }
+    }
+}
+
+template <typename T>
+static void
+denoise_band (
+    const SoftImage<T> &cur, const std::vector<SmartPtr<SoftImage<T> > > &refs,
+    const Denoise3DWeightTable *table, int32_t y_begin, int32_t y_end,
+    Denoise3DScratch &scratch, SoftImage<T> &out)
+{
+    const uint32_t bytes = cur.get_width () * sizeof (T);
+    y_end = XCAM_MIN (y_end, (int32_t)cur.get_height ());
+    if (y_begin >= y_end)
+        return;
+
+    if (!table) {
+        if (&cur != &out) {
+            for (int32_t y = y_begin; y < y_end; ++y)
+                memcpy ((void *)out.get_buf_ptr (0, y), (const void *)cur.get_buf_ptr (0, y), bytes);
+        }
+        return;
+    }
+
+    scratch.resize (y_end - y_begin, bytes, cur.get_width ());
+
+    // pixel itself comes with weight 1
+    for (int32_t y = y_begin; y < y_end; ++y) {
+        const uint8_t *line = (const uint8_t *)cur.get_buf_ptr (0, y);
+        float *acc_value = &scratch.acc_value[(y - y_begin) * bytes];
+        float *acc_weight = &scratch.acc_weight[(y - y_begin) * bytes];
+        for (uint32_t x = 0; x < bytes; ++x) {
+            acc_value[x] = line[x];
+            acc_weight[x] = 1.0f;
+        }
+    }
+
+    const int32_t search = XCAM_SOFT_3D_DENOISE_SEARCH_RADIUS;
+    for (size_t i = 0; i <= refs.size (); ++i) {
+        const SoftImage<T> &ref = i ? *refs[i - 1].ptr () : cur;
+        for (int32_t dy = -search; dy <= search; ++dy) {
+            for (int32_t dx = -search; dx <= search; ++dx) {
+                if (!i && !dx && !dy)
+                    continue;
+                accumulate_candidate (cur, ref, dx, dy, y_begin, y_end, *table, scratch);
+            }
+        }
+    }
+
+    for (int32_t y = y_begin; y < y_end; ++y) {
+        uint8_t *line = (uint8_t *)out.get_buf_ptr (0, y);
+        const float *acc_value = &scratch.acc_value[(y - y_begin) * bytes];
+        const float *acc_weight = &scratch.acc_weight[(y - y_begin) * bytes];
+        for (uint32_t x = 0; x < bytes; ++x)
+            line[x] = (uint8_t)XCAM_MIN (acc_value[x] / acc_weight[x] + 0.5f, 255.0f);
+    }
+}
+
+XCamReturn
+Denoise3DTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<Denoise3DTask::Args> args = base.dynamic_cast_ptr<Denoise3DTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    XCAM_ASSERT (args->in_luma.ptr () && args->in_uv.ptr () && args->out_luma.ptr () && args->out_uv.ptr ());
+    XCAM_ASSERT (args->ref_luma.size () == args->ref_uv.size ());
+
+    Denoise3DScratch scratch;
+    for (uint32_t band = range.pos[1]; band < range.pos[1] + range.pos_len[1]; ++band) {
+        const int32_t uv_begin = band * XCAM_SOFT_3D_DENOISE_BAND_LINES;
+        const int32_t uv_end = uv_begin + XCAM_SOFT_3D_DENOISE_BAND_LINES;
+
+        denoise_band (
+            *args->in_luma.ptr (), args->ref_luma, args->luma_table.ptr (),
+            uv_begin * 2, uv_end * 2, scratch, *args->out_luma.ptr ());
+        denoise_band (
+            *args->in_uv.ptr (), args->ref_uv, args->uv_table.ptr (),
+            uv_begin, uv_end, scratch, *args->out_uv.ptr ());
+    }
+
+    XCAM_LOG_DEBUG (
+        "Denoise3DTask work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+}
+
+}
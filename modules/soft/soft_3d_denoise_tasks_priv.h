@@ -0,0 +1,91 @@
+/*
+ * soft_3d_denoise_tasks_priv.h - soft 3D denoise tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_3D_DENOISE_TASKS_PRIV_H
+#define XCAM_SOFT_3D_DENOISE_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_handler.h>
+#include <vector>
+
+// matching block is (2 * radius + 1) pixels square
+#define XCAM_SOFT_3D_DENOISE_BLOCK_RADIUS 2
+// candidates are displaced up to search radius in both directions
+#define XCAM_SOFT_3D_DENOISE_SEARCH_RADIUS 1
+// input uv lines of one work item
+#define XCAM_SOFT_3D_DENOISE_BAND_LINES 8
+#define XCAM_SOFT_3D_DENOISE_WEIGHT_TABLE_SIZE 1024
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+/* candidate weight by block ssd, weight[min (ssd * index_scale, size - 1)].
+ * same falloff as kernel_3d_denoise, exp (-5 / gain * ssd) over 16 normalized
+ * values, scaled to @block_values values of one block.
+ */
+struct Denoise3DWeightTable {
+    float       index_scale;
+    float       weight[XCAM_SOFT_3D_DENOISE_WEIGHT_TABLE_SIZE];
+
+    void init (float gain, uint32_t block_values);
+};
+
+/* one work item is XCAM_SOFT_3D_DENOISE_BAND_LINES uv lines and their luma lines.
+ * each output pixel is a weighted mean over candidate pixels of current frame
+ * and references displaced up to search radius, weight of a candidate comes
+ * from sum of squared differences between blocks around both pixels.
+ * block sums come from column sums kept along lines and prefix sums along
+ * each line, so cost of one candidate does not grow with block size.
+ */
+class Denoise3DTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>                    in_luma, out_luma;
+        SmartPtr<Uchar2Image>                   in_uv, out_uv;
+        std::vector<SmartPtr<UcharImage> >      ref_luma;
+        std::vector<SmartPtr<Uchar2Image> >     ref_uv;
+        SmartPtr<Denoise3DWeightTable>          luma_table;
+        SmartPtr<Denoise3DWeightTable>          uv_table;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {}
+    };
+
+public:
+    explicit Denoise3DTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("Denoise3DTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+}
+
+}
+
+#endif //XCAM_SOFT_3D_DENOISE_TASKS_PRIV_H
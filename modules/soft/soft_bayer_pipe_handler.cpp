@@ -0,0 +1,307 @@
+/*
+ * soft_bayer_pipe_handler.cpp - soft bayer pipe handler class implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_bayer_pipe_handler.h"
+#include "soft_bayer_pipe_tasks_priv.h"
+
+// display gamma used until gamma table comes
+#define BAYER_DEFAULT_GAMMA (1.0 / 2.2)
+
+namespace XCam {
+
+// full range BT.601, same as soft csc
+static const double bayer_default_rgb2yuv[XCAM_COLOR_MATRIX_SIZE] = {
+    0.299, 0.587, 0.114,
+    -0.168736, -0.331264, 0.5,
+    0.5, -0.418688, -0.081312
+};
+
+DECLARE_WORK_CALLBACK (CbBayerPipeTask, SoftBayerPipeHandler, bayer_pipe_done);
+
+SoftBayerPipeHandler::SoftBayerPipeHandler (SoftDemosaicMode mode, const char *name)
+    : SoftHandler (name)
+    , _mode (mode)
+    , _config_changed (true)
+{
+    xcam_mem_clear (_blc);
+    xcam_mem_clear (_wb);
+    xcam_mem_clear (_gamma);
+    xcam_mem_clear (_ccm);
+    xcam_mem_clear (_rgb2yuv);
+
+    _wb.r_gain = _wb.gr_gain = _wb.gb_gain = _wb.b_gain = 1.0;
+    for (uint32_t i = 0; i < XCAM_GAMMA_TABLE_SIZE; ++i)
+        _gamma.table[i] = 256.0 * pow (i / 255.0, BAYER_DEFAULT_GAMMA);
+    _ccm.matrix[0] = _ccm.matrix[4] = _ccm.matrix[8] = 1.0;
+    memcpy (_rgb2yuv.matrix, bayer_default_rgb2yuv, sizeof (_rgb2yuv.matrix));
+}
+
+SoftBayerPipeHandler::~SoftBayerPipeHandler ()
+{
+}
+
+bool
+SoftBayerPipeHandler::is_supported_format (uint32_t format)
+{
+    return XCamSoftTasks::bayer_get_pattern (format, NULL);
+}
+
+bool
+SoftBayerPipeHandler::set_blc_config (const XCam3aResultBlackLevel &blc)
+{
+    XCAM_FAIL_RETURN (
+        ERROR,
+        blc.r_level >= 0.0 && blc.r_level < 1.0 && blc.gr_level >= 0.0 && blc.gr_level < 1.0 &&
+        blc.gb_level >= 0.0 && blc.gb_level < 1.0 && blc.b_level >= 0.0 && blc.b_level < 1.0,
+        false,
+        "SoftBayerPipeHandler(%s) invalid black level, r:%.3f, gr:%.3f, gb:%.3f, b:%.3f",
+        XCAM_STR (get_name ()), blc.r_level, blc.gr_level, blc.gb_level, blc.b_level);
+
+    SmartLock locker (_config_mutex);
+    _blc = blc;
+    _config_changed = true;
+    return true;
+}
+
+bool
+SoftBayerPipeHandler::set_wb_config (const XCam3aResultWhiteBalance &wb)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, wb.r_gain > 0.0 && wb.gr_gain > 0.0 && wb.gb_gain > 0.0 && wb.b_gain > 0.0, false,
+        "SoftBayerPipeHandler(%s) invalid white balance, r:%.3f, gr:%.3f, gb:%.3f, b:%.3f",
+        XCAM_STR (get_name ()), wb.r_gain, wb.gr_gain, wb.gb_gain, wb.b_gain);
+
+    SmartLock locker (_config_mutex);
+    _wb = wb;
+    _config_changed = true;
+    return true;
+}
+
+bool
+SoftBayerPipeHandler::set_gamma_table (const XCam3aResultGammaTable &gamma)
+{
+    SmartLock locker (_config_mutex);
+    _gamma = gamma;
+    _config_changed = true;
+    return true;
+}
+
+bool
+SoftBayerPipeHandler::set_ccm (const XCam3aResultColorMatrix &ccm)
+{
+    SmartLock locker (_config_mutex);
+    _ccm = ccm;
+    _config_changed = true;
+    return true;
+}
+
+bool
+SoftBayerPipeHandler::set_rgb2yuv_matrix (const XCam3aResultColorMatrix &matrix)
+{
+    SmartLock locker (_config_mutex);
+    _rgb2yuv = matrix;
+    _config_changed = true;
+    return true;
+}
+
+XCamReturn
+SoftBayerPipeHandler::process (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in, out);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+void
+SoftBayerPipeHandler::update_table (const VideoBufferInfo &in_info)
+{
+    XCam3aResultBlackLevel blc;
+    XCam3aResultWhiteBalance wb;
+    XCam3aResultGammaTable gamma;
+    XCam3aResultColorMatrix ccm, rgb2yuv;
+    {
+        SmartLock locker (_config_mutex);
+        blc = _blc;
+        wb = _wb;
+        gamma = _gamma;
+        ccm = _ccm;
+        rgb2yuv = _rgb2yuv;
+        _config_changed = false;
+    }
+
+    SmartPtr<XCamSoftTasks::BayerPipeTable> table = new XCamSoftTasks::BayerPipeTable;
+    XCAM_ASSERT (table.ptr ());
+    table->color_bits = in_info.color_bits;
+    table->edge_aware = (_mode == SoftDemosaicEdgeAware);
+    XCamSoftTasks::bayer_get_pattern (in_info.format, table->channel);
+
+    const float max_value = (float)(1 << in_info.color_bits);
+    for (uint32_t i = 0; i < 4; ++i) {
+        double level = 0.0, gain = 1.0;
+        switch (table->channel[i]) {
+        case XCamSoftTasks::BayerChannelR:
+            level = blc.r_level;
+            gain = wb.r_gain;
+            break;
+        case XCamSoftTasks::BayerChannelB:
+            level = blc.b_level;
+            gain = wb.b_gain;
+            break;
+        default:
+            // green on red rows is gr
+            const bool red_row = (table->channel[(i & 2) + ((i & 1) ^ 1)] == XCamSoftTasks::BayerChannelR);
+            level = red_row ? blc.gr_level : blc.gb_level;
+            gain = red_row ? wb.gr_gain : wb.gb_gain;
+            break;
+        }
+        table->scale[i] = (float)gain / max_value;
+        table->offset[i] = (float)(-level * gain);
+    }
+
+    for (uint32_t i = 0; i < XCAM_COLOR_MATRIX_SIZE; ++i) {
+        table->ccm[i] = (float)ccm.matrix[i];
+        table->rgb2yuv[i] = (float)rgb2yuv.matrix[i];
+    }
+
+    for (uint32_t i = 0; i < XCAM_SOFT_BAYER_GAMMA_LUT_SIZE; ++i) {
+        const double pos = i * (XCAM_GAMMA_TABLE_SIZE - 1.0) / (XCAM_SOFT_BAYER_GAMMA_LUT_SIZE - 1);
+        const uint32_t i0 = XCAM_MIN ((uint32_t)pos, XCAM_GAMMA_TABLE_SIZE - 2);
+        const double value = gamma.table[i0] + (gamma.table[i0 + 1] - gamma.table[i0]) * (pos - i0);
+        table->gamma[i] = (float)XCAM_CLAMP (value * 255.0 / 256.0, 0.0, 255.0);
+    }
+
+    _table = table;
+}
+
+XCamReturn
+SoftBayerPipeHandler::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        ERROR, is_supported_format (in_info.format), XCAM_RETURN_ERROR_PARAM,
+        "SoftBayerPipeHandler(%s) only support bayer formats but input format is %s",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (in_info.format));
+
+    XCAM_FAIL_RETURN (
+        ERROR,
+        !(in_info.width % 2) && !(in_info.height % 2) &&
+        in_info.width >= XCAM_SOFT_BAYER_TILE_BORDER * 2 && in_info.height >= XCAM_SOFT_BAYER_TILE_BORDER * 2,
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftBayerPipeHandler(%s) input size(%dx%d) need be even and no less than %d",
+        XCAM_STR (get_name ()), in_info.width, in_info.height, XCAM_SOFT_BAYER_TILE_BORDER * 2);
+
+    VideoBufferInfo out_info;
+    out_info.init (
+        V4L2_PIX_FMT_NV12, in_info.width, in_info.height,
+        XCAM_ALIGN_UP (in_info.width, 16), XCAM_ALIGN_UP (in_info.height, 16));
+    set_out_video_info (out_info);
+
+    XCAM_ASSERT (!_bayer_task.ptr ());
+    _bayer_task = new XCamSoftTasks::BayerPipeTask (new CbBayerPipeTask (this));
+    XCAM_ASSERT (_bayer_task.ptr ());
+    share_threads (_bayer_task);
+
+    // bands of tile rows, one band keeps its tiles in cache of one thread
+    uint32_t thread_x = 1, thread_y = 8;
+    WorkSize global_size (
+        xcam_ceil (in_info.width, XCAM_SOFT_BAYER_TILE_WIDTH) / XCAM_SOFT_BAYER_TILE_WIDTH,
+        xcam_ceil (in_info.height, XCAM_SOFT_BAYER_TILE_HEIGHT) / XCAM_SOFT_BAYER_TILE_HEIGHT);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    _bayer_task->set_local_size (local_size);
+    _bayer_task->set_global_size (global_size);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftBayerPipeHandler::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_bayer_task.ptr ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    bool changed;
+    {
+        SmartLock locker (_config_mutex);
+        changed = _config_changed;
+    }
+    if (changed || !_table.ptr ())
+        update_table (param->in_buf->get_video_info ());
+
+    SmartPtr<XCamSoftTasks::BayerPipeTask::Args> args = new XCamSoftTasks::BayerPipeTask::Args (param);
+    args->in_buf = param->in_buf;
+    args->out_luma = new UcharImage (param->out_buf, 0);
+    args->out_uv = new Uchar2Image (param->out_buf, 1);
+    args->table = _table;
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = _bayer_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftBayerPipeHandler(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+void
+SoftBayerPipeHandler::bayer_pipe_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _bayer_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    work_well_done (param, error);
+}
+
+XCamReturn
+SoftBayerPipeHandler::terminate ()
+{
+    if (_bayer_task.ptr ()) {
+        _bayer_task->stop ();
+        _bayer_task.release ();
+    }
+
+    return SoftHandler::terminate ();
+}
+
+SmartPtr<SoftHandler>
+create_soft_bayer_pipe_handler (SoftDemosaicMode mode)
+{
+    SmartPtr<SoftBayerPipeHandler> bayer = new SoftBayerPipeHandler (mode);
+    XCAM_ASSERT (bayer.ptr ());
+
+    return bayer;
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+ * soft_bayer_pipe_handler.h - soft bayer pipe handler class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_BAYER_PIPE_HANDLER_H
+#define XCAM_SOFT_BAYER_PIPE_HANDLER_H
+
+#include <xcam_std.h>
+#include <base/xcam_3a_result.h>
+#include <soft/soft_handler.h>
+
+namespace XCam {
+
+class SoftWorker;
+
+namespace XCamSoftTasks {
+struct BayerPipeTable;
+};
+
+enum SoftDemosaicMode {
+    SoftDemosaicBilinear = 0,
+    // green along smaller gradient, red and blue from color difference to green
+    SoftDemosaicEdgeAware,
+};
+
+/* CPU counterpart of CLBayerBasicImageHandler and the rgb/yuv pipes after it.
+ * 8/10/12/16 bit bayer in any order to NV12 of same size in one pass over tiles:
+ * black level, white balance, demosaic, color correction, gamma and rgb to yuv.
+ * black level and gamma follow kernel_bayer_basic, levels are in [0, 1] of full
+ * scale and gamma table maps [0, 255] to [0, 256), 1/2.2 power curve is used
+ * until a gamma table is set. all configs are thread safe and take effect from next frame.
+ */
+class SoftBayerPipeHandler
+    : public SoftHandler
+{
+public:
+    explicit SoftBayerPipeHandler (
+        SoftDemosaicMode mode = SoftDemosaicEdgeAware, const char *name = "SoftBayerPipeHandler");
+    ~SoftBayerPipeHandler ();
+
+    static bool is_supported_format (uint32_t format);
+
+    bool set_blc_config (const XCam3aResultBlackLevel &blc);
+    bool set_wb_config (const XCam3aResultWhiteBalance &wb);
+    bool set_gamma_table (const XCam3aResultGammaTable &gamma);
+    // camera rgb to linear output rgb
+    bool set_ccm (const XCam3aResultColorMatrix &ccm);
+    // same as CLCscImageHandler, uv offset added by handler
+    bool set_rgb2yuv_matrix (const XCam3aResultColorMatrix &matrix);
+
+    XCamReturn process (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+
+    void bayer_pipe_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    void update_table (const VideoBufferInfo &in_info);
+
+    XCAM_DEAD_COPY (SoftBayerPipeHandler);
+
+private:
+    SmartPtr<SoftWorker>                        _bayer_task;
+    SmartPtr<XCamSoftTasks::BayerPipeTable>     _table;
+    SoftDemosaicMode                            _mode;
+
+    Mutex                                       _config_mutex;
+    XCam3aResultBlackLevel                      _blc;
+    XCam3aResultWhiteBalance                    _wb;
+    XCam3aResultGammaTable                      _gamma;
+    XCam3aResultColorMatrix                     _ccm;
+    XCam3aResultColorMatrix                     _rgb2yuv;
+    bool                                        _config_changed;
+};
+
+extern SmartPtr<SoftHandler> create_soft_bayer_pipe_handler (SoftDemosaicMode mode = SoftDemosaicEdgeAware);
+
+}
+
+#endif //XCAM_SOFT_BAYER_PIPE_HANDLER_H
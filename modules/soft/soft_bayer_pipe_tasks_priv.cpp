@@ -0,0 +1,599 @@
+/*
+ * soft_bayer_pipe_tasks_priv.cpp - soft bayer pipe tasks private implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_bayer_pipe_tasks_priv.h"
+#include <vector>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+#define BAYER_RAW_PITCH (XCAM_SOFT_BAYER_TILE_WIDTH + XCAM_SOFT_BAYER_TILE_BORDER * 2)
+#define BAYER_RAW_ROWS (XCAM_SOFT_BAYER_TILE_HEIGHT + XCAM_SOFT_BAYER_TILE_BORDER * 2)
+
+BayerPipeTable::BayerPipeTable ()
+    : color_bits (8)
+    , edge_aware (true)
+{
+    for (uint32_t i = 0; i < 4; ++i) {
+        channel[i] = BayerChannelG;
+        scale[i] = 1.0f;
+        offset[i] = 0.0f;
+    }
+    xcam_mem_clear (ccm);
+    xcam_mem_clear (rgb2yuv);
+    xcam_mem_clear (gamma);
+}
+
+bool
+bayer_get_pattern (uint32_t format, BayerChannel channel[4])
+{
+    static const BayerChannel grbg[4] = {BayerChannelG, BayerChannelR, BayerChannelB, BayerChannelG};
+    static const BayerChannel rggb[4] = {BayerChannelR, BayerChannelG, BayerChannelG, BayerChannelB};
+    static const BayerChannel bggr[4] = {BayerChannelB, BayerChannelG, BayerChannelG, BayerChannelR};
+    static const BayerChannel gbrg[4] = {BayerChannelG, BayerChannelB, BayerChannelR, BayerChannelG};
+
+    const BayerChannel *pattern = NULL;
+    switch (format) {
+    case V4L2_PIX_FMT_SGRBG8:
+    case V4L2_PIX_FMT_SGRBG10:
+    case V4L2_PIX_FMT_SGRBG12:
+    case XCAM_PIX_FMT_SGRBG16:
+        pattern = grbg;
+        break;
+    case V4L2_PIX_FMT_SRGGB8:
+    case V4L2_PIX_FMT_SRGGB10:
+    case V4L2_PIX_FMT_SRGGB12:
+        pattern = rggb;
+        break;
+    case V4L2_PIX_FMT_SBGGR8:
+    case V4L2_PIX_FMT_SBGGR10:
+    case V4L2_PIX_FMT_SBGGR12:
+    case V4L2_PIX_FMT_SBGGR16:
+        pattern = bggr;
+        break;
+    case V4L2_PIX_FMT_SGBRG8:
+    case V4L2_PIX_FMT_SGBRG10:
+    case V4L2_PIX_FMT_SGBRG12:
+        pattern = gbrg;
+        break;
+    default:
+        return false;
+    }
+
+    if (channel)
+        memcpy (channel, pattern, sizeof (BayerChannel) * 4);
+    return true;
+}
+
+// one tile of every stage, owned by one thread for all its tiles
+struct BayerTileScratch {
+    // normalized raw and green, both with border
+    std::vector<float>      raw;
+    std::vector<float>      green;
+    // tile pixels
+    std::vector<float>      rgb[3];
+    std::vector<int32_t>    index[3];
+
+    BayerTileScratch ()
+        : raw (BAYER_RAW_PITCH * BAYER_RAW_ROWS, 0.0f)
+        , green (BAYER_RAW_PITCH * BAYER_RAW_ROWS, 0.0f)
+    {
+        for (uint32_t i = 0; i < 3; ++i) {
+            rgb[i].resize (XCAM_SOFT_BAYER_TILE_WIDTH * XCAM_SOFT_BAYER_TILE_HEIGHT);
+            index[i].resize (XCAM_SOFT_BAYER_TILE_WIDTH);
+        }
+    }
+};
+
+// mirror without repeating edge pixel keeps bayer phase
+static inline int32_t
+reflect_pos (int32_t pos, int32_t size)
+{
+    if (pos < 0)
+        return -pos;
+    if (pos >= size)
+        return 2 * (size - 1) - pos;
+    return pos;
+}
+
+static inline float
+normalize_raw (uint32_t raw, float scale, float offset)
+{
+    return XCAM_CLAMP (raw * scale + offset, 0.0f, 1.0f);
+}
+
+// normalize @count pixels from even position @src, coefficients alternate
+template <typename T>
+static void
+normalize_span (const T *src, uint32_t count, const float *scale, const float *offset, float *dst)
+{
+    uint32_t x = 0;
+#if defined (__SSE2__)
+    const __m128 s = _mm_setr_ps (scale[0], scale[1], scale[0], scale[1]);
+    const __m128 o = _mm_setr_ps (offset[0], offset[1], offset[0], offset[1]);
+    const __m128 zero = _mm_setzero_ps ();
+    const __m128 one = _mm_set1_ps (1.0f);
+    const __m128i izero = _mm_setzero_si128 ();
+
+    for (; x + 8 <= count; x += 8) {
+        __m128i v16;
+        if (sizeof (T) == 1)
+            v16 = _mm_unpacklo_epi8 (_mm_loadl_epi64 ((const __m128i *)(src + x)), izero);
+        else
+            v16 = _mm_loadu_si128 ((const __m128i *)(src + x));
+
+        __m128 lo = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (v16, izero));
+        __m128 hi = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (v16, izero));
+        lo = _mm_min_ps (_mm_max_ps (_mm_add_ps (_mm_mul_ps (lo, s), o), zero), one);
+        hi = _mm_min_ps (_mm_max_ps (_mm_add_ps (_mm_mul_ps (hi, s), o), zero), one);
+        _mm_storeu_ps (dst + x, lo);
+        _mm_storeu_ps (dst + x + 4, hi);
+    }
+#endif
+
+    for (; x < count; ++x)
+        dst[x] = normalize_raw (src[x], scale[x % 2], offset[x % 2]);
+}
+
+template <typename T>
+static void
+load_raw_tile (
+    const uint8_t *in, const VideoBufferInfo &info, const BayerPipeTable &table,
+    int32_t x0, int32_t y0, uint32_t tile_w, uint32_t tile_h, float *raw)
+{
+    const int32_t border = XCAM_SOFT_BAYER_TILE_BORDER;
+    const int32_t width = info.width;
+    const int32_t height = info.height;
+    const int32_t begin = x0 - border;
+    const int32_t end = x0 + (int32_t)tile_w + border;
+    const int32_t span_begin = XCAM_MAX (begin, 0);
+    const int32_t span_end = XCAM_MIN (end, width);
+
+    for (int32_t ry = 0; ry < (int32_t)tile_h + 2 * border; ++ry) {
+        const int32_t y = reflect_pos (y0 - border + ry, height);
+        const T *src = (const T *)(in + info.offsets[0] + y * info.strides[0]);
+        // image and raw tile have same phase on both axes
+        const uint32_t phase = (y % 2) * 2;
+        const float *scale = table.scale + phase;
+        const float *offset = table.offset + phase;
+        float *dst = raw + ry * BAYER_RAW_PITCH;
+
+        normalize_span (src + span_begin, span_end - span_begin, scale, offset, dst + span_begin - begin);
+        for (int32_t x = begin; x < span_begin; ++x)
+            dst[x - begin] = normalize_raw (src[reflect_pos (x, width)], scale[x & 1], offset[x & 1]);
+        for (int32_t x = span_end; x < end; ++x)
+            dst[x - begin] = normalize_raw (src[reflect_pos (x, width)], scale[x & 1], offset[x & 1]);
+    }
+}
+
+// green on R/B pixel at @x, rows are centered at the pixel
+template <bool EDGE>
+static inline float
+interp_green (const float *r, const float *up1, const float *dn1, const float *up2, const float *dn2, int32_t x)
+{
+    if (!EDGE)
+        return (r[x - 1] + r[x + 1] + up1[x] + dn1[x]) * 0.25f;
+
+    const float lap_h = 2.0f * r[x] - r[x - 2] - r[x + 2];
+    const float lap_v = 2.0f * r[x] - up2[x] - dn2[x];
+    const float grad_h = fabsf (r[x - 1] - r[x + 1]) + fabsf (lap_h);
+    const float grad_v = fabsf (up1[x] - dn1[x]) + fabsf (lap_v);
+    const float gh = (r[x - 1] + r[x + 1]) * 0.5f + lap_h * 0.25f;
+    const float gv = (up1[x] + dn1[x]) * 0.5f + lap_v * 0.25f;
+
+    float g = (gh + gv) * 0.5f;
+    if (grad_h < grad_v)
+        g = gh;
+    else if (grad_v < grad_h)
+        g = gv;
+    return XCAM_CLAMP (g, 0.0f, 1.0f);
+}
+
+#if defined (__SSE2__)
+static inline __m128
+select_ps (__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps (_mm_and_ps (mask, a), _mm_andnot_ps (mask, b));
+}
+
+static inline __m128
+abs_ps (__m128 v)
+{
+    return _mm_andnot_ps (_mm_set1_ps (-0.0f), v);
+}
+
+template <bool EDGE>
+static inline __m128
+interp_green_sse2 (const float *r, const float *up1, const float *dn1, const float *up2, const float *dn2, int32_t x)
+{
+    const __m128 quarter = _mm_set1_ps (0.25f);
+    const __m128 left = _mm_loadu_ps (r + x - 1);
+    const __m128 right = _mm_loadu_ps (r + x + 1);
+    const __m128 up = _mm_loadu_ps (up1 + x);
+    const __m128 down = _mm_loadu_ps (dn1 + x);
+
+    if (!EDGE)
+        return _mm_mul_ps (_mm_add_ps (_mm_add_ps (_mm_add_ps (left, right), up), down), quarter);
+
+    const __m128 half = _mm_set1_ps (0.5f);
+    const __m128 c2 = _mm_mul_ps (_mm_loadu_ps (r + x), _mm_set1_ps (2.0f));
+    const __m128 lap_h = _mm_sub_ps (_mm_sub_ps (c2, _mm_loadu_ps (r + x - 2)), _mm_loadu_ps (r + x + 2));
+    const __m128 lap_v = _mm_sub_ps (_mm_sub_ps (c2, _mm_loadu_ps (up2 + x)), _mm_loadu_ps (dn2 + x));
+    const __m128 grad_h = _mm_add_ps (abs_ps (_mm_sub_ps (left, right)), abs_ps (lap_h));
+    const __m128 grad_v = _mm_add_ps (abs_ps (_mm_sub_ps (up, down)), abs_ps (lap_v));
+    const __m128 gh = _mm_add_ps (_mm_mul_ps (_mm_add_ps (left, right), half), _mm_mul_ps (lap_h, quarter));
+    const __m128 gv = _mm_add_ps (_mm_mul_ps (_mm_add_ps (up, down), half), _mm_mul_ps (lap_v, quarter));
+
+    __m128 g = _mm_mul_ps (_mm_add_ps (gh, gv), half);
+    g = select_ps (_mm_cmplt_ps (grad_h, grad_v), gh, g);
+    g = select_ps (_mm_cmplt_ps (grad_v, grad_h), gv, g);
+    return _mm_min_ps (_mm_max_ps (g, _mm_setzero_ps ()), _mm_set1_ps (1.0f));
+}
+#endif
+
+// green of tile with one pixel ring, at same positions as raw
+template <bool EDGE>
+static void
+demosaic_green (const BayerPipeTable &table, uint32_t tile_w, uint32_t tile_h, const float *raw, float *green)
+{
+    const int32_t begin = XCAM_SOFT_BAYER_TILE_BORDER - 1;
+    const int32_t end_x = XCAM_SOFT_BAYER_TILE_BORDER + tile_w + 1;
+    const int32_t end_y = XCAM_SOFT_BAYER_TILE_BORDER + tile_h + 1;
+
+    for (int32_t ry = begin; ry < end_y; ++ry) {
+        const float *r = raw + ry * BAYER_RAW_PITCH;
+        const float *up1 = r - BAYER_RAW_PITCH, *dn1 = r + BAYER_RAW_PITCH;
+        const float *up2 = up1 - BAYER_RAW_PITCH, *dn2 = dn1 + BAYER_RAW_PITCH;
+        float *g = green + ry * BAYER_RAW_PITCH;
+        const BayerChannel *row = table.channel + (ry % 2) * 2;
+
+        int32_t x = begin;
+#if defined (__SSE2__)
+        // begin is odd, lanes hold phase 1 0 1 0
+        const __m128 is_green = _mm_castsi128_ps (_mm_setr_epi32 (
+                                    row[1] == BayerChannelG ? -1 : 0, row[0] == BayerChannelG ? -1 : 0,
+                                    row[1] == BayerChannelG ? -1 : 0, row[0] == BayerChannelG ? -1 : 0));
+        for (; x + 4 <= end_x; x += 4) {
+            const __m128 value = interp_green_sse2<EDGE> (r, up1, dn1, up2, dn2, x);
+            _mm_storeu_ps (g + x, select_ps (is_green, _mm_loadu_ps (r + x), value));
+        }
+#endif
+        for (; x < end_x; ++x)
+            g[x] = (row[x % 2] == BayerChannelG) ? r[x] : interp_green<EDGE> (r, up1, dn1, up2, dn2, x);
+    }
+}
+
+/* red and blue of tile pixels. edge aware interpolates color differences to
+ * green, bilinear interpolates colors themselves.
+ * diag: average of 4 diagonal neighbors, horz/vert: of 2 neighbors.
+ */
+template <bool EDGE>
+static inline void
+interp_rb (
+    const float *r, const float *g, int32_t x,
+    float &diag, float &horz, float &vert)
+{
+    const int32_t p = BAYER_RAW_PITCH;
+    if (EDGE) {
+        diag = ((r[x - p - 1] - g[x - p - 1]) + (r[x - p + 1] - g[x - p + 1]) +
+                (r[x + p - 1] - g[x + p - 1]) + (r[x + p + 1] - g[x + p + 1])) * 0.25f + g[x];
+        horz = ((r[x - 1] - g[x - 1]) + (r[x + 1] - g[x + 1])) * 0.5f + g[x];
+        vert = ((r[x - p] - g[x - p]) + (r[x + p] - g[x + p])) * 0.5f + g[x];
+    } else {
+        diag = ((r[x - p - 1] + r[x - p + 1]) + (r[x + p - 1] + r[x + p + 1])) * 0.25f;
+        horz = (r[x - 1] + r[x + 1]) * 0.5f;
+        vert = (r[x - p] + r[x + p]) * 0.5f;
+    }
+}
+
+#if defined (__SSE2__)
+template <bool EDGE>
+static inline void
+interp_rb_sse2 (
+    const float *r, const float *g, int32_t x,
+    __m128 &diag, __m128 &horz, __m128 &vert)
+{
+    const int32_t p = BAYER_RAW_PITCH;
+    const __m128 quarter = _mm_set1_ps (0.25f);
+    const __m128 half = _mm_set1_ps (0.5f);
+
+    if (EDGE) {
+        const __m128 c = _mm_loadu_ps (g + x);
+#define COLOR_DIFF(pos) _mm_sub_ps (_mm_loadu_ps (r + (pos)), _mm_loadu_ps (g + (pos)))
+        diag = _mm_add_ps (
+                   _mm_mul_ps (
+                       _mm_add_ps (
+                           _mm_add_ps (_mm_add_ps (COLOR_DIFF (x - p - 1), COLOR_DIFF (x - p + 1)), COLOR_DIFF (x + p - 1)),
+                           COLOR_DIFF (x + p + 1)),
+                       quarter),
+                   c);
+        horz = _mm_add_ps (_mm_mul_ps (_mm_add_ps (COLOR_DIFF (x - 1), COLOR_DIFF (x + 1)), half), c);
+        vert = _mm_add_ps (_mm_mul_ps (_mm_add_ps (COLOR_DIFF (x - p), COLOR_DIFF (x + p)), half), c);
+#undef COLOR_DIFF
+    } else {
+        diag = _mm_mul_ps (
+                   _mm_add_ps (
+                       _mm_add_ps (_mm_loadu_ps (r + x - p - 1), _mm_loadu_ps (r + x - p + 1)),
+                       _mm_add_ps (_mm_loadu_ps (r + x + p - 1), _mm_loadu_ps (r + x + p + 1))),
+                   quarter);
+        horz = _mm_mul_ps (_mm_add_ps (_mm_loadu_ps (r + x - 1), _mm_loadu_ps (r + x + 1)), half);
+        vert = _mm_mul_ps (_mm_add_ps (_mm_loadu_ps (r + x - p), _mm_loadu_ps (r + x + p)), half);
+    }
+}
+#endif
+
+template <bool EDGE>
+static void
+demosaic_rb (
+    const BayerPipeTable &table, uint32_t tile_w, uint32_t tile_h,
+    const float *raw, const float *green, float *red, float *blue, float *out_green)
+{
+    const int32_t border = XCAM_SOFT_BAYER_TILE_BORDER;
+
+    for (uint32_t y = 0; y < tile_h; ++y) {
+        const int32_t offset = (y + border) * BAYER_RAW_PITCH + border;
+        const float *r = raw + offset;
+        const float *g = green + offset;
+        const BayerChannel *row = table.channel + (y % 2) * 2;
+        // channel of the non-green pixel on this row, the other one is on next rows
+        const BayerChannel own = (row[0] == BayerChannelG) ? row[1] : row[0];
+        const uint32_t color_phase = (row[0] == BayerChannelG) ? 1 : 0;
+        float *own_out = (own == BayerChannelR ? red : blue) + y * XCAM_SOFT_BAYER_TILE_WIDTH;
+        float *other_out = (own == BayerChannelR ? blue : red) + y * XCAM_SOFT_BAYER_TILE_WIDTH;
+        float *g_out = out_green + y * XCAM_SOFT_BAYER_TILE_WIDTH;
+
+        /* own color pixel: own is raw, other is diagonal.
+         * green pixel: own is horizontal, other is vertical.
+         */
+        int32_t x = 0;
+#if defined (__SSE2__)
+        const __m128 is_color = _mm_castsi128_ps (_mm_setr_epi32 (
+                                    color_phase == 0 ? -1 : 0, color_phase == 1 ? -1 : 0,
+                                    color_phase == 0 ? -1 : 0, color_phase == 1 ? -1 : 0));
+        for (; x + 4 <= (int32_t)tile_w; x += 4) {
+            __m128 diag, horz, vert;
+            interp_rb_sse2<EDGE> (r, g, x, diag, horz, vert);
+            _mm_storeu_ps (own_out + x, select_ps (is_color, _mm_loadu_ps (r + x), horz));
+            _mm_storeu_ps (other_out + x, select_ps (is_color, diag, vert));
+            _mm_storeu_ps (g_out + x, _mm_loadu_ps (g + x));
+        }
+#endif
+        for (; x < (int32_t)tile_w; ++x) {
+            float diag, horz, vert;
+            interp_rb<EDGE> (r, g, x, diag, horz, vert);
+            const bool is_color = ((uint32_t)x % 2 == color_phase);
+            own_out[x] = is_color ? r[x] : horz;
+            other_out[x] = is_color ? diag : vert;
+            g_out[x] = g[x];
+        }
+    }
+}
+
+// color correction and gamma of one tile line, in place
+static void
+correct_line (const BayerPipeTable &table, uint32_t count, float *rgb[3], int32_t *index[3])
+{
+    const float *m = table.ccm;
+    const float lut_scale = XCAM_SOFT_BAYER_GAMMA_LUT_SIZE - 1;
+
+    uint32_t x = 0;
+#if defined (__SSE2__)
+    const __m128 zero = _mm_setzero_ps ();
+    const __m128 one = _mm_set1_ps (1.0f);
+    const __m128 scale = _mm_set1_ps (lut_scale);
+    const __m128 half = _mm_set1_ps (0.5f);
+    for (; x + 4 <= count; x += 4) {
+        const __m128 r = _mm_loadu_ps (rgb[0] + x);
+        const __m128 g = _mm_loadu_ps (rgb[1] + x);
+        const __m128 b = _mm_loadu_ps (rgb[2] + x);
+        for (uint32_t c = 0; c < 3; ++c) {
+            __m128 v = _mm_add_ps (
+                           _mm_add_ps (_mm_mul_ps (_mm_set1_ps (m[c * 3]), r), _mm_mul_ps (_mm_set1_ps (m[c * 3 + 1]), g)),
+                           _mm_mul_ps (_mm_set1_ps (m[c * 3 + 2]), b));
+            v = _mm_min_ps (_mm_max_ps (v, zero), one);
+            _mm_storeu_si128 ((__m128i *)(index[c] + x), _mm_cvttps_epi32 (_mm_add_ps (_mm_mul_ps (v, scale), half)));
+        }
+    }
+#endif
+    for (; x < count; ++x) {
+        const float r = rgb[0][x], g = rgb[1][x], b = rgb[2][x];
+        for (uint32_t c = 0; c < 3; ++c) {
+            float v = m[c * 3] * r + m[c * 3 + 1] * g + m[c * 3 + 2] * b;
+            v = XCAM_CLAMP (v, 0.0f, 1.0f);
+            index[c][x] = (int32_t)(v * lut_scale + 0.5f);
+        }
+    }
+
+    // no gather before avx2, table is small enough to stay in cache
+    for (uint32_t c = 0; c < 3; ++c) {
+        float *dst = rgb[c];
+        const int32_t *idx = index[c];
+        for (x = 0; x < count; ++x)
+            dst[x] = table.gamma[idx[x]];
+    }
+}
+
+static inline uint8_t
+to_uchar (float v)
+{
+    return (uint8_t)(XCAM_CLAMP (v, 0.0f, 255.0f) + 0.5f);
+}
+
+// two tile lines of gamma corrected rgb to NV12, uv from average of 2x2
+static void
+write_nv12_lines (
+    const BayerPipeTable &table, uint32_t count,
+    const float *line0[3], const float *line1[3], uint8_t *y0, uint8_t *y1, uint8_t *uv)
+{
+    const float *m = table.rgb2yuv;
+
+    uint32_t x = 0;
+#if defined (__SSE2__)
+    const __m128 zero = _mm_setzero_ps ();
+    const __m128 max = _mm_set1_ps (255.0f);
+    const __m128 half = _mm_set1_ps (0.5f);
+    const __m128 quarter = _mm_set1_ps (0.25f);
+    const __m128 uv_offset = _mm_set1_ps (128.0f);
+    for (; x + 8 <= count; x += 8) {
+        __m128 sum[3];
+        const float **lines[2] = {line0, line1};
+        uint8_t *y_out[2] = {y0, y1};
+        for (uint32_t i = 0; i < 2; ++i) {
+            __m128i luma[2];
+            for (uint32_t k = 0; k < 2; ++k) {
+                const __m128 r = _mm_loadu_ps (lines[i][0] + x + k * 4);
+                const __m128 g = _mm_loadu_ps (lines[i][1] + x + k * 4);
+                const __m128 b = _mm_loadu_ps (lines[i][2] + x + k * 4);
+                __m128 v = _mm_add_ps (
+                               _mm_add_ps (_mm_mul_ps (_mm_set1_ps (m[0]), r), _mm_mul_ps (_mm_set1_ps (m[1]), g)),
+                               _mm_mul_ps (_mm_set1_ps (m[2]), b));
+                v = _mm_add_ps (_mm_min_ps (_mm_max_ps (v, zero), max), half);
+                luma[k] = _mm_cvttps_epi32 (v);
+            }
+            const __m128i packed = _mm_packs_epi32 (luma[0], luma[1]);
+            _mm_storel_epi64 ((__m128i *)(y_out[i] + x), _mm_packus_epi16 (packed, packed));
+        }
+
+        // pixel pairs of both lines, 8 pixels to 4 uv
+        for (uint32_t c = 0; c < 3; ++c) {
+            const __m128 a = _mm_add_ps (_mm_loadu_ps (line0[c] + x), _mm_loadu_ps (line1[c] + x));
+            const __m128 b = _mm_add_ps (_mm_loadu_ps (line0[c] + x + 4), _mm_loadu_ps (line1[c] + x + 4));
+            sum[c] = _mm_mul_ps (
+                         _mm_add_ps (
+                             _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)),
+                             _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1))),
+                         quarter);
+        }
+        __m128i chroma[2];
+        for (uint32_t k = 0; k < 2; ++k) {
+            const float *row = m + (k + 1) * 3;
+            __m128 v = _mm_add_ps (
+                           _mm_add_ps (_mm_mul_ps (_mm_set1_ps (row[0]), sum[0]), _mm_mul_ps (_mm_set1_ps (row[1]), sum[1])),
+                           _mm_mul_ps (_mm_set1_ps (row[2]), sum[2]));
+            v = _mm_add_ps (_mm_min_ps (_mm_max_ps (_mm_add_ps (v, uv_offset), zero), max), half);
+            chroma[k] = _mm_cvttps_epi32 (v);
+        }
+        const __m128i packed = _mm_packs_epi32 (
+                                   _mm_unpacklo_epi32 (chroma[0], chroma[1]), _mm_unpackhi_epi32 (chroma[0], chroma[1]));
+        _mm_storel_epi64 ((__m128i *)(uv + x), _mm_packus_epi16 (packed, packed));
+    }
+#endif
+
+    for (; x < count; x += 2) {
+        float sum[3];
+        for (uint32_t c = 0; c < 3; ++c)
+            sum[c] = ((line0[c][x] + line1[c][x]) + (line0[c][x + 1] + line1[c][x + 1])) * 0.25f;
+
+        for (uint32_t k = 0; k < 2; ++k) {
+            y0[x + k] = to_uchar (m[0] * line0[0][x + k] + m[1] * line0[1][x + k] + m[2] * line0[2][x + k]);
+            y1[x + k] = to_uchar (m[0] * line1[0][x + k] + m[1] * line1[1][x + k] + m[2] * line1[2][x + k]);
+            const float *row = m + (k + 1) * 3;
+            uv[x + k] = to_uchar (row[0] * sum[0] + row[1] * sum[1] + row[2] * sum[2] + 128.0f);
+        }
+    }
+}
+
+template <typename T>
+static void
+process_tile (
+    const uint8_t *in, const VideoBufferInfo &info, const BayerPipeTable &table,
+    uint32_t x0, uint32_t y0, UcharImage *out_luma, Uchar2Image *out_uv, BayerTileScratch &scratch)
+{
+    const uint32_t tile_w = XCAM_MIN (XCAM_SOFT_BAYER_TILE_WIDTH, info.width - x0);
+    const uint32_t tile_h = XCAM_MIN (XCAM_SOFT_BAYER_TILE_HEIGHT, info.height - y0);
+    const uint32_t tile_pitch = XCAM_SOFT_BAYER_TILE_WIDTH;
+
+    load_raw_tile<T> (in, info, table, x0, y0, tile_w, tile_h, &scratch.raw[0]);
+
+    float *rgb[3] = {&scratch.rgb[0][0], &scratch.rgb[1][0], &scratch.rgb[2][0]};
+    if (table.edge_aware) {
+        demosaic_green<true> (table, tile_w, tile_h, &scratch.raw[0], &scratch.green[0]);
+        demosaic_rb<true> (table, tile_w, tile_h, &scratch.raw[0], &scratch.green[0], rgb[0], rgb[2], rgb[1]);
+    } else {
+        demosaic_green<false> (table, tile_w, tile_h, &scratch.raw[0], &scratch.green[0]);
+        demosaic_rb<false> (table, tile_w, tile_h, &scratch.raw[0], &scratch.green[0], rgb[0], rgb[2], rgb[1]);
+    }
+
+    int32_t *index[3] = {&scratch.index[0][0], &scratch.index[1][0], &scratch.index[2][0]};
+    for (uint32_t y = 0; y < tile_h; ++y) {
+        float *line[3] = {rgb[0] + y * tile_pitch, rgb[1] + y * tile_pitch, rgb[2] + y * tile_pitch};
+        correct_line (table, tile_w, line, index);
+    }
+
+    for (uint32_t y = 0; y < tile_h; y += 2) {
+        const float *line0[3] = {rgb[0] + y * tile_pitch, rgb[1] + y * tile_pitch, rgb[2] + y * tile_pitch};
+        const float *line1[3] = {line0[0] + tile_pitch, line0[1] + tile_pitch, line0[2] + tile_pitch};
+        write_nv12_lines (
+            table, tile_w, line0, line1,
+            out_luma->get_buf_ptr (x0, y0 + y), out_luma->get_buf_ptr (x0, y0 + y + 1),
+            (uint8_t *)out_uv->get_buf_ptr (x0 / 2, (y0 + y) / 2));
+    }
+}
+
+XCamReturn
+BayerPipeTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<BayerPipeTask::Args> args = base.dynamic_cast_ptr<BayerPipeTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    XCAM_ASSERT (args->in_buf.ptr () && args->table.ptr ());
+    UcharImage *out_luma = args->out_luma.ptr ();
+    Uchar2Image *out_uv = args->out_uv.ptr ();
+    XCAM_ASSERT (out_luma && out_uv);
+
+    const VideoBufferInfo &info = args->in_buf->get_video_info ();
+    const BayerPipeTable &table = *args->table.ptr ();
+    const uint8_t *in = args->in_buf->map ();
+    XCAM_FAIL_RETURN (
+        ERROR, in, XCAM_RETURN_ERROR_MEM,
+        "BayerPipeTask map input buffer failed");
+
+    BayerTileScratch scratch;
+    for (uint32_t ty = range.pos[1]; ty < range.pos[1] + range.pos_len[1]; ++ty) {
+        const uint32_t y0 = ty * XCAM_SOFT_BAYER_TILE_HEIGHT;
+        if (y0 >= info.height)
+            break;
+        for (uint32_t tx = range.pos[0]; tx < range.pos[0] + range.pos_len[0]; ++tx) {
+            const uint32_t x0 = tx * XCAM_SOFT_BAYER_TILE_WIDTH;
+            if (x0 >= info.width)
+                break;
+            if (table.color_bits > 8)
+                process_tile<uint16_t> (in, info, table, x0, y0, out_luma, out_uv, scratch);
+            else
+                process_tile<uint8_t> (in, info, table, x0, y0, out_luma, out_uv, scratch);
+        }
+    }
+
+    args->in_buf->unmap ();
+
+    XCAM_LOG_DEBUG (
+        "BayerPipeTask work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+}
+
+}
@@ -0,0 +1,101 @@
+/*
+ * soft_bayer_pipe_tasks_priv.h - soft bayer pipe tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_BAYER_PIPE_TASKS_PRIV_H
+#define XCAM_SOFT_BAYER_PIPE_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_handler.h>
+
+// output tile of one step, both need be even
+#define XCAM_SOFT_BAYER_TILE_WIDTH 128
+#define XCAM_SOFT_BAYER_TILE_HEIGHT 16
+// raw pixels around tile, even to keep bayer phase of tile same as image
+#define XCAM_SOFT_BAYER_TILE_BORDER 4
+#define XCAM_SOFT_BAYER_GAMMA_LUT_SIZE 1024
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+enum BayerChannel {
+    BayerChannelR = 0,
+    BayerChannelG,
+    BayerChannelB,
+};
+
+/* per frame settings of the whole pipe, rebuilt when 3a results change.
+ * cfa phases are indexed by (y & 1) * 2 + (x & 1).
+ */
+struct BayerPipeTable {
+    uint32_t        color_bits;
+    bool            edge_aware;
+    BayerChannel    channel[4];
+    // black level and white balance folded, value = raw * scale + offset
+    float           scale[4];
+    float           offset[4];
+    // row-major 3x3, color correction on linear rgb
+    float           ccm[9];
+    // row-major 3x3, gamma corrected rgb to yuv, uv centered at 128
+    float           rgb2yuv[9];
+    // linear [0, 1] to gamma corrected [0, 255]
+    float           gamma[XCAM_SOFT_BAYER_GAMMA_LUT_SIZE];
+
+    BayerPipeTable ();
+};
+
+bool bayer_get_pattern (uint32_t format, BayerChannel channel[4]);
+
+/* each work item is a block of tiles, raw tile with border is normalized,
+ * demosaiced, color corrected, gamma corrected and converted to NV12 in
+ * scratch of the calling thread before the next tile is loaded.
+ */
+class BayerPipeTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<VideoBuffer>           in_buf;
+        SmartPtr<UcharImage>            out_luma;
+        SmartPtr<Uchar2Image>           out_uv;
+        SmartPtr<BayerPipeTable>        table;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {}
+    };
+
+public:
+    explicit BayerPipeTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("BayerPipeTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+}
+
+}
+
+#endif //XCAM_SOFT_BAYER_PIPE_TASKS_PRIV_H
@@ -0,0 +1,224 @@
+/*
+ * soft_csc.cpp - soft color space conversion implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_csc.h"
+#include "soft_csc_tasks_priv.h"
+
+namespace XCam {
+
+DECLARE_WORK_CALLBACK (CbCscTask, SoftCscHandler, csc_done);
+
+bool
+soft_csc_is_supported (uint32_t in_format, uint32_t out_format)
+{
+    return XCamSoftTasks::csc_is_supported_input (in_format) &&
+           XCamSoftTasks::csc_is_supported_output (out_format);
+}
+
+XCamReturn
+soft_csc_convert (const SmartPtr<VideoBuffer> &in, const SmartPtr<VideoBuffer> &out)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, in.ptr () && out.ptr (), XCAM_RETURN_ERROR_PARAM,
+        "soft_csc_convert needs both input and output buffers");
+
+    const VideoBufferInfo &in_info = in->get_video_info ();
+    const VideoBufferInfo &out_info = out->get_video_info ();
+    XCamSoftTasks::CscPlan plan;
+    XCamReturn ret = plan.init (in_info, out_info);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "soft_csc_convert init plan failed");
+
+    const uint8_t *in_mem = in->map ();
+    uint8_t *out_mem = out->map ();
+    if (!in_mem || !out_mem) {
+        if (in_mem)
+            in->unmap ();
+        if (out_mem)
+            out->unmap ();
+        XCAM_LOG_ERROR ("soft_csc_convert map buffers failed");
+        return XCAM_RETURN_ERROR_MEM;
+    }
+
+    XCamSoftTasks::csc_convert_lines (plan, in_mem, in_info, out_mem, out_info, 0, plan.get_pair_count ());
+    out->set_timestamp (in->get_timestamp ());
+
+    in->unmap ();
+    out->unmap ();
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftCscHandler::SoftCscHandler (const char *name)
+    : SoftHandler (name)
+    , _out_format (V4L2_PIX_FMT_NV12)
+    , _out_width (0)
+    , _out_height (0)
+{
+}
+
+SoftCscHandler::~SoftCscHandler ()
+{
+}
+
+bool
+SoftCscHandler::set_output_format (uint32_t format)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, XCamSoftTasks::csc_is_supported_output (format), false,
+        "SoftCscHandler(%s) does not support output format(%s)",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (format));
+
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "SoftCscHandler(%s) output format can NOT be changed after configured", XCAM_STR (get_name ()));
+
+    _out_format = format;
+    return true;
+}
+
+bool
+SoftCscHandler::set_output_size (uint32_t width, uint32_t height)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, !width == !height, false,
+        "SoftCscHandler(%s) output size(%dx%d) need be both set or both 0",
+        XCAM_STR (get_name ()), width, height);
+
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "SoftCscHandler(%s) output size can NOT be changed after configured", XCAM_STR (get_name ()));
+
+    _out_width = width;
+    _out_height = height;
+    return true;
+}
+
+XCamReturn
+SoftCscHandler::convert (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in, out);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftCscHandler::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+
+    VideoBufferInfo out_info;
+    out_info.init (
+        _out_format, _out_width ? _out_width : in_info.width, _out_height ? _out_height : in_info.height);
+
+    _plan = new XCamSoftTasks::CscPlan;
+    XCAM_ASSERT (_plan.ptr ());
+    XCamReturn ret = _plan->init (in_info, out_info);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftCscHandler(%s) can't convert %s(%dx%d) to %s(%dx%d)", XCAM_STR (get_name ()),
+        xcam_fourcc_to_string (in_info.format), in_info.width, in_info.height,
+        xcam_fourcc_to_string (out_info.format), out_info.width, out_info.height);
+
+    set_out_video_info (out_info);
+
+    XCAM_ASSERT (!_csc_task.ptr ());
+    _csc_task = new XCamSoftTasks::CscTask (new CbCscTask (this));
+    XCAM_ASSERT (_csc_task.ptr ());
+    share_threads (_csc_task);
+
+    uint32_t thread_x = 1, thread_y = 4;
+    WorkSize global_size (1, _plan->get_pair_count ());
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    _csc_task->set_local_size (local_size);
+    _csc_task->set_global_size (global_size);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftCscHandler::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_csc_task.ptr () && _plan.ptr ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    SmartPtr<XCamSoftTasks::CscTask::Args> args = new XCamSoftTasks::CscTask::Args (param);
+    args->in_buf = param->in_buf;
+    args->out_buf = param->out_buf;
+    args->plan = _plan;
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = _csc_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftCscHandler(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+void
+SoftCscHandler::csc_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _csc_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    work_well_done (param, error);
+}
+
+XCamReturn
+SoftCscHandler::terminate ()
+{
+    if (_csc_task.ptr ()) {
+        _csc_task->stop ();
+        _csc_task.release ();
+    }
+
+    return SoftHandler::terminate ();
+}
+
+SmartPtr<SoftHandler>
+create_soft_csc_handler (uint32_t out_format, uint32_t width, uint32_t height)
+{
+    SmartPtr<SoftCscHandler> csc = new SoftCscHandler ();
+    XCAM_ASSERT (csc.ptr ());
+
+    if (!csc->set_output_format (out_format) || !csc->set_output_size (width, height))
+        return NULL;
+
+    return csc;
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+ * soft_csc.h - soft color space conversion
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_CSC_H
+#define XCAM_SOFT_CSC_H
+
+#include <xcam_std.h>
+#include <soft/soft_handler.h>
+
+namespace XCam {
+
+class SoftWorker;
+
+namespace XCamSoftTasks {
+struct CscPlan;
+};
+
+/* conversion between NV12, YUV420(I420), YUYV, RGB24, BGR24, RGBA32, BGR32/XBGR32/ABGR32
+ * and to XCAM_PIX_FMT_RGBF32_planar/XCAM_PIX_FMT_BGRF32_planar, with full range BT.601.
+ * bilinear resize is done in the same pass when output size differs from input.
+ * line kernels are picked on cpu features at runtime (avx2, sse2 or c).
+ */
+bool soft_csc_is_supported (uint32_t in_format, uint32_t out_format);
+
+// converts @in into @out on calling thread, format and size are taken from buffers
+XCamReturn soft_csc_convert (const SmartPtr<VideoBuffer> &in, const SmartPtr<VideoBuffer> &out);
+
+/* same conversion as soft_csc_convert on handler threads, line pairs are split
+ * between threads. output buffers are allocated by handler if not given.
+ */
+class SoftCscHandler
+    : public SoftHandler
+{
+public:
+    explicit SoftCscHandler (const char *name = "SoftCscHandler");
+    ~SoftCscHandler ();
+
+    // output format and size can NOT be changed after configured, size 0 keeps input size
+    bool set_output_format (uint32_t format);
+    bool set_output_size (uint32_t width, uint32_t height);
+    uint32_t get_output_format () const {
+        return _out_format;
+    }
+
+    XCamReturn convert (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+
+    void csc_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    XCAM_DEAD_COPY (SoftCscHandler);
+
+private:
+    SmartPtr<SoftWorker>                    _csc_task;
+    SmartPtr<XCamSoftTasks::CscPlan>        _plan;
+    uint32_t                                _out_format;
+    uint32_t                                _out_width;
+    uint32_t                                _out_height;
+};
+
+extern SmartPtr<SoftHandler> create_soft_csc_handler (
+    uint32_t out_format, uint32_t width = 0, uint32_t height = 0);
+
+}
+
+#endif //XCAM_SOFT_CSC_H
@@ -0,0 +1,667 @@
+/*
+ * soft_csc_tasks_priv.cpp - soft color space conversion tasks private implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_csc_tasks_priv.h"
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// avx2 variants are built with target attribute and picked at runtime
+#if defined (__SSE2__) && defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define CSC_AVX2_DISPATCH 1
+#define CSC_TARGET_AVX2 __attribute__ ((target ("avx2")))
+#include <immintrin.h>
+#endif
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+// full range BT.601, same as soft 3a stats and defog
+static const float csc_yuv_to_rgb[12] = {
+    1.0f, 0.0f, 1.402f, -1.402f * 128.0f,
+    1.0f, -0.344136f, -0.714136f, (0.344136f + 0.714136f) * 128.0f,
+    1.0f, 1.772f, 0.0f, -1.772f * 128.0f
+};
+
+static const float csc_rgb_to_yuv[12] = {
+    0.299f, 0.587f, 0.114f, 0.0f,
+    -0.168736f, -0.331264f, 0.5f, 128.0f,
+    0.5f, -0.418688f, -0.081312f, 128.0f
+};
+
+static inline void
+blend_tail (
+    const uint8_t *src0, const uint8_t *src1, uint16_t weight, uint32_t x, uint32_t count, uint8_t *dst)
+{
+    const uint32_t w0 = 256 - weight;
+    for (; x < count; ++x)
+        dst[x] = (uint8_t)((src0[x] * w0 + src1[x] * weight + 128) >> 8);
+}
+
+static inline void
+matrix_pixel (const uint8_t *src, const float *m, uint8_t *dst)
+{
+    const float s0 = src[0], s1 = src[1], s2 = src[2];
+    for (uint32_t c = 0; c < 3; ++c) {
+        const float *row = m + c * 4;
+        float v = row[3] + row[0] * s0;
+        v += row[1] * s1;
+        v += row[2] * s2;
+        dst[c] = (uint8_t)XCAM_CLAMP (v + 0.5f, 0.0f, 255.0f);
+    }
+    dst[3] = 255;
+}
+
+static void
+blend_c (const uint8_t *src0, const uint8_t *src1, uint16_t weight, uint32_t count, uint8_t *dst)
+{
+    blend_tail (src0, src1, weight, 0, count, dst);
+}
+
+static void
+matrix_c (const uint8_t *src, uint32_t count, const float *matrix, uint8_t *dst)
+{
+    for (uint32_t x = 0; x < count; ++x)
+        matrix_pixel (src + x * 4, matrix, dst + x * 4);
+}
+
+#if defined (__SSE2__)
+static void
+blend_sse2 (const uint8_t *src0, const uint8_t *src1, uint16_t weight, uint32_t count, uint8_t *dst)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i w0 = _mm_set1_epi16 (256 - weight);
+    const __m128i w1 = _mm_set1_epi16 (weight);
+    const __m128i round = _mm_set1_epi16 (128);
+
+    uint32_t x = 0;
+    for (; x + 16 <= count; x += 16) {
+        const __m128i a = _mm_loadu_si128 ((const __m128i *)(src0 + x));
+        const __m128i b = _mm_loadu_si128 ((const __m128i *)(src1 + x));
+        __m128i lo = _mm_add_epi16 (
+                         _mm_mullo_epi16 (_mm_unpacklo_epi8 (a, zero), w0),
+                         _mm_mullo_epi16 (_mm_unpacklo_epi8 (b, zero), w1));
+        __m128i hi = _mm_add_epi16 (
+                         _mm_mullo_epi16 (_mm_unpackhi_epi8 (a, zero), w0),
+                         _mm_mullo_epi16 (_mm_unpackhi_epi8 (b, zero), w1));
+        lo = _mm_srli_epi16 (_mm_add_epi16 (lo, round), 8);
+        hi = _mm_srli_epi16 (_mm_add_epi16 (hi, round), 8);
+        _mm_storeu_si128 ((__m128i *)(dst + x), _mm_packus_epi16 (lo, hi));
+    }
+
+    blend_tail (src0, src1, weight, x, count, dst);
+}
+
+struct MatrixSse2 {
+    __m128  col[3];
+    __m128  bias;
+
+    explicit MatrixSse2 (const float *m) {
+        for (uint32_t k = 0; k < 3; ++k)
+            col[k] = _mm_setr_ps (m[k], m[4 + k], m[8 + k], 0.0f);
+        bias = _mm_setr_ps (m[3], m[7], m[11], 255.0f);
+    }
+
+    // one pixel in 4 floats
+    inline __m128i apply (__m128 p) const {
+        __m128 v = _mm_add_ps (bias, _mm_mul_ps (col[0], _mm_shuffle_ps (p, p, 0x00)));
+        v = _mm_add_ps (v, _mm_mul_ps (col[1], _mm_shuffle_ps (p, p, 0x55)));
+        v = _mm_add_ps (v, _mm_mul_ps (col[2], _mm_shuffle_ps (p, p, 0xAA)));
+        v = _mm_add_ps (v, _mm_set1_ps (0.5f));
+        v = _mm_min_ps (_mm_max_ps (v, _mm_setzero_ps ()), _mm_set1_ps (255.0f));
+        return _mm_cvttps_epi32 (v);
+    }
+};
+
+static void
+matrix_sse2 (const uint8_t *src, uint32_t count, const float *matrix, uint8_t *dst)
+{
+    const MatrixSse2 m (matrix);
+    const __m128i zero = _mm_setzero_si128 ();
+
+    uint32_t x = 0;
+    for (; x + 4 <= count; x += 4) {
+        const __m128i in = _mm_loadu_si128 ((const __m128i *)(src + x * 4));
+        const __m128i lo = _mm_unpacklo_epi8 (in, zero);
+        const __m128i hi = _mm_unpackhi_epi8 (in, zero);
+        const __m128i p0 = m.apply (_mm_cvtepi32_ps (_mm_unpacklo_epi16 (lo, zero)));
+        const __m128i p1 = m.apply (_mm_cvtepi32_ps (_mm_unpackhi_epi16 (lo, zero)));
+        const __m128i p2 = m.apply (_mm_cvtepi32_ps (_mm_unpacklo_epi16 (hi, zero)));
+        const __m128i p3 = m.apply (_mm_cvtepi32_ps (_mm_unpackhi_epi16 (hi, zero)));
+        _mm_storeu_si128 (
+            (__m128i *)(dst + x * 4),
+            _mm_packus_epi16 (_mm_packs_epi32 (p0, p1), _mm_packs_epi32 (p2, p3)));
+    }
+
+    for (; x < count; ++x)
+        matrix_pixel (src + x * 4, matrix, dst + x * 4);
+}
+#endif
+
+#if CSC_AVX2_DISPATCH
+CSC_TARGET_AVX2 static void
+blend_avx2 (const uint8_t *src0, const uint8_t *src1, uint16_t weight, uint32_t count, uint8_t *dst)
+{
+    const __m256i zero = _mm256_setzero_si256 ();
+    const __m256i w0 = _mm256_set1_epi16 (256 - weight);
+    const __m256i w1 = _mm256_set1_epi16 (weight);
+    const __m256i round = _mm256_set1_epi16 (128);
+
+    // unpack and pack both stay in 128 bit lanes, byte order is kept
+    uint32_t x = 0;
+    for (; x + 32 <= count; x += 32) {
+        const __m256i a = _mm256_loadu_si256 ((const __m256i *)(src0 + x));
+        const __m256i b = _mm256_loadu_si256 ((const __m256i *)(src1 + x));
+        __m256i lo = _mm256_add_epi16 (
+                         _mm256_mullo_epi16 (_mm256_unpacklo_epi8 (a, zero), w0),
+                         _mm256_mullo_epi16 (_mm256_unpacklo_epi8 (b, zero), w1));
+        __m256i hi = _mm256_add_epi16 (
+                         _mm256_mullo_epi16 (_mm256_unpackhi_epi8 (a, zero), w0),
+                         _mm256_mullo_epi16 (_mm256_unpackhi_epi8 (b, zero), w1));
+        lo = _mm256_srli_epi16 (_mm256_add_epi16 (lo, round), 8);
+        hi = _mm256_srli_epi16 (_mm256_add_epi16 (hi, round), 8);
+        _mm256_storeu_si256 ((__m256i *)(dst + x), _mm256_packus_epi16 (lo, hi));
+    }
+
+    blend_tail (src0, src1, weight, x, count, dst);
+}
+
+// two pixels in 8 floats, one each 128 bit lane
+CSC_TARGET_AVX2 static inline __m256i
+matrix_apply_avx2 (const __m256 *col, __m256 bias, __m256 p)
+{
+    __m256 v = _mm256_add_ps (bias, _mm256_mul_ps (col[0], _mm256_permute_ps (p, 0x00)));
+    v = _mm256_add_ps (v, _mm256_mul_ps (col[1], _mm256_permute_ps (p, 0x55)));
+    v = _mm256_add_ps (v, _mm256_mul_ps (col[2], _mm256_permute_ps (p, 0xAA)));
+    v = _mm256_add_ps (v, _mm256_set1_ps (0.5f));
+    v = _mm256_min_ps (_mm256_max_ps (v, _mm256_setzero_ps ()), _mm256_set1_ps (255.0f));
+    return _mm256_cvttps_epi32 (v);
+}
+
+CSC_TARGET_AVX2 static void
+matrix_avx2 (const uint8_t *src, uint32_t count, const float *matrix, uint8_t *dst)
+{
+    __m256 col[3];
+    for (uint32_t k = 0; k < 3; ++k)
+        col[k] = _mm256_setr_ps (
+                     matrix[k], matrix[4 + k], matrix[8 + k], 0.0f,
+                     matrix[k], matrix[4 + k], matrix[8 + k], 0.0f);
+    const __m256 bias = _mm256_setr_ps (
+                            matrix[3], matrix[7], matrix[11], 255.0f,
+                            matrix[3], matrix[7], matrix[11], 255.0f);
+    // pixels come out of packs as 0 2 4 6 1 3 5 7
+    const __m256i order = _mm256_setr_epi32 (0, 4, 1, 5, 2, 6, 3, 7);
+
+    uint32_t x = 0;
+    for (; x + 8 <= count; x += 8) {
+        const __m128i lo = _mm_loadu_si128 ((const __m128i *)(src + x * 4));
+        const __m128i hi = _mm_loadu_si128 ((const __m128i *)(src + x * 4 + 16));
+        const __m256i p01 = matrix_apply_avx2 (col, bias, _mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (lo)));
+        const __m256i p23 = matrix_apply_avx2 (
+                                col, bias, _mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (_mm_srli_si128 (lo, 8))));
+        const __m256i p45 = matrix_apply_avx2 (col, bias, _mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (hi)));
+        const __m256i p67 = matrix_apply_avx2 (
+                                col, bias, _mm256_cvtepi32_ps (_mm256_cvtepu8_epi32 (_mm_srli_si128 (hi, 8))));
+        const __m256i packed = _mm256_packus_epi16 (
+                                   _mm256_packs_epi32 (p01, p23), _mm256_packs_epi32 (p45, p67));
+        _mm256_storeu_si256 ((__m256i *)(dst + x * 4), _mm256_permutevar8x32_epi32 (packed, order));
+    }
+
+    for (; x < count; ++x)
+        matrix_pixel (src + x * 4, matrix, dst + x * 4);
+}
+#endif
+
+static CscKernels
+select_csc_kernels ()
+{
+    CscKernels kernels;
+    kernels.isa = "c";
+    kernels.blend = blend_c;
+    kernels.matrix = matrix_c;
+
+#if defined (__SSE2__)
+    kernels.isa = "sse2";
+    kernels.blend = blend_sse2;
+    kernels.matrix = matrix_sse2;
+#endif
+
+#if CSC_AVX2_DISPATCH
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2")) {
+        kernels.isa = "avx2";
+        kernels.blend = blend_avx2;
+        kernels.matrix = matrix_avx2;
+    }
+#endif
+
+    XCAM_LOG_DEBUG ("soft csc picks %s kernels", kernels.isa);
+    return kernels;
+}
+
+const CscKernels &
+get_csc_kernels ()
+{
+    static const CscKernels kernels = select_csc_kernels ();
+    return kernels;
+}
+
+void
+get_csc_kernel_variants (std::vector<CscKernels> &variants)
+{
+    CscKernels kernels;
+    variants.clear ();
+
+    kernels.isa = "c";
+    kernels.blend = blend_c;
+    kernels.matrix = matrix_c;
+    variants.push_back (kernels);
+
+#if defined (__SSE2__)
+    kernels.isa = "sse2";
+    kernels.blend = blend_sse2;
+    kernels.matrix = matrix_sse2;
+    variants.push_back (kernels);
+#endif
+
+#if CSC_AVX2_DISPATCH
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2")) {
+        kernels.isa = "avx2";
+        kernels.blend = blend_avx2;
+        kernels.matrix = matrix_avx2;
+        variants.push_back (kernels);
+    }
+#endif
+}
+
+bool
+csc_is_supported_input (uint32_t format)
+{
+    switch (format) {
+    case V4L2_PIX_FMT_NV12:
+    case V4L2_PIX_FMT_YUV420:
+    case V4L2_PIX_FMT_YUYV:
+    case V4L2_PIX_FMT_RGB24:
+    case V4L2_PIX_FMT_BGR24:
+    case V4L2_PIX_FMT_RGBA32:
+    case V4L2_PIX_FMT_BGR32:
+    case V4L2_PIX_FMT_XBGR32:
+    case V4L2_PIX_FMT_ABGR32:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool
+csc_is_supported_output (uint32_t format)
+{
+    return csc_is_supported_input (format) ||
+           format == XCAM_PIX_FMT_RGBF32_planar || format == XCAM_PIX_FMT_BGRF32_planar;
+}
+
+static inline CscFamily
+get_csc_family (uint32_t format)
+{
+    switch (format) {
+    case V4L2_PIX_FMT_NV12:
+    case V4L2_PIX_FMT_YUV420:
+    case V4L2_PIX_FMT_YUYV:
+        return CscFamilyYuv;
+    default:
+        return CscFamilyRgb;
+    }
+}
+
+// bilinear position of @count outputs over @size inputs, next input always exists
+static void
+get_resample_table (uint32_t size, uint32_t count, std::vector<uint32_t> &pos, std::vector<uint16_t> &weight)
+{
+    pos.resize (count);
+    weight.resize (count);
+    for (uint32_t i = 0; i < count; ++i) {
+        float f = (i + 0.5f) * size / count - 0.5f;
+        f = XCAM_CLAMP (f, 0.0f, (float)(size - 1));
+        pos[i] = XCAM_MIN ((uint32_t)f, size - 2);
+        weight[i] = (uint16_t)((f - pos[i]) * 256.0f + 0.5f);
+    }
+}
+
+CscPlan::CscPlan ()
+    : in_format (0), out_format (0)
+    , in_width (0), in_height (0)
+    , out_width (0), out_height (0)
+    , in_family (CscFamilyYuv)
+    , out_family (CscFamilyYuv)
+    , resize (false)
+{
+    xcam_mem_clear (matrix);
+}
+
+XCamReturn
+CscPlan::init (const VideoBufferInfo &in_info, const VideoBufferInfo &out_info)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, csc_is_supported_input (in_info.format) && csc_is_supported_output (out_info.format),
+        XCAM_RETURN_ERROR_PARAM,
+        "soft csc does not support %s to %s",
+        xcam_fourcc_to_string (in_info.format), xcam_fourcc_to_string (out_info.format));
+
+    in_format = in_info.format;
+    out_format = out_info.format;
+    in_width = in_info.width;
+    in_height = in_info.height;
+    out_width = out_info.width;
+    out_height = out_info.height;
+    in_family = get_csc_family (in_format);
+    out_family = get_csc_family (out_format);
+    resize = (in_width != out_width || in_height != out_height);
+
+    XCAM_FAIL_RETURN (
+        ERROR,
+        !(in_family == CscFamilyYuv && in_width % 2) && !(out_family == CscFamilyYuv && out_width % 2),
+        XCAM_RETURN_ERROR_PARAM, "soft csc needs even width on yuv formats");
+    XCAM_FAIL_RETURN (
+        ERROR,
+        !(in_format != V4L2_PIX_FMT_YUYV && in_family == CscFamilyYuv && in_height % 2) &&
+        !(out_format != V4L2_PIX_FMT_YUYV && out_family == CscFamilyYuv && out_height % 2),
+        XCAM_RETURN_ERROR_PARAM, "soft csc needs even height on 4:2:0 formats");
+    XCAM_FAIL_RETURN (
+        ERROR, !resize || (in_width >= 2 && in_height >= 2 && out_width && out_height),
+        XCAM_RETURN_ERROR_PARAM, "soft csc can not resize %dx%d to %dx%d",
+        in_width, in_height, out_width, out_height);
+
+    if (in_family == CscFamilyYuv && out_family == CscFamilyRgb)
+        memcpy (matrix, csc_yuv_to_rgb, sizeof (matrix));
+    else if (in_family == CscFamilyRgb && out_family == CscFamilyYuv)
+        memcpy (matrix, csc_rgb_to_yuv, sizeof (matrix));
+
+    if (resize) {
+        get_resample_table (in_width, out_width, x0, wx);
+        get_resample_table (in_height, out_height, y0, wy);
+    }
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+static inline void
+set_pixel (uint8_t *dst, uint8_t c0, uint8_t c1, uint8_t c2, uint8_t c3)
+{
+    dst[0] = c0;
+    dst[1] = c1;
+    dst[2] = c2;
+    dst[3] = c3;
+}
+
+// input line @y into 4 bytes each pixel
+static void
+unpack_line (const CscPlan &plan, const uint8_t *in, const VideoBufferInfo &info, uint32_t y, uint8_t *dst)
+{
+    const uint32_t width = plan.in_width;
+    const uint8_t *line = in + info.offsets[0] + y * info.strides[0];
+
+    switch (plan.in_format) {
+    case V4L2_PIX_FMT_NV12: {
+        const uint8_t *uv = in + info.offsets[1] + (y / 2) * info.strides[1];
+        for (uint32_t x = 0; x < width; x += 2, dst += 8) {
+            set_pixel (dst, line[x], uv[x], uv[x + 1], 255);
+            set_pixel (dst + 4, line[x + 1], uv[x], uv[x + 1], 255);
+        }
+        break;
+    }
+    case V4L2_PIX_FMT_YUV420: {
+        const uint8_t *u = in + info.offsets[1] + (y / 2) * info.strides[1];
+        const uint8_t *v = in + info.offsets[2] + (y / 2) * info.strides[2];
+        for (uint32_t x = 0; x < width; x += 2, dst += 8) {
+            set_pixel (dst, line[x], u[x / 2], v[x / 2], 255);
+            set_pixel (dst + 4, line[x + 1], u[x / 2], v[x / 2], 255);
+        }
+        break;
+    }
+    case V4L2_PIX_FMT_YUYV:
+        for (uint32_t x = 0; x < width; x += 2, line += 4, dst += 8) {
+            set_pixel (dst, line[0], line[1], line[3], 255);
+            set_pixel (dst + 4, line[2], line[1], line[3], 255);
+        }
+        break;
+    case V4L2_PIX_FMT_RGB24:
+        for (uint32_t x = 0; x < width; ++x, line += 3, dst += 4)
+            set_pixel (dst, line[0], line[1], line[2], 255);
+        break;
+    case V4L2_PIX_FMT_BGR24:
+        for (uint32_t x = 0; x < width; ++x, line += 3, dst += 4)
+            set_pixel (dst, line[2], line[1], line[0], 255);
+        break;
+    case V4L2_PIX_FMT_RGBA32:
+        memcpy (dst, line, width * 4);
+        break;
+    default:
+        // memory order B G R A
+        for (uint32_t x = 0; x < width; ++x, line += 4, dst += 4)
+            set_pixel (dst, line[2], line[1], line[0], line[3]);
+        break;
+    }
+}
+
+static void
+resample_line (const CscPlan &plan, const uint8_t *src, uint8_t *dst)
+{
+    for (uint32_t x = 0; x < plan.out_width; ++x, dst += 4) {
+        const uint8_t *p0 = src + plan.x0[x] * 4;
+        const uint8_t *p1 = p0 + 4;
+        const uint32_t w1 = plan.wx[x];
+        const uint32_t w0 = 256 - w1;
+        for (uint32_t c = 0; c < 4; ++c)
+            dst[c] = (uint8_t)((p0[c] * w0 + p1[c] * w1 + 128) >> 8);
+    }
+}
+
+// chroma of 4:2:x outputs is averaged over 2 or 4 pixels
+static void
+pack_lines (
+    const CscPlan &plan, const uint8_t *line0, const uint8_t *line1, uint32_t pair,
+    uint8_t *out, const VideoBufferInfo &info)
+{
+    const uint32_t width = plan.out_width;
+    const uint32_t y = pair * 2;
+    const uint32_t lines = (y + 1 < plan.out_height) ? 2 : 1;
+    const uint8_t *src[2] = {line0, line1};
+
+    switch (plan.out_format) {
+    case V4L2_PIX_FMT_NV12:
+    case V4L2_PIX_FMT_YUV420: {
+        for (uint32_t i = 0; i < 2; ++i) {
+            uint8_t *luma = out + info.offsets[0] + (y + i) * info.strides[0];
+            for (uint32_t x = 0; x < width; ++x)
+                luma[x] = src[i][x * 4];
+        }
+
+        const bool nv12 = (plan.out_format == V4L2_PIX_FMT_NV12);
+        uint8_t *u = out + info.offsets[1] + pair * info.strides[1];
+        uint8_t *v = nv12 ? u + 1 : out + info.offsets[2] + pair * info.strides[2];
+        const uint32_t step = nv12 ? 2 : 1;
+        for (uint32_t x = 0; x < width; x += 2, u += step, v += step) {
+            const uint8_t *a = line0 + x * 4, *b = line1 + x * 4;
+            *u = (uint8_t)((a[1] + a[5] + b[1] + b[5] + 2) >> 2);
+            *v = (uint8_t)((a[2] + a[6] + b[2] + b[6] + 2) >> 2);
+        }
+        break;
+    }
+    case V4L2_PIX_FMT_YUYV:
+        for (uint32_t i = 0; i < lines; ++i) {
+            uint8_t *dst = out + info.offsets[0] + (y + i) * info.strides[0];
+            const uint8_t *a = src[i];
+            for (uint32_t x = 0; x < width; x += 2, a += 8, dst += 4)
+                set_pixel (dst, a[0], (a[1] + a[5] + 1) >> 1, a[4], (a[2] + a[6] + 1) >> 1);
+        }
+        break;
+    case V4L2_PIX_FMT_RGB24:
+    case V4L2_PIX_FMT_BGR24: {
+        const uint32_t r = (plan.out_format == V4L2_PIX_FMT_RGB24) ? 0 : 2;
+        for (uint32_t i = 0; i < lines; ++i) {
+            uint8_t *dst = out + info.offsets[0] + (y + i) * info.strides[0];
+            const uint8_t *a = src[i];
+            for (uint32_t x = 0; x < width; ++x, a += 4, dst += 3) {
+                dst[r] = a[0];
+                dst[1] = a[1];
+                dst[2 - r] = a[2];
+            }
+        }
+        break;
+    }
+    case V4L2_PIX_FMT_RGBA32:
+        for (uint32_t i = 0; i < lines; ++i)
+            memcpy (out + info.offsets[0] + (y + i) * info.strides[0], src[i], width * 4);
+        break;
+    case XCAM_PIX_FMT_RGBF32_planar:
+    case XCAM_PIX_FMT_BGRF32_planar: {
+        const uint32_t r = (plan.out_format == XCAM_PIX_FMT_RGBF32_planar) ? 0 : 2;
+        for (uint32_t i = 0; i < lines; ++i) {
+            float *planes[3];
+            for (uint32_t c = 0; c < 3; ++c)
+                planes[c] = (float *)(out + info.offsets[c] + (y + i) * info.strides[c]);
+            const uint8_t *a = src[i];
+            for (uint32_t x = 0; x < width; ++x, a += 4) {
+                planes[r][x] = a[0];
+                planes[1][x] = a[1];
+                planes[2 - r][x] = a[2];
+            }
+        }
+        break;
+    }
+    default:
+        // memory order B G R A
+        for (uint32_t i = 0; i < lines; ++i) {
+            uint8_t *dst = out + info.offsets[0] + (y + i) * info.strides[0];
+            const uint8_t *a = src[i];
+            for (uint32_t x = 0; x < width; ++x, a += 4, dst += 4)
+                set_pixel (dst, a[2], a[1], a[0], a[3]);
+        }
+        break;
+    }
+}
+
+// last two unpacked input lines, consecutive output lines mostly share them
+struct CscLineCache {
+    std::vector<uint8_t>    line[2];
+    int32_t                 y[2];
+
+    explicit CscLineCache (uint32_t bytes) {
+        line[0].resize (bytes);
+        line[1].resize (bytes);
+        y[0] = y[1] = -1;
+    }
+
+    const uint8_t *get (
+        const CscPlan &plan, const uint8_t *in, const VideoBufferInfo &info, int32_t line_y, int32_t keep_y) {
+        for (uint32_t i = 0; i < 2; ++i) {
+            if (y[i] == line_y)
+                return &line[i][0];
+        }
+        const uint32_t slot = (y[0] == keep_y) ? 1 : 0;
+        unpack_line (plan, in, info, line_y, &line[slot][0]);
+        y[slot] = line_y;
+        return &line[slot][0];
+    }
+};
+
+void
+csc_convert_lines (
+    const CscPlan &plan, const uint8_t *in, const VideoBufferInfo &in_info,
+    uint8_t *out, const VideoBufferInfo &out_info, uint32_t pair_begin, uint32_t pair_end)
+{
+    const CscKernels &kernels = get_csc_kernels ();
+    const uint32_t in_bytes = plan.in_width * 4;
+    const uint32_t out_bytes = plan.out_width * 4;
+
+    CscLineCache cache (plan.resize ? in_bytes : 0);
+    std::vector<uint8_t> blended (plan.resize ? in_bytes : 0);
+    std::vector<uint8_t> lines[2];
+    lines[0].resize (out_bytes);
+    lines[1].resize (out_bytes);
+
+    pair_end = XCAM_MIN (pair_end, plan.get_pair_count ());
+    for (uint32_t pair = pair_begin; pair < pair_end; ++pair) {
+        for (uint32_t i = 0; i < 2; ++i) {
+            const uint32_t y = pair * 2 + i;
+            if (y >= plan.out_height)
+                break;
+
+            uint8_t *line = &lines[i][0];
+            if (!plan.resize) {
+                unpack_line (plan, in, in_info, y, line);
+            } else {
+                const int32_t y0 = plan.y0[y];
+                const uint16_t wy = plan.wy[y];
+                const uint8_t *src;
+                if (!wy) {
+                    src = cache.get (plan, in, in_info, y0, -1);
+                } else if (wy == 256) {
+                    src = cache.get (plan, in, in_info, y0 + 1, -1);
+                } else {
+                    const uint8_t *src0 = cache.get (plan, in, in_info, y0, y0 + 1);
+                    const uint8_t *src1 = cache.get (plan, in, in_info, y0 + 1, y0);
+                    kernels.blend (src0, src1, wy, in_bytes, &blended[0]);
+                    src = &blended[0];
+                }
+                resample_line (plan, src, line);
+            }
+
+            if (plan.in_family != plan.out_family)
+                kernels.matrix (line, plan.out_width, plan.matrix, line);
+        }
+
+        pack_lines (plan, &lines[0][0], &lines[1][0], pair, out, out_info);
+    }
+}
+
+XCamReturn
+CscTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<CscTask::Args> args = base.dynamic_cast_ptr<CscTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    XCAM_ASSERT (args->in_buf.ptr () && args->out_buf.ptr () && args->plan.ptr ());
+
+    const uint8_t *in = args->in_buf->map ();
+    uint8_t *out = args->out_buf->map ();
+    XCAM_FAIL_RETURN (
+        ERROR, in && out, XCAM_RETURN_ERROR_MEM,
+        "CscTask map buffers failed");
+
+    csc_convert_lines (
+        *args->plan.ptr (), in, args->in_buf->get_video_info (), out, args->out_buf->get_video_info (),
+        range.pos[1], range.pos[1] + range.pos_len[1]);
+
+    args->in_buf->unmap ();
+    args->out_buf->unmap ();
+
+    XCAM_LOG_DEBUG (
+        "CscTask work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+}
+
+}
@@ -0,0 +1,123 @@
+/*
+ * soft_csc_tasks_priv.h - soft color space conversion tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_CSC_TASKS_PRIV_H
+#define XCAM_SOFT_CSC_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_handler.h>
+#include <vector>
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+/* lines of every format are unpacked into 4 bytes each pixel, Y U V A for
+ * yuv formats and R G B A for rgb formats, so that resampling and matrix
+ * only deal with one layout.
+ */
+enum CscFamily {
+    CscFamilyYuv = 0,
+    CscFamilyRgb,
+};
+
+/* line kernels picked once on cpu features at runtime, all variants
+ * run the same operations in the same order.
+ */
+struct CscKernels {
+    const char *isa;
+    // dst = src0 + (src1 - src0) * weight / 256, on @count bytes
+    void (*blend) (const uint8_t *src0, const uint8_t *src1, uint16_t weight, uint32_t count, uint8_t *dst);
+    // 3x4 matrix on @count pixels of 4 bytes, alpha set to 255, in place is allowed
+    void (*matrix) (const uint8_t *src, uint32_t count, const float *matrix, uint8_t *dst);
+};
+
+const CscKernels &get_csc_kernels ();
+// every variant runnable on this cpu, c first, for equivalence checks
+void get_csc_kernel_variants (std::vector<CscKernels> &variants);
+
+/* conversion of one input size and format to one output size and format,
+ * fixed on configure. output lines go in pairs so that 4:2:0 chroma is
+ * averaged over both lines.
+ */
+struct CscPlan {
+    uint32_t                in_format;
+    uint32_t                out_format;
+    uint32_t                in_width, in_height;
+    uint32_t                out_width, out_height;
+    CscFamily               in_family;
+    CscFamily               out_family;
+    bool                    resize;
+    // row-major 3x4, last column is offset
+    float                   matrix[12];
+    // first input pixel and weight of next one, each output column and line
+    std::vector<uint32_t>   x0;
+    std::vector<uint16_t>   wx;
+    std::vector<uint32_t>   y0;
+    std::vector<uint16_t>   wy;
+
+    CscPlan ();
+    XCamReturn init (const VideoBufferInfo &in_info, const VideoBufferInfo &out_info);
+    uint32_t get_pair_count () const {
+        return (out_height + 1) / 2;
+    }
+};
+
+bool csc_is_supported_input (uint32_t format);
+bool csc_is_supported_output (uint32_t format);
+
+/* converts output line pairs [pair_begin, pair_end) of @out from @in,
+ * both buffers are mapped by caller.
+ */
+void csc_convert_lines (
+    const CscPlan &plan, const uint8_t *in, const VideoBufferInfo &in_info,
+    uint8_t *out, const VideoBufferInfo &out_info, uint32_t pair_begin, uint32_t pair_end);
+
+// one work item is one pair of output lines
+class CscTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<VideoBuffer>           in_buf;
+        SmartPtr<VideoBuffer>           out_buf;
+        SmartPtr<CscPlan>               plan;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {}
+    };
+
+public:
+    explicit CscTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("CscTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+}
+
+}
+
+#endif //XCAM_SOFT_CSC_TASKS_PRIV_H
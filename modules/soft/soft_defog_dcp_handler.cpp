@@ -0,0 +1,343 @@
+/*
+ * soft_defog_dcp_handler.cpp - soft dark channel prior defog handler class implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_defog_dcp_handler.h"
+#include "soft_defog_dcp_tasks_priv.h"
+#include "soft_video_buf_allocator.h"
+
+// maps of frames in flight
+#define DCP_MAPS_POOL_SIZE 2
+
+// guided filter radius on downscaled maps, 32 pixels on full image
+#define DCP_GUIDE_RADIUS 8
+#define DCP_GUIDE_EPS 0.001f
+
+// one uv line of each sample step looks for atmospheric light, phase moves by frame
+#define DCP_ATMOS_SAMPLE_STEP 8
+#define DCP_ATMOS_SMOOTH 0.125f
+#define DCP_ATMOS_MIN 100.0f
+
+namespace XCam {
+
+DECLARE_WORK_CALLBACK (CbDcpDarkChannel, SoftDefogDcpHandler, dark_channel_done);
+DECLARE_WORK_CALLBACK (CbDcpMinFilter, SoftDefogDcpHandler, min_filter_done);
+DECLARE_WORK_CALLBACK (CbDcpGuideCoeff, SoftDefogDcpHandler, guide_coeff_done);
+DECLARE_WORK_CALLBACK (CbDcpGuideMean, SoftDefogDcpHandler, guide_mean_done);
+DECLARE_WORK_CALLBACK (CbDcpRecover, SoftDefogDcpHandler, recover_done);
+
+SoftDefogDcpHandler::SoftDefogDcpHandler (const char *name)
+    : SoftHandler (name)
+    , _atmos_valid (false)
+    , _frame_count (0)
+{
+    _atmos[0] = _atmos[1] = _atmos[2] = 255.0f;
+}
+
+SoftDefogDcpHandler::~SoftDefogDcpHandler ()
+{
+}
+
+XCamReturn
+SoftDefogDcpHandler::defog (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in, out);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftDefogDcpHandler::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        ERROR, in_info.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftDefogDcpHandler(%s) only support format(NV12) but input format is %s",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (in_info.format));
+
+    set_out_video_info (in_info);
+
+    const uint32_t low_height = xcam_ceil (in_info.height, XCAM_SOFT_DCP_GUIDE_SCALE) / XCAM_SOFT_DCP_GUIDE_SCALE;
+    VideoBufferInfo maps_info;
+    XCamSoftTasks::DcpMaps::get_buf_info (maps_info, in_info.width, in_info.height);
+    _maps_pool = new SoftVideoBufAllocator (maps_info);
+    XCAM_ASSERT (_maps_pool.ptr ());
+    XCAM_FAIL_RETURN (
+        ERROR, _maps_pool->reserve (DCP_MAPS_POOL_SIZE), XCAM_RETURN_ERROR_MEM,
+        "SoftDefogDcpHandler(%s) reserve maps failed", XCAM_STR (get_name ()));
+
+    XCAM_ASSERT (!_dark_channel_task.ptr () && !_min_filter_task.ptr () && !_recover_task.ptr ());
+    XCAM_ASSERT (!_guide_coeff_task.ptr () && !_guide_mean_task.ptr ());
+    _dark_channel_task = new XCamSoftTasks::DcpDarkChannelTask (new CbDcpDarkChannel (this));
+    _min_filter_task = new XCamSoftTasks::DcpMinFilterTask (new CbDcpMinFilter (this));
+    _guide_coeff_task = new XCamSoftTasks::DcpGuideCoeffTask (new CbDcpGuideCoeff (this));
+    _guide_mean_task = new XCamSoftTasks::DcpGuideMeanTask (new CbDcpGuideMean (this));
+    _recover_task = new XCamSoftTasks::DcpRecoverTask (new CbDcpRecover (this));
+    XCAM_ASSERT (_dark_channel_task.ptr () && _min_filter_task.ptr () && _recover_task.ptr ());
+    XCAM_ASSERT (_guide_coeff_task.ptr () && _guide_mean_task.ptr ());
+    share_threads (_dark_channel_task);
+    share_threads (_min_filter_task);
+    share_threads (_guide_coeff_task);
+    share_threads (_guide_mean_task);
+    share_threads (_recover_task);
+
+    set_work_size (_dark_channel_task, in_info.height / 2);
+    set_work_size (_min_filter_task, low_height);
+    set_work_size (_guide_coeff_task, low_height);
+    set_work_size (_guide_mean_task, low_height);
+    set_work_size (_recover_task, in_info.height / 2);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftDefogDcpHandler::set_work_size (const SmartPtr<SoftWorker> &worker, uint32_t height)
+{
+    uint32_t thread_x = 1, thread_y = 4;
+
+    WorkSize global_size (1, height);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    worker->set_local_size (local_size);
+    worker->set_global_size (global_size);
+}
+
+XCamReturn
+SoftDefogDcpHandler::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_dark_channel_task.ptr () && _maps_pool.ptr ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    SmartPtr<VideoBuffer> maps_buf = _maps_pool->get_buffer (_maps_pool);
+    XCAM_FAIL_RETURN (
+        ERROR, maps_buf.ptr (), XCAM_RETURN_ERROR_MEM,
+        "SoftDefogDcpHandler(%s) get maps failed", XCAM_STR (get_name ()));
+
+    SmartPtr<XCamSoftTasks::DcpMaps> maps = new XCamSoftTasks::DcpMaps;
+    XCAM_ASSERT (maps.ptr ());
+    XCAM_FAIL_RETURN (
+        ERROR, maps->init (maps_buf, in_info.width, in_info.height), XCAM_RETURN_ERROR_MEM,
+        "SoftDefogDcpHandler(%s) init maps failed", XCAM_STR (get_name ()));
+
+    SmartPtr<XCamSoftTasks::DcpDarkChannelTask::Args> args = new XCamSoftTasks::DcpDarkChannelTask::Args (param);
+    args->in_luma = new UcharImage (param->in_buf, 0);
+    args->in_uv = new Uchar2Image (param->in_buf, 1);
+    args->maps = maps;
+    args->atmos = new XCamSoftTasks::DcpAtmosCandidate;
+    args->sample_step = DCP_ATMOS_SAMPLE_STEP;
+    args->sample_phase = (_frame_count++) % DCP_ATMOS_SAMPLE_STEP;
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = _dark_channel_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftDefogDcpHandler(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+// smooths atmospheric light by @rgb if it is not NULL, copies result into @atmos,
+// callbacks of frames in flight may run on different threads
+void
+SoftDefogDcpHandler::update_atmos (const float *rgb, float *atmos)
+{
+    SmartLock locker (_atmos_mutex);
+    if (rgb) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            const float value = XCAM_CLAMP (rgb[i], DCP_ATMOS_MIN, 255.0f);
+            _atmos[i] = _atmos_valid ? _atmos[i] + (value - _atmos[i]) * DCP_ATMOS_SMOOTH : value;
+        }
+        _atmos_valid = true;
+    }
+
+    atmos[0] = _atmos[0];
+    atmos[1] = _atmos[1];
+    atmos[2] = _atmos[2];
+}
+
+void
+SoftDefogDcpHandler::dark_channel_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _dark_channel_task.ptr ());
+
+    SmartPtr<XCamSoftTasks::DcpDarkChannelTask::Args> args =
+        base.dynamic_cast_ptr<XCamSoftTasks::DcpDarkChannelTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    SmartPtr<XCamSoftTasks::DcpMinFilterTask::Args> next = new XCamSoftTasks::DcpMinFilterTask::Args (param);
+    next->in_luma = args->in_luma;
+    next->maps = args->maps;
+    update_atmos ((args->atmos->dark >= 0) ? args->atmos->rgb : NULL, next->atmos);
+
+    XCamReturn ret = _min_filter_task->work (next);
+    if (!xcam_ret_is_ok (ret)) {
+        work_broken (param, ret);
+    }
+}
+
+void
+SoftDefogDcpHandler::min_filter_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _min_filter_task.ptr ());
+
+    SmartPtr<XCamSoftTasks::DcpMinFilterTask::Args> args =
+        base.dynamic_cast_ptr<XCamSoftTasks::DcpMinFilterTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    SmartPtr<XCamSoftTasks::DcpGuideArgs> next = new XCamSoftTasks::DcpGuideArgs (param);
+    next->in_luma = args->in_luma;
+    next->maps = args->maps;
+    next->radius = DCP_GUIDE_RADIUS;
+    next->eps = DCP_GUIDE_EPS;
+    next->atmos[0] = args->atmos[0];
+    next->atmos[1] = args->atmos[1];
+    next->atmos[2] = args->atmos[2];
+
+    XCamReturn ret = _guide_coeff_task->work (next);
+    if (!xcam_ret_is_ok (ret)) {
+        work_broken (param, ret);
+    }
+}
+
+void
+SoftDefogDcpHandler::guide_coeff_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _guide_coeff_task.ptr ());
+
+    SmartPtr<XCamSoftTasks::DcpGuideArgs> args = base.dynamic_cast_ptr<XCamSoftTasks::DcpGuideArgs> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    // same args, means need all coefficients of the window
+    XCamReturn ret = _guide_mean_task->work (args);
+    if (!xcam_ret_is_ok (ret)) {
+        work_broken (param, ret);
+    }
+}
+
+void
+SoftDefogDcpHandler::guide_mean_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _guide_mean_task.ptr ());
+
+    SmartPtr<XCamSoftTasks::DcpGuideArgs> args = base.dynamic_cast_ptr<XCamSoftTasks::DcpGuideArgs> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    SmartPtr<XCamSoftTasks::DcpRecoverTask::Args> next = new XCamSoftTasks::DcpRecoverTask::Args (param);
+    next->in_luma = args->in_luma;
+    next->in_uv = new Uchar2Image (param->in_buf, 1);
+    next->out_luma = new UcharImage (param->out_buf, 0);
+    next->out_uv = new Uchar2Image (param->out_buf, 1);
+    next->coeff_a = args->maps->mean_a;
+    next->coeff_b = args->maps->mean_b;
+    next->atmos[0] = args->atmos[0];
+    next->atmos[1] = args->atmos[1];
+    next->atmos[2] = args->atmos[2];
+
+    XCamReturn ret = _recover_task->work (next);
+    if (!xcam_ret_is_ok (ret)) {
+        work_broken (param, ret);
+    }
+}
+
+void
+SoftDefogDcpHandler::recover_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _recover_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    work_well_done (param, error);
+}
+
+XCamReturn
+SoftDefogDcpHandler::terminate ()
+{
+    if (_dark_channel_task.ptr ()) {
+        _dark_channel_task->stop ();
+        _dark_channel_task.release ();
+    }
+    if (_min_filter_task.ptr ()) {
+        _min_filter_task->stop ();
+        _min_filter_task.release ();
+    }
+    if (_guide_coeff_task.ptr ()) {
+        _guide_coeff_task->stop ();
+        _guide_coeff_task.release ();
+    }
+    if (_guide_mean_task.ptr ()) {
+        _guide_mean_task->stop ();
+        _guide_mean_task.release ();
+    }
+    if (_recover_task.ptr ()) {
+        _recover_task->stop ();
+        _recover_task.release ();
+    }
+    if (_maps_pool.ptr ()) {
+        _maps_pool->stop ();
+        _maps_pool.release ();
+    }
+
+    return SoftHandler::terminate ();
+}
+
+SmartPtr<SoftHandler>
+create_soft_defog_dcp_handler ()
+{
+    SmartPtr<SoftDefogDcpHandler> defog = new SoftDefogDcpHandler ();
+    XCAM_ASSERT (defog.ptr ());
+
+    return defog;
+}
+
+}
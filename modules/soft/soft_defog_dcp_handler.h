@@ -0,0 +1,94 @@
+/*
+ * soft_defog_dcp_handler.h - soft dark channel prior defog handler class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_DEFOG_DCP_HANDLER_H
+#define XCAM_SOFT_DEFOG_DCP_HANDLER_H
+
+#include <xcam_std.h>
+#include <soft/soft_handler.h>
+#include <buffer_pool.h>
+
+namespace XCam {
+
+class SoftWorker;
+
+/* dark channel prior defog on NV12 in five passes.
+ * pass 1: dark channel and horizontal van Herk/Gil-Werman min filter.
+ * pass 2: vertical min filter, downscales dark channel and luma guide.
+ * pass 3, 4: guided filter coefficients and their means on the small maps.
+ * pass 5: upsamples guided filter result into transmission, recovers radiance.
+ * dark channel and guided filter maps of each frame come from a small pool,
+ * only atmospheric light is kept on handler, sampled from a few lines each frame
+ * and smoothed over frames, each frame recovers with a copy taken after its pass 1.
+ */
+class SoftDefogDcpHandler
+    : public SoftHandler
+{
+public:
+    explicit SoftDefogDcpHandler (const char *name = "SoftDefogDcpHandler");
+    ~SoftDefogDcpHandler ();
+
+    XCamReturn defog (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+
+    void dark_channel_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+    void min_filter_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+    void guide_coeff_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+    void guide_mean_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+    void recover_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    void update_atmos (const float *rgb, float *atmos);
+    void set_work_size (const SmartPtr<SoftWorker> &worker, uint32_t height);
+
+    XCAM_DEAD_COPY (SoftDefogDcpHandler);
+
+private:
+    SmartPtr<SoftWorker>        _dark_channel_task;
+    SmartPtr<SoftWorker>        _min_filter_task;
+    SmartPtr<SoftWorker>        _guide_coeff_task;
+    SmartPtr<SoftWorker>        _guide_mean_task;
+    SmartPtr<SoftWorker>        _recover_task;
+
+    SmartPtr<BufferPool>        _maps_pool;
+
+    Mutex                       _atmos_mutex;
+    float                       _atmos[3];
+    bool                        _atmos_valid;
+    uint32_t                    _frame_count;
+};
+
+extern SmartPtr<SoftHandler> create_soft_defog_dcp_handler ();
+
+}
+
+#endif //XCAM_SOFT_DEFOG_DCP_HANDLER_H
@@ -0,0 +1,538 @@
+/*
+ * soft_defog_dcp_tasks_priv.cpp - soft dark channel prior defog tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_defog_dcp_tasks_priv.h"
+#include <vector>
+#include <math.h>
+
+// same as kernel_defog_recover
+#define DCP_TRANSMIT_COEFF 0.95f
+#define DCP_MIN_TRANSMIT 0.1f
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+// rgb = clamp (y + offset), offsets are shared by 2x2 pixels of one uv pair
+static inline void
+get_rgb_offset (const Uchar2 &uv, float *offset)
+{
+    const float u = uv.x - 128.0f;
+    const float v = uv.y - 128.0f;
+    offset[0] = -0.001f * u + 1.402f * v;
+    offset[1] = -0.344f * u - 0.714f * v;
+    offset[2] = 1.772f * u + 0.001f * v;
+}
+
+static inline void
+yuv_to_rgb (float y, const float *offset, float *rgb)
+{
+    rgb[0] = XCAM_CLAMP (y + offset[0], 0.0f, 255.0f);
+    rgb[1] = XCAM_CLAMP (y + offset[1], 0.0f, 255.0f);
+    rgb[2] = XCAM_CLAMP (y + offset[2], 0.0f, 255.0f);
+}
+
+/* van Herk/Gil-Werman running min, O(1) per pixel for any radius.
+ * @ext holds @count values, split into blocks of window size, @prefix and @suffix
+ * get min from block start and to block end, window [i, i + window) is
+ * min (suffix[i], prefix[i + window - 1]).
+ */
+static void
+block_min_scan (const uint8_t *ext, uint32_t count, uint32_t window, uint8_t *prefix, uint8_t *suffix)
+{
+    for (uint32_t start = 0; start < count; start += window) {
+        const uint32_t end = XCAM_MIN (start + window, count);
+        prefix[start] = ext[start];
+        for (uint32_t i = start + 1; i < end; ++i)
+            prefix[i] = XCAM_MIN (prefix[i - 1], ext[i]);
+
+        suffix[end - 1] = ext[end - 1];
+        for (uint32_t i = end - 1; i > start; --i)
+            suffix[i - 1] = XCAM_MIN (suffix[i], ext[i - 1]);
+    }
+}
+
+static void
+min_filter_line (
+    const uint8_t *ext, uint32_t width, uint32_t radius,
+    uint8_t *prefix, uint8_t *suffix, uint8_t *out)
+{
+    const uint32_t window = radius * 2 + 1;
+    block_min_scan (ext, width + radius * 2, window, prefix, suffix);
+    for (uint32_t x = 0; x < width; ++x)
+        out[x] = XCAM_MIN (suffix[x], prefix[x + window - 1]);
+}
+
+// full resolution dark channel, then six low resolution float maps, one after another
+static void
+get_maps_layout (
+    uint32_t width, uint32_t height,
+    uint32_t &dark_pitch, uint32_t &low_width, uint32_t &low_height, uint32_t &low_pitch)
+{
+    dark_pitch = XCAM_ALIGN_UP (width, 16);
+    low_width = xcam_ceil (width, XCAM_SOFT_DCP_GUIDE_SCALE) / XCAM_SOFT_DCP_GUIDE_SCALE;
+    low_height = xcam_ceil (height, XCAM_SOFT_DCP_GUIDE_SCALE) / XCAM_SOFT_DCP_GUIDE_SCALE;
+    low_pitch = XCAM_ALIGN_UP (low_width * sizeof (float), 16);
+}
+
+void
+DcpMaps::get_buf_info (VideoBufferInfo &info, uint32_t width, uint32_t height)
+{
+    uint32_t dark_pitch, low_width, low_height, low_pitch;
+    get_maps_layout (width, height, dark_pitch, low_width, low_height, low_pitch);
+
+    const uint32_t lines = height + xcam_ceil (low_pitch * low_height * 6, dark_pitch) / dark_pitch;
+    info.init (V4L2_PIX_FMT_GREY, dark_pitch, lines, dark_pitch, lines);
+}
+
+bool
+DcpMaps::init (const SmartPtr<VideoBuffer> &buf, uint32_t width, uint32_t height)
+{
+    XCAM_ASSERT (buf.ptr ());
+    uint32_t dark_pitch, low_width, low_height, low_pitch;
+    get_maps_layout (width, height, dark_pitch, low_width, low_height, low_pitch);
+
+    const uint32_t low_offset = dark_pitch * height;
+    const uint32_t low_size = low_pitch * low_height;
+    XCAM_FAIL_RETURN (
+        ERROR, buf->get_video_info ().size >= low_offset + low_size * 6, false,
+        "DcpMaps buffer is too small for %dx%d", width, height);
+    XCAM_FAIL_RETURN (ERROR, buf->map (), false, "DcpMaps map buffer failed");
+
+    dark = new UcharImage (buf, width, height, dark_pitch);
+    guide_low = new FloatImage (buf, low_width, low_height, low_pitch, low_offset);
+    dark_low = new FloatImage (buf, low_width, low_height, low_pitch, low_offset + low_size);
+    coeff_a = new FloatImage (buf, low_width, low_height, low_pitch, low_offset + low_size * 2);
+    coeff_b = new FloatImage (buf, low_width, low_height, low_pitch, low_offset + low_size * 3);
+    mean_a = new FloatImage (buf, low_width, low_height, low_pitch, low_offset + low_size * 4);
+    mean_b = new FloatImage (buf, low_width, low_height, low_pitch, low_offset + low_size * 5);
+    return true;
+}
+
+XCamReturn
+DcpDarkChannelTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<DcpDarkChannelTask::Args> args = base.dynamic_cast_ptr<DcpDarkChannelTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    UcharImage *in_luma = args->in_luma.ptr (), *dark = args->maps->dark.ptr ();
+    Uchar2Image *in_uv = args->in_uv.ptr ();
+    XCAM_ASSERT (in_luma && in_uv && dark);
+
+    const uint32_t radius = XCAM_SOFT_DCP_PATCH_RADIUS;
+    const uint32_t width = in_luma->get_width ();
+    const uint32_t height = in_luma->get_height ();
+    const uint32_t ext_size = width + radius * 2;
+    std::vector<uint8_t> ext (ext_size), prefix (ext_size), suffix (ext_size);
+    // min (r, g, b) - y of each uv pair
+    std::vector<int16_t> dark_offset (width / 2);
+
+    int32_t best_dark = -1;
+    uint32_t best_x = 0, best_y = 0;
+    float offset[3], rgb[3];
+
+    for (uint32_t uv_y = range.pos[1]; uv_y < range.pos[1] + range.pos_len[1]; ++uv_y) {
+        const Uchar2 *uv = in_uv->get_buf_ptr (0, uv_y);
+        const bool sample = (uv_y % args->sample_step == args->sample_phase);
+
+        for (uint32_t x = 0; x < width / 2; ++x) {
+            get_rgb_offset (uv[x], offset);
+            dark_offset[x] = (int16_t)floorf (XCAM_MIN (XCAM_MIN (offset[0], offset[1]), offset[2]));
+        }
+
+        for (uint32_t y = uv_y * 2; y < XCAM_MIN (uv_y * 2 + 2, height); ++y) {
+            const Uchar *luma = in_luma->get_buf_ptr (0, y);
+            for (uint32_t x = 0; x < width; ++x) {
+                const int32_t dark_value = luma[x] + dark_offset[x / 2];
+                ext[x + radius] = (uint8_t)XCAM_CLAMP (dark_value, 0, 255);
+            }
+            memset (&ext[0], ext[radius], radius);
+            memset (&ext[width + radius], ext[width + radius - 1], radius);
+
+            uint8_t *out = dark->get_buf_ptr (0, y);
+            min_filter_line (&ext[0], width, radius, &prefix[0], &suffix[0], out);
+
+            if (!sample)
+                continue;
+            for (uint32_t x = 0; x < width; ++x) {
+                if (out[x] > best_dark) {
+                    best_dark = out[x];
+                    best_x = x;
+                    best_y = y;
+                }
+            }
+        }
+    }
+
+    if (best_dark >= 0) {
+        get_rgb_offset (in_uv->read_data_no_check (best_x / 2, best_y / 2), offset);
+        yuv_to_rgb (in_luma->read_data_no_check (best_x, best_y), offset, rgb);
+
+        DcpAtmosCandidate *atmos = args->atmos.ptr ();
+        XCAM_ASSERT (atmos);
+        SmartLock locker (atmos->mutex);
+        if (best_dark > atmos->dark) {
+            atmos->dark = best_dark;
+            atmos->rgb[0] = rgb[0];
+            atmos->rgb[1] = rgb[1];
+            atmos->rgb[2] = rgb[2];
+        }
+    }
+
+    XCAM_LOG_DEBUG ("DcpDarkChannelTask work on range:[y:%d, len:%d]", range.pos[1], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+DcpMinFilterTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<DcpMinFilterTask::Args> args = base.dynamic_cast_ptr<DcpMinFilterTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    UcharImage *in_luma = args->in_luma.ptr (), *dark = args->maps->dark.ptr ();
+    FloatImage *guide_low = args->maps->guide_low.ptr (), *dark_low = args->maps->dark_low.ptr ();
+    XCAM_ASSERT (in_luma && dark && guide_low && dark_low);
+
+    const uint32_t radius = XCAM_SOFT_DCP_PATCH_RADIUS;
+    const uint32_t window = radius * 2 + 1;
+    const uint32_t scale = XCAM_SOFT_DCP_GUIDE_SCALE;
+    const uint32_t width = dark->get_width ();
+    const int32_t height = dark->get_height ();
+    const uint32_t low_width = dark_low->get_width ();
+
+    const int32_t y_start = range.pos[1] * scale;
+    const int32_t y_end = XCAM_MIN ((range.pos[1] + range.pos_len[1]) * scale, (uint32_t)height);
+    const uint32_t count = (y_end - y_start) + radius * 2;
+
+    // vertical running min over whole columns of this band, rows clamped to image
+    std::vector<const uint8_t *> ext (count);
+    std::vector<uint8_t> prefix (count * width), suffix (count * width);
+    for (uint32_t i = 0; i < count; ++i) {
+        int32_t y = XCAM_CLAMP (y_start - (int32_t)radius + (int32_t)i, 0, height - 1);
+        ext[i] = dark->get_buf_ptr (0, y);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t *p = &prefix[i * width];
+        const uint8_t *e = ext[i];
+        if (i % window) {
+            const uint8_t *last = &prefix[(i - 1) * width];
+            for (uint32_t x = 0; x < width; ++x)
+                p[x] = XCAM_MIN (last[x], e[x]);
+        } else
+            memcpy (p, e, width);
+    }
+    for (int32_t i = (int32_t)count - 1; i >= 0; --i) {
+        uint8_t *s = &suffix[i * width];
+        const uint8_t *e = ext[i];
+        if (i != (int32_t)count - 1 && (i + 1) % window) {
+            const uint8_t *next = &suffix[(i + 1) * width];
+            for (uint32_t x = 0; x < width; ++x)
+                s[x] = XCAM_MIN (next[x], e[x]);
+        } else
+            memcpy (s, e, width);
+    }
+
+    // column sums of each block line, then sums of each block
+    std::vector<uint16_t> dark_sum (width), luma_sum (width);
+    for (uint32_t ly = range.pos[1]; ly < range.pos[1] + range.pos_len[1]; ++ly) {
+        const int32_t y0 = ly * scale;
+        const int32_t y1 = XCAM_MIN (y0 + (int32_t)scale, y_end);
+        std::fill (dark_sum.begin (), dark_sum.end (), 0);
+        std::fill (luma_sum.begin (), luma_sum.end (), 0);
+
+        for (int32_t y = y0; y < y1; ++y) {
+            const uint8_t *s = &suffix[(y - y_start) * width];
+            const uint8_t *p = &prefix[(y - y_start + window - 1) * width];
+            const Uchar *luma = in_luma->get_buf_ptr (0, y);
+            for (uint32_t x = 0; x < width; ++x) {
+                dark_sum[x] += XCAM_MIN (s[x], p[x]);
+                luma_sum[x] += luma[x];
+            }
+        }
+
+        float *dark_out = dark_low->get_buf_ptr (0, ly);
+        float *guide_out = guide_low->get_buf_ptr (0, ly);
+        for (uint32_t lx = 0; lx < low_width; ++lx) {
+            const uint32_t x0 = lx * scale;
+            const uint32_t x1 = XCAM_MIN (x0 + scale, width);
+            uint32_t dark_block = 0, luma_block = 0;
+            for (uint32_t x = x0; x < x1; ++x) {
+                dark_block += dark_sum[x];
+                luma_block += luma_sum[x];
+            }
+            const float norm = 1.0f / ((x1 - x0) * (y1 - y0) * 255.0f);
+            dark_out[lx] = dark_block * norm;
+            guide_out[lx] = luma_block * norm;
+        }
+    }
+
+    XCAM_LOG_DEBUG ("DcpMinFilterTask work on range:[y:%d, len:%d]", range.pos[1], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+// bilinear position on downscaled maps
+struct LowPos {
+    uint32_t    p0, p1;
+    float       w1;
+};
+
+static inline void
+get_low_pos (uint32_t pos, uint32_t low_size, LowPos &low)
+{
+    float f = (pos + 0.5f) / XCAM_SOFT_DCP_GUIDE_SCALE - 0.5f;
+    f = XCAM_CLAMP (f, 0.0f, low_size - 1.0f);
+    low.p0 = (uint32_t)f;
+    low.p1 = XCAM_MIN (low.p0 + 1, low_size - 1);
+    low.w1 = f - low.p0;
+}
+
+XCamReturn
+DcpRecoverTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<DcpRecoverTask::Args> args = base.dynamic_cast_ptr<DcpRecoverTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    UcharImage *in_luma = args->in_luma.ptr (), *out_luma = args->out_luma.ptr ();
+    Uchar2Image *in_uv = args->in_uv.ptr (), *out_uv = args->out_uv.ptr ();
+    FloatImage *coeff_a = args->coeff_a.ptr (), *coeff_b = args->coeff_b.ptr ();
+    XCAM_ASSERT (in_luma && out_luma && in_uv && out_uv && coeff_a && coeff_b);
+
+    const uint32_t width = in_luma->get_width ();
+    const uint32_t height = in_luma->get_height ();
+    const uint32_t low_width = coeff_a->get_width ();
+    const uint32_t low_height = coeff_a->get_height ();
+    const float *atmos = args->atmos;
+    const float atmos_max = XCAM_MAX (XCAM_MAX (atmos[0], atmos[1]), atmos[2]);
+    const float transmit_scale = DCP_TRANSMIT_COEFF * 255.0f / atmos_max;
+
+    std::vector<LowPos> low_x (width);
+    for (uint32_t x = 0; x < width; ++x)
+        get_low_pos (x, low_width, low_x[x]);
+
+    std::vector<float> line_a (low_width), line_b (low_width), refined (width);
+    std::vector<float> rgb_offset (width / 2 * 3);
+    // recovered rgb planes of two lines
+    std::vector<float> rgb_lines (width * 3 * 2);
+
+    for (uint32_t uv_y = range.pos[1]; uv_y < range.pos[1] + range.pos_len[1]; ++uv_y) {
+        const Uchar2 *uv = in_uv->get_buf_ptr (0, uv_y);
+        const uint32_t y_end = XCAM_MIN (uv_y * 2 + 2, height);
+        for (uint32_t x = 0; x < width / 2; ++x)
+            get_rgb_offset (uv[x], &rgb_offset[x * 3]);
+
+        for (uint32_t y = uv_y * 2; y < y_end; ++y) {
+            // refined dark channel of this line, vertical interpolation first
+            LowPos low_y;
+            get_low_pos (y, low_height, low_y);
+            const float *a0 = coeff_a->get_buf_ptr (0, low_y.p0), *a1 = coeff_a->get_buf_ptr (0, low_y.p1);
+            const float *b0 = coeff_b->get_buf_ptr (0, low_y.p0), *b1 = coeff_b->get_buf_ptr (0, low_y.p1);
+            for (uint32_t lx = 0; lx < low_width; ++lx) {
+                line_a[lx] = a0[lx] + (a1[lx] - a0[lx]) * low_y.w1;
+                line_b[lx] = b0[lx] + (b1[lx] - b0[lx]) * low_y.w1;
+            }
+
+            const Uchar *luma = in_luma->get_buf_ptr (0, y);
+            for (uint32_t x = 0; x < width; ++x) {
+                const LowPos &px = low_x[x];
+                const float a = line_a[px.p0] + (line_a[px.p1] - line_a[px.p0]) * px.w1;
+                const float b = line_b[px.p0] + (line_b[px.p1] - line_b[px.p0]) * px.w1;
+                refined[x] = a * (luma[x] / 255.0f) + b;
+            }
+
+            float *r = &rgb_lines[(y - uv_y * 2) * width * 3];
+            float *g = r + width, *b = g + width;
+            Uchar *luma_out = out_luma->get_buf_ptr (0, y);
+            for (uint32_t x = 0; x < width; ++x) {
+                const float transmit = XCAM_MAX (1.0f - transmit_scale * refined[x], DCP_MIN_TRANSMIT);
+                const float inv_transmit = 1.0f / transmit;
+                const float *offset = &rgb_offset[x / 2 * 3];
+                r[x] = atmos[0] + (XCAM_CLAMP (luma[x] + offset[0], 0.0f, 255.0f) - atmos[0]) * inv_transmit;
+                g[x] = atmos[1] + (XCAM_CLAMP (luma[x] + offset[1], 0.0f, 255.0f) - atmos[1]) * inv_transmit;
+                b[x] = atmos[2] + (XCAM_CLAMP (luma[x] + offset[2], 0.0f, 255.0f) - atmos[2]) * inv_transmit;
+                luma_out[x] = convert_to_uchar (0.299f * r[x] + 0.587f * g[x] + 0.114f * b[x]);
+            }
+        }
+
+        // uv from average rgb of each 2x2 block
+        const uint32_t lines = y_end - uv_y * 2;
+        const float *r0 = &rgb_lines[0], *g0 = r0 + width, *b0 = g0 + width;
+        const float *r1 = (lines > 1) ? b0 + width : r0, *g1 = r1 + width, *b1 = g1 + width;
+        Uchar2 *uv_out = out_uv->get_buf_ptr (0, uv_y);
+        for (uint32_t x = 0; x < width / 2; ++x) {
+            const uint32_t i = x * 2;
+            const float r = (r0[i] + r0[i + 1] + r1[i] + r1[i + 1]) * 0.25f;
+            const float g = (g0[i] + g0[i + 1] + g1[i] + g1[i + 1]) * 0.25f;
+            const float b = (b0[i] + b0[i + 1] + b1[i] + b1[i + 1]) * 0.25f;
+            uv_out[x].x = convert_to_uchar (-0.169f * r - 0.331f * g + 0.5f * b + 128.0f);
+            uv_out[x].y = convert_to_uchar (0.5f * r - 0.419f * g - 0.081f * b + 128.0f);
+        }
+    }
+
+    XCAM_LOG_DEBUG ("DcpRecoverTask work on range:[y:%d, len:%d]", range.pos[1], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+// means over [x - radius, x + radius] clipped to line of column sums @col over @rows lines
+static void
+window_mean_line (
+    const std::vector<float> &col, uint32_t radius, uint32_t rows, std::vector<double> &sums, float *mean)
+{
+    const uint32_t width = col.size ();
+    sums[0] = 0.0;
+    for (uint32_t x = 0; x < width; ++x)
+        sums[x + 1] = sums[x] + col[x];
+
+    for (uint32_t x = 0; x < width; ++x) {
+        const uint32_t x0 = (x > radius) ? x - radius : 0;
+        const uint32_t x1 = XCAM_MIN (x + radius + 1, width);
+        mean[x] = (float)((sums[x1] - sums[x0]) / ((x1 - x0) * rows));
+    }
+}
+
+// adds lines [y0, y1) of @map into column sums @col, or subtracts them if @sign is negative
+static void
+slide_lines (const FloatImage &map, uint32_t y0, uint32_t y1, float sign, std::vector<float> &col)
+{
+    const uint32_t width = col.size ();
+    for (uint32_t y = y0; y < y1; ++y) {
+        const float *line = map.get_buf_ptr (0, y);
+        for (uint32_t x = 0; x < width; ++x)
+            col[x] += sign * line[x];
+    }
+}
+
+// same as slide_lines on guide, source and their products
+static void
+slide_guide_lines (
+    const FloatImage &guide, const FloatImage &src, uint32_t y0, uint32_t y1, float sign,
+    std::vector<float> &col_i, std::vector<float> &col_p, std::vector<float> &col_ip, std::vector<float> &col_ii)
+{
+    const uint32_t width = col_i.size ();
+    for (uint32_t y = y0; y < y1; ++y) {
+        const float *i_line = guide.get_buf_ptr (0, y);
+        const float *p_line = src.get_buf_ptr (0, y);
+        for (uint32_t x = 0; x < width; ++x) {
+            const float i = sign * i_line[x];
+            col_i[x] += i;
+            col_p[x] += sign * p_line[x];
+            col_ip[x] += i * p_line[x];
+            col_ii[x] += i * i_line[x];
+        }
+    }
+}
+
+XCamReturn
+DcpGuideCoeffTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<DcpGuideArgs> args = base.dynamic_cast_ptr<DcpGuideArgs> ();
+    XCAM_ASSERT (args.ptr ());
+    const DcpMaps *maps = args->maps.ptr ();
+    FloatImage *guide = maps->guide_low.ptr (), *src = maps->dark_low.ptr ();
+    FloatImage *coeff_a = maps->coeff_a.ptr (), *coeff_b = maps->coeff_b.ptr ();
+    XCAM_ASSERT (guide && src && coeff_a && coeff_b);
+
+    const uint32_t width = guide->get_width ();
+    const uint32_t height = guide->get_height ();
+    const uint32_t radius = args->radius;
+    const float eps = args->eps;
+
+    std::vector<float> col_i (width), col_p (width), col_ip (width), col_ii (width);
+    std::vector<float> mean_i (width), mean_p (width), mean_ip (width), mean_ii (width);
+    std::vector<double> sums (width + 1);
+    // column sums of window [win0, win1) slide down with lines
+    uint32_t win0 = 0, win1 = 0;
+
+    for (uint32_t y = range.pos[1]; y < range.pos[1] + range.pos_len[1]; ++y) {
+        const uint32_t y0 = (y > radius) ? y - radius : 0;
+        const uint32_t y1 = XCAM_MIN (y + radius + 1, height);
+        if (y == range.pos[1]) {
+            slide_guide_lines (*guide, *src, y0, y1, 1.0f, col_i, col_p, col_ip, col_ii);
+        } else {
+            slide_guide_lines (*guide, *src, win1, y1, 1.0f, col_i, col_p, col_ip, col_ii);
+            slide_guide_lines (*guide, *src, win0, y0, -1.0f, col_i, col_p, col_ip, col_ii);
+        }
+        win0 = y0;
+        win1 = y1;
+
+        window_mean_line (col_i, radius, y1 - y0, sums, &mean_i[0]);
+        window_mean_line (col_p, radius, y1 - y0, sums, &mean_p[0]);
+        window_mean_line (col_ip, radius, y1 - y0, sums, &mean_ip[0]);
+        window_mean_line (col_ii, radius, y1 - y0, sums, &mean_ii[0]);
+
+        float *a = coeff_a->get_buf_ptr (0, y);
+        float *b = coeff_b->get_buf_ptr (0, y);
+        for (uint32_t x = 0; x < width; ++x) {
+            const float cov = mean_ip[x] - mean_i[x] * mean_p[x];
+            const float var = mean_ii[x] - mean_i[x] * mean_i[x];
+            a[x] = cov / (var + eps);
+            b[x] = mean_p[x] - a[x] * mean_i[x];
+        }
+    }
+
+    XCAM_LOG_DEBUG ("DcpGuideCoeffTask work on range:[y:%d, len:%d]", range.pos[1], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+DcpGuideMeanTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<DcpGuideArgs> args = base.dynamic_cast_ptr<DcpGuideArgs> ();
+    XCAM_ASSERT (args.ptr ());
+    const DcpMaps *maps = args->maps.ptr ();
+    FloatImage *coeff_a = maps->coeff_a.ptr (), *coeff_b = maps->coeff_b.ptr ();
+    FloatImage *mean_a = maps->mean_a.ptr (), *mean_b = maps->mean_b.ptr ();
+    XCAM_ASSERT (coeff_a && coeff_b && mean_a && mean_b);
+
+    const uint32_t width = coeff_a->get_width ();
+    const uint32_t height = coeff_a->get_height ();
+    const uint32_t radius = args->radius;
+
+    std::vector<float> col_a (width), col_b (width);
+    std::vector<double> sums (width + 1);
+    uint32_t win0 = 0, win1 = 0;
+
+    for (uint32_t y = range.pos[1]; y < range.pos[1] + range.pos_len[1]; ++y) {
+        const uint32_t y0 = (y > radius) ? y - radius : 0;
+        const uint32_t y1 = XCAM_MIN (y + radius + 1, height);
+        if (y == range.pos[1]) {
+            slide_lines (*coeff_a, y0, y1, 1.0f, col_a);
+            slide_lines (*coeff_b, y0, y1, 1.0f, col_b);
+        } else {
+            slide_lines (*coeff_a, win1, y1, 1.0f, col_a);
+            slide_lines (*coeff_b, win1, y1, 1.0f, col_b);
+            slide_lines (*coeff_a, win0, y0, -1.0f, col_a);
+            slide_lines (*coeff_b, win0, y0, -1.0f, col_b);
+        }
+        win0 = y0;
+        win1 = y1;
+
+        window_mean_line (col_a, radius, y1 - y0, sums, mean_a->get_buf_ptr (0, y));
+        window_mean_line (col_b, radius, y1 - y0, sums, mean_b->get_buf_ptr (0, y));
+    }
+
+    XCAM_LOG_DEBUG ("DcpGuideMeanTask work on range:[y:%d, len:%d]", range.pos[1], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+}
+
+}
@@ -0,0 +1,216 @@
+/*
+ * soft_defog_dcp_tasks_priv.h - soft dark channel prior defog tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_DEFOG_DCP_TASKS_PRIV_H
+#define XCAM_SOFT_DEFOG_DCP_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_handler.h>
+
+// patch radius of dark channel min filter, same as kernel_min_filter
+#define XCAM_SOFT_DCP_PATCH_RADIUS 8
+// guided filter runs on maps downscaled by this factor
+#define XCAM_SOFT_DCP_GUIDE_SCALE 4
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+// brightest dark channel pixel found on sampled rows of one frame
+struct DcpAtmosCandidate {
+    Mutex       mutex;
+    int32_t     dark;
+    float       rgb[3];
+
+    DcpAtmosCandidate () : dark (-1) {
+        rgb[0] = rgb[1] = rgb[2] = 0.0f;
+    }
+};
+
+// dark channel and guided filter maps of one frame, views of one pool buffer
+struct DcpMaps {
+    SmartPtr<UcharImage>        dark;
+    SmartPtr<FloatImage>        guide_low;
+    SmartPtr<FloatImage>        dark_low;
+    SmartPtr<FloatImage>        coeff_a;
+    SmartPtr<FloatImage>        coeff_b;
+    SmartPtr<FloatImage>        mean_a;
+    SmartPtr<FloatImage>        mean_b;
+
+    bool init (const SmartPtr<VideoBuffer> &buf, uint32_t width, uint32_t height);
+
+    // pool buffer info of maps of @width x @height frame, described as bytes
+    static void get_buf_info (VideoBufferInfo &info, uint32_t width, uint32_t height);
+};
+
+/* pass 1, one work item is one uv line and its two luma lines.
+ * converts to RGB, takes per-pixel dark channel and runs horizontal min filter.
+ * rows with (uv_y % sample_step == sample_phase) also look for atmospheric light.
+ */
+class DcpDarkChannelTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>            in_luma;
+        SmartPtr<Uchar2Image>           in_uv;
+        SmartPtr<DcpMaps>               maps;
+        SmartPtr<DcpAtmosCandidate>     atmos;
+        uint32_t                        sample_step;
+        uint32_t                        sample_phase;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+            , sample_step (1)
+            , sample_phase (0)
+        {}
+    };
+
+public:
+    explicit DcpDarkChannelTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("DcpDarkChannelTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+/* pass 2, one work item is one line of downscaled maps.
+ * runs vertical min filter on dark channel, then averages dark channel and
+ * luma guide over XCAM_SOFT_DCP_GUIDE_SCALE square blocks, both normalized to [0, 1].
+ */
+class DcpMinFilterTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>            in_luma;
+        SmartPtr<DcpMaps>               maps;
+        float                           atmos[3];
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {
+            atmos[0] = atmos[1] = atmos[2] = 255.0f;
+        }
+    };
+
+public:
+    explicit DcpMinFilterTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("DcpMinFilterTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+/* pass 3 and 4 run guided filter on downscaled maps, one work item is one line.
+ * box filters of @radius are clipped to the maps.
+ * pass 3 gets linear coefficients coeff_a, coeff_b of dark_low by guide_low.
+ * pass 4 averages them into mean_a, mean_b, refined = mean_a * guide + mean_b.
+ */
+struct DcpGuideArgs : SoftArgs {
+    SmartPtr<UcharImage>            in_luma;
+    SmartPtr<DcpMaps>               maps;
+    uint32_t                        radius;
+    float                           eps;
+    float                           atmos[3];
+
+    DcpGuideArgs (
+        const SmartPtr<ImageHandler::Parameters> &param)
+        : SoftArgs (param)
+        , radius (1)
+        , eps (0.001f)
+    {
+        atmos[0] = atmos[1] = atmos[2] = 255.0f;
+    }
+};
+
+class DcpGuideCoeffTask
+    : public SoftWorker
+{
+public:
+    typedef DcpGuideArgs Args;
+
+public:
+    explicit DcpGuideCoeffTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("DcpGuideCoeffTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+class DcpGuideMeanTask
+    : public SoftWorker
+{
+public:
+    typedef DcpGuideArgs Args;
+
+public:
+    explicit DcpGuideMeanTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("DcpGuideMeanTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+/* pass 5, one work item is one uv line and its two luma lines.
+ * upsamples guided filter coefficients, refines dark channel by luma guide
+ * into transmission and recovers scene radiance.
+ */
+class DcpRecoverTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>            in_luma, out_luma;
+        SmartPtr<Uchar2Image>           in_uv, out_uv;
+        SmartPtr<FloatImage>            coeff_a;
+        SmartPtr<FloatImage>            coeff_b;
+        float                           atmos[3];
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {
+            atmos[0] = atmos[1] = atmos[2] = 255.0f;
+        }
+    };
+
+public:
+    explicit DcpRecoverTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("DcpRecoverTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+}
+
+}
+
+#endif //XCAM_SOFT_DEFOG_DCP_TASKS_PRIV_H
@@ -0,0 +1,198 @@
+/*
+ * soft_downscaler.cpp - soft NV12 area downscaler class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_downscaler.h"
+#include "soft_downscaler_tasks_priv.h"
+
+namespace XCam {
+
+DECLARE_WORK_CALLBACK (CbDownscaleTask, SoftDownscaler, downscale_task_done);
+
+static void
+init_positions (std::vector<uint32_t> &pos, uint32_t in_size, uint32_t out_size)
+{
+    pos.resize (out_size + 1);
+    for (uint32_t i = 0; i <= out_size; ++i)
+        pos[i] = (uint32_t)((uint64_t)i * in_size / out_size);
+}
+
+SoftDownscaler::SoftDownscaler (const char *name)
+    : SoftHandler (name)
+    , _out_width (0)
+    , _out_height (0)
+{
+}
+
+SoftDownscaler::~SoftDownscaler ()
+{
+}
+
+bool
+SoftDownscaler::set_output_size (uint32_t width, uint32_t height)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, width && height && !(width % 2) && !(height % 2), false,
+        "SoftDownscaler(%s) output size(%dx%d) need be even",
+        XCAM_STR (get_name ()), width, height);
+
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "SoftDownscaler(%s) output size can NOT be changed after configured",
+        XCAM_STR (get_name ()));
+
+    _out_width = width;
+    _out_height = height;
+    return true;
+}
+
+XCamReturn
+SoftDownscaler::scale (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in, out);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftDownscaler::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        ERROR, in_info.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftDownscaler(%s) only support format(NV12) but input format is %s",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (in_info.format));
+
+    XCAM_FAIL_RETURN (
+        ERROR, _out_width && _out_height, XCAM_RETURN_ERROR_PARAM,
+        "SoftDownscaler(%s) output size was not set", XCAM_STR (get_name ()));
+
+    XCAM_FAIL_RETURN (
+        ERROR,
+        _out_width <= in_info.width && _out_height <= in_info.height &&
+        in_info.width <= _out_width * XCAM_SOFT_DOWNSCALE_MAX_FACTOR &&
+        in_info.height <= _out_height * XCAM_SOFT_DOWNSCALE_MAX_FACTOR,
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftDownscaler(%s) can't scale %dx%d to %dx%d, factor need be in range [1, %d]",
+        XCAM_STR (get_name ()), in_info.width, in_info.height, _out_width, _out_height,
+        XCAM_SOFT_DOWNSCALE_MAX_FACTOR);
+
+    VideoBufferInfo out_info;
+    out_info.init (in_info.format, _out_width, _out_height);
+    set_out_video_info (out_info);
+
+    _table = new XCamSoftTasks::DownscaleTable;
+    XCAM_ASSERT (_table.ptr ());
+    init_positions (_table->luma_x, in_info.width, _out_width);
+    init_positions (_table->luma_y, in_info.height, _out_height);
+    init_positions (_table->uv_x, in_info.width / 2, _out_width / 2);
+    init_positions (_table->uv_y, in_info.height / 2, _out_height / 2);
+
+    XCAM_ASSERT (!_downscale_task.ptr ());
+    _downscale_task = new XCamSoftTasks::DownscaleNV12Task (new CbDownscaleTask (this));
+    XCAM_ASSERT (_downscale_task.ptr ());
+    share_threads (_downscale_task);
+
+    set_work_size (_out_height / 2);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftDownscaler::set_work_size (uint32_t uv_height)
+{
+    uint32_t thread_x = 1, thread_y = 4;
+
+    WorkSize global_size (1, uv_height);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    _downscale_task->set_local_size (local_size);
+    _downscale_task->set_global_size (global_size);
+}
+
+XCamReturn
+SoftDownscaler::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_downscale_task.ptr () && _table.ptr ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    SmartPtr<XCamSoftTasks::DownscaleNV12Task::Args> args = new XCamSoftTasks::DownscaleNV12Task::Args (param);
+    args->in_luma = new UcharImage (param->in_buf, 0);
+    args->in_uv = new Uchar2Image (param->in_buf, 1);
+    args->out_luma = new UcharImage (param->out_buf, 0);
+    args->out_uv = new Uchar2Image (param->out_buf, 1);
+    args->table = _table;
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = _downscale_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftDownscaler(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+XCamReturn
+SoftDownscaler::terminate ()
+{
+    if (_downscale_task.ptr ()) {
+        _downscale_task->stop ();
+        _downscale_task.release ();
+    }
+    return SoftHandler::terminate ();
+}
+
+void
+SoftDownscaler::downscale_task_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _downscale_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    work_well_done (param, error);
+}
+
+SmartPtr<SoftHandler>
+create_soft_downscaler (uint32_t width, uint32_t height)
+{
+    SmartPtr<SoftDownscaler> downscaler = new SoftDownscaler ();
+    XCAM_ASSERT (downscaler.ptr ());
+
+    if (!downscaler->set_output_size (width, height))
+        return NULL;
+
+    return downscaler;
+}
+
+}
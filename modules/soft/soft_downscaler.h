@@ -0,0 +1,83 @@
+/*
+ * soft_downscaler.h - soft NV12 area downscaler class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_DOWNSCALER_H
+#define XCAM_SOFT_DOWNSCALER_H
+
+#include <xcam_std.h>
+#include <soft/soft_handler.h>
+
+#define XCAM_SOFT_DOWNSCALE_MAX_FACTOR 64
+
+namespace XCam {
+
+class SoftWorker;
+
+namespace XCamSoftTasks {
+struct DownscaleTable;
+};
+
+/* box/area filter downscaler on NV12, each output pixel is the average of
+ * the source pixels it covers, output size can be any size not larger than input
+ */
+class SoftDownscaler
+    : public SoftHandler
+{
+public:
+    explicit SoftDownscaler (const char *name = "SoftDownscaler");
+    ~SoftDownscaler ();
+
+    // width and height need be even, can NOT be changed after configured
+    bool set_output_size (uint32_t width, uint32_t height);
+    void get_output_size (uint32_t &width, uint32_t &height) const {
+        width = _out_width;
+        height = _out_height;
+    }
+
+    XCamReturn scale (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+
+    void downscale_task_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    void set_work_size (uint32_t uv_height);
+
+    XCAM_DEAD_COPY (SoftDownscaler);
+
+private:
+    SmartPtr<SoftWorker>                        _downscale_task;
+    SmartPtr<XCamSoftTasks::DownscaleTable>     _table;
+    uint32_t                                    _out_width;
+    uint32_t                                    _out_height;
+};
+
+extern SmartPtr<SoftHandler> create_soft_downscaler (uint32_t width, uint32_t height);
+
+}
+
+#endif //XCAM_SOFT_DOWNSCALER_H
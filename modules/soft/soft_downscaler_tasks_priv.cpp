@@ -0,0 +1,182 @@
+/*
+ * soft_downscaler_tasks_priv.cpp - soft downscaler tasks
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_downscaler_tasks_priv.h"
+#include "soft_downscaler.h"
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+// add one source line into 16-bit column sums, boxes are at most 256 lines high
+static void
+accumulate_line (const uint8_t *src, uint32_t bytes, uint16_t *sums)
+{
+    uint32_t i = 0;
+
+#if defined (__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i pixels = _mm_loadu_si128 ((const __m128i *)(src + i));
+        __m128i lo = _mm_loadu_si128 ((const __m128i *)(sums + i));
+        __m128i hi = _mm_loadu_si128 ((const __m128i *)(sums + i + 8));
+        lo = _mm_add_epi16 (lo, _mm_unpacklo_epi8 (pixels, zero));
+        hi = _mm_add_epi16 (hi, _mm_unpackhi_epi8 (pixels, zero));
+        _mm_storeu_si128 ((__m128i *)(sums + i), lo);
+        _mm_storeu_si128 ((__m128i *)(sums + i + 8), hi);
+    }
+#endif
+
+    for (; i < bytes; ++i)
+        sums[i] += src[i];
+}
+
+// (n * recip) >> 40 equals n / area for n < 2^21 and area < 2^19
+#define DOWNSCALE_RECIP_SHIFT 40
+
+// average column sums over each output box, channels are interleaved
+template <uint32_t channels>
+static void
+reduce_line (
+    const uint16_t *sums, const uint32_t *pos_x, uint32_t out_width,
+    uint32_t rows, uint8_t *dst)
+{
+    // box widths differ by at most 1 pixel, cache reciprocal of each area
+    uint64_t recip[XCAM_SOFT_DOWNSCALE_MAX_FACTOR + 2];
+    xcam_mem_clear (recip);
+
+    for (uint32_t x = 0; x < out_width; ++x) {
+        const uint32_t x0 = pos_x[x];
+        const uint32_t x1 = pos_x[x + 1];
+        const uint32_t box = x1 - x0;
+        const uint32_t area = box * rows;
+        XCAM_ASSERT (box > 0 && box < XCAM_SOFT_DOWNSCALE_MAX_FACTOR + 2);
+
+        if (!recip[box])
+            recip[box] = (((uint64_t)1 << DOWNSCALE_RECIP_SHIFT) + area - 1) / area;
+
+        for (uint32_t c = 0; c < channels; ++c) {
+            uint32_t sum = area / 2;
+            for (uint32_t i = x0; i < x1; ++i)
+                sum += sums[i * channels + c];
+            dst[x * channels + c] = (uint8_t)((sum * recip[box]) >> DOWNSCALE_RECIP_SHIFT);
+        }
+    }
+}
+
+// uniform integer factor, box width is known at compile time
+template <uint32_t channels, uint32_t box>
+static void
+reduce_line_fixed (const uint16_t *sums, uint32_t out_width, uint32_t rows, uint8_t *dst)
+{
+    const uint32_t area = box * rows;
+    const uint64_t recip = (((uint64_t)1 << DOWNSCALE_RECIP_SHIFT) + area - 1) / area;
+
+    for (uint32_t x = 0; x < out_width; ++x) {
+        const uint16_t *pixel = sums + x * box * channels;
+        for (uint32_t c = 0; c < channels; ++c) {
+            uint32_t sum = area / 2;
+            for (uint32_t i = 0; i < box; ++i)
+                sum += pixel[i * channels + c];
+            dst[x * channels + c] = (uint8_t)((sum * recip) >> DOWNSCALE_RECIP_SHIFT);
+        }
+    }
+}
+
+template <uint32_t channels>
+static void
+reduce_line_dispatch (
+    const uint16_t *sums, const std::vector<uint32_t> &pos_x, uint32_t out_width,
+    uint32_t rows, uint8_t *dst)
+{
+    const uint32_t in_width = pos_x[out_width];
+    const uint32_t box = (in_width % out_width) ? 0 : in_width / out_width;
+
+    switch (box) {
+    case 2:
+        reduce_line_fixed<channels, 2> (sums, out_width, rows, dst);
+        break;
+    case 3:
+        reduce_line_fixed<channels, 3> (sums, out_width, rows, dst);
+        break;
+    case 4:
+        reduce_line_fixed<channels, 4> (sums, out_width, rows, dst);
+        break;
+    default:
+        reduce_line<channels> (sums, &pos_x[0], out_width, rows, dst);
+        break;
+    }
+}
+
+template <typename ImageT>
+static void
+downscale_line (
+    const ImageT &in, ImageT &out, uint32_t out_y,
+    const std::vector<uint32_t> &pos_x, const std::vector<uint32_t> &pos_y,
+    std::vector<uint16_t> &sums)
+{
+    const uint32_t channels = in.pixel_size ();
+    const uint32_t bytes = in.get_width () * channels;
+    const uint32_t y0 = pos_y[out_y];
+    const uint32_t y1 = pos_y[out_y + 1];
+    XCAM_ASSERT (y1 > y0);
+
+    memset (&sums[0], 0, bytes * sizeof (uint16_t));
+    for (uint32_t y = y0; y < y1; ++y)
+        accumulate_line ((const uint8_t *)in.get_buf_ptr (0, y), bytes, &sums[0]);
+
+    reduce_line_dispatch<sizeof (typename ImageT::Type)> (
+        &sums[0], pos_x, out.get_width (), y1 - y0,
+        (uint8_t *)out.get_buf_ptr (0, out_y));
+}
+
+XCamReturn
+DownscaleNV12Task::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<DownscaleNV12Task::Args> args = base.dynamic_cast_ptr<DownscaleNV12Task::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    UcharImage *in_luma = args->in_luma.ptr (), *out_luma = args->out_luma.ptr ();
+    Uchar2Image *in_uv = args->in_uv.ptr (), *out_uv = args->out_uv.ptr ();
+    const DownscaleTable *table = args->table.ptr ();
+    XCAM_ASSERT (in_luma && out_luma && in_uv && out_uv && table);
+
+    const uint32_t out_height = out_luma->get_height ();
+    std::vector<uint16_t> sums (in_luma->get_width ());
+    XCAM_ASSERT (in_uv->get_width () * 2 <= in_luma->get_width ());
+
+    for (uint32_t uv_y = range.pos[1]; uv_y < range.pos[1] + range.pos_len[1]; ++uv_y) {
+        for (uint32_t y = uv_y * 2; y < XCAM_MIN (uv_y * 2 + 2, out_height); ++y)
+            downscale_line (*in_luma, *out_luma, y, table->luma_x, table->luma_y, sums);
+
+        downscale_line (*in_uv, *out_uv, uv_y, table->uv_x, table->uv_y, sums);
+    }
+
+    XCAM_LOG_DEBUG ("DownscaleNV12Task work on range:[y:%d, len:%d]", range.pos[1], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+}
+
+}
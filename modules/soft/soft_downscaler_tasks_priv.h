@@ -0,0 +1,71 @@
+/*
+ * soft_downscaler_tasks_priv.h - soft downscaler tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_DOWNSCALER_TASKS_PRIV_H
+#define XCAM_SOFT_DOWNSCALER_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_handler.h>
+#include <vector>
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+// source start positions of each output pixel and row, entry [n] is the source size
+struct DownscaleTable {
+    std::vector<uint32_t>  luma_x;
+    std::vector<uint32_t>  luma_y;
+    std::vector<uint32_t>  uv_x;
+    std::vector<uint32_t>  uv_y;
+};
+
+// one work item is one output uv line and its two luma lines
+class DownscaleNV12Task
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>        in_luma, out_luma;
+        SmartPtr<Uchar2Image>       in_uv, out_uv;
+        SmartPtr<DownscaleTable>    table;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {}
+    };
+
+public:
+    explicit DownscaleNV12Task (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("DownscaleNV12Task", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+}
+
+}
+
+#endif //XCAM_SOFT_DOWNSCALER_TASKS_PRIV_H
@@ -0,0 +1,587 @@
+/*
+ * soft_feature_match.cpp - soft feature match class implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_feature_match.h"
+#include <algorithm>
+#include <math.h>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define XCAM_SOFT_FM_FAST_THRESHOLD 20
+#define XCAM_SOFT_FM_MAX_CORNERS 1024
+#define XCAM_SOFT_FM_HARRIS_K 0.04f
+// FAST circle and Harris window need 4 pixels, interpolation of LK patch needs one more
+#define XCAM_SOFT_FM_BORDER 5
+
+#define XCAM_SOFT_FM_WIN_RADIUS 3
+#define XCAM_SOFT_FM_MAX_LEVEL 3
+#define XCAM_SOFT_FM_MIN_LEVEL_SIZE 16
+#define XCAM_SOFT_FM_MIN_MATCH_SIZE 32
+#define XCAM_SOFT_FM_LK_ITERATIONS 10
+#define XCAM_SOFT_FM_LK_EPSILON 0.01f
+#define XCAM_SOFT_FM_MIN_EIGEN 0.01f
+
+namespace XCam {
+
+struct FastCandidate {
+    int32_t x, y;
+    float score;
+
+    FastCandidate (int32_t pos_x, int32_t pos_y, float s)
+        : x (pos_x), y (pos_y), score (s)
+    {}
+    bool operator < (const FastCandidate &other) const {
+        return score > other.score;
+    }
+};
+
+// Bresenham circle of radius 3, clockwise from top, compass points are 0, 4, 8, 12
+static const int32_t fast_circle[16][2] = {
+    {0, -3}, {1, -3}, {2, -2}, {3, -1}, {3, 0}, {3, 1}, {2, 2}, {1, 3},
+    {0, 3}, {-1, 3}, {-2, 2}, {-3, 1}, {-3, 0}, {-3, -1}, {-2, -2}, {-1, -3}
+};
+
+static inline bool
+has_fast_arc (uint32_t mask)
+{
+    if (!mask)
+        return false;
+
+    // 9 contiguous bits on the circle
+    mask |= mask << 16;
+    uint32_t run = mask;
+    for (int32_t i = 1; i < 9; ++i)
+        run &= mask >> i;
+    return run != 0;
+}
+
+static inline bool
+is_fast_corner (const Uchar *p, int32_t pitch, int32_t threshold)
+{
+    const int32_t high = p[0] + threshold;
+    const int32_t low = p[0] - threshold;
+    uint32_t bright = 0, dark = 0;
+
+    for (int32_t i = 0; i < 16; ++i) {
+        const int32_t v = p[fast_circle[i][1] * pitch + fast_circle[i][0]];
+        if (v > high)
+            bright |= (1 << i);
+        else if (v < low)
+            dark |= (1 << i);
+    }
+
+    return has_fast_arc (bright) || has_fast_arc (dark);
+}
+
+#if defined (__SSE2__)
+static inline __m128i
+greater_than_u8 (const __m128i &a, const __m128i &b)
+{
+    return _mm_xor_si128 (
+               _mm_cmpeq_epi8 (_mm_subs_epu8 (a, b), _mm_setzero_si128 ()), _mm_set1_epi8 (-1));
+}
+
+// an arc of 9 always covers 2 neighboring compass points, check 16 pixels together
+static inline uint32_t
+fast_precheck_16 (const Uchar *p, int32_t pitch, const __m128i &threshold)
+{
+    const __m128i center = _mm_loadu_si128 ((const __m128i *)p);
+    const __m128i high = _mm_adds_epu8 (center, threshold);
+    const __m128i low = _mm_subs_epu8 (center, threshold);
+
+    const __m128i top = _mm_loadu_si128 ((const __m128i *)(p - 3 * pitch));
+    const __m128i right = _mm_loadu_si128 ((const __m128i *)(p + 3));
+    const __m128i bottom = _mm_loadu_si128 ((const __m128i *)(p + 3 * pitch));
+    const __m128i left = _mm_loadu_si128 ((const __m128i *)(p - 3));
+
+    __m128i b0 = greater_than_u8 (top, high);
+    __m128i b1 = greater_than_u8 (right, high);
+    __m128i b2 = greater_than_u8 (bottom, high);
+    __m128i b3 = greater_than_u8 (left, high);
+    __m128i bright = _mm_or_si128 (
+                         _mm_or_si128 (_mm_and_si128 (b0, b1), _mm_and_si128 (b1, b2)),
+                         _mm_or_si128 (_mm_and_si128 (b2, b3), _mm_and_si128 (b3, b0)));
+
+    b0 = greater_than_u8 (low, top);
+    b1 = greater_than_u8 (low, right);
+    b2 = greater_than_u8 (low, bottom);
+    b3 = greater_than_u8 (low, left);
+    __m128i dark = _mm_or_si128 (
+                       _mm_or_si128 (_mm_and_si128 (b0, b1), _mm_and_si128 (b1, b2)),
+                       _mm_or_si128 (_mm_and_si128 (b2, b3), _mm_and_si128 (b3, b0)));
+
+    return (uint32_t)_mm_movemask_epi8 (_mm_or_si128 (bright, dark));
+}
+#endif
+
+static float
+harris_score (const UcharImage &image, int32_t x, int32_t y)
+{
+    const int32_t r = XCAM_SOFT_FM_WIN_RADIUS;
+    const int32_t pitch = image.get_pitch ();
+    int32_t sxx = 0, sxy = 0, syy = 0;
+
+    for (int32_t j = -r; j <= r; ++j) {
+        const Uchar *p = image.get_buf_ptr (x - r, y + j);
+        for (int32_t i = -r; i <= r; ++i, ++p) {
+            const int32_t dx =
+                (p[1 - pitch] + 2 * p[1] + p[1 + pitch]) - (p[-1 - pitch] + 2 * p[-1] + p[-1 + pitch]);
+            const int32_t dy =
+                (p[pitch - 1] + 2 * p[pitch] + p[pitch + 1]) - (p[-pitch - 1] + 2 * p[-pitch] + p[-pitch + 1]);
+            sxx += dx * dx;
+            sxy += dx * dy;
+            syy += dy * dy;
+        }
+    }
+
+    const float a = (float)sxx, b = (float)sxy, c = (float)syy;
+    return a * c - b * b - XCAM_SOFT_FM_HARRIS_K * (a + c) * (a + c);
+}
+
+static void
+downscale_2x2 (const UcharImage &in, UcharImage &out)
+{
+    const uint32_t width = out.get_width ();
+    const uint32_t height = out.get_height ();
+    XCAM_ASSERT (in.get_width () >= width * 2 && in.get_height () >= height * 2);
+
+    for (uint32_t y = 0; y < height; ++y) {
+        const Uchar *in0 = in.get_buf_ptr (0, y * 2);
+        const Uchar *in1 = in0 + in.get_pitch ();
+        Uchar *out_line = out.get_buf_ptr (0, y);
+        uint32_t x = 0;
+
+#if defined (__SSE2__)
+        const __m128i even_mask = _mm_set1_epi16 (0x00ff);
+        const __m128i round = _mm_set1_epi16 (2);
+        for (; x + 8 <= width; x += 8) {
+            const __m128i r0 = _mm_loadu_si128 ((const __m128i *)(in0 + x * 2));
+            const __m128i r1 = _mm_loadu_si128 ((const __m128i *)(in1 + x * 2));
+            __m128i sum = _mm_add_epi16 (
+                              _mm_add_epi16 (_mm_and_si128 (r0, even_mask), _mm_srli_epi16 (r0, 8)),
+                              _mm_add_epi16 (_mm_and_si128 (r1, even_mask), _mm_srli_epi16 (r1, 8)));
+            sum = _mm_srli_epi16 (_mm_add_epi16 (sum, round), 2);
+            _mm_storel_epi64 ((__m128i *)(out_line + x), _mm_packus_epi16 (sum, sum));
+        }
+#endif
+        for (; x < width; ++x) {
+            out_line[x] = (in0[x * 2] + in0[x * 2 + 1] + in1[x * 2] + in1[x * 2 + 1] + 2) >> 2;
+        }
+    }
+}
+
+static inline bool
+is_inside (const UcharImage &image, float x, float y, float margin)
+{
+    return x - margin >= 0.0f && y - margin >= 0.0f &&
+           x + margin < (float)image.get_width () - 1.0f && y + margin < (float)image.get_height () - 1.0f;
+}
+
+// bilinear sample size x size pixels from top-left (x, y), all samples share the same fraction
+static inline void
+read_patch (const UcharImage &image, float x, float y, int32_t size, float *patch)
+{
+    const int32_t ix = (int32_t)x, iy = (int32_t)y;
+    const float fx = x - ix, fy = y - iy;
+    const float w00 = (1.0f - fx) * (1.0f - fy), w01 = fx * (1.0f - fy);
+    const float w10 = (1.0f - fx) * fy, w11 = fx * fy;
+    const int32_t pitch = image.get_pitch ();
+
+    for (int32_t j = 0; j < size; ++j) {
+        const Uchar *p = image.get_buf_ptr (ix, iy + j);
+        for (int32_t i = 0; i < size; ++i, ++p) {
+            patch[j * size + i] = p[0] * w00 + p[1] * w01 + p[pitch] * w10 + p[pitch + 1] * w11;
+        }
+    }
+}
+
+// track @pt of level 0 from @prev to @next, coarse to fine
+static bool
+track_point (
+    const SoftFeatureMatch::Pyramid &prev, const SoftFeatureMatch::Pyramid &next,
+    const Float2 &pt, Float2 &flow, float &error)
+{
+    const int32_t r = XCAM_SOFT_FM_WIN_RADIUS;
+    const int32_t win = 2 * r + 1;
+    const int32_t ext = win + 2;
+    float patch_i[ext * ext], patch_j[win * win];
+    float grad_x[win * win], grad_y[win * win];
+    float gx = 0.0f, gy = 0.0f;
+
+    for (int32_t level = (int32_t)prev.size () - 1; level >= 0; --level) {
+        const UcharImage &img_i = *prev[level].ptr ();
+        const UcharImage &img_j = *next[level].ptr ();
+        const float scale = 1.0f / (1 << level);
+        const float px = (pt.x + 0.5f) * scale - 0.5f;
+        const float py = (pt.y + 0.5f) * scale - 0.5f;
+
+        if (!is_inside (img_i, px, py, r + 1)) {
+            if (level == 0)
+                return false;
+            gx *= 2.0f;
+            gy *= 2.0f;
+            continue;
+        }
+
+        // patch of prev image has 1 pixel border for gradients
+        read_patch (img_i, px - r - 1, py - r - 1, ext, patch_i);
+        float gxx = 0.0f, gxy = 0.0f, gyy = 0.0f;
+        for (int32_t j = 0; j < win; ++j) {
+            for (int32_t i = 0; i < win; ++i) {
+                const float *p = &patch_i[(j + 1) * ext + i + 1];
+                const float dx = (p[1] - p[-1]) * 0.5f;
+                const float dy = (p[ext] - p[-ext]) * 0.5f;
+                grad_x[j * win + i] = dx;
+                grad_y[j * win + i] = dy;
+                gxx += dx * dx;
+                gxy += dx * dy;
+                gyy += dy * dy;
+            }
+        }
+
+        const float det = gxx * gyy - gxy * gxy;
+        const float min_eigen =
+            (gxx + gyy - sqrtf ((gxx - gyy) * (gxx - gyy) + 4.0f * gxy * gxy)) * 0.5f / (win * win);
+        if (min_eigen < XCAM_SOFT_FM_MIN_EIGEN || det <= 0.0f) {
+            if (level == 0)
+                return false;
+            gx *= 2.0f;
+            gy *= 2.0f;
+            continue;
+        }
+
+        float vx = 0.0f, vy = 0.0f;
+        for (int32_t iter = 0; iter < XCAM_SOFT_FM_LK_ITERATIONS; ++iter) {
+            const float qx = px + gx + vx, qy = py + gy + vy;
+            if (!is_inside (img_j, qx, qy, r)) {
+                if (level == 0)
+                    return false;
+                break;
+            }
+
+            read_patch (img_j, qx - r, qy - r, win, patch_j);
+            float bx = 0.0f, by = 0.0f;
+            for (int32_t j = 0; j < win; ++j) {
+                for (int32_t i = 0; i < win; ++i) {
+                    const float diff = patch_i[(j + 1) * ext + i + 1] - patch_j[j * win + i];
+                    bx += diff * grad_x[j * win + i];
+                    by += diff * grad_y[j * win + i];
+                }
+            }
+
+            const float dx = (gyy * bx - gxy * by) / det;
+            const float dy = (gxx * by - gxy * bx) / det;
+            vx += dx;
+            vy += dy;
+            if (dx * dx + dy * dy < XCAM_SOFT_FM_LK_EPSILON * XCAM_SOFT_FM_LK_EPSILON)
+                break;
+        }
+
+        gx += vx;
+        gy += vy;
+        if (level > 0) {
+            gx *= 2.0f;
+            gy *= 2.0f;
+            continue;
+        }
+
+        const float qx = px + gx, qy = py + gy;
+        if (!is_inside (img_j, qx, qy, r))
+            return false;
+
+        read_patch (img_j, qx - r, qy - r, win, patch_j);
+        float sum = 0.0f;
+        for (int32_t j = 0; j < win; ++j) {
+            for (int32_t i = 0; i < win; ++i) {
+                sum += fabsf (patch_i[(j + 1) * ext + i + 1] - patch_j[j * win + i]);
+            }
+        }
+        error = sum / (win * win);
+    }
+
+    flow = Float2 (gx, gy);
+    return true;
+}
+
+SoftFeatureMatch::SoftFeatureMatch ()
+    : FeatureMatch ()
+{
+}
+
+SoftFeatureMatch::~SoftFeatureMatch ()
+{
+}
+
+uint32_t
+SoftFeatureMatch::get_match_level (uint32_t width, uint32_t height)
+{
+    uint32_t level = (uint32_t)XCAM_MAX (_config.match_level, 0);
+    while (level > 0 &&
+            ((width >> level) < XCAM_SOFT_FM_MIN_MATCH_SIZE || (height >> level) < XCAM_SOFT_FM_MIN_MATCH_SIZE))
+        --level;
+
+    return level;
+}
+
+bool
+SoftFeatureMatch::build_pyramid (
+    const SmartPtr<VideoBuffer> &buf, const Rect &rect, uint32_t levels, Pyramid &pyr)
+{
+    const VideoBufferInfo &info = buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        ERROR,
+        rect.pos_x >= 0 && rect.pos_y >= 0 &&
+        rect.pos_x + rect.width <= (int32_t)info.width && rect.pos_y + rect.height <= (int32_t)info.height,
+        false,
+        "SoftFeatureMatch(idx:%d) crop rect(%d, %d, %d, %d) is out of buffer(%dx%d)",
+        _fm_idx, rect.pos_x, rect.pos_y, rect.width, rect.height, info.width, info.height);
+
+    XCAM_FAIL_RETURN (
+        ERROR, buf->map (), false,
+        "SoftFeatureMatch(idx:%d) map buffer failed", _fm_idx);
+
+    // level 0 works on buffer in place, other levels are kept across frames
+    pyr.resize (levels + 1);
+    pyr[0] = new UcharImage (
+        buf, rect.width, rect.height, info.strides[0],
+        info.offsets[0] + rect.pos_y * info.strides[0] + rect.pos_x);
+    XCAM_ASSERT (pyr[0].ptr ());
+
+    for (uint32_t i = 1; i <= levels; ++i) {
+        const uint32_t width = pyr[i - 1]->get_width () / 2;
+        const uint32_t height = pyr[i - 1]->get_height () / 2;
+        if (!pyr[i].ptr () || pyr[i]->get_width () != width || pyr[i]->get_height () != height) {
+            pyr[i] = new UcharImage (width, height);
+            XCAM_ASSERT (pyr[i].ptr ());
+        }
+        downscale_2x2 (*pyr[i - 1].ptr (), *pyr[i].ptr ());
+    }
+
+    return true;
+}
+
+void
+SoftFeatureMatch::detect_corners (const UcharImage &image, std::vector<Float2> &corners, bool simd)
+{
+    const int32_t width = image.get_width ();
+    const int32_t height = image.get_height ();
+    const int32_t pitch = image.get_pitch ();
+    const int32_t border = XCAM_SOFT_FM_BORDER;
+    const int32_t threshold = XCAM_SOFT_FM_FAST_THRESHOLD;
+
+    if (width <= border * 2 || height <= border * 2)
+        return;
+
+    std::vector<FastCandidate> candidates;
+    _score_map.assign (width * height, 0.0f);
+
+#if defined (__SSE2__)
+    const __m128i threshold_16 = _mm_set1_epi8 ((char)threshold);
+#else
+    XCAM_UNUSED (simd);
+#endif
+
+    for (int32_t y = border; y < height - border; ++y) {
+        const Uchar *line = image.get_buf_ptr (0, y);
+        float *score_line = &_score_map[y * width];
+        int32_t x = border;
+
+#if defined (__SSE2__)
+        for (; simd && x + 16 <= width - border; x += 16) {
+            const uint32_t mask = fast_precheck_16 (line + x, pitch, threshold_16);
+            if (!mask)
+                continue;
+
+            for (int32_t i = 0; i < 16; ++i) {
+                if (!(mask & (1 << i)) || !is_fast_corner (line + x + i, pitch, threshold))
+                    continue;
+
+                const float score = harris_score (image, x + i, y);
+                if (score > 0.0f) {
+                    score_line[x + i] = score;
+                    candidates.push_back (FastCandidate (x + i, y, score));
+                }
+            }
+        }
+#endif
+
+        for (; x < width - border; ++x) {
+            if (!is_fast_corner (line + x, pitch, threshold))
+                continue;
+
+            const float score = harris_score (image, x, y);
+            if (score > 0.0f) {
+                score_line[x] = score;
+                candidates.push_back (FastCandidate (x, y, score));
+            }
+        }
+    }
+
+    // 3x3 non-maximum suppression, ties are resolved in favor of the first one in raster order
+    size_t count = 0;
+    for (size_t i = 0; i < candidates.size (); ++i) {
+        const FastCandidate &c = candidates[i];
+        const float *s = &_score_map[c.y * width + c.x];
+        if (s[-width - 1] >= c.score || s[-width] >= c.score || s[-width + 1] >= c.score || s[-1] >= c.score ||
+                s[1] > c.score || s[width - 1] > c.score || s[width] > c.score || s[width + 1] > c.score)
+            continue;
+        candidates[count++] = c;
+    }
+    candidates.erase (candidates.begin () + count, candidates.end ());
+
+    if (candidates.size () > XCAM_SOFT_FM_MAX_CORNERS) {
+        std::nth_element (
+            candidates.begin (), candidates.begin () + XCAM_SOFT_FM_MAX_CORNERS, candidates.end ());
+        candidates.erase (candidates.begin () + XCAM_SOFT_FM_MAX_CORNERS, candidates.end ());
+    }
+
+    corners.reserve (corners.size () + candidates.size ());
+    for (size_t i = 0; i < candidates.size (); ++i) {
+        corners.push_back (Float2 ((float)candidates[i].x, (float)candidates[i].y));
+    }
+}
+
+void
+SoftFeatureMatch::track_corners (
+    const Pyramid &prev, const Pyramid &next, const std::vector<Float2> &prev_pts,
+    std::vector<Float2> &next_pts, std::vector<uint8_t> &status, std::vector<float> &error)
+{
+    XCAM_ASSERT (prev.size () == next.size ());
+
+    next_pts.resize (prev_pts.size ());
+    status.resize (prev_pts.size ());
+    error.resize (prev_pts.size ());
+
+    for (size_t i = 0; i < prev_pts.size (); ++i) {
+        Float2 flow;
+        float err = 0.0f;
+        status[i] = track_point (prev, next, prev_pts[i], flow, err) ? 1 : 0;
+        error[i] = err;
+        next_pts[i] = Float2 (prev_pts[i].x + flow.x, prev_pts[i].y + flow.y);
+    }
+}
+
+void
+SoftFeatureMatch::calc_of_match (
+    const std::vector<Float2> &corner0, const std::vector<Float2> &corner1,
+    const std::vector<uint8_t> &status, const std::vector<float> &error, uint32_t width)
+{
+    std::vector<float> offsets;
+    float offset_sum = 0.0f;
+    int count = 0;
+    float mean_offset = 0.0f;
+    float last_mean_offset = _mean_offset;
+
+    offsets.reserve (corner0.size ());
+    for (size_t i = 0; i < status.size (); ++i) {
+        if (!status[i])
+            continue;
+        if (error[i] > _config.max_track_error)
+            continue;
+        if (fabs (corner0[i].y - corner1[i].y) >= _config.max_valid_offset_y)
+            continue;
+        if (corner1[i].x < 0.0f || corner1[i].x > width)
+            continue;
+
+        float offset = corner1[i].x - corner0[i].x;
+        offset_sum += offset;
+        ++count;
+        offsets.push_back (offset);
+    }
+
+    bool ret = get_mean_offset (offsets, offset_sum, count, mean_offset);
+    if (ret) {
+        if (fabs (mean_offset - last_mean_offset) < _config.delta_mean_offset) {
+            _x_offset = _x_offset * _config.offset_factor + mean_offset * (1.0f - _config.offset_factor);
+
+            if (fabs (_x_offset) > _config.max_adjusted_offset)
+                _x_offset = (_x_offset > 0.0f) ? _config.max_adjusted_offset : (-_config.max_adjusted_offset);
+        }
+    }
+
+    _valid_count = count;
+    _mean_offset = mean_offset;
+}
+
+void
+SoftFeatureMatch::feature_match (
+    const SmartPtr<VideoBuffer> &left_buf, const SmartPtr<VideoBuffer> &right_buf)
+{
+    XCAM_ASSERT (_left_rect.width && _left_rect.height);
+    XCAM_ASSERT (_right_rect.width && _right_rect.height);
+
+    const uint32_t width = XCAM_MIN (_left_rect.width, _right_rect.width);
+    const uint32_t height = XCAM_MIN (_left_rect.height, _right_rect.height);
+
+    // corners are detected in @match_level, tracked from the top level down to full resolution
+    const uint32_t match_level = get_match_level (width, height);
+    uint32_t levels = match_level;
+    while (levels < match_level + XCAM_SOFT_FM_MAX_LEVEL &&
+            (width >> (levels + 1)) >= XCAM_SOFT_FM_MIN_LEVEL_SIZE &&
+            (height >> (levels + 1)) >= XCAM_SOFT_FM_MIN_LEVEL_SIZE)
+        ++levels;
+
+    // build_pyramid maps input buffer on success
+    const bool left_mapped = build_pyramid (left_buf, _left_rect, levels, _left_pyr);
+    const bool right_mapped = left_mapped && build_pyramid (right_buf, _right_rect, levels, _right_pyr);
+
+    if (left_mapped && right_mapped) {
+        std::vector<Float2> corner_left, corner_right;
+        std::vector<uint8_t> status;
+        std::vector<float> error;
+
+        detect_corners (*_left_pyr[match_level].ptr (), corner_left);
+        const float scale = (float)(1 << match_level);
+        for (size_t i = 0; i < corner_left.size (); ++i) {
+            corner_left[i].x = (corner_left[i].x + 0.5f) * scale - 0.5f;
+            corner_left[i].y = (corner_left[i].y + 0.5f) * scale - 0.5f;
+        }
+
+        if (!corner_left.empty ()) {
+            track_corners (_left_pyr, _right_pyr, corner_left, corner_right, status, error);
+            calc_of_match (corner_left, corner_right, status, error, _left_rect.width);
+        }
+    }
+
+    // do not hold input buffers after match
+    if (!_left_pyr.empty ())
+        _left_pyr[0].release ();
+    if (!_right_pyr.empty ())
+        _right_pyr[0].release ();
+    if (left_mapped)
+        left_buf->unmap ();
+    if (right_mapped)
+        right_buf->unmap ();
+
+    _frame_num++;
+}
+
+SmartPtr<FeatureMatch>
+FeatureMatch::create_soft_feature_match ()
+{
+    SmartPtr<SoftFeatureMatch> matcher = new SoftFeatureMatch ();
+    XCAM_ASSERT (matcher.ptr ());
+
+    return matcher;
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+ * soft_feature_match.h - soft feature match class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_FEATURE_MATCH_H
+#define XCAM_SOFT_FEATURE_MATCH_H
+
+#include <xcam_std.h>
+#include <interface/feature_match.h>
+#include <soft/soft_image.h>
+
+namespace XCam {
+
+/* feature match without OpenCV, works on luma of NV12 buffers in place.
+ * FAST corners ranked by Harris response are tracked from left crop
+ * to right crop by pyramidal Lucas-Kanade.
+ */
+class SoftFeatureMatch
+    : public FeatureMatch
+{
+public:
+    typedef std::vector<SmartPtr<UcharImage> > Pyramid;
+
+public:
+    explicit SoftFeatureMatch ();
+    virtual ~SoftFeatureMatch ();
+
+    virtual void feature_match (
+        const SmartPtr<VideoBuffer> &left_buf, const SmartPtr<VideoBuffer> &right_buf);
+
+    // @simd false skips SSE2 pre-check, results must be the same
+    void detect_corners (const UcharImage &image, std::vector<Float2> &corners, bool simd = true);
+
+private:
+    uint32_t get_match_level (uint32_t width, uint32_t height);
+    bool build_pyramid (
+        const SmartPtr<VideoBuffer> &buf, const Rect &rect, uint32_t levels, Pyramid &pyr);
+    void track_corners (
+        const Pyramid &prev, const Pyramid &next, const std::vector<Float2> &prev_pts,
+        std::vector<Float2> &next_pts, std::vector<uint8_t> &status, std::vector<float> &error);
+
+    void calc_of_match (
+        const std::vector<Float2> &corner0, const std::vector<Float2> &corner1,
+        const std::vector<uint8_t> &status, const std::vector<float> &error, uint32_t width);
+
+private:
+    XCAM_DEAD_COPY (SoftFeatureMatch);
+
+private:
+    Pyramid                 _left_pyr;
+    Pyramid                 _right_pyr;
+    std::vector<float>      _score_map;
+};
+
+}
+
+#endif // XCAM_SOFT_FEATURE_MATCH_H
@@ -107,6 +107,7 @@ SoftGeoMapper::configure_resource (const SmartPtr<Parameters> &param)
 
     XCAM_ASSERT (!_map_task.ptr ());
     _map_task = create_remap_task ();
+    share_threads (_map_task);
 
     return XCAM_RETURN_NO_ERROR;
 }
@@ -148,10 +149,9 @@ SoftGeoMapper::create_remap_task ()
     return map_task;
 }
 
-XCamReturn
-SoftGeoMapper::start_remap_task (const SmartPtr<ImageHandler::Parameters> &param)
+SmartPtr<Worker::Arguments>
+SoftGeoMapper::create_remap_args (const SmartPtr<ImageHandler::Parameters> &param)
 {
-    XCAM_ASSERT (_map_task.ptr ());
     XCAM_ASSERT (_lookup_table.ptr ());
 
     Float2 factors;
@@ -175,6 +175,19 @@ SoftGeoMapper::start_remap_task (const SmartPtr<ImageHandler::Parameters> &param
     set_work_size (thread_x, thread_y, args->out_luma->get_width (), args->out_luma->get_height ());
 
     param->in_buf.release ();
+    return args;
+}
+
+XCamReturn
+SoftGeoMapper::start_remap_task (const SmartPtr<ImageHandler::Parameters> &param)
+{
+    XCAM_ASSERT (_map_task.ptr ());
+
+    SmartPtr<Worker::Arguments> args = create_remap_args (param);
+    XCAM_FAIL_RETURN (
+        ERROR, args.ptr (), XCAM_RETURN_ERROR_PARAM,
+        "SoftGeoMapper(%s) create remap arguments failed", XCAM_STR (get_name ()));
+
     return _map_task->work (args);
 }
 
@@ -195,6 +208,32 @@ SoftGeoMapper::start_work (const SmartPtr<ImageHandler::Parameters> &param)
     return ret;
 };
 
+XCamReturn
+SoftGeoMapper::start_works (const ParametersList &params, uint32_t &started)
+{
+    XCAM_ASSERT (_map_task.ptr ());
+    started = 0;
+
+    SoftWorker::ArgumentsList args_list;
+    for (ParametersList::const_iterator i = params.begin (); i != params.end (); ++i) {
+        XCAM_ASSERT ((*i)->out_buf.ptr ());
+
+        SmartPtr<Worker::Arguments> args = create_remap_args (*i);
+        XCAM_FAIL_RETURN (
+            ERROR, args.ptr (), XCAM_RETURN_ERROR_PARAM,
+            "SoftGeoMapper(%s) create remap arguments failed", XCAM_STR (get_name ()));
+        args_list.push_back (args);
+    }
+
+    // a frame partly queued never reaches remap_task_done, it is not counted as started
+    XCamReturn ret = _map_task->work_batch (args_list, &started);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftGeoMapper(%s) start_works failed in batch", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
 XCamReturn
 SoftGeoMapper::terminate ()
 {
@@ -360,19 +399,16 @@ SoftDualConstGeoMapper::prepare_arguments (
     return XCAM_RETURN_NO_ERROR;
 }
 
-XCamReturn
-SoftDualConstGeoMapper::start_remap_task (const SmartPtr<ImageHandler::Parameters> &param)
+SmartPtr<Worker::Arguments>
+SoftDualConstGeoMapper::create_remap_args (const SmartPtr<ImageHandler::Parameters> &param)
 {
-    SmartPtr<XCamSoftTasks::GeoMapTask> map_task = get_map_task ();
-    XCAM_ASSERT (map_task.ptr ());
-
     SmartPtr<XCamSoftTasks::GeoMapDualConstTask::Args> args =
         new XCamSoftTasks::GeoMapDualConstTask::Args (param);
     XCAM_ASSERT (args.ptr ());
 
     prepare_arguments (args, param);
 
-    return map_task->work (args);
+    return args;
 }
 
 void
@@ -422,19 +458,16 @@ SoftDualCurveGeoMapper::create_remap_task ()
     return map_task;
 }
 
-XCamReturn
-SoftDualCurveGeoMapper::start_remap_task (const SmartPtr<ImageHandler::Parameters> &param)
+SmartPtr<Worker::Arguments>
+SoftDualCurveGeoMapper::create_remap_args (const SmartPtr<ImageHandler::Parameters> &param)
 {
-    SmartPtr<XCamSoftTasks::GeoMapTask> map_task = get_map_task ();
-    XCAM_ASSERT (map_task.ptr ());
-
     SmartPtr<XCamSoftTasks::GeoMapDualCurveTask::Args> args =
         new XCamSoftTasks::GeoMapDualCurveTask::Args (param);
     XCAM_ASSERT (args.ptr ());
 
     prepare_arguments (args, param);
 
-    return map_task->work (args);
+    return args;
 }
 
 void
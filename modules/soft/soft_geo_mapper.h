@@ -58,6 +58,7 @@ protected:
     //derived from SoftHandler
     XCamReturn configure_resource (const SmartPtr<Parameters> &param);
     XCamReturn start_work (const SmartPtr<Parameters> &param);
+    XCamReturn start_works (const ParametersList &params, uint32_t &started);
 
     void set_work_size (uint32_t thread_x, uint32_t thread_y, uint32_t luma_width, uint32_t luma_height);
     SmartPtr<XCamSoftTasks::GeoMapTask> &get_map_task () {
@@ -70,7 +71,8 @@ protected:
 protected:
     virtual bool init_factors ();
     virtual SmartPtr<XCamSoftTasks::GeoMapTask> create_remap_task ();
-    virtual XCamReturn start_remap_task (const SmartPtr<ImageHandler::Parameters> &param);
+    virtual SmartPtr<Worker::Arguments> create_remap_args (const SmartPtr<ImageHandler::Parameters> &param);
+    XCamReturn start_remap_task (const SmartPtr<ImageHandler::Parameters> &param);
 
 private:
     SmartPtr<XCamSoftTasks::GeoMapTask>   _map_task;
@@ -108,7 +110,7 @@ protected:
 protected:
     virtual bool init_factors ();
     virtual SmartPtr<XCamSoftTasks::GeoMapTask> create_remap_task ();
-    virtual XCamReturn start_remap_task (const SmartPtr<ImageHandler::Parameters> &param);
+    virtual SmartPtr<Worker::Arguments> create_remap_args (const SmartPtr<ImageHandler::Parameters> &param);
 
 private:
     float        _left_factor_x, _left_factor_y;
@@ -131,7 +133,7 @@ public:
 
 private:
     virtual SmartPtr<XCamSoftTasks::GeoMapTask> create_remap_task ();
-    virtual XCamReturn start_remap_task (const SmartPtr<ImageHandler::Parameters> &param);
+    virtual SmartPtr<Worker::Arguments> create_remap_args (const SmartPtr<ImageHandler::Parameters> &param);
 
 private:
     float        _scaled_height;
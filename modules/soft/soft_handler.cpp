@@ -125,15 +125,10 @@ SoftHandler::configure_rest ()
 }
 
 XCamReturn
-SoftHandler::execute_buffer (const SmartPtr<ImageHandler::Parameters> &param, bool sync)
+SoftHandler::configure (const SmartPtr<Parameters> &param)
 {
     XCamReturn ret = XCAM_RETURN_NO_ERROR;
 
-    XCAM_FAIL_RETURN (
-        ERROR, param.ptr (), XCAM_RETURN_ERROR_PARAM,
-        "soft_hander(%s) execute buffer failed, params is null",
-        XCAM_STR (get_name ()));
-
     if (_need_configure) {
         ret = configure_resource (param);
         XCAM_FAIL_RETURN (
@@ -148,6 +143,12 @@ SoftHandler::execute_buffer (const SmartPtr<ImageHandler::Parameters> &param, bo
         _need_configure = false;
     }
 
+    return ret;
+}
+
+XCamReturn
+SoftHandler::prepare_param (const SmartPtr<Parameters> &param, SmartPtr<SyncMeta> &sync_meta)
+{
     if (!param->out_buf.ptr () && _enable_allocator) {
         param->out_buf = get_free_buf ();
         XCAM_FAIL_RETURN (
@@ -157,10 +158,32 @@ SoftHandler::execute_buffer (const SmartPtr<ImageHandler::Parameters> &param, bo
     }
 
     XCAM_ASSERT (!param->find_meta<SyncMeta> ().ptr ());
-    SmartPtr<SyncMeta> sync_meta = new SyncMeta ();
+    sync_meta = new SyncMeta ();
     XCAM_ASSERT (sync_meta.ptr ());
     param->add_meta (sync_meta);
 
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftHandler::execute_buffer (const SmartPtr<ImageHandler::Parameters> &param, bool sync)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    XCAM_FAIL_RETURN (
+        ERROR, param.ptr (), XCAM_RETURN_ERROR_PARAM,
+        "soft_hander(%s) execute buffer failed, params is null",
+        XCAM_STR (get_name ()));
+
+    ret = configure (param);
+    if (!xcam_ret_is_ok (ret))
+        return ret;
+
+    SmartPtr<SyncMeta> sync_meta;
+    ret = prepare_param (param, sync_meta);
+    if (!xcam_ret_is_ok (ret))
+        return ret;
+
 #if 0
     SmartPtr<SoftWorker> worker = get_first_worker ().dynamic_cast_ptr<SoftWorker> ();
     XCAM_FAIL_RETURN (
@@ -198,6 +221,94 @@ SoftHandler::execute_buffer (const SmartPtr<ImageHandler::Parameters> &param, bo
     return ret;
 }
 
+XCamReturn
+SoftHandler::execute_buffers (const ParametersList &params, bool sync)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    XCAM_FAIL_RETURN (
+        ERROR, !params.empty (), XCAM_RETURN_ERROR_PARAM,
+        "soft_hander(%s) execute buffers failed, params list is empty",
+        XCAM_STR (get_name ()));
+
+    if (params.size () == 1)
+        return execute_buffer (params.front (), sync);
+
+    for (ParametersList::const_iterator i = params.begin (); i != params.end (); ++i) {
+        XCAM_FAIL_RETURN (
+            ERROR, (*i).ptr (), XCAM_RETURN_ERROR_PARAM,
+            "soft_hander(%s) execute buffers failed, one of params is null",
+            XCAM_STR (get_name ()));
+    }
+
+    ret = configure (params.front ());
+    if (!xcam_ret_is_ok (ret))
+        return ret;
+
+    std::vector<SmartPtr<SyncMeta> > sync_metas;
+    for (ParametersList::const_iterator i = params.begin (); i != params.end (); ++i) {
+        SmartPtr<SyncMeta> sync_meta;
+        ret = prepare_param (*i, sync_meta);
+        if (!xcam_ret_is_ok (ret)) {
+            // params are not started, so they can be passed in again
+            for (ParametersList::const_iterator j = params.begin (); j != i; ++j)
+                (*j)->remove_meta<SyncMeta> ();
+            XCAM_LOG_ERROR ("soft_hander(%s) execute buffers failed in preparing params", XCAM_STR (get_name ()));
+            return ret;
+        }
+
+        sync_metas.push_back (sync_meta);
+    }
+
+    for (ParametersList::const_iterator i = params.begin (); i != params.end (); ++i) {
+        _params.push (*i);
+        ++_wip_buf_count;
+    }
+
+    uint32_t started = 0;
+    ret = start_works (params, started);
+    if (!xcam_ret_is_ok (ret)) {
+        XCAM_ASSERT (started <= params.size ());
+        for (uint32_t i = started; i < params.size (); ++i)
+            work_broken (params[i], ret);
+
+        // works already started still use the buffers of their params
+        for (uint32_t i = 0; i < started; ++i)
+            sync_metas[i]->signal_wait_ret ();
+
+        XCAM_LOG_WARNING ("soft_hander(%s) execute buffers failed in starting workers", XCAM_STR (get_name ()));
+        return ret;
+    }
+
+    _cur_sync = sync_metas.back ();
+
+    if (sync) {
+        for (uint32_t i = 0; i < sync_metas.size (); ++i) {
+            XCamReturn err = sync_metas[i]->signal_wait_ret ();
+            if (xcam_ret_is_ok (ret))
+                ret = err;
+        }
+        _cur_sync.release ();
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftHandler::start_works (const ParametersList &params, uint32_t &started)
+{
+    started = 0;
+    for (ParametersList::const_iterator i = params.begin (); i != params.end (); ++i) {
+        XCamReturn ret = start_work (*i);
+        XCAM_FAIL_RETURN (
+            WARNING, xcam_ret_is_ok (ret), ret,
+            "soft_hander(%s) start works failed", XCAM_STR (get_name ()));
+        ++started;
+    }
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
 XCamReturn
 SoftHandler::finish ()
 {
@@ -280,6 +391,16 @@ SoftHandler::param_ended (SmartPtr<ImageHandler::Parameters> param, XCamReturn e
     execute_status_check (param, err);
 }
 
+bool
+SoftHandler::share_threads (const SmartPtr<SoftWorker> &worker)
+{
+    XCAM_ASSERT (worker.ptr ());
+    if (!_threads.ptr ())
+        return true;
+
+    return worker->set_threads (_threads);
+}
+
 bool
 SoftHandler::check_work_continue (const SmartPtr<ImageHandler::Parameters> &param, XCamReturn err)
 {
@@ -25,6 +25,7 @@
 #include <image_handler.h>
 #include <video_buffer.h>
 #include <worker.h>
+#include <vector>
 
 namespace XCam {
 
@@ -52,6 +53,9 @@ public:
 class SoftHandler
     : public ImageHandler
 {
+public:
+    typedef std::vector<SmartPtr<Parameters> > ParametersList;
+
 public:
     explicit SoftHandler (const char* name);
     ~SoftHandler ();
@@ -60,6 +64,8 @@ public:
 
     // derive from ImageHandler
     virtual XCamReturn execute_buffer (const SmartPtr<Parameters> &param, bool sync);
+    // batched variant of execute_buffer, all params need same size and format
+    virtual XCamReturn execute_buffers (const ParametersList &params, bool sync);
     virtual XCamReturn finish ();
     virtual XCamReturn terminate ();
 
@@ -67,6 +73,12 @@ protected:
     // derived from ImageHandler
     virtual SmartPtr<BufferPool> create_allocator ();
     virtual XCamReturn configure_rest ();
+    // start works of a batch of params, @started returns count of leading params started.
+    // only SoftGeoMapper overrides it to run the batch in one dispatch, other handlers
+    // get the default which calls start_work on each param.
+    // started works end through work_well_done/work_broken as usual even on error,
+    // execute_buffers breaks the params which were not started
+    virtual XCamReturn start_works (const ParametersList &params, uint32_t &started);
 
     //virtual SmartPtr<Worker::Arguments> get_first_worker_args (const SmartPtr<SoftWorker> &worker, SmartPtr<Parameters> &params) = 0;
     virtual void work_well_done (const SmartPtr<ImageHandler::Parameters> &param, XCamReturn err);
@@ -74,8 +86,12 @@ protected:
 
     //directly usage
     bool check_work_continue (const SmartPtr<ImageHandler::Parameters> &param, XCamReturn err);
+    // run @worker on threads set by set_threads, worker keeps own threads if none set
+    bool share_threads (const SmartPtr<SoftWorker> &worker);
 
 private:
+    XCamReturn configure (const SmartPtr<Parameters> &param);
+    XCamReturn prepare_param (const SmartPtr<Parameters> &param, SmartPtr<SyncMeta> &sync_meta);
     void param_ended (SmartPtr<ImageHandler::Parameters> param, XCamReturn err);
     static bool is_param_error (const SmartPtr<ImageHandler::Parameters> &param);
 
@@ -0,0 +1,179 @@
+/*
+ * soft_image_warp.cpp - soft image warp implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_image_warp.h"
+
+namespace XCam {
+
+static void
+reset_warp_config (XCamDVSResult &config)
+{
+    xcam_mem_clear (config);
+    config.frame_id = -1;
+    config.proj_mat[0] = 1.0;
+    config.proj_mat[4] = 1.0;
+    config.proj_mat[8] = 1.0;
+}
+
+SoftImageWarp::SoftImageWarp (const char *name)
+    : SoftGeoMapper (name)
+    , _config_changed (true)
+    , _trim_ratio (XCAM_SOFT_IMAGE_WARP_TRIM_RATIO)
+    , _lut_width (0)
+    , _lut_height (0)
+{
+    reset_warp_config (_config);
+}
+
+SoftImageWarp::~SoftImageWarp ()
+{
+}
+
+bool
+SoftImageWarp::set_warp_config (const XCamDVSResult &config)
+{
+    SmartLock locker (_config_mutex);
+    _config = config;
+    _config_changed = true;
+    return true;
+}
+
+bool
+SoftImageWarp::set_trim_ratio (float ratio)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, ratio >= 0.0f && ratio < 0.5f, false,
+        "SoftImageWarp(%s) trim ratio(%.3f) need be in range [0, 0.5)", XCAM_STR (get_name ()), ratio);
+
+    SmartLock locker (_config_mutex);
+    _trim_ratio = ratio;
+    _config_changed = true;
+    return true;
+}
+
+XCamReturn
+SoftImageWarp::warp (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out_buf)
+{
+    return remap (in, out_buf);
+}
+
+XCamReturn
+SoftImageWarp::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    set_output_size (in_info.width, in_info.height);
+
+    _lut_width = XCAM_ALIGN_UP (in_info.width - 1, XCAM_SOFT_IMAGE_WARP_LUT_STEP) / XCAM_SOFT_IMAGE_WARP_LUT_STEP + 1;
+    _lut_height = XCAM_ALIGN_UP (in_info.height - 1, XCAM_SOFT_IMAGE_WARP_LUT_STEP) / XCAM_SOFT_IMAGE_WARP_LUT_STEP + 1;
+    _lut_data.resize (_lut_width * _lut_height);
+
+    XCAM_FAIL_RETURN (
+        ERROR, update_lookup_table (in_info), XCAM_RETURN_ERROR_PARAM,
+        "SoftImageWarp(%s) init lookup table failed", XCAM_STR (get_name ()));
+
+    return SoftGeoMapper::configure_resource (param);
+}
+
+bool
+SoftImageWarp::update_lookup_table (const VideoBufferInfo &in_info)
+{
+    XCamDVSResult config;
+    float trim_ratio;
+    {
+        SmartLock locker (_config_mutex);
+        config = _config;
+        trim_ratio = _trim_ratio;
+        _config_changed = false;
+    }
+
+    // matrix was estimated on frame_width x frame_height, rescale it to input size
+    double scale[3] = {1.0, 1.0, 1.0};
+    if (config.frame_width > 0 && config.frame_height > 0) {
+        scale[0] = (double)config.frame_width / in_info.width;
+        scale[1] = (double)config.frame_height / in_info.height;
+    }
+    double mat[9];
+    for (uint32_t i = 0; i < 3; ++i)
+        for (uint32_t j = 0; j < 3; ++j)
+            mat[i * 3 + j] = config.proj_mat[i * 3 + j] * scale[j] / scale[i];
+
+    const double max_x = in_info.width - 1.0;
+    const double max_y = in_info.height - 1.0;
+    const double step_x = max_x / (_lut_width - 1.0);
+    const double step_y = max_y / (_lut_height - 1.0);
+    const double crop_scale = 1.0 - 2.0 * trim_ratio;
+    const double crop_x = trim_ratio * in_info.width;
+    const double crop_y = trim_ratio * in_info.height;
+
+    for (uint32_t y = 0; y < _lut_height; ++y) {
+        PointFloat2 *line = &_lut_data[y * _lut_width];
+        double out_y = crop_y + y * step_y * crop_scale;
+        for (uint32_t x = 0; x < _lut_width; ++x) {
+            double out_x = crop_x + x * step_x * crop_scale;
+            double px = mat[0] * out_x + mat[1] * out_y + mat[2];
+            double py = mat[3] * out_x + mat[4] * out_y + mat[5];
+            double pz = mat[6] * out_x + mat[7] * out_y + mat[8];
+            if (!XCAM_DOUBLE_EQUAL_AROUND (pz, 0.0)) {
+                px /= pz;
+                py /= pz;
+            }
+            line[x] = PointFloat2 (XCAM_CLAMP (px, 0.0, max_x), XCAM_CLAMP (py, 0.0, max_y));
+        }
+    }
+
+    return set_lookup_table (&_lut_data[0], _lut_width, _lut_height);
+}
+
+XCamReturn
+SoftImageWarp::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    bool changed;
+    {
+        SmartLock locker (_config_mutex);
+        changed = _config_changed;
+    }
+    if (changed) {
+        XCAM_FAIL_RETURN (
+            ERROR, update_lookup_table (param->in_buf->get_video_info ()), XCAM_RETURN_ERROR_PARAM,
+            "SoftImageWarp(%s) update lookup table failed", XCAM_STR (get_name ()));
+    }
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = start_remap_task (param);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftImageWarp(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+SmartPtr<SoftHandler>
+create_soft_image_warp ()
+{
+    SmartPtr<SoftHandler> warp = new SoftImageWarp ();
+    XCAM_ASSERT (warp.ptr ());
+
+    return warp;
+}
+
+}
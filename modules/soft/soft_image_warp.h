@@ -0,0 +1,75 @@
+/*
+ * soft_image_warp.h - soft image warp class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_IMAGE_WARP_H
+#define XCAM_SOFT_IMAGE_WARP_H
+
+#include <xcam_std.h>
+#include <base/xcam_smart_result.h>
+#include <soft/soft_geo_mapper.h>
+
+#define XCAM_SOFT_IMAGE_WARP_LUT_STEP 16
+#define XCAM_SOFT_IMAGE_WARP_TRIM_RATIO 0.05f
+
+namespace XCam {
+
+/* perspective warp by DVS results on CPU, NV12 only, output size is same as input.
+ * projection matrix maps output to input pixels, it is sampled into the geomap
+ * lookup table every XCAM_SOFT_IMAGE_WARP_LUT_STEP pixels when a new config comes.
+ * output is cropped by trim ratio on each side then scaled back to full size.
+ */
+class SoftImageWarp
+    : public SoftGeoMapper
+{
+public:
+    explicit SoftImageWarp (const char *name = "SoftImageWarp");
+    ~SoftImageWarp ();
+
+    // latest config is used by following frames, thread safe
+    bool set_warp_config (const XCamDVSResult &config);
+    bool set_trim_ratio (float ratio);
+
+    XCamReturn warp (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out_buf);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    bool update_lookup_table (const VideoBufferInfo &in_info);
+
+    XCAM_DEAD_COPY (SoftImageWarp);
+
+private:
+    Mutex                       _config_mutex;
+    XCamDVSResult               _config;
+    bool                        _config_changed;
+    float                       _trim_ratio;
+    uint32_t                    _lut_width;
+    uint32_t                    _lut_height;
+    std::vector<PointFloat2>    _lut_data;
+};
+
+extern SmartPtr<SoftHandler> create_soft_image_warp ();
+
+}
+
+#endif //XCAM_SOFT_IMAGE_WARP_H
@@ -0,0 +1,719 @@
+/*
+ * soft_post_image_processor.cpp - soft post image processor
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_post_image_processor.h"
+#include "soft_video_buf_allocator.h"
+#include "soft_downscaler.h"
+#include "soft_bayer_pipe_handler.h"
+#include "soft_image_warp.h"
+#include "soft_tnr_handler.h"
+#include "soft_defog_dcp_handler.h"
+#include "soft_retinex_handler.h"
+#include "soft_wavelet_denoise_handler.h"
+#include "soft_3d_denoise_handler.h"
+#include "soft_tonemapping_handler.h"
+#include "thread_pool.h"
+#include "x3a_result.h"
+#include <unistd.h>
+
+#define XCAM_SOFT_POST_IMAGE_POOL_SIZE 6
+#define XCAM_SOFT_POST_MAX_THREADS 64
+
+#define XCAM_SOFT_WIRE_FRAME_BORDER 2
+#define XCAM_SOFT_WIRE_FRAME_Y 120
+#define XCAM_SOFT_WIRE_FRAME_U 70
+#define XCAM_SOFT_WIRE_FRAME_V 24
+
+namespace XCam {
+
+#define STREAM_LOCK SmartLock stream_lock (this->_stream_mutex)
+
+SoftPostImageProcessor::SoftPostImageProcessor ()
+    : ImageProcessor ("SoftPostImageProcessor")
+    , _output_fourcc (V4L2_PIX_FMT_NV12)
+    , _thread_count (0)
+    , _scaler_factor (1.0)
+    , _tnr_mode (TnrDisable)
+    , _defog_mode (DefogDisabled)
+    , _wavelet_basis (WaveletDisabled)
+    , _wavelet_channel (XCAM_SOFT_WAVELET_CHANNEL_UV)
+    , _wavelet_bayes_shrink (false)
+    , _3d_denoise_mode (Denoise3DDisabled)
+    , _3d_denoise_ref_count (XCAM_SOFT_3D_DENOISE_DEFAULT_REF_COUNT)
+    , _enable_tonemapping (false)
+    , _enable_scaler (false)
+    , _enable_wireframe (false)
+    , _enable_image_warp (false)
+{
+    XCAM_LOG_DEBUG ("SoftPostImageProcessor constructed");
+}
+
+SoftPostImageProcessor::~SoftPostImageProcessor ()
+{
+    XCAM_LOG_DEBUG ("SoftPostImageProcessor destructed");
+}
+
+bool
+SoftPostImageProcessor::set_output_format (uint32_t fourcc)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, fourcc == V4L2_PIX_FMT_NV12, false,
+        "soft post processor doesn't support output format: %s", xcam_fourcc_to_string (fourcc));
+
+    _output_fourcc = fourcc;
+    return true;
+}
+
+void
+SoftPostImageProcessor::set_stats_callback (const SmartPtr<StatsCallback> &callback)
+{
+    XCAM_ASSERT (callback.ptr ());
+    _stats_callback = callback;
+}
+
+bool
+SoftPostImageProcessor::set_scaler_factor (const double factor)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, factor > 0.0 && factor <= 1.0, false,
+        "soft post processor scaler factor(%.3f) need be in range (0, 1]", factor);
+
+    STREAM_LOCK;
+    _scaler_factor = factor;
+    return true;
+}
+
+bool
+SoftPostImageProcessor::set_tnr (TnrMode mode)
+{
+    STREAM_LOCK;
+    _tnr_mode = mode;
+    return true;
+}
+
+bool
+SoftPostImageProcessor::set_defog_mode (DefogMode mode)
+{
+    STREAM_LOCK;
+    _defog_mode = mode;
+    return true;
+}
+
+bool
+SoftPostImageProcessor::set_wavelet (WaveletBasis basis, uint32_t channel, bool bayes_shrink)
+{
+    STREAM_LOCK;
+    _wavelet_basis = basis;
+    _wavelet_channel = channel;
+    _wavelet_bayes_shrink = bayes_shrink;
+    return true;
+}
+
+bool
+SoftPostImageProcessor::set_3ddenoise_mode (Denoise3DMode mode, uint8_t ref_frame_count)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, ref_frame_count && ref_frame_count <= XCAM_SOFT_3D_DENOISE_MAX_REF_COUNT, false,
+        "soft post processor 3d denoise ref count(%d) need be in range [1, %d]",
+        ref_frame_count, XCAM_SOFT_3D_DENOISE_MAX_REF_COUNT);
+
+    STREAM_LOCK;
+    _3d_denoise_mode = mode;
+    _3d_denoise_ref_count = ref_frame_count;
+    return true;
+}
+
+bool
+SoftPostImageProcessor::set_tonemapping (bool enable)
+{
+    STREAM_LOCK;
+    _enable_tonemapping = enable;
+    return true;
+}
+
+bool
+SoftPostImageProcessor::set_scaler (bool enable)
+{
+    STREAM_LOCK;
+    _enable_scaler = enable;
+    return true;
+}
+
+bool
+SoftPostImageProcessor::set_wireframe (bool enable)
+{
+    STREAM_LOCK;
+    _enable_wireframe = enable;
+    return true;
+}
+
+bool
+SoftPostImageProcessor::set_image_warp (bool enable)
+{
+    STREAM_LOCK;
+    _enable_image_warp = enable;
+    return true;
+}
+
+bool
+SoftPostImageProcessor::set_thread_count (uint32_t count)
+{
+    STREAM_LOCK;
+    XCAM_FAIL_RETURN (
+        WARNING, !_threads.ptr (), false,
+        "soft post processor thread count can NOT be changed after started");
+
+    _thread_count = XCAM_MIN (count, XCAM_SOFT_POST_MAX_THREADS);
+    return true;
+}
+
+bool
+SoftPostImageProcessor::can_process_result (SmartPtr<X3aResult> &result)
+{
+    if (!result.ptr ())
+        return false;
+
+    switch (result->get_type ()) {
+    case XCAM_3A_RESULT_BLACK_LEVEL:
+    case XCAM_3A_RESULT_WHITE_BALANCE:
+    case XCAM_3A_RESULT_G_GAMMA:
+    case XCAM_3A_RESULT_Y_GAMMA:
+    case XCAM_3A_RESULT_RGB2YUV_MATRIX:
+    case XCAM_3A_RESULT_TEMPORAL_NOISE_REDUCTION_YUV:
+    case XCAM_3A_RESULT_3D_NOISE_REDUCTION:
+    case XCAM_3A_RESULT_WAVELET_NOISE_REDUCTION:
+    case XCAM_3A_RESULT_FACE_DETECTION:
+    case XCAM_3A_RESULT_DVS:
+        return true;
+    default:
+        return false;
+    }
+
+    return false;
+}
+
+XCamReturn
+SoftPostImageProcessor::apply_3a_results (X3aResultList &results)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    for (X3aResultList::iterator iter = results.begin (); iter != results.end (); ++iter)
+    {
+        SmartPtr<X3aResult> &result = *iter;
+        ret = apply_3a_result (result);
+        if (ret != XCAM_RETURN_NO_ERROR)
+            break;
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftPostImageProcessor::apply_3a_result (SmartPtr<X3aResult> &result)
+{
+    if (!result.ptr ())
+        return XCAM_RETURN_BYPASS;
+
+    uint32_t res_type = result->get_type ();
+
+    switch (res_type) {
+    case XCAM_3A_RESULT_BLACK_LEVEL: {
+        SmartPtr<X3aBlackLevelResult> bl_res = result.dynamic_cast_ptr<X3aBlackLevelResult> ();
+        XCAM_ASSERT (bl_res.ptr ());
+        STREAM_LOCK;
+        // bayer results are kept for bayer pipe created later on first raw buffer
+        _blc_result = bl_res;
+        if (_bayer_pipe.ptr ()) {
+            _bayer_pipe->set_blc_config (bl_res->get_standard_result ());
+        }
+        break;
+    }
+    case XCAM_3A_RESULT_WHITE_BALANCE: {
+        SmartPtr<X3aWhiteBalanceResult> wb_res = result.dynamic_cast_ptr<X3aWhiteBalanceResult> ();
+        XCAM_ASSERT (wb_res.ptr ());
+        STREAM_LOCK;
+        _wb_result = wb_res;
+        if (_bayer_pipe.ptr ()) {
+            _bayer_pipe->set_wb_config (wb_res->get_standard_result ());
+        }
+        break;
+    }
+    case XCAM_3A_RESULT_G_GAMMA:
+    case XCAM_3A_RESULT_Y_GAMMA: {
+        SmartPtr<X3aGammaTableResult> gamma_res = result.dynamic_cast_ptr<X3aGammaTableResult> ();
+        XCAM_ASSERT (gamma_res.ptr ());
+        STREAM_LOCK;
+        _gamma_result = gamma_res;
+        if (_bayer_pipe.ptr ()) {
+            _bayer_pipe->set_gamma_table (gamma_res->get_standard_result ());
+        }
+        break;
+    }
+    case XCAM_3A_RESULT_RGB2YUV_MATRIX: {
+        SmartPtr<X3aColorMatrixResult> csc_res = result.dynamic_cast_ptr<X3aColorMatrixResult> ();
+        XCAM_ASSERT (csc_res.ptr ());
+        STREAM_LOCK;
+        _rgb2yuv_result = csc_res;
+        if (_bayer_pipe.ptr ()) {
+            _bayer_pipe->set_rgb2yuv_matrix (csc_res->get_standard_result ());
+        }
+        break;
+    }
+    case XCAM_3A_RESULT_TEMPORAL_NOISE_REDUCTION_YUV: {
+        SmartPtr<X3aTemporalNoiseReduction> tnr_res = result.dynamic_cast_ptr<X3aTemporalNoiseReduction> ();
+        XCAM_ASSERT (tnr_res.ptr ());
+        STREAM_LOCK;
+        // kept for tnr handler created later on first buffer
+        _tnr_result = tnr_res;
+        if (_tnr.ptr ()) {
+            _tnr->set_yuv_config (tnr_res->get_standard_result ());
+        }
+        break;
+    }
+    case XCAM_3A_RESULT_3D_NOISE_REDUCTION: {
+        SmartPtr<X3aTemporalNoiseReduction> nr_res = result.dynamic_cast_ptr<X3aTemporalNoiseReduction> ();
+        XCAM_ASSERT (nr_res.ptr ());
+        STREAM_LOCK;
+        // kept for 3d denoise handler created later on first buffer
+        _3d_denoise_result = nr_res;
+        if (_3d_denoise.ptr ()) {
+            _3d_denoise->set_denoise_config (nr_res->get_standard_result ());
+        }
+        break;
+    }
+    case XCAM_3A_RESULT_WAVELET_NOISE_REDUCTION: {
+        SmartPtr<X3aWaveletNoiseReduction> wavelet_res = result.dynamic_cast_ptr<X3aWaveletNoiseReduction> ();
+        XCAM_ASSERT (wavelet_res.ptr ());
+        STREAM_LOCK;
+        // kept for wavelet handler created later on first buffer
+        _wavelet_result = wavelet_res;
+        if (_wavelet.ptr ()) {
+            _wavelet->set_denoise_config (wavelet_res->get_standard_result ());
+        }
+        break;
+    }
+    case XCAM_3A_RESULT_FACE_DETECTION: {
+        SmartPtr<X3aFaceDetectionResult> fd_res = result.dynamic_cast_ptr<X3aFaceDetectionResult> ();
+        XCAM_ASSERT (fd_res.ptr ());
+        const XCamFDResult *fd = fd_res->get_standard_result_ptr ();
+        XCAM_ASSERT (fd);
+
+        // faces were detected on scaled image
+        double factor = get_scaler_factor ();
+        SmartLock locker (_wire_frames_mutex);
+        _wire_frames.clear ();
+        for (uint32_t i = 0; i < fd->face_num; ++i) {
+            const XCamFaceInfo &face = fd->faces[i];
+            _wire_frames.push_back (Rect (
+                (int32_t)(face.pos_x / factor / 2) * 2, (int32_t)(face.pos_y / factor / 2) * 2,
+                (int32_t)(face.width / factor / 2) * 2, (int32_t)(face.height / factor / 2) * 2));
+        }
+        break;
+    }
+    case XCAM_3A_RESULT_DVS: {
+        SmartPtr<X3aDVSResult> dvs_res = result.dynamic_cast_ptr<X3aDVSResult> ();
+        XCAM_ASSERT (dvs_res.ptr ());
+        STREAM_LOCK;
+        // kept for image warp created later on first buffer
+        _dvs_result = dvs_res;
+        if (_image_warp.ptr ()) {
+            _image_warp->set_warp_config (dvs_res->get_standard_result ());
+        }
+        break;
+    }
+    default:
+        XCAM_LOG_WARNING ("SoftPostImageProcessor unknown 3a result: %d", res_type);
+        break;
+    }
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftPostImageProcessor::add_stage (const SmartPtr<SoftHandler> &handler, bool enable)
+{
+    if (handler.ptr ()) {
+        // stage outputs come from processor pools
+        handler->enable_allocator (false);
+        handler->set_threads (_threads);
+    }
+    _stages.push_back (Stage (handler, enable));
+}
+
+XCamReturn
+SoftPostImageProcessor::create_handlers (const VideoBufferInfo &in_info)
+{
+    const bool is_bayer = SoftBayerPipeHandler::is_supported_format (in_info.format);
+    XCAM_FAIL_RETURN (
+        WARNING, in_info.format == V4L2_PIX_FMT_NV12 || is_bayer, XCAM_RETURN_ERROR_PARAM,
+        "SoftPostImageProcessor only support NV12 or bayer input, but input format is %s",
+        xcam_fourcc_to_string (in_info.format));
+
+    uint32_t thread_count = _thread_count;
+    if (!thread_count)
+        thread_count = XCAM_CLAMP (sysconf (_SC_NPROCESSORS_ONLN), 1, XCAM_SOFT_POST_MAX_THREADS);
+
+    _threads = new ThreadPool ("soft_post_thrs");
+    XCAM_ASSERT (_threads.ptr ());
+    // extra thread to process all_items_done of stage workers
+    _threads->set_threads (thread_count, thread_count + 1);
+
+    /* bayer pipe, raw to NV12 of same size */
+    if (is_bayer) {
+        SmartPtr<SoftHandler> handler = create_soft_bayer_pipe_handler ();
+        _bayer_pipe = handler.dynamic_cast_ptr<SoftBayerPipeHandler> ();
+        XCAM_FAIL_RETURN (
+            WARNING, _bayer_pipe.ptr (), XCAM_RETURN_ERROR_MEM,
+            "SoftPostImageProcessor create bayer pipe handler failed");
+        if (_blc_result.ptr ())
+            _bayer_pipe->set_blc_config (_blc_result->get_standard_result ());
+        if (_wb_result.ptr ())
+            _bayer_pipe->set_wb_config (_wb_result->get_standard_result ());
+        if (_gamma_result.ptr ())
+            _bayer_pipe->set_gamma_table (_gamma_result->get_standard_result ());
+        if (_rgb2yuv_result.ptr ())
+            _bayer_pipe->set_rgb2yuv_matrix (_rgb2yuv_result->get_standard_result ());
+        add_stage (handler, true);
+    }
+
+    /* defog */
+    switch (_defog_mode) {
+    case DefogDarkChannelPrior: {
+        SmartPtr<SoftHandler> handler = create_soft_defog_dcp_handler ();
+        XCAM_FAIL_RETURN (
+            WARNING, handler.ptr (), XCAM_RETURN_ERROR_MEM,
+            "SoftPostImageProcessor create defog handler failed");
+        add_stage (handler, true);
+        break;
+    }
+    case DefogRetinex: {
+        SmartPtr<SoftHandler> handler = create_soft_retinex_handler ();
+        XCAM_FAIL_RETURN (
+            WARNING, handler.ptr (), XCAM_RETURN_ERROR_MEM,
+            "SoftPostImageProcessor create retinex handler failed");
+        add_stage (handler, true);
+        break;
+    }
+    case DefogDisabled:
+        XCAM_LOG_DEBUG ("SoftPostImageProcessor disable defog");
+        break;
+    default:
+        XCAM_LOG_WARNING ("SoftPostImageProcessor unknown defog mode (%d)", _defog_mode);
+        break;
+    }
+
+    /* temporal noise reduction */
+    switch (_tnr_mode) {
+    case TnrYuv: {
+        SmartPtr<SoftHandler> handler = create_soft_tnr_handler ();
+        _tnr = handler.dynamic_cast_ptr<SoftTnrHandler> ();
+        XCAM_FAIL_RETURN (
+            WARNING, _tnr.ptr (), XCAM_RETURN_ERROR_MEM,
+            "SoftPostImageProcessor create tnr handler failed");
+        if (_tnr_result.ptr ())
+            _tnr->set_yuv_config (_tnr_result->get_standard_result ());
+        add_stage (handler, true);
+        break;
+    }
+    case TnrDisable:
+        XCAM_LOG_DEBUG ("SoftPostImageProcessor disable tnr");
+        break;
+    default:
+        XCAM_LOG_WARNING ("SoftPostImageProcessor unknown tnr mode (%d)", _tnr_mode);
+        break;
+    }
+
+    /* wavelet denoise */
+    switch (_wavelet_basis) {
+    case WaveletHat:
+    case WaveletHaar: {
+        // CDF 5/3 takes the hat basis, its synthesis scaling function is the hat function
+        SmartPtr<SoftHandler> handler = create_soft_wavelet_denoise_handler (
+            (_wavelet_basis == WaveletHat) ? SoftWaveletCdf53 : SoftWaveletHaar,
+            _wavelet_channel, _wavelet_bayes_shrink);
+        _wavelet = handler.dynamic_cast_ptr<SoftWaveletDenoiseHandler> ();
+        XCAM_FAIL_RETURN (
+            WARNING, _wavelet.ptr (), XCAM_RETURN_ERROR_MEM,
+            "SoftPostImageProcessor create wavelet denoise handler failed");
+        if (_wavelet_result.ptr ())
+            _wavelet->set_denoise_config (_wavelet_result->get_standard_result ());
+        add_stage (handler, true);
+        break;
+    }
+    case WaveletDisabled:
+        XCAM_LOG_DEBUG ("SoftPostImageProcessor disable wavelet");
+        break;
+    default:
+        XCAM_LOG_WARNING ("SoftPostImageProcessor unknown wavelet basis (%d)", _wavelet_basis);
+        break;
+    }
+
+    /* 3d denoise */
+    switch (_3d_denoise_mode) {
+    case Denoise3DYuv:
+    case Denoise3DUV: {
+        uint32_t channel = XCAM_SOFT_3D_DENOISE_CHANNEL_UV;
+        if (_3d_denoise_mode == Denoise3DYuv)
+            channel |= XCAM_SOFT_3D_DENOISE_CHANNEL_Y;
+        SmartPtr<SoftHandler> handler = create_soft_3d_denoise_handler (channel, _3d_denoise_ref_count);
+        _3d_denoise = handler.dynamic_cast_ptr<Soft3DDenoiseHandler> ();
+        XCAM_FAIL_RETURN (
+            WARNING, _3d_denoise.ptr (), XCAM_RETURN_ERROR_MEM,
+            "SoftPostImageProcessor create 3d denoise handler failed");
+        if (_3d_denoise_result.ptr ())
+            _3d_denoise->set_denoise_config (_3d_denoise_result->get_standard_result ());
+        add_stage (handler, true);
+        break;
+    }
+    case Denoise3DDisabled:
+        XCAM_LOG_DEBUG ("SoftPostImageProcessor disable 3d denoise");
+        break;
+    default:
+        XCAM_LOG_WARNING ("SoftPostImageProcessor unknown 3d denoise mode (%d)", _3d_denoise_mode);
+        break;
+    }
+
+    /* local tone mapping, after denoise so that lifted shadows carry less noise */
+    if (_enable_tonemapping) {
+        SmartPtr<SoftHandler> handler = create_soft_tonemapping_handler ();
+        XCAM_FAIL_RETURN (
+            WARNING, handler.ptr (), XCAM_RETURN_ERROR_MEM,
+            "SoftPostImageProcessor create tonemapping handler failed");
+        add_stage (handler, true);
+    }
+
+    /* image scaler, scaled image goes to stats callback, main image passes through */
+    if (_enable_scaler) {
+        uint32_t width = XCAM_ALIGN_UP ((uint32_t)(in_info.width * _scaler_factor), 2);
+        uint32_t height = XCAM_ALIGN_UP ((uint32_t)(in_info.height * _scaler_factor), 2);
+        width = XCAM_MIN (width, in_info.width);
+        height = XCAM_MIN (height, in_info.height);
+
+        SmartPtr<SoftHandler> handler = create_soft_downscaler (width, height);
+        _scaler = handler.dynamic_cast_ptr<SoftDownscaler> ();
+        XCAM_FAIL_RETURN (
+            WARNING, _scaler.ptr (), XCAM_RETURN_ERROR_MEM,
+            "SoftPostImageProcessor create scaler handler failed");
+        add_stage (handler, true);
+    }
+
+    /* wire frame, drawn in place */
+    add_stage (NULL, _enable_wireframe);
+
+    /* image warp */
+    if (_enable_image_warp) {
+        SmartPtr<SoftHandler> handler = create_soft_image_warp ();
+        _image_warp = handler.dynamic_cast_ptr<SoftImageWarp> ();
+        XCAM_FAIL_RETURN (
+            WARNING, _image_warp.ptr (), XCAM_RETURN_ERROR_MEM,
+            "SoftPostImageProcessor create image warp handler failed");
+        if (_dvs_result.ptr ())
+            _image_warp->set_warp_config (_dvs_result->get_standard_result ());
+        add_stage (handler, true);
+    }
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SmartPtr<VideoBuffer>
+SoftPostImageProcessor::get_stage_buffer (uint32_t width, uint32_t height, uint32_t pool_size)
+{
+    uint64_t key = ((uint64_t)width << 32) | height;
+    SmartPtr<BufferPool> pool;
+    {
+        SmartLock locker (_pools_mutex);
+        SmartPtr<BufferPool> &entry = _buf_pools[key];
+        if (!entry.ptr ()) {
+            VideoBufferInfo info;
+            info.init (V4L2_PIX_FMT_NV12, width, height, XCAM_ALIGN_UP (width, 16), XCAM_ALIGN_UP (height, 16));
+            entry = new SoftVideoBufAllocator (info);
+            XCAM_ASSERT (entry.ptr ());
+            if (!entry->reserve (pool_size)) {
+                XCAM_LOG_ERROR ("SoftPostImageProcessor reserve buffers(%dx%d) failed", width, height);
+                _buf_pools.erase (key);
+                return NULL;
+            }
+        }
+        pool = entry;
+    }
+
+    // blocks until a buffer is free or the pool is stopped, no lock is held here
+    return pool->get_buffer (pool);
+}
+
+void
+SoftPostImageProcessor::draw_wire_frames (const SmartPtr<VideoBuffer> &buf)
+{
+    std::vector<Rect> frames;
+    {
+        SmartLock locker (_wire_frames_mutex);
+        frames = _wire_frames;
+    }
+    if (frames.empty ())
+        return;
+
+    const VideoBufferInfo &info = buf->get_video_info ();
+    uint8_t *mem = buf->map ();
+    XCAM_FAIL_RETURN (ERROR, mem, , "SoftPostImageProcessor map buffer failed in drawing wire frames");
+
+    uint8_t *luma = mem + info.offsets[0];
+    uint8_t *uv = mem + info.offsets[1];
+    const int32_t border = XCAM_SOFT_WIRE_FRAME_BORDER;
+
+    for (size_t i = 0; i < frames.size (); ++i) {
+        // clip to image, keep even for uv
+        int32_t x0 = XCAM_CLAMP (frames[i].pos_x, 0, (int32_t)info.width) & ~1;
+        int32_t y0 = XCAM_CLAMP (frames[i].pos_y, 0, (int32_t)info.height) & ~1;
+        int32_t x1 = XCAM_CLAMP (frames[i].pos_x + frames[i].width, 0, (int32_t)info.width) & ~1;
+        int32_t y1 = XCAM_CLAMP (frames[i].pos_y + frames[i].height, 0, (int32_t)info.height) & ~1;
+        if (x1 - x0 <= 2 * border || y1 - y0 <= 2 * border)
+            continue;
+
+        for (int32_t y = y0; y < y1; ++y) {
+            bool edge_row = (y < y0 + border || y >= y1 - border);
+            uint8_t *line = luma + y * info.strides[0];
+            uint8_t *uv_line = uv + (y / 2) * info.strides[1];
+            for (int32_t x = x0; x < x1; x += 2) {
+                if (!edge_row && x >= x0 + border && x < x1 - border) {
+                    x = x1 - border - 2;
+                    continue;
+                }
+                line[x] = line[x + 1] = XCAM_SOFT_WIRE_FRAME_Y;
+                uv_line[x] = XCAM_SOFT_WIRE_FRAME_U;
+                uv_line[x + 1] = XCAM_SOFT_WIRE_FRAME_V;
+            }
+        }
+    }
+
+    buf->unmap ();
+}
+
+XCamReturn
+SoftPostImageProcessor::process_buffer (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    XCAM_ASSERT (input.ptr ());
+
+    // stages run on copies taken under stream lock, so that 3a results and emit_stop
+    // are not blocked for a whole frame, handlers guard their own configs
+    StageList stages;
+    SmartPtr<SoftDownscaler> scaler;
+    SmartPtr<StatsCallback> stats_callback;
+    uint32_t pool_size = XCAM_SOFT_POST_IMAGE_POOL_SIZE;
+    {
+        STREAM_LOCK;
+        if (!_threads.ptr ()) {
+            ret = create_handlers (input->get_video_info ());
+            XCAM_FAIL_RETURN (
+                WARNING, xcam_ret_is_ok (ret), ret,
+                "SoftPostImageProcessor create handlers failed");
+        }
+
+        stages = _stages;
+        scaler = _scaler;
+        stats_callback = _stats_callback;
+        // tnr and 3d denoise hold their former outputs as references
+        if (_tnr.ptr ())
+            pool_size += _tnr->get_ref_count ();
+        if (_3d_denoise.ptr ())
+            pool_size += _3d_denoise_ref_count;
+    }
+
+    SmartPtr<VideoBuffer> buf = input;
+    for (StageList::iterator i = stages.begin (); i != stages.end (); ++i) {
+        Stage &stage = *i;
+        if (!stage.enabled)
+            continue;
+
+        // NULL handler stands for wire frame drawing
+        if (!stage.handler.ptr ()) {
+            draw_wire_frames (buf);
+            continue;
+        }
+
+        const VideoBufferInfo &in_info = buf->get_video_info ();
+        uint32_t width = in_info.width;
+        uint32_t height = in_info.height;
+        if (scaler.ptr () && stage.handler.ptr () == scaler.ptr ())
+            scaler->get_output_size (width, height);
+
+        SmartPtr<VideoBuffer> out = get_stage_buffer (width, height, pool_size);
+        XCAM_FAIL_RETURN (
+            WARNING, out.ptr (), XCAM_RETURN_ERROR_MEM,
+            "SoftPostImageProcessor get output buffer of stage(%s) failed",
+            XCAM_STR (stage.handler->get_name ()));
+
+        SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (buf, out);
+        ret = stage.handler->execute_buffer (param, true);
+        XCAM_FAIL_RETURN (
+            WARNING, xcam_ret_is_ok (ret), ret,
+            "SoftPostImageProcessor stage(%s) execute buffer failed",
+            XCAM_STR (stage.handler->get_name ()));
+        out->set_timestamp (buf->get_timestamp ());
+
+        if (stage.handler.ptr () == scaler.ptr ()) {
+            if (stats_callback.ptr ())
+                stats_callback->scaled_image_ready (out);
+            continue;
+        }
+        buf = out;
+    }
+
+    output = buf;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftPostImageProcessor::emit_stop ()
+{
+    // stop pools before stream lock, it wakes up processing thread blocked in get_buffer
+    {
+        SmartLock locker (_pools_mutex);
+        for (BufferPoolMap::iterator i = _buf_pools.begin (); i != _buf_pools.end (); ++i) {
+            i->second->stop ();
+        }
+    }
+
+    STREAM_LOCK;
+
+    for (StageList::iterator i = _stages.begin (); i != _stages.end (); ++i) {
+        if ((*i).handler.ptr ())
+            (*i).handler->terminate ();
+    }
+
+    if (_threads.ptr ())
+        _threads->stop ();
+
+    // terminated handlers and stopped pools can't be reused, next start rebuilds all stages on first buffer
+    _stages.clear ();
+    {
+        SmartLock locker (_pools_mutex);
+        _buf_pools.clear ();
+    }
+    _bayer_pipe.release ();
+    _tnr.release ();
+    _wavelet.release ();
+    _3d_denoise.release ();
+    _scaler.release ();
+    _image_warp.release ();
+    _threads.release ();
+}
+
+};
@@ -0,0 +1,177 @@
+/*
+ * soft_post_image_processor.h - soft post image processor
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_POST_IMAGE_PROCESSOR_H
+#define XCAM_SOFT_POST_IMAGE_PROCESSOR_H
+
+#include <xcam_std.h>
+#include <image_processor.h>
+#include <stats_callback_interface.h>
+#include <interface/data_types.h>
+#include <x3a_result.h>
+#include <soft/soft_handler.h>
+#include <list>
+#include <map>
+
+namespace XCam {
+
+class ThreadPool;
+class SoftDownscaler;
+class SoftTnrHandler;
+class SoftWaveletDenoiseHandler;
+class Soft3DDenoiseHandler;
+class SoftBayerPipeHandler;
+class SoftImageWarp;
+
+/* CPU counterpart of CLPostImageProcessor on NV12 buffers.
+ * bayer input goes through SoftBayerPipeHandler to NV12 as the first stage.
+ * enabled stages run one after another in processor thread, each stage
+ * splits its frame into work items on one thread pool shared by all stages.
+ * stage outputs come from pools owned by processor and keyed by resolution,
+ * so consecutive stages of same size reuse the same few buffers.
+ */
+class SoftPostImageProcessor
+    : public ImageProcessor
+{
+public:
+    enum TnrMode {
+        TnrDisable = 0,
+        TnrYuv,
+    };
+
+    enum DefogMode {
+        DefogDisabled = 0,
+        DefogRetinex,
+        DefogDarkChannelPrior,
+    };
+
+    enum WaveletBasis {
+        WaveletDisabled = 0,
+        WaveletHat,
+        WaveletHaar,
+    };
+
+    enum Denoise3DMode {
+        Denoise3DDisabled = 0,
+        Denoise3DYuv,
+        Denoise3DUV,
+    };
+
+private:
+    struct Stage {
+        SmartPtr<SoftHandler>   handler;
+        bool                    enabled;
+
+        explicit Stage (const SmartPtr<SoftHandler> &h = NULL, bool enable = true)
+            : handler (h), enabled (enable) {}
+    };
+    typedef std::list<Stage> StageList;
+    typedef std::map<uint64_t, SmartPtr<BufferPool> > BufferPoolMap;
+
+public:
+    explicit SoftPostImageProcessor ();
+    virtual ~SoftPostImageProcessor ();
+
+    bool set_output_format (uint32_t fourcc);
+    void set_stats_callback (const SmartPtr<StatsCallback> &callback);
+
+    bool set_scaler_factor (const double factor);
+    double get_scaler_factor () const {
+        return _scaler_factor;
+    }
+    bool is_scaled () {
+        return _enable_scaler;
+    }
+
+    // stages are created on first buffer, setters take effect before start
+    virtual bool set_tnr (TnrMode mode);
+    virtual bool set_defog_mode (DefogMode mode);
+    virtual bool set_wavelet (WaveletBasis basis, uint32_t channel, bool bayes_shrink);
+    virtual bool set_3ddenoise_mode (Denoise3DMode mode, uint8_t ref_frame_count);
+    virtual bool set_tonemapping (bool enable);
+    virtual bool set_scaler (bool enable);
+    virtual bool set_wireframe (bool enable);
+    virtual bool set_image_warp (bool enable);
+    // 0, threads count same as cpu count
+    bool set_thread_count (uint32_t count);
+
+protected:
+    //derived from ImageProcessor
+    virtual bool can_process_result (SmartPtr<X3aResult> &result);
+    virtual XCamReturn apply_3a_results (X3aResultList &results);
+    virtual XCamReturn apply_3a_result (SmartPtr<X3aResult> &result);
+    virtual XCamReturn process_buffer (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+    virtual void emit_stop ();
+
+private:
+    XCamReturn create_handlers (const VideoBufferInfo &in_info);
+    void add_stage (const SmartPtr<SoftHandler> &handler, bool enable);
+    SmartPtr<VideoBuffer> get_stage_buffer (uint32_t width, uint32_t height, uint32_t pool_size);
+    void draw_wire_frames (const SmartPtr<VideoBuffer> &buf);
+
+    XCAM_DEAD_COPY (SoftPostImageProcessor);
+
+private:
+    uint32_t                          _output_fourcc;
+    SmartPtr<StatsCallback>           _stats_callback;
+    SmartPtr<ThreadPool>              _threads;
+    uint32_t                          _thread_count;
+    StageList                         _stages;
+    BufferPoolMap                     _buf_pools;
+
+    SmartPtr<SoftBayerPipeHandler>    _bayer_pipe;
+    SmartPtr<SoftTnrHandler>          _tnr;
+    SmartPtr<SoftWaveletDenoiseHandler> _wavelet;
+    SmartPtr<Soft3DDenoiseHandler>    _3d_denoise;
+    SmartPtr<SoftDownscaler>          _scaler;
+    SmartPtr<SoftImageWarp>           _image_warp;
+    SmartPtr<X3aBlackLevelResult>     _blc_result;
+    SmartPtr<X3aWhiteBalanceResult>   _wb_result;
+    SmartPtr<X3aGammaTableResult>     _gamma_result;
+    SmartPtr<X3aColorMatrixResult>    _rgb2yuv_result;
+    SmartPtr<X3aTemporalNoiseReduction> _tnr_result;
+    SmartPtr<X3aWaveletNoiseReduction> _wavelet_result;
+    SmartPtr<X3aTemporalNoiseReduction> _3d_denoise_result;
+    SmartPtr<X3aDVSResult>            _dvs_result;
+
+    double                            _scaler_factor;
+    TnrMode                           _tnr_mode;
+    DefogMode                         _defog_mode;
+    WaveletBasis                      _wavelet_basis;
+    uint32_t                          _wavelet_channel;
+    bool                              _wavelet_bayes_shrink;
+    Denoise3DMode                     _3d_denoise_mode;
+    uint8_t                           _3d_denoise_ref_count;
+    bool                              _enable_tonemapping;
+    bool                              _enable_scaler;
+    bool                              _enable_wireframe;
+    bool                              _enable_image_warp;
+
+    Mutex                             _wire_frames_mutex;
+    std::vector<Rect>                 _wire_frames;
+
+    // stream lock guards stages and config, it is not held while stages run
+    Mutex                             _stream_mutex;
+    // guards _buf_pools, emit_stop stops pools without stream lock
+    Mutex                             _pools_mutex;
+};
+
+};
+#endif // XCAM_SOFT_POST_IMAGE_PROCESSOR_H
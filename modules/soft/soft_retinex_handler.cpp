@@ -0,0 +1,297 @@
+/*
+ * soft_retinex_handler.cpp - soft retinex handler class implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_retinex_handler.h"
+#include "soft_retinex_tasks_priv.h"
+#include "soft_video_buf_allocator.h"
+
+// working planes of frames in flight
+#define XCAM_SOFT_RETINEX_PLANES_POOL_SIZE 2
+
+namespace XCam {
+
+// same scales and range as CLRetinexImageHandler, on image downscaled by 2
+static const float retinex_default_sigma[XCAM_SOFT_RETINEX_MAX_SCALES] = {2.0f, 8.0f, 20.0f};
+static const float retinex_default_log_min = -0.12f;
+static const float retinex_default_log_max = 0.18f;
+
+DECLARE_WORK_CALLBACK (CbRetinexGaussH, SoftRetinexHandler, gauss_h_done);
+DECLARE_WORK_CALLBACK (CbRetinexGaussV, SoftRetinexHandler, gauss_v_done);
+DECLARE_WORK_CALLBACK (CbRetinex, SoftRetinexHandler, retinex_done);
+
+SoftRetinexHandler::SoftRetinexHandler (const char *name)
+    : SoftHandler (name)
+    , _sigma (retinex_default_sigma, retinex_default_sigma + XCAM_SOFT_RETINEX_MAX_SCALES)
+    , _log_min (retinex_default_log_min)
+    , _log_max (retinex_default_log_max)
+{
+}
+
+SoftRetinexHandler::~SoftRetinexHandler ()
+{
+}
+
+bool
+SoftRetinexHandler::set_scales (const float *sigma, uint32_t count)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, sigma && count && count <= XCAM_SOFT_RETINEX_MAX_SCALES, false,
+        "SoftRetinexHandler(%s) scale count(%d) need be in range [1, %d]",
+        XCAM_STR (get_name ()), count, XCAM_SOFT_RETINEX_MAX_SCALES);
+
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "SoftRetinexHandler(%s) scales can NOT be changed after configured", XCAM_STR (get_name ()));
+
+    for (uint32_t i = 0; i < count; ++i) {
+        XCAM_FAIL_RETURN (
+            ERROR, sigma[i] >= 0.5f, false,
+            "SoftRetinexHandler(%s) sigma(%.3f) need be no less than 0.5", XCAM_STR (get_name ()), sigma[i]);
+    }
+
+    _sigma.assign (sigma, sigma + count);
+    return true;
+}
+
+bool
+SoftRetinexHandler::set_log_range (float log_min, float log_max)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, log_max > log_min, false,
+        "SoftRetinexHandler(%s) invalid log range [%.3f, %.3f]", XCAM_STR (get_name ()), log_min, log_max);
+
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "SoftRetinexHandler(%s) log range can NOT be changed after configured", XCAM_STR (get_name ()));
+
+    _log_min = log_min;
+    _log_max = log_max;
+    return true;
+}
+
+XCamReturn
+SoftRetinexHandler::retinex (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in, out);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftRetinexHandler::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        ERROR, in_info.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftRetinexHandler(%s) only support format(NV12) but input format is %s",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (in_info.format));
+
+    set_out_video_info (in_info);
+
+    const uint32_t work_width = xcam_ceil (in_info.width, XCAM_SOFT_RETINEX_DOWN_SCALE) / XCAM_SOFT_RETINEX_DOWN_SCALE;
+    const uint32_t work_height = xcam_ceil (in_info.height, XCAM_SOFT_RETINEX_DOWN_SCALE) / XCAM_SOFT_RETINEX_DOWN_SCALE;
+    VideoBufferInfo planes_info;
+    XCamSoftTasks::RetinexPlanes::get_buf_info (planes_info, work_width, work_height, _sigma.size ());
+    _planes_pool = new SoftVideoBufAllocator (planes_info);
+    XCAM_ASSERT (_planes_pool.ptr ());
+    XCAM_FAIL_RETURN (
+        ERROR, _planes_pool->reserve (XCAM_SOFT_RETINEX_PLANES_POOL_SIZE), XCAM_RETURN_ERROR_MEM,
+        "SoftRetinexHandler(%s) reserve working planes failed", XCAM_STR (get_name ()));
+
+    _table = new XCamSoftTasks::RetinexTable;
+    XCAM_ASSERT (_table.ptr ());
+    _table->init (&_sigma[0], _sigma.size (), _log_min, _log_max, in_info.width, work_width);
+
+    XCAM_ASSERT (!_gauss_h_task.ptr () && !_gauss_v_task.ptr () && !_retinex_task.ptr ());
+    _gauss_h_task = new XCamSoftTasks::RetinexGaussHTask (new CbRetinexGaussH (this));
+    _gauss_v_task = new XCamSoftTasks::RetinexGaussVTask (new CbRetinexGaussV (this));
+    _retinex_task = new XCamSoftTasks::RetinexTask (new CbRetinex (this));
+    XCAM_ASSERT (_gauss_h_task.ptr () && _gauss_v_task.ptr () && _retinex_task.ptr ());
+    share_threads (_gauss_h_task);
+    share_threads (_gauss_v_task);
+    share_threads (_retinex_task);
+
+    set_work_size (_gauss_h_task, 1, work_height);
+    set_work_size (
+        _gauss_v_task,
+        xcam_ceil (work_width, XCAM_SOFT_RETINEX_STRIP_WIDTH) / XCAM_SOFT_RETINEX_STRIP_WIDTH, 1);
+    set_work_size (_retinex_task, 1, in_info.height / 2);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftRetinexHandler::set_work_size (const SmartPtr<SoftWorker> &worker, uint32_t width, uint32_t height)
+{
+    uint32_t thread_x = (width > 1) ? 4 : 1;
+    uint32_t thread_y = (height > 1) ? 4 : 1;
+
+    WorkSize global_size (width, height);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    worker->set_local_size (local_size);
+    worker->set_global_size (global_size);
+}
+
+XCamReturn
+SoftRetinexHandler::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_gauss_h_task.ptr () && _planes_pool.ptr ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    SmartPtr<VideoBuffer> planes_buf = _planes_pool->get_buffer (_planes_pool);
+    XCAM_FAIL_RETURN (
+        ERROR, planes_buf.ptr (), XCAM_RETURN_ERROR_MEM,
+        "SoftRetinexHandler(%s) get working planes failed", XCAM_STR (get_name ()));
+
+    SmartPtr<XCamSoftTasks::RetinexPlanes> planes = new XCamSoftTasks::RetinexPlanes;
+    XCAM_ASSERT (planes.ptr ());
+    XCAM_FAIL_RETURN (
+        ERROR,
+        planes->init (
+            planes_buf,
+            xcam_ceil (in_info.width, XCAM_SOFT_RETINEX_DOWN_SCALE) / XCAM_SOFT_RETINEX_DOWN_SCALE,
+            xcam_ceil (in_info.height, XCAM_SOFT_RETINEX_DOWN_SCALE) / XCAM_SOFT_RETINEX_DOWN_SCALE,
+            _sigma.size ()),
+        XCAM_RETURN_ERROR_MEM,
+        "SoftRetinexHandler(%s) init working planes failed", XCAM_STR (get_name ()));
+
+    SmartPtr<XCamSoftTasks::RetinexGaussHTask::Args> args = new XCamSoftTasks::RetinexGaussHTask::Args (param);
+    args->in_luma = new UcharImage (param->in_buf, 0);
+    args->planes = planes;
+    args->table = _table;
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = _gauss_h_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftRetinexHandler(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+void
+SoftRetinexHandler::gauss_h_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _gauss_h_task.ptr ());
+
+    SmartPtr<XCamSoftTasks::RetinexGaussHTask::Args> args = base.dynamic_cast_ptr<XCamSoftTasks::RetinexGaussHTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    SmartPtr<XCamSoftTasks::RetinexGaussVTask::Args> next = new XCamSoftTasks::RetinexGaussVTask::Args (param);
+    next->planes = args->planes;
+    next->table = _table;
+
+    XCamReturn ret = _gauss_v_task->work (next);
+    if (!xcam_ret_is_ok (ret)) {
+        work_broken (param, ret);
+    }
+}
+
+void
+SoftRetinexHandler::gauss_v_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _gauss_v_task.ptr ());
+
+    SmartPtr<XCamSoftTasks::RetinexGaussVTask::Args> args = base.dynamic_cast_ptr<XCamSoftTasks::RetinexGaussVTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    SmartPtr<XCamSoftTasks::RetinexTask::Args> next = new XCamSoftTasks::RetinexTask::Args (param);
+    next->in_luma = new UcharImage (param->in_buf, 0);
+    next->in_uv = new Uchar2Image (param->in_buf, 1);
+    next->out_luma = new UcharImage (param->out_buf, 0);
+    next->out_uv = new Uchar2Image (param->out_buf, 1);
+    next->planes = args->planes;
+    next->table = _table;
+
+    XCamReturn ret = _retinex_task->work (next);
+    if (!xcam_ret_is_ok (ret)) {
+        work_broken (param, ret);
+    }
+}
+
+void
+SoftRetinexHandler::retinex_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _retinex_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    work_well_done (param, error);
+}
+
+XCamReturn
+SoftRetinexHandler::terminate ()
+{
+    if (_gauss_h_task.ptr ()) {
+        _gauss_h_task->stop ();
+        _gauss_h_task.release ();
+    }
+    if (_gauss_v_task.ptr ()) {
+        _gauss_v_task->stop ();
+        _gauss_v_task.release ();
+    }
+    if (_retinex_task.ptr ()) {
+        _retinex_task->stop ();
+        _retinex_task.release ();
+    }
+    if (_planes_pool.ptr ()) {
+        _planes_pool->stop ();
+        _planes_pool.release ();
+    }
+
+    return SoftHandler::terminate ();
+}
+
+SmartPtr<SoftHandler>
+create_soft_retinex_handler ()
+{
+    SmartPtr<SoftRetinexHandler> retinex = new SoftRetinexHandler ();
+    XCAM_ASSERT (retinex.ptr ());
+
+    return retinex;
+}
+
+}
@@ -0,0 +1,94 @@
+/*
+ * soft_retinex_handler.h - soft retinex handler class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_RETINEX_HANDLER_H
+#define XCAM_SOFT_RETINEX_HANDLER_H
+
+#include <xcam_std.h>
+#include <soft/soft_handler.h>
+#include <buffer_pool.h>
+#include <vector>
+
+namespace XCam {
+
+class SoftWorker;
+
+namespace XCamSoftTasks {
+struct RetinexPlanes;
+struct RetinexTable;
+};
+
+/* multi-scale retinex on NV12 luma, CPU counterpart of CLRetinexImageHandler.
+ * luma is downscaled by 2 once, all scales blur the same working image with
+ * recursive gaussian whose cost does not depend on sigma.
+ * output luma maps mean log10 ratio of pixel to its blurs from
+ * [log_min, log_max] to [0, 255], chroma is copied.
+ * working planes of each frame come from a small pool, so frames can be in flight together.
+ */
+class SoftRetinexHandler
+    : public SoftHandler
+{
+public:
+    explicit SoftRetinexHandler (const char *name = "SoftRetinexHandler");
+    ~SoftRetinexHandler ();
+
+    // sigma of scales on working image, scales and range can NOT be changed after configured
+    bool set_scales (const float *sigma, uint32_t count);
+    bool set_log_range (float log_min, float log_max);
+
+    XCamReturn retinex (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+
+    void gauss_h_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+    void gauss_v_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+    void retinex_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    void set_work_size (const SmartPtr<SoftWorker> &worker, uint32_t width, uint32_t height);
+
+    XCAM_DEAD_COPY (SoftRetinexHandler);
+
+private:
+    SmartPtr<SoftWorker>                    _gauss_h_task;
+    SmartPtr<SoftWorker>                    _gauss_v_task;
+    SmartPtr<SoftWorker>                    _retinex_task;
+    SmartPtr<BufferPool>                    _planes_pool;
+    SmartPtr<XCamSoftTasks::RetinexTable>   _table;
+
+    std::vector<float>                      _sigma;
+    float                                   _log_min;
+    float                                   _log_max;
+};
+
+extern SmartPtr<SoftHandler> create_soft_retinex_handler ();
+
+}
+
+#endif //XCAM_SOFT_RETINEX_HANDLER_H
@@ -0,0 +1,317 @@
+/*
+ * soft_retinex_tasks_priv.cpp - soft retinex tasks private implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_retinex_tasks_priv.h"
+#include <math.h>
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+void
+RetinexGaussCoeffs::init (float sigma)
+{
+    // Young and van Vliet, valid for sigma >= 0.5
+    sigma = XCAM_MAX (sigma, 0.5f);
+    const float q = (sigma >= 2.5f) ?
+                    (0.98711f * sigma - 0.96330f) :
+                    (3.97156f - 4.14554f * sqrtf (1.0f - 0.26891f * sigma));
+    const float q2 = q * q;
+    const float q3 = q2 * q;
+
+    const float b0 = 1.57825f + 2.44413f * q + 1.4281f * q2 + 0.422205f * q3;
+    const float b1 = 2.44413f * q + 2.85619f * q2 + 1.26661f * q3;
+    const float b2 = -(1.4281f * q2 + 1.26661f * q3);
+    const float b3 = 0.422205f * q3;
+
+    a[0] = b1 / b0;
+    a[1] = b2 / b0;
+    a[2] = b3 / b0;
+    b = 1.0f - (a[0] + a[1] + a[2]);
+}
+
+RetinexPlanes::RetinexPlanes ()
+    : width (0)
+    , height (0)
+    , scales (0)
+    , log_mean (NULL)
+{
+    for (uint32_t i = 0; i < XCAM_SOFT_RETINEX_MAX_SCALES; ++i)
+        gauss[i] = NULL;
+}
+
+void
+RetinexPlanes::get_buf_info (VideoBufferInfo &info, uint32_t w, uint32_t h, uint32_t scale_count)
+{
+    // scale planes and log mean, one after another
+    const uint32_t line_bytes = w * sizeof (float);
+    const uint32_t lines = h * (scale_count + 1);
+    info.init (V4L2_PIX_FMT_GREY, line_bytes, lines, line_bytes, lines);
+}
+
+bool
+RetinexPlanes::init (const SmartPtr<VideoBuffer> &buf, uint32_t w, uint32_t h, uint32_t scale_count)
+{
+    XCAM_ASSERT (buf.ptr () && scale_count <= XCAM_SOFT_RETINEX_MAX_SCALES);
+    XCAM_FAIL_RETURN (
+        ERROR, buf->get_video_info ().size >= w * h * (scale_count + 1) * sizeof (float), false,
+        "RetinexPlanes buffer is too small for %dx%d with %d scales", w, h, scale_count);
+
+    float *mem = (float *)buf->map ();
+    XCAM_FAIL_RETURN (ERROR, mem, false, "RetinexPlanes map buffer failed");
+
+    _buf = buf;
+    width = w;
+    height = h;
+    scales = scale_count;
+    for (uint32_t i = 0; i < scales; ++i)
+        gauss[i] = mem + i * w * h;
+    log_mean = mem + scales * w * h;
+    return true;
+}
+
+void
+RetinexTable::init (
+    const float *sigma, uint32_t scales, float min, float max,
+    uint32_t width, uint32_t work_width)
+{
+    XCAM_ASSERT (scales <= XCAM_SOFT_RETINEX_MAX_SCALES && max > min);
+    for (uint32_t i = 0; i < scales; ++i)
+        coeffs[i].init (sigma[i]);
+
+    for (uint32_t i = 0; i < 256; ++i)
+        log_luma[i] = log10f ((float)XCAM_MAX (i, 1u));
+    log_min = min;
+    gain = 255.0f / (max - min);
+
+    // last column is repeated once in interpolated lines
+    x0.resize (width);
+    wx.resize (width);
+    for (uint32_t x = 0; x < width; ++x) {
+        float fx = (x + 0.5f) / XCAM_SOFT_RETINEX_DOWN_SCALE - 0.5f;
+        fx = XCAM_CLAMP (fx, 0.0f, (float)(work_width - 1));
+        x0[x] = (uint32_t)fx;
+        wx[x] = fx - x0[x];
+    }
+}
+
+// in place on @line is allowed
+static void
+gauss_line (const RetinexGaussCoeffs &c, const float *src, uint32_t count, float *line)
+{
+    // history starts from steady state of edge values
+    float w1 = src[0], w2 = src[0], w3 = src[0];
+    for (uint32_t i = 0; i < count; ++i) {
+        const float w = c.b * src[i] + c.a[0] * w1 + c.a[1] * w2 + c.a[2] * w3;
+        line[i] = w;
+        w3 = w2;
+        w2 = w1;
+        w1 = w;
+    }
+
+    w1 = w2 = w3 = line[count - 1];
+    for (int32_t i = count - 1; i >= 0; --i) {
+        const float w = c.b * line[i] + c.a[0] * w1 + c.a[1] * w2 + c.a[2] * w3;
+        line[i] = w;
+        w3 = w2;
+        w2 = w1;
+        w1 = w;
+    }
+}
+
+XCamReturn
+RetinexGaussHTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<RetinexGaussHTask::Args> args = base.dynamic_cast_ptr<RetinexGaussHTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    const UcharImage *in_luma = args->in_luma.ptr ();
+    RetinexPlanes *planes = args->planes.ptr ();
+    const RetinexTable *table = args->table.ptr ();
+    XCAM_ASSERT (in_luma && planes && table);
+
+    const uint32_t width = in_luma->get_width ();
+    const uint32_t height = in_luma->get_height ();
+    const uint32_t down = XCAM_SOFT_RETINEX_DOWN_SCALE;
+    const float box_scale = 1.0f / (down * down);
+    std::vector<uint32_t> sum (planes->width);
+    std::vector<float> line (planes->width);
+
+    for (uint32_t y = range.pos[1]; y < range.pos[1] + range.pos_len[1]; ++y) {
+        std::fill (sum.begin (), sum.end (), 0);
+        for (uint32_t i = 0; i < down; ++i) {
+            const uint8_t *in = in_luma->get_buf_ptr (0, XCAM_MIN (y * down + i, height - 1));
+            for (uint32_t x = 0; x < planes->width; ++x) {
+                for (uint32_t j = 0; j < down; ++j)
+                    sum[x] += in[XCAM_MIN (x * down + j, width - 1)];
+            }
+        }
+        for (uint32_t x = 0; x < planes->width; ++x)
+            line[x] = sum[x] * box_scale;
+
+        for (uint32_t i = 0; i < planes->scales; ++i)
+            gauss_line (table->coeffs[i], &line[0], planes->width, &planes->gauss[i][y * planes->width]);
+    }
+
+    XCAM_LOG_DEBUG (
+        "RetinexGaussHTask work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+/* blurs columns [x_begin, x_end) of @plane in place, all columns of one row
+ * are updated together with their own history.
+ */
+static void
+gauss_strip (
+    const RetinexGaussCoeffs &c, float *plane, uint32_t stride, uint32_t height,
+    uint32_t x_begin, uint32_t x_end)
+{
+    const uint32_t count = x_end - x_begin;
+    float w1[XCAM_SOFT_RETINEX_STRIP_WIDTH], w2[XCAM_SOFT_RETINEX_STRIP_WIDTH], w3[XCAM_SOFT_RETINEX_STRIP_WIDTH];
+    XCAM_ASSERT (count <= XCAM_SOFT_RETINEX_STRIP_WIDTH);
+
+    const float *first = plane + x_begin;
+    for (uint32_t x = 0; x < count; ++x)
+        w1[x] = w2[x] = w3[x] = first[x];
+    for (uint32_t y = 0; y < height; ++y) {
+        float *row = plane + y * stride + x_begin;
+        for (uint32_t x = 0; x < count; ++x) {
+            const float w = c.b * row[x] + c.a[0] * w1[x] + c.a[1] * w2[x] + c.a[2] * w3[x];
+            row[x] = w;
+            w3[x] = w2[x];
+            w2[x] = w1[x];
+            w1[x] = w;
+        }
+    }
+
+    const float *last = plane + (height - 1) * stride + x_begin;
+    for (uint32_t x = 0; x < count; ++x)
+        w1[x] = w2[x] = w3[x] = last[x];
+    for (int32_t y = height - 1; y >= 0; --y) {
+        float *row = plane + y * stride + x_begin;
+        for (uint32_t x = 0; x < count; ++x) {
+            const float w = c.b * row[x] + c.a[0] * w1[x] + c.a[1] * w2[x] + c.a[2] * w3[x];
+            row[x] = w;
+            w3[x] = w2[x];
+            w2[x] = w1[x];
+            w1[x] = w;
+        }
+    }
+}
+
+XCamReturn
+RetinexGaussVTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<RetinexGaussVTask::Args> args = base.dynamic_cast_ptr<RetinexGaussVTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    RetinexPlanes *planes = args->planes.ptr ();
+    const RetinexTable *table = args->table.ptr ();
+    XCAM_ASSERT (planes && table && planes->scales);
+
+    const uint32_t width = planes->width;
+    const float mean_scale = 1.0f / planes->scales;
+
+    for (uint32_t strip = range.pos[0]; strip < range.pos[0] + range.pos_len[0]; ++strip) {
+        const uint32_t x_begin = strip * XCAM_SOFT_RETINEX_STRIP_WIDTH;
+        const uint32_t x_end = XCAM_MIN (x_begin + XCAM_SOFT_RETINEX_STRIP_WIDTH, width);
+        if (x_begin >= x_end)
+            continue;
+
+        for (uint32_t i = 0; i < planes->scales; ++i)
+            gauss_strip (table->coeffs[i], &planes->gauss[i][0], width, planes->height, x_begin, x_end);
+
+        // mean of logs is log of product, one log each pixel
+        for (uint32_t y = 0; y < planes->height; ++y) {
+            const uint32_t offset = y * width;
+            for (uint32_t x = x_begin; x < x_end; ++x) {
+                float product = 1.0f;
+                for (uint32_t i = 0; i < planes->scales; ++i)
+                    product *= XCAM_MAX (planes->gauss[i][offset + x], 1.0f);
+                planes->log_mean[offset + x] = log10f (product) * mean_scale;
+            }
+        }
+    }
+
+    XCAM_LOG_DEBUG (
+        "RetinexGaussVTask work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+RetinexTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<RetinexTask::Args> args = base.dynamic_cast_ptr<RetinexTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    UcharImage *in_luma = args->in_luma.ptr (), *out_luma = args->out_luma.ptr ();
+    Uchar2Image *in_uv = args->in_uv.ptr (), *out_uv = args->out_uv.ptr ();
+    const RetinexPlanes *planes = args->planes.ptr ();
+    const RetinexTable *table = args->table.ptr ();
+    XCAM_ASSERT (in_luma && out_luma && in_uv && out_uv && planes && table);
+
+    const uint32_t width = in_luma->get_width ();
+    const uint32_t height = in_luma->get_height ();
+    const uint32_t uv_bytes = in_uv->get_width () * sizeof (Uchar2);
+    const float offset = table->log_min;
+    const float gain = table->gain;
+    std::vector<float> line (planes->width + 1);
+
+    for (uint32_t uv_y = range.pos[1]; uv_y < range.pos[1] + range.pos_len[1]; ++uv_y) {
+        const uint32_t y_end = XCAM_MIN (uv_y * 2 + 2, height);
+        for (uint32_t y = uv_y * 2; y < y_end; ++y) {
+            float fy = (y + 0.5f) / XCAM_SOFT_RETINEX_DOWN_SCALE - 0.5f;
+            fy = XCAM_CLAMP (fy, 0.0f, (float)(planes->height - 1));
+            const uint32_t y0 = (uint32_t)fy;
+            const uint32_t y1 = XCAM_MIN (y0 + 1, planes->height - 1);
+            const float wy = fy - y0;
+            const float *row0 = &planes->log_mean[y0 * planes->width];
+            const float *row1 = &planes->log_mean[y1 * planes->width];
+            for (uint32_t x = 0; x < planes->width; ++x)
+                line[x] = row0[x] + (row1[x] - row0[x]) * wy;
+            line[planes->width] = line[planes->width - 1];
+
+            const uint8_t *in = in_luma->get_buf_ptr (0, y);
+            uint8_t *out = out_luma->get_buf_ptr (0, y);
+            for (uint32_t x = 0; x < width; ++x) {
+                const float *pos = &line[table->x0[x]];
+                const float log_mean = pos[0] + (pos[1] - pos[0]) * table->wx[x];
+                const float value = (table->log_luma[in[x]] - log_mean - offset) * gain + 0.5f;
+                out[x] = (uint8_t)XCAM_CLAMP (value, 0.0f, 255.0f);
+            }
+        }
+
+        const Uchar2 *in = in_uv->get_buf_ptr (0, uv_y);
+        Uchar2 *out = out_uv->get_buf_ptr (0, uv_y);
+        if (in != out)
+            memcpy ((void *)out, (const void *)in, uv_bytes);
+    }
+
+    XCAM_LOG_DEBUG (
+        "RetinexTask work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+}
+
+}
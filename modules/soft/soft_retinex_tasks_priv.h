@@ -0,0 +1,174 @@
+/*
+ * soft_retinex_tasks_priv.h - soft retinex tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_RETINEX_TASKS_PRIV_H
+#define XCAM_SOFT_RETINEX_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_handler.h>
+#include <vector>
+
+#define XCAM_SOFT_RETINEX_MAX_SCALES 3
+// luma pixels of one working pixel side, all scales blur the same working image
+#define XCAM_SOFT_RETINEX_DOWN_SCALE 2
+// working columns of one vertical work item
+#define XCAM_SOFT_RETINEX_STRIP_WIDTH 64
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+/* Young-van Vliet recursive gaussian, third order forward and backward,
+ * w[n] = b * x[n] + a[0] * w[n - 1] + a[1] * w[n - 2] + a[2] * w[n - 3].
+ * cost does not depend on sigma.
+ */
+struct RetinexGaussCoeffs {
+    float       b;
+    float       a[3];
+
+    void init (float sigma);
+};
+
+/* per-frame working planes, row-major with width floats each row.
+ * all planes are stacked in one pool buffer held until the frame is done.
+ */
+struct RetinexPlanes {
+    uint32_t                width;
+    uint32_t                height;
+    uint32_t                scales;
+    float                  *gauss[XCAM_SOFT_RETINEX_MAX_SCALES];
+    // mean of log10 of all blurred planes
+    float                  *log_mean;
+
+    RetinexPlanes ();
+    bool init (const SmartPtr<VideoBuffer> &buf, uint32_t w, uint32_t h, uint32_t scale_count);
+
+    // pool buffer info of planes, described as bytes
+    static void get_buf_info (VideoBufferInfo &info, uint32_t w, uint32_t h, uint32_t scale_count);
+
+private:
+    SmartPtr<VideoBuffer>   _buf;
+};
+
+// fixed on configure
+struct RetinexTable {
+    RetinexGaussCoeffs      coeffs[XCAM_SOFT_RETINEX_MAX_SCALES];
+    float                   log_luma[256];
+    // output luma = (log_luma - log_mean - log_min) * gain
+    float                   log_min;
+    float                   gain;
+    // working coordinates of full resolution columns
+    std::vector<uint32_t>   x0;
+    std::vector<float>      wx;
+
+    void init (
+        const float *sigma, uint32_t scales, float min, float max,
+        uint32_t width, uint32_t work_width);
+};
+
+/* pass 1, one work item is one working row.
+ * box-averages luma into working row and blurs it horizontally for all scales.
+ */
+class RetinexGaussHTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>            in_luma;
+        SmartPtr<RetinexPlanes>         planes;
+        SmartPtr<RetinexTable>          table;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {}
+    };
+
+public:
+    explicit RetinexGaussHTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("RetinexGaussHTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+/* pass 2, one work item is XCAM_SOFT_RETINEX_STRIP_WIDTH working columns.
+ * blurs all scales vertically in place, rows of a strip are walked together
+ * so inner loops run over contiguous columns, then fills log mean.
+ */
+class RetinexGaussVTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<RetinexPlanes>         planes;
+        SmartPtr<RetinexTable>          table;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {}
+    };
+
+public:
+    explicit RetinexGaussVTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("RetinexGaussVTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+/* pass 3, one work item is one uv line and its two luma lines.
+ * log mean is bilinearly interpolated to full resolution, chroma is copied.
+ */
+class RetinexTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>            in_luma, out_luma;
+        SmartPtr<Uchar2Image>           in_uv, out_uv;
+        SmartPtr<RetinexPlanes>         planes;
+        SmartPtr<RetinexTable>          table;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {}
+    };
+
+public:
+    explicit RetinexTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("RetinexTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+}
+
+}
+
+#endif //XCAM_SOFT_RETINEX_TASKS_PRIV_H
@@ -0,0 +1,285 @@
+/*
+ * soft_scaler.cpp - soft polyphase scaler class implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_scaler.h"
+#include "soft_scaler_tasks_priv.h"
+#include "soft_video_buf_allocator.h"
+
+namespace XCam {
+
+DECLARE_WORK_CALLBACK (CbScaleTask, SoftScaler, scale_task_done);
+
+SoftScaler::SoftScaler (SoftScaleFilter filter, const char *name)
+    : SoftHandler (name)
+    , _filter (filter)
+    , _out_width (0)
+    , _out_height (0)
+{
+}
+
+SoftScaler::~SoftScaler ()
+{
+}
+
+bool
+SoftScaler::check_output_size (uint32_t width, uint32_t height)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, width && height && !(width % 2) && !(height % 2), false,
+        "SoftScaler(%s) output size(%dx%d) need be even",
+        XCAM_STR (get_name ()), width, height);
+
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "SoftScaler(%s) output size can NOT be changed after configured",
+        XCAM_STR (get_name ()));
+
+    return true;
+}
+
+bool
+SoftScaler::set_output_size (uint32_t width, uint32_t height)
+{
+    if (!check_output_size (width, height))
+        return false;
+
+    _out_width = width;
+    _out_height = height;
+    return true;
+}
+
+bool
+SoftScaler::add_extra_output_size (uint32_t width, uint32_t height)
+{
+    if (!check_output_size (width, height))
+        return false;
+
+    XCAM_FAIL_RETURN (
+        ERROR, _extra_sizes.size () + 1 < XCAM_SOFT_SCALE_MAX_OUTPUTS, false,
+        "SoftScaler(%s) supports %d outputs at most",
+        XCAM_STR (get_name ()), XCAM_SOFT_SCALE_MAX_OUTPUTS);
+
+    _extra_sizes.push_back (OutSize (width, height));
+    return true;
+}
+
+XCamReturn
+SoftScaler::scale (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in, out);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftScaler::scale (
+    const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out,
+    std::vector<SmartPtr<VideoBuffer> > &extra_outs)
+{
+    SmartPtr<ScaleParam> param = new ScaleParam (in, out);
+    param->extra_out_bufs = extra_outs;
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        extra_outs = param->extra_out_bufs;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftScaler::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        ERROR, in_info.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftScaler(%s) only support format(NV12) but input format is %s",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (in_info.format));
+
+    XCAM_FAIL_RETURN (
+        ERROR, _out_width && _out_height, XCAM_RETURN_ERROR_PARAM,
+        "SoftScaler(%s) output size was not set", XCAM_STR (get_name ()));
+
+    std::vector<OutSize> sizes;
+    sizes.push_back (OutSize (_out_width, _out_height));
+    sizes.insert (sizes.end (), _extra_sizes.begin (), _extra_sizes.end ());
+
+    _tables.clear ();
+    _extra_pools.clear ();
+    for (size_t i = 0; i < sizes.size (); ++i) {
+        const OutSize &size = sizes[i];
+        XCAM_FAIL_RETURN (
+            ERROR,
+            in_info.width <= size.width * XCAM_SOFT_SCALE_MAX_FACTOR &&
+            in_info.height <= size.height * XCAM_SOFT_SCALE_MAX_FACTOR &&
+            size.width <= in_info.width * XCAM_SOFT_SCALE_MAX_FACTOR &&
+            size.height <= in_info.height * XCAM_SOFT_SCALE_MAX_FACTOR,
+            XCAM_RETURN_ERROR_PARAM,
+            "SoftScaler(%s) can't scale %dx%d to %dx%d, factor need be in range [1/%d, %d]",
+            XCAM_STR (get_name ()), in_info.width, in_info.height, size.width, size.height,
+            XCAM_SOFT_SCALE_MAX_FACTOR, XCAM_SOFT_SCALE_MAX_FACTOR);
+
+        SmartPtr<XCamSoftTasks::ScaleTable> table = new XCamSoftTasks::ScaleTable;
+        XCAM_ASSERT (table.ptr ());
+        XCAM_FAIL_RETURN (
+            ERROR, table->init (_filter, in_info.width, in_info.height, size.width, size.height),
+            XCAM_RETURN_ERROR_PARAM,
+            "SoftScaler(%s) init filter table failed", XCAM_STR (get_name ()));
+        _tables.push_back (table);
+
+        VideoBufferInfo out_info;
+        out_info.init (in_info.format, size.width, size.height);
+        if (!i) {
+            set_out_video_info (out_info);
+            continue;
+        }
+
+        SmartPtr<BufferPool> pool = new SoftVideoBufAllocator (out_info);
+        XCAM_ASSERT (pool.ptr ());
+        XCAM_FAIL_RETURN (
+            ERROR, pool->reserve (XCAM_DEFAULT_HANDLER_BUF_CAP), XCAM_RETURN_ERROR_MEM,
+            "SoftScaler(%s) reserve buffers of %dx%d failed",
+            XCAM_STR (get_name ()), size.width, size.height);
+        _extra_pools.push_back (pool);
+    }
+
+    XCAM_ASSERT (!_scale_task.ptr ());
+    _scale_task = new XCamSoftTasks::ScaleNV12Task (new CbScaleTask (this));
+    XCAM_ASSERT (_scale_task.ptr ());
+    share_threads (_scale_task);
+
+    set_work_size (in_info.height / 2);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftScaler::set_work_size (uint32_t uv_height)
+{
+    uint32_t thread_x = 1, thread_y = 4;
+
+    WorkSize global_size (1, xcam_ceil (uv_height, XCAM_SOFT_SCALE_BAND_LINES) / XCAM_SOFT_SCALE_BAND_LINES);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    _scale_task->set_local_size (local_size);
+    _scale_task->set_global_size (global_size);
+}
+
+XCamReturn
+SoftScaler::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_scale_task.ptr () && !_tables.empty ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    SmartPtr<XCamSoftTasks::ScaleNV12Task::Args> args = new XCamSoftTasks::ScaleNV12Task::Args (param);
+    args->in_luma = new UcharImage (param->in_buf, 0);
+    args->in_uv = new Uchar2Image (param->in_buf, 1);
+
+    XCamSoftTasks::ScaleOutput output;
+    output.luma = new UcharImage (param->out_buf, 0);
+    output.uv = new Uchar2Image (param->out_buf, 1);
+    output.table = _tables[0];
+    args->outputs.push_back (output);
+
+    // extra outputs come only with ScaleParam, plain Parameters get the main size
+    SmartPtr<ScaleParam> scale_param = param.dynamic_cast_ptr<ScaleParam> ();
+    if (scale_param.ptr ()) {
+        std::vector<SmartPtr<VideoBuffer> > &extra_bufs = scale_param->extra_out_bufs;
+        if (extra_bufs.size () < _extra_pools.size ()) {
+            for (size_t i = extra_bufs.size (); i < _extra_pools.size (); ++i) {
+                SmartPtr<VideoBuffer> buf = _extra_pools[i]->get_buffer (_extra_pools[i]);
+                XCAM_FAIL_RETURN (
+                    ERROR, buf.ptr (), XCAM_RETURN_ERROR_MEM,
+                    "SoftScaler(%s) allocate extra output(%d) failed", XCAM_STR (get_name ()), (int)i);
+                extra_bufs.push_back (buf);
+            }
+        }
+
+        for (size_t i = 0; i < _extra_pools.size (); ++i) {
+            XCAM_ASSERT (extra_bufs[i].ptr ());
+            output.luma = new UcharImage (extra_bufs[i], 0);
+            output.uv = new Uchar2Image (extra_bufs[i], 1);
+            output.table = _tables[i + 1];
+            args->outputs.push_back (output);
+            extra_bufs[i]->set_timestamp (param->in_buf->get_timestamp ());
+        }
+    }
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = _scale_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftScaler(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+XCamReturn
+SoftScaler::terminate ()
+{
+    if (_scale_task.ptr ()) {
+        _scale_task->stop ();
+        _scale_task.release ();
+    }
+    for (size_t i = 0; i < _extra_pools.size (); ++i)
+        _extra_pools[i]->stop ();
+
+    return SoftHandler::terminate ();
+}
+
+void
+SoftScaler::scale_task_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _scale_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    work_well_done (param, error);
+}
+
+SmartPtr<SoftHandler>
+create_soft_scaler (SoftScaleFilter filter, uint32_t width, uint32_t height)
+{
+    SmartPtr<SoftScaler> scaler = new SoftScaler (filter);
+    XCAM_ASSERT (scaler.ptr ());
+
+    if (!scaler->set_output_size (width, height))
+        return NULL;
+
+    return scaler;
+}
+
+}
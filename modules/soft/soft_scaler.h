@@ -0,0 +1,126 @@
+/*
+ * soft_scaler.h - soft polyphase scaler class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_SCALER_H
+#define XCAM_SOFT_SCALER_H
+
+#include <xcam_std.h>
+#include <soft/soft_handler.h>
+#include <buffer_pool.h>
+#include <vector>
+
+// scale factor in both directions
+#define XCAM_SOFT_SCALE_MAX_FACTOR 16
+// main output and extra outputs
+#define XCAM_SOFT_SCALE_MAX_OUTPUTS 4
+
+namespace XCam {
+
+class SoftWorker;
+
+namespace XCamSoftTasks {
+struct ScaleTable;
+};
+
+enum SoftScaleFilter {
+    SoftScaleBilinear = 0,
+    SoftScaleBicubic,
+    SoftScaleLanczos,
+};
+
+/* separable polyphase scaler on NV12 with any ratio up to XCAM_SOFT_SCALE_MAX_FACTOR.
+ * filter taps of each output row and column are computed once on configure in
+ * 14-bit fixed point, widened by the ratio on downscale for anti-aliasing.
+ * extra output sizes are produced in the same pass, each work item is a band of
+ * input lines and makes every output line centered in it, so input is read once.
+ */
+class SoftScaler
+    : public SoftHandler
+{
+public:
+    struct ScaleParam : ImageHandler::Parameters {
+        // outputs of extra sizes in order of add_extra_output_size, allocated by scaler if empty
+        std::vector<SmartPtr<VideoBuffer> > extra_out_bufs;
+
+        ScaleParam (
+            const SmartPtr<VideoBuffer> &in = NULL,
+            const SmartPtr<VideoBuffer> &out = NULL)
+            : Parameters (in, out)
+        {}
+    };
+
+public:
+    explicit SoftScaler (SoftScaleFilter filter = SoftScaleBicubic, const char *name = "SoftScaler");
+    ~SoftScaler ();
+
+    // width and height need be even, can NOT be changed after configured
+    bool set_output_size (uint32_t width, uint32_t height);
+    void get_output_size (uint32_t &width, uint32_t &height) const {
+        width = _out_width;
+        height = _out_height;
+    }
+    // extra outputs only come with ScaleParam, can NOT be changed after configured
+    bool add_extra_output_size (uint32_t width, uint32_t height);
+
+    XCamReturn scale (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out);
+    XCamReturn scale (
+        const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out,
+        std::vector<SmartPtr<VideoBuffer> > &extra_outs);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+
+    void scale_task_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    bool check_output_size (uint32_t width, uint32_t height);
+    void set_work_size (uint32_t uv_height);
+
+    XCAM_DEAD_COPY (SoftScaler);
+
+private:
+    struct OutSize {
+        uint32_t    width;
+        uint32_t    height;
+
+        OutSize (uint32_t w = 0, uint32_t h = 0) : width (w), height (h) {}
+    };
+
+    SmartPtr<SoftWorker>                                _scale_task;
+    SoftScaleFilter                                     _filter;
+    uint32_t                                            _out_width;
+    uint32_t                                            _out_height;
+    std::vector<OutSize>                                _extra_sizes;
+    // main output first
+    std::vector<SmartPtr<XCamSoftTasks::ScaleTable> >   _tables;
+    std::vector<SmartPtr<BufferPool> >                  _extra_pools;
+};
+
+extern SmartPtr<SoftHandler> create_soft_scaler (SoftScaleFilter filter, uint32_t width, uint32_t height);
+
+}
+
+#endif //XCAM_SOFT_SCALER_H
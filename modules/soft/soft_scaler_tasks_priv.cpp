@@ -0,0 +1,318 @@
+/*
+ * soft_scaler_tasks_priv.cpp - soft polyphase scaler tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_scaler_tasks_priv.h"
+#include <math.h>
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// vertical pass keeps 6 fraction bits in 16-bit lines, horizontal pass removes the rest
+#define SCALE_LINE_BITS 6
+#define SCALE_VERT_SHIFT (XCAM_SOFT_SCALE_COEFF_BITS - SCALE_LINE_BITS)
+#define SCALE_HORZ_SHIFT (XCAM_SOFT_SCALE_COEFF_BITS + SCALE_LINE_BITS)
+// 16-bit lines are read 8 values at a time past the last tap
+#define SCALE_LINE_PADDING 8
+
+// catmull-rom, same as a = -0.5 of bicubic convolution
+#define SCALE_BICUBIC_A (-0.5f)
+#define SCALE_LANCZOS_LOBES 3
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+static float
+get_filter_support (SoftScaleFilter filter)
+{
+    switch (filter) {
+    case SoftScaleBilinear:
+        return 1.0f;
+    case SoftScaleBicubic:
+        return 2.0f;
+    case SoftScaleLanczos:
+        return (float)SCALE_LANCZOS_LOBES;
+    }
+    return 1.0f;
+}
+
+static float
+get_filter_weight (SoftScaleFilter filter, float x)
+{
+    x = fabsf (x);
+    switch (filter) {
+    case SoftScaleBilinear:
+        return (x < 1.0f) ? 1.0f - x : 0.0f;
+    case SoftScaleBicubic: {
+        const float a = SCALE_BICUBIC_A;
+        if (x < 1.0f)
+            return ((a + 2.0f) * x - (a + 3.0f)) * x * x + 1.0f;
+        if (x < 2.0f)
+            return ((a * x - 5.0f * a) * x + 8.0f * a) * x - 4.0f * a;
+        return 0.0f;
+    }
+    case SoftScaleLanczos: {
+        const float lobes = (float)SCALE_LANCZOS_LOBES;
+        if (x < 1e-6f)
+            return 1.0f;
+        if (x >= lobes)
+            return 0.0f;
+        const float px = (float)M_PI * x;
+        return lobes * sinf (px) * sinf (px / lobes) / (px * px);
+    }
+    }
+    return 0.0f;
+}
+
+bool
+ScaleFilterTable::init (SoftScaleFilter filter, uint32_t in_size, uint32_t out_size)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, in_size && out_size, false,
+        "ScaleFilterTable invalid size, in:%d, out:%d", in_size, out_size);
+
+    // filter stretches with ratio on downscale to cover every source pixel
+    const float ratio = (float)in_size / out_size;
+    const float scale = XCAM_MAX (ratio, 1.0f);
+    const float support = get_filter_support (filter) * scale;
+    window = XCAM_MIN ((uint32_t)ceilf (support * 2.0f) + 1, in_size);
+    taps = XCAM_ALIGN_UP (window, 8);
+
+    start.resize (out_size);
+    coeff.assign (out_size * taps, 0);
+    std::vector<float> weights (window);
+
+    for (uint32_t i = 0; i < out_size; ++i) {
+        const float center = (i + 0.5f) * ratio - 0.5f;
+        const int32_t first = (int32_t)floorf (center - support) + 1;
+        const int32_t win_start = XCAM_CLAMP (first, 0, (int32_t)(in_size - window));
+
+        std::fill (weights.begin (), weights.end (), 0.0f);
+        float sum = 0.0f;
+        for (uint32_t k = 0; k < (uint32_t)ceilf (support * 2.0f) + 1; ++k) {
+            const int32_t pos = first + (int32_t)k;
+            const float w = get_filter_weight (filter, (pos - center) / scale);
+            weights[XCAM_CLAMP (pos, 0, (int32_t)in_size - 1) - win_start] += w;
+            sum += w;
+        }
+
+        // quantize, rounding error goes to the largest tap so taps sum to one exactly
+        int16_t *c = &coeff[i * taps];
+        int32_t total = 0;
+        uint32_t max_k = 0;
+        for (uint32_t k = 0; k < window; ++k) {
+            c[k] = (int16_t)lrintf (weights[k] / sum * (1 << XCAM_SOFT_SCALE_COEFF_BITS));
+            total += c[k];
+            if (c[k] > c[max_k])
+                max_k = k;
+        }
+        c[max_k] += (int16_t)((1 << XCAM_SOFT_SCALE_COEFF_BITS) - total);
+        start[i] = win_start;
+    }
+
+    return true;
+}
+
+// first output line of each band, by source line at output line center
+static void
+init_band_lines (
+    std::vector<uint32_t> &lines, uint32_t in_size, uint32_t out_size,
+    uint32_t band_size, uint32_t bands)
+{
+    const float ratio = (float)in_size / out_size;
+    lines.assign (bands + 1, out_size);
+    lines[0] = 0;
+
+    uint32_t band = 0;
+    for (uint32_t i = 0; i < out_size; ++i) {
+        const int32_t src = XCAM_CLAMP ((int32_t)floorf ((i + 0.5f) * ratio - 0.5f), 0, (int32_t)in_size - 1);
+        const uint32_t cur = src / band_size;
+        while (band < cur)
+            lines[++band] = i;
+    }
+}
+
+bool
+ScaleTable::init (
+    SoftScaleFilter filter, uint32_t in_width, uint32_t in_height,
+    uint32_t out_width, uint32_t out_height)
+{
+    const uint32_t bands = xcam_ceil (in_height / 2, XCAM_SOFT_SCALE_BAND_LINES) / XCAM_SOFT_SCALE_BAND_LINES;
+
+    XCAM_FAIL_RETURN (
+        ERROR,
+        luma_x.init (filter, in_width, out_width) && luma_y.init (filter, in_height, out_height) &&
+        uv_x.init (filter, in_width / 2, out_width / 2) && uv_y.init (filter, in_height / 2, out_height / 2),
+        false,
+        "ScaleTable init failed, %dx%d to %dx%d", in_width, in_height, out_width, out_height);
+
+    init_band_lines (luma_band_line, in_height, out_height, XCAM_SOFT_SCALE_BAND_LINES * 2, bands);
+    init_band_lines (uv_band_line, in_height / 2, out_height / 2, XCAM_SOFT_SCALE_BAND_LINES, bands);
+
+    return true;
+}
+
+/* weighted sum of @window source lines into 16-bit line with SCALE_LINE_BITS fraction bits.
+ * taps go in pairs, the odd last one pairs with zero weight.
+ */
+static void
+filter_vertical (
+    const uint8_t * const *rows, const int16_t *coeff, uint32_t window, uint32_t bytes, int16_t *dst)
+{
+    uint32_t x = 0;
+
+#if defined (__SSE2__)
+    __m128i pairs[XCAM_SOFT_SCALE_MAX_FACTOR * 8];
+    const uint8_t *second[XCAM_SOFT_SCALE_MAX_FACTOR * 8];
+    const uint32_t pair_count = (window + 1) / 2;
+    XCAM_ASSERT (pair_count <= XCAM_SOFT_SCALE_MAX_FACTOR * 8);
+    for (uint32_t k = 0; k < pair_count; ++k) {
+        const bool has_odd = (2 * k + 1 < window);
+        const int16_t c1 = has_odd ? coeff[2 * k + 1] : 0;
+        pairs[k] = _mm_set1_epi32 ((int32_t)((uint16_t)coeff[2 * k] | ((uint32_t)(uint16_t)c1 << 16)));
+        second[k] = has_odd ? rows[2 * k + 1] : rows[2 * k];
+    }
+
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i round = _mm_set1_epi32 (1 << (SCALE_VERT_SHIFT - 1));
+    for (; x + 8 <= bytes; x += 8) {
+        __m128i acc_lo = round, acc_hi = round;
+        for (uint32_t k = 0; k < pair_count; ++k) {
+            __m128i a = _mm_unpacklo_epi8 (_mm_loadl_epi64 ((const __m128i *)(rows[2 * k] + x)), zero);
+            __m128i b = _mm_unpacklo_epi8 (_mm_loadl_epi64 ((const __m128i *)(second[k] + x)), zero);
+            acc_lo = _mm_add_epi32 (acc_lo, _mm_madd_epi16 (_mm_unpacklo_epi16 (a, b), pairs[k]));
+            acc_hi = _mm_add_epi32 (acc_hi, _mm_madd_epi16 (_mm_unpackhi_epi16 (a, b), pairs[k]));
+        }
+        acc_lo = _mm_srai_epi32 (acc_lo, SCALE_VERT_SHIFT);
+        acc_hi = _mm_srai_epi32 (acc_hi, SCALE_VERT_SHIFT);
+        _mm_storeu_si128 ((__m128i *)(dst + x), _mm_packs_epi32 (acc_lo, acc_hi));
+    }
+#endif
+
+    for (; x < bytes; ++x) {
+        int32_t acc = 1 << (SCALE_VERT_SHIFT - 1);
+        for (uint32_t k = 0; k < window; ++k)
+            acc += coeff[k] * rows[k][x];
+        dst[x] = (int16_t)XCAM_CLAMP (acc >> SCALE_VERT_SHIFT, -32768, 32767);
+    }
+}
+
+// filter 16-bit line into @out_size pixels @dst_step bytes apart
+static void
+filter_horizontal (
+    const int16_t *src, const ScaleFilterTable &table, uint32_t out_size, uint8_t *dst, uint32_t dst_step)
+{
+    const uint32_t taps = table.taps;
+    const int32_t round = 1 << (SCALE_HORZ_SHIFT - 1);
+
+    for (uint32_t i = 0; i < out_size; ++i) {
+        const int16_t *s = src + table.start[i];
+        const int16_t *c = &table.coeff[i * taps];
+        int32_t acc;
+
+#if defined (__SSE2__)
+        __m128i sum = _mm_setzero_si128 ();
+        for (uint32_t k = 0; k < taps; k += 8) {
+            __m128i v = _mm_loadu_si128 ((const __m128i *)(s + k));
+            __m128i w = _mm_loadu_si128 ((const __m128i *)(c + k));
+            sum = _mm_add_epi32 (sum, _mm_madd_epi16 (v, w));
+        }
+        sum = _mm_add_epi32 (sum, _mm_srli_si128 (sum, 8));
+        sum = _mm_add_epi32 (sum, _mm_srli_si128 (sum, 4));
+        acc = _mm_cvtsi128_si32 (sum);
+#else
+        acc = 0;
+        for (uint32_t k = 0; k < table.window; ++k)
+            acc += s[k] * c[k];
+#endif
+
+        acc = (acc + round) >> SCALE_HORZ_SHIFT;
+        dst[i * dst_step] = (uint8_t)XCAM_CLAMP (acc, 0, 255);
+    }
+}
+
+// source lines of output line @i, @lines has at least window entries
+template <typename Image>
+static void
+get_source_lines (const Image &in, const ScaleFilterTable &table, uint32_t i, const uint8_t **lines)
+{
+    for (uint32_t k = 0; k < table.window; ++k)
+        lines[k] = (const uint8_t *)in.get_buf_ptr (0, table.start[i] + k);
+}
+
+XCamReturn
+ScaleNV12Task::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<ScaleNV12Task::Args> args = base.dynamic_cast_ptr<ScaleNV12Task::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    XCAM_ASSERT (args->in_luma.ptr () && args->in_uv.ptr ());
+    const UcharImage &in_luma = *args->in_luma.ptr ();
+    const Uchar2Image &in_uv = *args->in_uv.ptr ();
+
+    const uint32_t in_width = in_luma.get_width ();
+    const uint32_t uv_width = in_uv.get_width ();
+    std::vector<int16_t> line (in_width + SCALE_LINE_PADDING);
+    std::vector<int16_t> line_u (uv_width + SCALE_LINE_PADDING), line_v (uv_width + SCALE_LINE_PADDING);
+    std::vector<const uint8_t *> src_lines;
+
+    for (uint32_t band = range.pos[1]; band < range.pos[1] + range.pos_len[1]; ++band) {
+        for (size_t n = 0; n < args->outputs.size (); ++n) {
+            const ScaleOutput &output = args->outputs[n];
+            const ScaleTable &table = *output.table.ptr ();
+            XCAM_ASSERT (output.luma.ptr () && output.uv.ptr () && output.table.ptr ());
+
+            src_lines.resize (XCAM_MAX (table.luma_y.window, table.uv_y.window));
+            const uint32_t out_width = output.luma->get_width ();
+            for (uint32_t i = table.luma_band_line[band]; i < table.luma_band_line[band + 1]; ++i) {
+                const int16_t *c = &table.luma_y.coeff[i * table.luma_y.taps];
+                get_source_lines (in_luma, table.luma_y, i, &src_lines[0]);
+                filter_vertical (&src_lines[0], c, table.luma_y.window, in_width, &line[0]);
+                filter_horizontal (&line[0], table.luma_x, out_width, output.luma->get_buf_ptr (0, i), 1);
+            }
+
+            const uint32_t out_uv_width = output.uv->get_width ();
+            for (uint32_t i = table.uv_band_line[band]; i < table.uv_band_line[band + 1]; ++i) {
+                const int16_t *c = &table.uv_y.coeff[i * table.uv_y.taps];
+                get_source_lines (in_uv, table.uv_y, i, &src_lines[0]);
+                // interleaved uv line goes through vertical pass as bytes, then splits
+                filter_vertical (&src_lines[0], c, table.uv_y.window, uv_width * 2, &line[0]);
+                for (uint32_t x = 0; x < uv_width; ++x) {
+                    line_u[x] = line[2 * x];
+                    line_v[x] = line[2 * x + 1];
+                }
+
+                uint8_t *dst = (uint8_t *)output.uv->get_buf_ptr (0, i);
+                filter_horizontal (&line_u[0], table.uv_x, out_uv_width, dst, 2);
+                filter_horizontal (&line_v[0], table.uv_x, out_uv_width, dst + 1, 2);
+            }
+        }
+    }
+
+    XCAM_LOG_DEBUG (
+        "ScaleNV12Task work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+ * soft_scaler_tasks_priv.h - soft polyphase scaler tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_SCALER_TASKS_PRIV_H
+#define XCAM_SOFT_SCALER_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_handler.h>
+#include <soft/soft_scaler.h>
+#include <vector>
+
+// filter coefficients sum to 1 << XCAM_SOFT_SCALE_COEFF_BITS
+#define XCAM_SOFT_SCALE_COEFF_BITS 14
+// input uv lines of one work item
+#define XCAM_SOFT_SCALE_BAND_LINES 8
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+/* taps of one direction, output position i reads source [start[i], start[i] + window),
+ * windows are clamped inside source, edge pixels take weights of outside taps.
+ * coefficients of position i are coeff[i * taps, (i + 1) * taps), taps is window rounded
+ * up to a multiple of 8 with zeros so rows can be read 8 at a time.
+ */
+struct ScaleFilterTable {
+    uint32_t                window;
+    uint32_t                taps;
+    std::vector<int32_t>    start;
+    std::vector<int16_t>    coeff;
+
+    ScaleFilterTable () : window (0), taps (0) {}
+    bool init (SoftScaleFilter filter, uint32_t in_size, uint32_t out_size);
+};
+
+// tables of one output size
+struct ScaleTable {
+    ScaleFilterTable            luma_x, luma_y;
+    ScaleFilterTable            uv_x, uv_y;
+    // first output line of each input band, entry [bands] is the output height
+    std::vector<uint32_t>       luma_band_line;
+    std::vector<uint32_t>       uv_band_line;
+
+    bool init (
+        SoftScaleFilter filter, uint32_t in_width, uint32_t in_height,
+        uint32_t out_width, uint32_t out_height);
+};
+
+struct ScaleOutput {
+    SmartPtr<UcharImage>        luma;
+    SmartPtr<Uchar2Image>       uv;
+    SmartPtr<ScaleTable>        table;
+};
+
+// one work item is XCAM_SOFT_SCALE_BAND_LINES input uv lines and its luma lines
+class ScaleNV12Task
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>        in_luma;
+        SmartPtr<Uchar2Image>       in_uv;
+        std::vector<ScaleOutput>    outputs;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {}
+    };
+
+public:
+    explicit ScaleNV12Task (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("ScaleNV12Task", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+}
+
+}
+
+#endif //XCAM_SOFT_SCALER_TASKS_PRIV_H
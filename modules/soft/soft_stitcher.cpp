@@ -24,8 +24,10 @@
 #include "soft_geo_mapper.h"
 #include "soft_video_buf_allocator.h"
 #include "interface/feature_match.h"
+#include "interface/stitch_quality.h"
 #include "soft_copy_task.h"
 #include "xcam_utils.h"
+#include "thread_pool.h"
 #include <map>
 
 #define ENABLE_FEATURE_MATCH HAVE_OPENCV
@@ -40,8 +42,11 @@
 #define SOFT_STITCHER_ALIGNMENT_X 8
 #define SOFT_STITCHER_ALIGNMENT_Y 4
 
-#define MAP_FACTOR_X  16
-#define MAP_FACTOR_Y  16
+// asynchronous feature match of two seams may hold geomap outputs of one camera
+#define GEOMAP_POOL_SIZE 2
+#define GEOMAP_POOL_SIZE_FM (GEOMAP_POOL_SIZE + 2)
+
+#define MAP_FACTOR  16
 
 #define DUMP_STITCHER 0
 
@@ -62,6 +67,13 @@ static void stitcher_dump_buf (const SmartPtr<VideoBuffer> buf, ...) {
 }
 #endif
 
+static inline int64_t
+get_time_us ()
+{
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+    return XCAM_TIMEVAL_2_USEC (tv);
+}
 
 namespace SoftStitcherPriv {
 
@@ -126,6 +138,25 @@ struct Overlap {
     SmartPtr<FeatureMatch>       matcher;
     SmartPtr<SoftBlender>        blender;
     BlenderParams                param_map;
+    // matcher keeps tracked corners, serialize feature match of the same seam
+    Mutex                        fm_mutex;
+
+    // protected by StitcherImpl::_map_mutex
+    // fm_busy: a match is queued, running or its result is not applied yet
+    // fm_ready: fm_left/right_factor of frame fm_frame wait to be applied
+    // fm_applied_frame: first frame whose geomap contains the last applied result
+    bool                         fm_busy;
+    bool                         fm_ready;
+    uint32_t                     fm_frame;
+    uint32_t                     fm_applied_frame;
+    Factor                       fm_left_factor, fm_right_factor;
+
+    Overlap ()
+        : fm_busy (false)
+        , fm_ready (false)
+        , fm_frame (0)
+        , fm_applied_frame (0)
+    {}
 
     SmartPtr<BlenderParam> find_blender_param_in_map (
         const SmartPtr<SoftStitcher::StitcherParam> &key,
@@ -138,9 +169,18 @@ struct FisheyeMap {
     FisheyeDewarpMode            dewarp_mode;
     FisheyeInfo                  fisheye_info;
     Factor                       left_match_factor, right_match_factor;
+    uint32_t                     table_width, table_height;
+
+    FisheyeMap ()
+        : dewarp_mode (DewarpSphere)
+        , table_width (0)
+        , table_height (0)
+    {}
 
     XCamReturn set_map_table (
-        SoftStitcher *stitcher, const Stitcher::RoundViewSlice &view_slice, uint32_t cam_idx);
+        SoftStitcher *stitcher, const Stitcher::RoundViewSlice &view_slice,
+        uint32_t cam_idx, uint32_t map_factor);
+    void rescale_factors (uint32_t last_width, uint32_t last_height);
 };
 
 struct Copier {
@@ -155,6 +195,7 @@ typedef std::vector<Copier>    Copiers;
 
 class StitcherImpl {
     friend class XCam::SoftStitcher;
+    friend class FeatureMatchJob;
 
 public:
     StitcherImpl (SoftStitcher *handler)
@@ -179,10 +220,16 @@ public:
     XCamReturn stop ();
 
     XCamReturn gen_geomap_table ();
+    XCamReturn update_quality (int64_t frame_time_us);
     XCamReturn start_feature_match (
-        const SmartPtr<VideoBuffer> &left_buf, const SmartPtr<VideoBuffer> &right_buf, const uint32_t idx);
+        const SmartPtr<VideoBuffer> &left_buf, const SmartPtr<VideoBuffer> &right_buf,
+        const uint32_t idx, const uint32_t frame_count);
+    bool acquire_feature_match (uint32_t idx, uint32_t frame_count);
+    void release_feature_match (uint32_t idx);
+    void apply_feature_match_results (uint32_t frame_count);
 
     bool get_and_reset_feature_match_factors (uint32_t idx, Factor &left, Factor &right);
+    bool need_feature_match (uint32_t frame_count) const;
 
 private:
     SmartPtr<SoftGeoMapper> create_geo_mapper (const Stitcher::RoundViewSlice &view_slice);
@@ -192,12 +239,13 @@ private:
     XCamReturn init_copier (Stitcher::CopyArea area);
     bool init_geomap_factors (uint32_t idx);
     XCamReturn create_copier (Stitcher::CopyArea area);
+    XCamReturn apply_quality (const StitchQuality &quality);
 
     void calc_factors (
         const uint32_t &idx, const Factor &last_left_factor, const Factor &last_right_factor,
         Factor &cur_left, Factor &cur_right);
 
-    void init_feature_match (uint32_t idx);
+    XCamReturn init_feature_match (uint32_t idx);
 
 private:
     StitchInfo              _stitch_info;
@@ -205,14 +253,83 @@ private:
     Overlap                 _overlaps [XCAM_STITCH_MAX_CAMERAS];
     Copiers                 _copiers;
     SmartPtr<BufferPool>    _geomap_pool;
+    SmartPtr<ThreadPool>    _fm_threads;
 
     Mutex                   _map_mutex;
     BlendCopyTaskNums       _task_counts;
 
+    StitchQualityCtrl       _quality_ctrl;
+    StitchQuality           _quality;
+
     SoftStitcher           *_stitcher;
 };
 
-#if ENABLE_FEATURE_MATCH
+/* feature match of one seam, seams run in parallel on the background thread pool.
+ * a synchronous job holds its frame until done, an asynchronous job only keeps
+ * the geomap outputs and its result is applied to a later frame.
+ */
+class FeatureMatchJob
+    : public ThreadPool::UserData
+{
+public:
+    FeatureMatchJob (SoftStitcher *stitcher, uint32_t idx, const SmartPtr<BlenderParam> &param)
+        : _stitcher (stitcher)
+        , _idx (idx)
+        , _frame_count (param->stitch_param->frame_count)
+        , _left_buf (param->in_buf)
+        , _right_buf (param->in1_buf)
+    {
+        if (param->stitch_param->fm_sync)
+            _stitch_param = param->stitch_param;
+    }
+
+    virtual XCamReturn run ();
+    virtual void done (XCamReturn err);
+
+private:
+    SoftStitcher                           *_stitcher;
+    uint32_t                                _idx;
+    uint32_t                                _frame_count;
+    SmartPtr<VideoBuffer>                   _left_buf;
+    SmartPtr<VideoBuffer>                   _right_buf;
+    SmartPtr<SoftStitcher::StitcherParam>   _stitch_param;
+};
+
+XCamReturn
+FeatureMatchJob::run ()
+{
+    StitcherImpl *impl = _stitcher->_impl.ptr ();
+    XCAM_ASSERT (impl);
+
+    int64_t fm_start = get_time_us ();
+    XCamReturn ret = impl->start_feature_match (_left_buf, _right_buf, _idx, _frame_count);
+
+    if (_stitch_param.ptr ()) {
+        SmartLock locker (impl->_map_mutex);
+        _stitch_param->fm_time += get_time_us () - fm_start;
+    }
+    return ret;
+}
+
+void
+FeatureMatchJob::done (XCamReturn err)
+{
+    _left_buf.release ();
+    _right_buf.release ();
+
+    if (_stitch_param.ptr ()) {
+        _stitcher->feature_match_done (_stitch_param, _idx, err);
+        return;
+    }
+
+    if (!xcam_ret_is_ok (err)) {
+        XCAM_LOG_WARNING (
+            "soft-stitcher:%s async feature match idx:%d frame:%d failed",
+            XCAM_STR (_stitcher->get_name ()), _idx, _frame_count);
+        _stitcher->_impl->release_feature_match (_idx);
+    }
+}
+
 static FMConfig
 get_fm_config (StitchResMode res_mode)
 {
@@ -253,6 +370,7 @@ get_fm_config (StitchResMode res_mode)
         config.max_adjusted_offset = 24.0f;
         config.max_valid_offset_y = 20.0f;
         config.max_track_error = 6.0f;
+        config.match_level = 2;
         break;
     }
     default:
@@ -262,7 +380,6 @@ get_fm_config (StitchResMode res_mode)
 
     return config;
 }
-#endif
 
 static StitchInfo
 get_stitch_info (StitchResMode res_mode, StitchScopicMode scopic_mode)
@@ -345,7 +462,8 @@ get_stitch_info (StitchResMode res_mode, StitchScopicMode scopic_mode)
 
 XCamReturn
 FisheyeMap::set_map_table (
-    SoftStitcher *stitcher, const Stitcher::RoundViewSlice &view_slice, uint32_t cam_idx)
+    SoftStitcher *stitcher, const Stitcher::RoundViewSlice &view_slice,
+    uint32_t cam_idx, uint32_t map_factor)
 {
     SmartPtr<FisheyeDewarp> dewarper;
     if(dewarp_mode == DewarpBowl) {
@@ -383,9 +501,10 @@ FisheyeMap::set_map_table (
 
     dewarper->set_out_size (view_slice.width, view_slice.height);
 
-    uint32_t table_width = view_slice.width / MAP_FACTOR_X;
+    XCAM_ASSERT (map_factor);
+    table_width = view_slice.width / map_factor;
     table_width = XCAM_ALIGN_UP (table_width, 4);
-    uint32_t table_height = view_slice.height / MAP_FACTOR_Y;
+    table_height = view_slice.height / map_factor;
     table_height = XCAM_ALIGN_UP (table_height, 2);
     dewarper->set_table_size (table_width, table_height);
 
@@ -399,6 +518,27 @@ FisheyeMap::set_map_table (
     return XCAM_RETURN_NO_ERROR;
 }
 
+void
+FisheyeMap::rescale_factors (uint32_t last_width, uint32_t last_height)
+{
+    XCAM_ASSERT (last_width > 1 && last_height > 1 && table_width > 1 && table_height > 1);
+    float ratio_x = (last_width - 1.0f) / (table_width - 1.0f);
+    float ratio_y = (last_height - 1.0f) / (table_height - 1.0f);
+
+    SmartPtr<SoftDualConstGeoMapper> dual_mapper = mapper.dynamic_cast_ptr<SoftDualConstGeoMapper> ();
+    if (dual_mapper.ptr ()) {
+        Factor left, right;
+        dual_mapper->get_left_factors (left.x, left.y);
+        dual_mapper->get_right_factors (right.x, right.y);
+        dual_mapper->set_left_factors (left.x * ratio_x, left.y * ratio_y);
+        dual_mapper->set_right_factors (right.x * ratio_x, right.y * ratio_y);
+    } else {
+        Factor factor;
+        mapper->get_factors (factor.x, factor.y);
+        mapper->set_factors (factor.x * ratio_x, factor.y * ratio_y);
+    }
+}
+
 void
 StitcherImpl::calc_factors (
     const uint32_t &idx, const Factor &last_left_factor, const Factor &last_right_factor,
@@ -521,8 +661,9 @@ StitcherImpl::init_fisheye (uint32_t idx)
     SmartPtr<BufferPool> pool = new SoftVideoBufAllocator (buf_info);
     XCAM_ASSERT (pool.ptr ());
     fisheye.buf_pool = pool;
+    uint32_t pool_size = (_stitcher->get_fm_mode () == FMNone) ? GEOMAP_POOL_SIZE : GEOMAP_POOL_SIZE_FM;
     XCAM_FAIL_RETURN (
-        ERROR, fisheye.buf_pool->reserve (2), XCAM_RETURN_ERROR_MEM,
+        ERROR, fisheye.buf_pool->reserve (pool_size), XCAM_RETURN_ERROR_MEM,
         "stitcher:%s reserve geomap buffer pool(w:%d,h:%d) failed",
         XCAM_STR (_stitcher->get_name ()), buf_info.width, buf_info.height);
 
@@ -551,29 +692,35 @@ StitcherImpl::create_copier (Stitcher::CopyArea area)
     return XCAM_RETURN_NO_ERROR;
 }
 
-void
+XCamReturn
 StitcherImpl::init_feature_match (uint32_t idx)
 {
-#if ENABLE_FEATURE_MATCH
-
-#ifndef ANDROID
     FeatureMatchMode fm_mode = _stitcher->get_fm_mode ();
     if (fm_mode == FMNone)
-        return ;
-    else if (fm_mode == FMDefault)
-        _overlaps[idx].matcher = FeatureMatch::create_default_feature_match ();
-    else if (fm_mode == FMCluster)
-        _overlaps[idx].matcher = FeatureMatch::create_cluster_feature_match ();
-    else if (fm_mode == FMCapi)
-        _overlaps[idx].matcher = FeatureMatch::create_capi_feature_match ();
-    else {
-        XCAM_LOG_ERROR ("unsupported FeatureMatchMode: %d", fm_mode);
-        XCAM_ASSERT (false);
-    }
+        return XCAM_RETURN_NO_ERROR;
+
+    if (fm_mode == FMSoft) {
+        _overlaps[idx].matcher = FeatureMatch::create_soft_feature_match ();
+    } else {
+#if ENABLE_FEATURE_MATCH
+#ifndef ANDROID
+        if (fm_mode == FMDefault) {
+            _overlaps[idx].matcher = FeatureMatch::create_default_feature_match ();
+            _overlaps[idx].matcher->enable_corner_tracking (true);
+        }
+        else if (fm_mode == FMCluster)
+            _overlaps[idx].matcher = FeatureMatch::create_cluster_feature_match ();
+        else if (fm_mode == FMCapi)
+            _overlaps[idx].matcher = FeatureMatch::create_capi_feature_match ();
 #else
-    _overlaps[idx].matcher = new CVCapiFeatureMatch;
+        _overlaps[idx].matcher = new CVCapiFeatureMatch;
+#endif
 #endif
-    XCAM_ASSERT (_overlaps[idx].matcher.ptr ());
+    }
+
+    XCAM_FAIL_RETURN (
+        ERROR, _overlaps[idx].matcher.ptr (), XCAM_RETURN_ERROR_PARAM,
+        "soft-stitcher:%s unsupported FeatureMatchMode: %d", XCAM_STR (_stitcher->get_name ()), fm_mode);
 
     const FMConfig &config = get_fm_config (_stitcher->get_res_mode ());
     _overlaps[idx].matcher->set_config (config);
@@ -596,10 +743,8 @@ StitcherImpl::init_feature_match (uint32_t idx)
         right_ovlap.height = left_ovlap.height;
     }
     _overlaps[idx].matcher->set_crop_rect (left_ovlap, right_ovlap);
-#else
-    XCAM_LOG_ERROR ("FeatureMatch unsupported");
-    XCAM_ASSERT (false);
-#endif
+
+    return XCAM_RETURN_NO_ERROR;
 }
 
 XCamReturn
@@ -608,7 +753,7 @@ StitcherImpl::init_blender (uint32_t idx)
     _overlaps[idx].blender = create_soft_blender ().dynamic_cast_ptr<SoftBlender>();
     XCAM_ASSERT (_overlaps[idx].blender.ptr ());
 
-    _overlaps[idx].blender->set_pyr_levels (_stitcher->get_blend_pyr_levels ());
+    _overlaps[idx].blender->set_pyr_levels (_quality.blend_pyr_levels);
 
     uint32_t out_width, out_height;
     _stitcher->get_output_size (out_width, out_height);
@@ -685,15 +830,36 @@ StitcherImpl::init_config (uint32_t count)
         _stitch_info = get_stitch_info (_stitcher->get_res_mode (), _stitcher->get_scopic_mode ());
     }
 
+    _quality.blend_pyr_levels = _stitcher->get_blend_pyr_levels ();
+    _quality.fm_interval = (_stitcher->get_fm_mode () == FMNone) ? 0 : 1;
+    _quality.map_factor = MAP_FACTOR;
+    _quality_ctrl.set_frame_budget (_stitcher->get_frame_time_budget ());
+    _quality_ctrl.reset (_quality);
+
+    if (_stitcher->get_fm_mode () != FMNone) {
+        _fm_threads = new ThreadPool ("stitcher-fm-thrs");
+        XCAM_ASSERT (_fm_threads.ptr ());
+        _fm_threads->set_threads (count, count);
+        _fm_threads->set_role (ThreadRoleBackground);
+        XCamReturn ret = _fm_threads->start ();
+        if (!xcam_ret_is_ok (ret)) {
+            XCAM_LOG_WARNING (
+                "soft-stitcher:%s start feature match threads failed, run feature match in blender threads",
+                XCAM_STR (_stitcher->get_name ()));
+            _fm_threads.release ();
+        }
+    }
+
     for (uint32_t i = 0; i < count; ++i) {
         XCamReturn ret = init_fisheye (i);
         XCAM_FAIL_RETURN (
             ERROR, xcam_ret_is_ok (ret), ret,
             "soft-stitcher:%s init fisheye failed, idx:%d.", XCAM_STR (_stitcher->get_name ()), i);
 
-#if ENABLE_FEATURE_MATCH
-        init_feature_match (i);
-#endif
+        ret = init_feature_match (i);
+        XCAM_FAIL_RETURN (
+            ERROR, xcam_ret_is_ok (ret), ret,
+            "soft-stitcher:%s init feature match failed, idx:%d.", XCAM_STR (_stitcher->get_name ()), i);
 
         init_blender (i);
     }
@@ -754,7 +920,7 @@ StitcherImpl::gen_geomap_table ()
         const Stitcher::RoundViewSlice view_slice = _stitcher->get_round_view_slice (i);
         _fisheye[i].mapper->set_output_size (view_slice.width, view_slice.height);
 
-        XCamReturn ret = _fisheye[i].set_map_table (_stitcher, view_slice, i);
+        XCamReturn ret = _fisheye[i].set_map_table (_stitcher, view_slice, i, _quality.map_factor);
         XCAM_FAIL_RETURN (
             ERROR, xcam_ret_is_ok (ret), ret,
             "stitcher:%s generate geomap table failed, idx:%d", XCAM_STR (_stitcher->get_name ()), i);
@@ -763,12 +929,63 @@ StitcherImpl::gen_geomap_table ()
     return XCAM_RETURN_NO_ERROR;
 }
 
+XCamReturn
+StitcherImpl::apply_quality (const StitchQuality &quality)
+{
+    uint32_t camera_num = _stitcher->get_camera_num ();
+    StitchQuality last = _quality;
+    _quality = quality;
+
+    if (quality.blend_pyr_levels != last.blend_pyr_levels) {
+        for (uint32_t i = 0; i < camera_num; ++i) {
+            if (_overlaps[i].blender.ptr ()) {
+                _overlaps[i].blender->terminate ();
+                _overlaps[i].blender.release ();
+            }
+
+            XCamReturn ret = init_blender (i);
+            XCAM_FAIL_RETURN (
+                ERROR, xcam_ret_is_ok (ret), ret,
+                "soft-stitcher:%s reinit blender failed, idx:%d", XCAM_STR (_stitcher->get_name ()), i);
+        }
+    }
+
+    if (quality.map_factor != last.map_factor) {
+        for (uint32_t i = 0; i < camera_num; ++i) {
+            const Stitcher::RoundViewSlice view_slice = _stitcher->get_round_view_slice (i);
+            uint32_t last_width = _fisheye[i].table_width;
+            uint32_t last_height = _fisheye[i].table_height;
+
+            XCamReturn ret = _fisheye[i].set_map_table (_stitcher, view_slice, i, quality.map_factor);
+            XCAM_FAIL_RETURN (
+                ERROR, xcam_ret_is_ok (ret), ret,
+                "soft-stitcher:%s update geomap table failed, idx:%d", XCAM_STR (_stitcher->get_name ()), i);
+
+            _fisheye[i].rescale_factors (last_width, last_height);
+        }
+    }
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+StitcherImpl::update_quality (int64_t frame_time_us)
+{
+    _quality_ctrl.set_frame_budget (_stitcher->get_frame_time_budget ());
+    if (!_quality_ctrl.update (frame_time_us))
+        return XCAM_RETURN_NO_ERROR;
+
+    return apply_quality (_quality_ctrl.get_quality ());
+}
+
 XCamReturn
 StitcherImpl::start_geomap_works (const SmartPtr<SoftStitcher::StitcherParam> &param)
 {
     uint32_t camera_num = _stitcher->get_camera_num ();
     Factor cur_left, cur_right;
 
+    apply_feature_match_results (param->frame_count);
+
     for (uint32_t i = 0; i < camera_num; ++i) {
         SmartPtr<VideoBuffer> out_buf = _fisheye[i].buf_pool->get_buffer ();
         SmartPtr<HandlerParam> geomap_params = new HandlerParam (i);
@@ -809,9 +1026,9 @@ XCamReturn
 StitcherImpl::start_feature_match (
     const SmartPtr<VideoBuffer> &left_buf,
     const SmartPtr<VideoBuffer> &right_buf,
-    const uint32_t idx)
+    const uint32_t idx, const uint32_t frame_count)
 {
-#if ENABLE_FEATURE_MATCH
+    SmartLock fm_locker (_overlaps[idx].fm_mutex);
     _overlaps[idx].matcher->reset_offsets ();
     _overlaps[idx].matcher->feature_match (left_buf, right_buf);
 
@@ -841,15 +1058,60 @@ StitcherImpl::start_feature_match (
 
     {
         SmartLock locker (_map_mutex);
-        _fisheye[left_idx].right_match_factor = right_factor;
-        _fisheye[right_idx].left_match_factor = left_factor;
+        Overlap &overlap = _overlaps[idx];
+        overlap.fm_left_factor = left_factor;
+        overlap.fm_right_factor = right_factor;
+        overlap.fm_frame = frame_count;
+        overlap.fm_ready = true;
     }
 
     return XCAM_RETURN_NO_ERROR;
-#else
-    XCAM_LOG_ERROR ("FeatureMatch unsupported");
-    return XCAM_RETURN_ERROR_PARAM;
-#endif
+}
+
+bool
+StitcherImpl::acquire_feature_match (uint32_t idx, uint32_t frame_count)
+{
+    SmartLock locker (_map_mutex);
+    Overlap &overlap = _overlaps[idx];
+
+    // frames stitched before last result applied would measure the offset again
+    if (overlap.fm_busy || frame_count < overlap.fm_applied_frame)
+        return false;
+
+    overlap.fm_busy = true;
+    return true;
+}
+
+void
+StitcherImpl::release_feature_match (uint32_t idx)
+{
+    SmartLock locker (_map_mutex);
+    _overlaps[idx].fm_busy = false;
+}
+
+void
+StitcherImpl::apply_feature_match_results (uint32_t frame_count)
+{
+    const uint32_t camera_num = _stitcher->get_camera_num ();
+    const uint32_t lag = XCAM_MAX (_stitcher->get_fm_lag (), 1u);
+
+    // decided before any geomap of the frame starts, both cameras of a seam take the result together
+    SmartLock locker (_map_mutex);
+    for (uint32_t idx = 0; idx < camera_num; ++idx) {
+        Overlap &overlap = _overlaps[idx];
+        if (!overlap.fm_ready || frame_count < overlap.fm_frame + lag)
+            continue;
+
+        _fisheye[idx].right_match_factor = overlap.fm_right_factor;
+        _fisheye[(idx + 1) % camera_num].left_match_factor = overlap.fm_left_factor;
+
+        overlap.fm_ready = false;
+        overlap.fm_busy = false;
+        overlap.fm_applied_frame = frame_count;
+        XCAM_LOG_DEBUG (
+            "soft-stitcher:%s apply feature match idx:%d of frame:%d to frame:%d",
+            XCAM_STR (_stitcher->get_name ()), idx, overlap.fm_frame, frame_count);
+    }
 }
 
 XCamReturn
@@ -865,21 +1127,40 @@ StitcherImpl::start_overlap_task (uint32_t idx, const SmartPtr<BlenderParam> &pa
             "soft-stitcher:%s blender idx:%d failed", XCAM_STR (_stitcher->get_name ()), idx);
     }
 
-#if ENABLE_FEATURE_MATCH
-    if (_stitcher->get_fm_mode ()) {
-        if (fm_status != FMStatusWholeWay && param->stitch_param->frame_count >= fm_frames)
+    if (param->stitch_param->need_fm) {
+        // one asynchronous match in flight for each seam, later frames go without it
+        if (!param->stitch_param->fm_sync &&
+                !acquire_feature_match (idx, param->stitch_param->frame_count))
             return XCAM_RETURN_NO_ERROR;
 
-        XCamReturn ret = start_feature_match (param->in_buf, param->in1_buf, idx);
-        XCAM_FAIL_RETURN (
-            ERROR, xcam_ret_is_ok (ret), ret,
-            "soft-stitcher:%s feature match idx:%d failed", XCAM_STR (_stitcher->get_name ()), idx);
+        SmartPtr<FeatureMatchJob> job = new FeatureMatchJob (_stitcher, idx, param);
+        XCAM_ASSERT (job.ptr ());
+        if (!_fm_threads.ptr () || !xcam_ret_is_ok (_fm_threads->queue (job))) {
+            job->done (job->run ());
+        }
     }
-#endif
 
     return XCAM_RETURN_NO_ERROR;
 }
 
+bool
+StitcherImpl::need_feature_match (uint32_t frame_count) const
+{
+    if (_stitcher->get_fm_mode () == FMNone)
+        return false;
+
+    FeatureMatchStatus fm_status = _stitcher->get_fm_status ();
+    if (fm_status != FMStatusWholeWay && frame_count >= _stitcher->get_fm_frames ())
+        return false;
+
+    // FMStatusFMFirst does not blend before feature match finished, never skip it
+    if (fm_status != FMStatusFMFirst && _quality.fm_interval > 1 &&
+            frame_count % _quality.fm_interval != 0)
+        return false;
+
+    return true;
+}
+
 XCamReturn
 StitcherImpl::start_overlap_tasks (
     const SmartPtr<SoftStitcher::StitcherParam> &param,
@@ -1015,6 +1296,11 @@ StitcherImpl::stop ()
         _geomap_pool->stop ();
     }
 
+    if (_fm_threads.ptr ()) {
+        _fm_threads->stop ();
+        _fm_threads.release ();
+    }
+
     return XCAM_RETURN_NO_ERROR;
 }
 
@@ -1066,12 +1352,29 @@ SoftStitcher::stitch_buffers (const VideoBufferList &in_bufs, SmartPtr<VideoBuff
         }
     }
 
+    param->start_time = get_time_us ();
+
     XCamReturn ret = execute_buffer (param, true);
 
     if (!out_buf.ptr () && xcam_ret_is_ok (ret)) {
         out_buf = param->out_buf;
     }
 
+    if (xcam_ret_is_ok (ret)) {
+        StitchStageTime stage_time;
+        stage_time.total = get_time_us () - param->start_time;
+        stage_time.geomap = param->geomap_end ? (param->geomap_end - param->start_time) : 0;
+        stage_time.blend = param->blend_end ? (param->blend_end - param->start_time) : 0;
+        stage_time.copy = param->copy_end ? (param->copy_end - param->start_time) : 0;
+        stage_time.feature_match = param->fm_time;
+        set_stage_time (stage_time);
+
+        XCamReturn ret_quality = _impl->update_quality (stage_time.total);
+        XCAM_FAIL_RETURN (
+            ERROR, xcam_ret_is_ok (ret_quality), ret_quality,
+            "soft-stitcher:%s update quality failed", XCAM_STR (get_name ()));
+    }
+
     return ret;
 }
 
@@ -1104,6 +1407,13 @@ SoftStitcher::start_task_count (const SmartPtr<SoftStitcher::StitcherParam> &par
         count += get_copy_area ().size ();
     }
 
+    // FMStatusFMFirst frames wait for feature match since they are not blended,
+    // others do not, their results are applied to later frames
+    param->need_fm = _impl->need_feature_match (param->frame_count);
+    param->fm_sync = param->need_fm && get_fm_status () == FMStatusFMFirst;
+    if (param->fm_sync)
+        count += get_camera_num ();
+
     XCAM_LOG_DEBUG ("stitcher :%s start task count :%d", XCAM_STR(get_name ()), count);
     _impl->_task_counts.insert (std::make_pair((void*)param.ptr(), count));
 
@@ -1125,6 +1435,11 @@ SoftStitcher::geomap_done (
     if (!check_work_continue (param, error))
         return;
 
+    {
+        SmartLock locker (_impl->_map_mutex);
+        param->geomap_end = get_time_us ();
+    }
+
     XCAM_LOG_DEBUG ("soft-stitcher:%s camera(idx:%d) geomap done", XCAM_STR (get_name ()), geomap_param->idx);
     stitcher_dump_buf (geomap_param->out_buf, geomap_param->idx, "stitcher-geomap");
 
@@ -1171,6 +1486,11 @@ SoftStitcher::blender_done (
     stitcher_dump_buf (blender_param->out_buf, blender_param->idx, "stitcher-blend");
     XCAM_LOG_DEBUG ("blender:(%s) overlap:%d done", XCAM_STR (handler->get_name ()), blender_param->idx);
 
+    {
+        SmartLock locker (_impl->_map_mutex);
+        param->blend_end = get_time_us ();
+    }
+
     if (_impl->dec_task_count (param) == 0) {
         work_well_done (param, error);
     }
@@ -1196,11 +1516,39 @@ SoftStitcher::copy_task_done (
     }
     XCAM_LOG_DEBUG ("soft-stitcher:%s camera(idx:%d) copy done", XCAM_STR (get_name ()), args->idx);
 
+    {
+        SmartLock locker (_impl->_map_mutex);
+        param->copy_end = get_time_us ();
+    }
+
     if (_impl->dec_task_count (param) == 0) {
         work_well_done (param, error);
     }
 }
 
+void
+SoftStitcher::feature_match_done (
+    const SmartPtr<SoftStitcher::StitcherParam> &param,
+    const uint32_t idx, const XCamReturn error)
+{
+    XCAM_ASSERT (param.ptr ());
+
+    // a failed match keeps factors of last match, it does not break the frame
+    if (!xcam_ret_is_ok (error)) {
+        XCAM_LOG_WARNING ("soft-stitcher:%s feature match idx:%d failed", XCAM_STR (get_name ()), idx);
+    }
+
+    if (!check_work_continue (param, XCAM_RETURN_NO_ERROR)) {
+        _impl->remove_task_count (param);
+        return;
+    }
+    XCAM_LOG_DEBUG ("soft-stitcher:%s feature match idx:%d done", XCAM_STR (get_name ()), idx);
+
+    if (_impl->dec_task_count (param) == 0) {
+        work_well_done (param, XCAM_RETURN_NO_ERROR);
+    }
+}
+
 XCamReturn
 SoftStitcher::configure_resource (const SmartPtr<Parameters> &param)
 {
@@ -32,6 +32,7 @@ class StitcherImpl;
 class CbGeoMap;
 class CbBlender;
 class CbCopyTask;
+class FeatureMatchJob;
 };
 
 class SoftStitcher
@@ -42,6 +43,7 @@ class SoftStitcher
     friend class SoftStitcherPriv::CbGeoMap;
     friend class SoftStitcherPriv::CbBlender;
     friend class SoftStitcherPriv::CbCopyTask;
+    friend class SoftStitcherPriv::FeatureMatchJob;
 
 public:
     struct StitcherParam
@@ -49,12 +51,30 @@ public:
     {
         uint32_t in_buf_num;
         uint32_t frame_count;
+        // decided once per frame, only fm_sync feature match tasks are counted in frame tasks,
+        // others run off the critical path and are applied to later frames
+        bool need_fm;
+        bool fm_sync;
         SmartPtr<VideoBuffer> in_bufs[XCAM_STITCH_MAX_CAMERAS];
 
+        // stage timestamps in microseconds
+        int64_t start_time;
+        int64_t geomap_end;
+        int64_t blend_end;
+        int64_t copy_end;
+        int64_t fm_time;
+
         StitcherParam ()
             : Parameters (NULL, NULL)
             , in_buf_num (0)
             , frame_count (0)
+            , need_fm (false)
+            , fm_sync (false)
+            , start_time (0)
+            , geomap_end (0)
+            , blend_end (0)
+            , copy_end (0)
+            , fm_time (0)
         {}
     };
 
@@ -86,6 +106,9 @@ private:
     void copy_task_done (
         const SmartPtr<Worker> &worker,
         const SmartPtr<Worker::Arguments> &base, const XCamReturn error);
+    void feature_match_done (
+        const SmartPtr<SoftStitcher::StitcherParam> &param,
+        const uint32_t idx, const XCamReturn error);
 
 private:
     SmartPtr<SoftStitcherPriv::StitcherImpl> _impl;
@@ -0,0 +1,316 @@
+/*
+ * soft_tnr_handler.cpp - soft temporal noise reduction handler class implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_tnr_handler.h"
+#include "soft_tnr_tasks_priv.h"
+
+// same as kernel_tnr_yuv
+#define TNR_DIFF_MAX 0.8f
+#define TNR_MIN_GAIN 0.05f
+// reference weight below it counts as moving, in XCAM_SOFT_TNR_WEIGHT_ONE unit
+#define TNR_MOVING_WEIGHT 2
+// tile mean difference above TNR_MOVING_RATIO * threshold is motion rather than noise,
+// not lower than TNR_MOVING_MIN_DIFF levels
+#define TNR_MOVING_RATIO 4.0f
+#define TNR_MOVING_MIN_DIFF 16
+
+namespace XCam {
+
+DECLARE_WORK_CALLBACK (CbTnrTask, SoftTnrHandler, tnr_task_done);
+
+// weight of reference relative to current pixel, from current blending ratio of kernel_tnr_yuv
+static uint16_t
+get_ref_weight (float diff, float gain, float thr)
+{
+    float coeff = gain;
+    if (diff >= thr) {
+        coeff = (thr < TNR_DIFF_MAX) ?
+                (diff * (1.0f - gain) + TNR_DIFF_MAX * gain - thr) / (TNR_DIFF_MAX - thr) : 1.0f;
+    }
+    if (coeff >= 1.0f)
+        return 0;
+
+    return (uint16_t)(XCAM_SOFT_TNR_WEIGHT_ONE * (1.0f - coeff) / coeff + 0.5f);
+}
+
+SoftTnrHandler::SoftTnrHandler (const char *name)
+    : SoftHandler (name)
+    , _ref_count (XCAM_SOFT_TNR_DEFAULT_REF_COUNT)
+    , _gain (0.4f)
+    , _thr_y (0.05f)
+    , _thr_uv (0.05f)
+    , _config_changed (true)
+{
+}
+
+SoftTnrHandler::~SoftTnrHandler ()
+{
+}
+
+bool
+SoftTnrHandler::set_ref_count (uint32_t count)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, count && count <= XCAM_SOFT_TNR_MAX_REF_COUNT, false,
+        "SoftTnrHandler(%s) reference count(%d) need be in range [1, %d]",
+        XCAM_STR (get_name ()), count, XCAM_SOFT_TNR_MAX_REF_COUNT);
+
+    XCAM_FAIL_RETURN (
+        ERROR, _need_configure, false,
+        "SoftTnrHandler(%s) reference count can NOT be changed after configured",
+        XCAM_STR (get_name ()));
+
+    _ref_count = count;
+    return true;
+}
+
+bool
+SoftTnrHandler::set_yuv_config (const XCam3aResultTemporalNoiseReduction &config)
+{
+    XCAM_FAIL_RETURN (
+        ERROR,
+        config.gain >= 0.0 && config.gain <= 1.0 &&
+        config.threshold[0] >= 0.0 && config.threshold[0] <= 1.0 &&
+        config.threshold[1] >= 0.0 && config.threshold[1] <= 1.0,
+        false,
+        "SoftTnrHandler(%s) invalid config, gain:%.3f, thr_y:%.3f, thr_uv:%.3f",
+        XCAM_STR (get_name ()), config.gain, config.threshold[0], config.threshold[1]);
+
+    SmartLock locker (_config_mutex);
+    _gain = (float)config.gain;
+    _thr_y = (float)config.threshold[0];
+    _thr_uv = (float)config.threshold[1];
+    _config_changed = true;
+
+    XCAM_LOG_DEBUG (
+        "SoftTnrHandler(%s) set yuv config, gain:%.3f, thr_y:%.3f, thr_uv:%.3f",
+        XCAM_STR (get_name ()), _gain, _thr_y, _thr_uv);
+
+    return true;
+}
+
+XCamReturn
+SoftTnrHandler::denoise (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in, out);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+void
+SoftTnrHandler::update_table ()
+{
+    float gain, thr_y, thr_uv;
+    {
+        SmartLock locker (_config_mutex);
+        gain = XCAM_MAX (_gain, TNR_MIN_GAIN);
+        thr_y = _thr_y;
+        thr_uv = _thr_uv;
+        _config_changed = false;
+    }
+
+    SmartPtr<XCamSoftTasks::TnrTable> table = new XCamSoftTasks::TnrTable;
+    XCAM_ASSERT (table.ptr ());
+
+    uint32_t moving = 256;
+    for (uint32_t i = 0; i < 256; ++i) {
+        const float diff = i / 255.0f;
+        table->luma_weight[i] = get_ref_weight (diff, gain, thr_y);
+        table->uv_weight[i] = get_ref_weight (diff, gain, thr_uv);
+        if (moving == 256 && table->luma_weight[i] < TNR_MOVING_WEIGHT)
+            moving = i;
+    }
+
+    const uint32_t weight = table->luma_weight[0];
+    table->static_weight = weight;
+    table->static_diff = (uint32_t)(thr_y * 255.0f * 16.0f);
+    moving = XCAM_MIN (moving, XCAM_MAX ((uint32_t)(thr_y * TNR_MOVING_RATIO * 255.0f), TNR_MOVING_MIN_DIFF));
+    table->moving_diff = XCAM_MAX (moving * 16, table->static_diff);
+
+    // 8-bit weights of current and each reference, sum of all is 256
+    table->static_cur[0] = 256;
+    table->static_ref[0] = 0;
+    for (uint32_t n = 1; n <= XCAM_SOFT_TNR_MAX_REF_COUNT; ++n) {
+        const uint32_t total = XCAM_SOFT_TNR_WEIGHT_ONE + n * weight;
+        table->static_ref[n] = (256 * weight + total / 2) / total;
+        table->static_cur[n] = 256 - n * table->static_ref[n];
+    }
+
+    _table = table;
+}
+
+XCamReturn
+SoftTnrHandler::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        ERROR, in_info.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftTnrHandler(%s) only support format(NV12) but input format is %s",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (in_info.format));
+
+    set_out_video_info (in_info);
+
+    // references stay in output pool
+    if (_enable_allocator)
+        enable_allocator (true, XCAM_DEFAULT_HANDLER_BUF_CAP + _ref_count);
+
+    XCAM_ASSERT (!_tnr_task.ptr ());
+    _tnr_task = new XCamSoftTasks::TnrNV12Task (new CbTnrTask (this));
+    XCAM_ASSERT (_tnr_task.ptr ());
+    share_threads (_tnr_task);
+
+    set_work_size (in_info.width, in_info.height);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftTnrHandler::set_work_size (uint32_t width, uint32_t height)
+{
+    uint32_t thread_x = 1, thread_y = 8;
+
+    WorkSize global_size (
+        xcam_ceil (width, XCAM_SOFT_TNR_TILE_SIZE) / XCAM_SOFT_TNR_TILE_SIZE,
+        xcam_ceil (height, XCAM_SOFT_TNR_TILE_SIZE) / XCAM_SOFT_TNR_TILE_SIZE);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    _tnr_task->set_local_size (local_size);
+    _tnr_task->set_global_size (global_size);
+}
+
+XCamReturn
+SoftTnrHandler::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_tnr_task.ptr ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    bool changed;
+    {
+        SmartLock locker (_config_mutex);
+        changed = _config_changed;
+    }
+    if (changed || !_table.ptr ())
+        update_table ();
+
+    SmartPtr<XCamSoftTasks::TnrNV12Task::Args> args = new XCamSoftTasks::TnrNV12Task::Args (param);
+    args->in_luma = new UcharImage (param->in_buf, 0);
+    args->in_uv = new Uchar2Image (param->in_buf, 1);
+    args->out_luma = new UcharImage (param->out_buf, 0);
+    args->out_uv = new Uchar2Image (param->out_buf, 1);
+    args->table = _table;
+    {
+        // execute_buffer is sync, so all references are finished outputs
+        SmartLock locker (_refs_mutex);
+        XCAM_ASSERT (_refs.size () <= _ref_count);
+        for (BufferList::iterator i = _refs.begin (); i != _refs.end (); ++i) {
+            XCAM_ASSERT ((*i).ptr () != param->out_buf.ptr ());
+            args->ref_luma[args->ref_count] = new UcharImage (*i, 0);
+            args->ref_uv[args->ref_count] = new Uchar2Image (*i, 1);
+            ++args->ref_count;
+        }
+
+        // latest output first
+        _refs.push_front (param->out_buf);
+        if (_refs.size () > _ref_count)
+            _refs.pop_back ();
+    }
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = _tnr_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftTnrHandler(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+XCamReturn
+SoftTnrHandler::execute_buffer (const SmartPtr<Parameters> &param, bool sync)
+{
+    XCAM_UNUSED (sync);
+    return SoftHandler::execute_buffer (param, true);
+}
+
+XCamReturn
+SoftTnrHandler::execute_buffers (const ParametersList &params, bool sync)
+{
+    XCAM_UNUSED (sync);
+
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    for (ParametersList::const_iterator i = params.begin (); i != params.end (); ++i) {
+        ret = execute_buffer (*i, true);
+        XCAM_FAIL_RETURN (
+            ERROR, xcam_ret_is_ok (ret), ret,
+            "SoftTnrHandler(%s) execute buffers failed", XCAM_STR (get_name ()));
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftTnrHandler::terminate ()
+{
+    if (_tnr_task.ptr ()) {
+        _tnr_task->stop ();
+        _tnr_task.release ();
+    }
+    {
+        SmartLock locker (_refs_mutex);
+        _refs.clear ();
+    }
+
+    return SoftHandler::terminate ();
+}
+
+void
+SoftTnrHandler::tnr_task_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _tnr_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    work_well_done (param, error);
+}
+
+SmartPtr<SoftHandler>
+create_soft_tnr_handler ()
+{
+    SmartPtr<SoftTnrHandler> tnr = new SoftTnrHandler ();
+    XCAM_ASSERT (tnr.ptr ());
+
+    return tnr;
+}
+
+}
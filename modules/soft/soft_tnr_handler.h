@@ -0,0 +1,104 @@
+/*
+ * soft_tnr_handler.h - soft temporal noise reduction handler class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_TNR_HANDLER_H
+#define XCAM_SOFT_TNR_HANDLER_H
+
+#include <xcam_std.h>
+#include <base/xcam_3a_result.h>
+#include <soft/soft_handler.h>
+#include <list>
+
+#define XCAM_SOFT_TNR_MAX_REF_COUNT 4
+#define XCAM_SOFT_TNR_DEFAULT_REF_COUNT 2
+
+namespace XCam {
+
+class SoftWorker;
+
+namespace XCamSoftTasks {
+struct TnrTable;
+};
+
+/* motion adaptive temporal noise reduction on NV12, same blending curve as kernel_tnr_yuv.
+ * the last K outputs are held as reference frames, so output buffers must not be
+ * written by others afterwards, output pool needs K more buffers.
+ * each 16x16 tile compares against every reference by SAD first, static tiles
+ * blend with fixed weights, moving tiles skip the reference, only the rest
+ * computes per-pixel weights. frame N+1 reads output of frame N, so buffers are
+ * always executed synchronously, one frame in flight.
+ */
+class SoftTnrHandler
+    : public SoftHandler
+{
+    typedef std::list<SmartPtr<VideoBuffer> > BufferList;
+
+public:
+    explicit SoftTnrHandler (const char *name = "SoftTnrHandler");
+    ~SoftTnrHandler ();
+
+    // count in range [1, XCAM_SOFT_TNR_MAX_REF_COUNT], can NOT be changed after configured
+    bool set_ref_count (uint32_t count);
+    uint32_t get_ref_count () const {
+        return _ref_count;
+    }
+    // gain and threshold[0..1] for luma and uv, all in range [0, 1], thread safe
+    bool set_yuv_config (const XCam3aResultTemporalNoiseReduction &config);
+
+    XCamReturn denoise (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out);
+
+    //derived from SoftHandler, sync is ignored, always waits for the frame done
+    virtual XCamReturn execute_buffer (const SmartPtr<Parameters> &param, bool sync);
+    virtual XCamReturn execute_buffers (const ParametersList &params, bool sync);
+    virtual XCamReturn terminate ();
+
+    void tnr_task_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    void update_table ();
+    void set_work_size (uint32_t width, uint32_t height);
+
+    XCAM_DEAD_COPY (SoftTnrHandler);
+
+private:
+    SmartPtr<SoftWorker>                _tnr_task;
+    SmartPtr<XCamSoftTasks::TnrTable>   _table;
+    Mutex                               _refs_mutex;
+    BufferList                          _refs;
+    uint32_t                            _ref_count;
+
+    Mutex                               _config_mutex;
+    float                               _gain;
+    float                               _thr_y;
+    float                               _thr_uv;
+    bool                                _config_changed;
+};
+
+extern SmartPtr<SoftHandler> create_soft_tnr_handler ();
+
+}
+
+#endif //XCAM_SOFT_TNR_HANDLER_H
@@ -0,0 +1,234 @@
+/*
+ * soft_tnr_tasks_priv.cpp - soft temporal noise reduction tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_tnr_tasks_priv.h"
+
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+struct TileRows {
+    const uint8_t   *cur;
+    const uint8_t   *refs[XCAM_SOFT_TNR_MAX_REF_COUNT];
+    uint8_t         *out;
+};
+
+static uint32_t
+tile_sad (
+    const uint8_t *cur, uint32_t cur_stride, const uint8_t *ref, uint32_t ref_stride,
+    uint32_t bytes, uint32_t rows)
+{
+    uint32_t sad = 0;
+
+#if defined (__SSE2__)
+    if (bytes == XCAM_SOFT_TNR_TILE_SIZE) {
+        __m128i acc = _mm_setzero_si128 ();
+        for (uint32_t y = 0; y < rows; ++y) {
+            __m128i a = _mm_loadu_si128 ((const __m128i *)(cur + y * cur_stride));
+            __m128i b = _mm_loadu_si128 ((const __m128i *)(ref + y * ref_stride));
+            acc = _mm_add_epi64 (acc, _mm_sad_epu8 (a, b));
+        }
+        return _mm_cvtsi128_si32 (acc) + _mm_cvtsi128_si32 (_mm_srli_si128 (acc, 8));
+    }
+#endif
+
+    for (uint32_t y = 0; y < rows; ++y) {
+        const uint8_t *a = cur + y * cur_stride;
+        const uint8_t *b = ref + y * ref_stride;
+        for (uint32_t x = 0; x < bytes; ++x)
+            sad += abs ((int32_t)a[x] - (int32_t)b[x]);
+    }
+    return sad;
+}
+
+static void
+copy_row (const TileRows &row, uint32_t bytes)
+{
+    memcpy (row.out, row.cur, bytes);
+}
+
+// out = (cur * w_cur + sum (ref * w_ref) + 128) >> 8, w_cur + count * w_ref == 256
+static void
+blend_static_row (
+    const TileRows &row, const uint32_t *refs, uint32_t count,
+    uint16_t w_cur, uint16_t w_ref, uint32_t bytes)
+{
+    uint32_t i = 0;
+
+#if defined (__SSE2__)
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i round = _mm_set1_epi16 (128);
+    const __m128i wc = _mm_set1_epi16 (w_cur);
+    const __m128i wr = _mm_set1_epi16 (w_ref);
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i pixels = _mm_loadu_si128 ((const __m128i *)(row.cur + i));
+        __m128i lo = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (pixels, zero), wc), round);
+        __m128i hi = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (pixels, zero), wc), round);
+        for (uint32_t k = 0; k < count; ++k) {
+            pixels = _mm_loadu_si128 ((const __m128i *)(row.refs[refs[k]] + i));
+            lo = _mm_add_epi16 (lo, _mm_mullo_epi16 (_mm_unpacklo_epi8 (pixels, zero), wr));
+            hi = _mm_add_epi16 (hi, _mm_mullo_epi16 (_mm_unpackhi_epi8 (pixels, zero), wr));
+        }
+        pixels = _mm_packus_epi16 (_mm_srli_epi16 (lo, 8), _mm_srli_epi16 (hi, 8));
+        _mm_storeu_si128 ((__m128i *)(row.out + i), pixels);
+    }
+#endif
+
+    for (; i < bytes; ++i) {
+        uint32_t sum = row.cur[i] * w_cur + 128;
+        for (uint32_t k = 0; k < count; ++k)
+            sum += row.refs[refs[k]][i] * w_ref;
+        row.out[i] = (uint8_t)(sum >> 8);
+    }
+}
+
+// per-pixel weights, static references keep fixed weight
+static void
+blend_adaptive_row (
+    const TileRows &row, const uint32_t *refs, uint32_t count, uint32_t static_count,
+    const uint16_t *weight, uint16_t static_weight, uint32_t bytes)
+{
+    for (uint32_t i = 0; i < bytes; ++i) {
+        const int32_t cur = row.cur[i];
+        uint32_t sum = cur * XCAM_SOFT_TNR_WEIGHT_ONE;
+        uint32_t total = XCAM_SOFT_TNR_WEIGHT_ONE;
+        for (uint32_t k = 0; k < count; ++k) {
+            const int32_t ref = row.refs[refs[k]][i];
+            const uint32_t w = (k < static_count) ? static_weight : weight[abs (cur - ref)];
+            sum += ref * w;
+            total += w;
+        }
+        row.out[i] = (uint8_t)((sum + total / 2) / total);
+    }
+}
+
+static inline void
+get_luma_rows (TnrNV12Task::Args *args, uint32_t x, uint32_t y, TileRows &row)
+{
+    row.cur = args->in_luma->get_buf_ptr (x, y);
+    row.out = args->out_luma->get_buf_ptr (x, y);
+    for (uint32_t k = 0; k < args->ref_count; ++k)
+        row.refs[k] = args->ref_luma[k]->get_buf_ptr (x, y);
+}
+
+static inline void
+get_uv_rows (TnrNV12Task::Args *args, uint32_t x, uint32_t y, TileRows &row)
+{
+    row.cur = (const uint8_t *)args->in_uv->get_buf_ptr (x, y);
+    row.out = (uint8_t *)args->out_uv->get_buf_ptr (x, y);
+    for (uint32_t k = 0; k < args->ref_count; ++k)
+        row.refs[k] = (const uint8_t *)args->ref_uv[k]->get_buf_ptr (x, y);
+}
+
+XCamReturn
+TnrNV12Task::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<TnrNV12Task::Args> args = base.dynamic_cast_ptr<TnrNV12Task::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    XCAM_ASSERT (args->in_luma.ptr () && args->out_luma.ptr ());
+    XCAM_ASSERT (args->in_uv.ptr () && args->out_uv.ptr ());
+    XCAM_ASSERT (args->ref_count <= XCAM_SOFT_TNR_MAX_REF_COUNT);
+    const TnrTable *table = args->table.ptr ();
+    XCAM_ASSERT (table);
+
+    const uint32_t width = args->in_luma->get_width ();
+    const uint32_t height = args->in_luma->get_height ();
+    const uint32_t uv_height = args->in_uv->get_height ();
+    const uint32_t cur_stride = args->in_luma->get_pitch ();
+    TileRows row;
+
+    for (uint32_t ty = range.pos[1]; ty < range.pos[1] + range.pos_len[1]; ++ty) {
+        for (uint32_t tx = range.pos[0]; tx < range.pos[0] + range.pos_len[0]; ++tx) {
+            const uint32_t x0 = tx * XCAM_SOFT_TNR_TILE_SIZE;
+            const uint32_t y0 = ty * XCAM_SOFT_TNR_TILE_SIZE;
+            const uint32_t bytes = XCAM_MIN (XCAM_SOFT_TNR_TILE_SIZE, width - x0);
+            const uint32_t rows = XCAM_MIN (XCAM_SOFT_TNR_TILE_SIZE, height - y0);
+            const uint32_t area = bytes * rows;
+            const uint32_t uv_y0 = y0 / 2;
+            const uint32_t uv_y1 = XCAM_MIN ((y0 + rows + 1) / 2, uv_height);
+
+            // static references first, then adaptive ones, moving ones are skipped
+            uint32_t refs[XCAM_SOFT_TNR_MAX_REF_COUNT];
+            uint32_t static_count = 0, adaptive_count = 0;
+            uint32_t adaptive[XCAM_SOFT_TNR_MAX_REF_COUNT];
+
+            get_luma_rows (args.ptr (), x0, y0, row);
+            for (uint32_t k = 0; k < args->ref_count; ++k) {
+                const uint32_t ref_stride = args->ref_luma[k]->get_pitch ();
+                // differences in 1/16 level
+                const uint32_t diff = tile_sad (row.cur, cur_stride, row.refs[k], ref_stride, bytes, rows) * 16;
+                if (diff < table->static_diff * area)
+                    refs[static_count++] = k;
+                else if (diff < table->moving_diff * area)
+                    adaptive[adaptive_count++] = k;
+            }
+            for (uint32_t k = 0; k < adaptive_count; ++k)
+                refs[static_count + k] = adaptive[k];
+            const uint32_t count = static_count + adaptive_count;
+
+            if (!count) {
+                for (uint32_t y = y0; y < y0 + rows; ++y) {
+                    get_luma_rows (args.ptr (), x0, y, row);
+                    copy_row (row, bytes);
+                }
+                for (uint32_t y = uv_y0; y < uv_y1; ++y) {
+                    get_uv_rows (args.ptr (), x0 / 2, y, row);
+                    copy_row (row, bytes);
+                }
+            } else if (!adaptive_count) {
+                const uint16_t w_cur = table->static_cur[count];
+                const uint16_t w_ref = table->static_ref[count];
+                for (uint32_t y = y0; y < y0 + rows; ++y) {
+                    get_luma_rows (args.ptr (), x0, y, row);
+                    blend_static_row (row, refs, count, w_cur, w_ref, bytes);
+                }
+                for (uint32_t y = uv_y0; y < uv_y1; ++y) {
+                    get_uv_rows (args.ptr (), x0 / 2, y, row);
+                    blend_static_row (row, refs, count, w_cur, w_ref, bytes);
+                }
+            } else {
+                for (uint32_t y = y0; y < y0 + rows; ++y) {
+                    get_luma_rows (args.ptr (), x0, y, row);
+                    blend_adaptive_row (
+                        row, refs, count, static_count, table->luma_weight, table->static_weight, bytes);
+                }
+                for (uint32_t y = uv_y0; y < uv_y1; ++y) {
+                    get_uv_rows (args.ptr (), x0 / 2, y, row);
+                    blend_adaptive_row (
+                        row, refs, count, static_count, table->uv_weight, table->static_weight, bytes);
+                }
+            }
+        }
+    }
+
+    XCAM_LOG_DEBUG (
+        "TnrNV12Task work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+}
+
+}
@@ -0,0 +1,88 @@
+/*
+ * soft_tnr_tasks_priv.h - soft temporal noise reduction tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_TNR_TASKS_PRIV_H
+#define XCAM_SOFT_TNR_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_handler.h>
+#include <soft/soft_tnr_handler.h>
+
+// luma tile size, uv tile is half height with same bytes per line
+#define XCAM_SOFT_TNR_TILE_SIZE 16
+// fixed point unit of reference weights, current pixel weight is always 1
+#define XCAM_SOFT_TNR_WEIGHT_ONE 64
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+struct TnrTable {
+    // reference weight of per-pixel absolute difference
+    uint16_t    luma_weight[256];
+    uint16_t    uv_weight[256];
+
+    // tile mean difference below static_diff, reference takes static_weight on all pixels
+    // tile mean difference from moving_diff, reference is skipped
+    uint32_t    static_diff;
+    uint32_t    moving_diff;
+    uint16_t    static_weight;
+
+    // 8-bit blending weights when n references are all static, index is n
+    uint16_t    static_cur[XCAM_SOFT_TNR_MAX_REF_COUNT + 1];
+    uint16_t    static_ref[XCAM_SOFT_TNR_MAX_REF_COUNT + 1];
+};
+
+// one work item is one luma tile and its uv tile
+class TnrNV12Task
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>        in_luma, out_luma;
+        SmartPtr<Uchar2Image>       in_uv, out_uv;
+        SmartPtr<UcharImage>        ref_luma[XCAM_SOFT_TNR_MAX_REF_COUNT];
+        SmartPtr<Uchar2Image>       ref_uv[XCAM_SOFT_TNR_MAX_REF_COUNT];
+        uint32_t                    ref_count;
+        SmartPtr<TnrTable>          table;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+            , ref_count (0)
+        {}
+    };
+
+public:
+    explicit TnrNV12Task (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("TnrNV12Task", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+}
+
+}
+
+#endif //XCAM_SOFT_TNR_TASKS_PRIV_H
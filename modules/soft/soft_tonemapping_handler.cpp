@@ -0,0 +1,243 @@
+/*
+ * soft_tonemapping_handler.cpp - soft local tone mapping handler class implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_tonemapping_handler.h"
+#include "soft_tonemapping_tasks_priv.h"
+
+#define TONEMAP_DEFAULT_STRENGTH 0.5f
+#define TONEMAP_DEFAULT_SMOOTH 0.25f
+// 4x gain on shadows at most, same limit on highlights
+#define TONEMAP_MAX_STOPS 2.0f
+
+namespace XCam {
+
+DECLARE_WORK_CALLBACK (CbTonemapSplat, SoftTonemappingHandler, splat_done);
+DECLARE_WORK_CALLBACK (CbTonemapSlice, SoftTonemappingHandler, slice_done);
+
+SoftTonemappingHandler::SoftTonemappingHandler (const char *name)
+    : SoftHandler (name)
+    , _strength (TONEMAP_DEFAULT_STRENGTH)
+    , _smooth (TONEMAP_DEFAULT_SMOOTH)
+    , _anchor (0.0f)
+    , _grid_valid (false)
+{
+}
+
+SoftTonemappingHandler::~SoftTonemappingHandler ()
+{
+}
+
+bool
+SoftTonemappingHandler::set_strength (float strength)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, strength >= 0.0f && strength <= 1.0f, false,
+        "SoftTonemappingHandler(%s) strength(%.3f) need be in range [0, 1]",
+        XCAM_STR (get_name ()), strength);
+
+    SmartLock locker (_config_mutex);
+    _strength = strength;
+    return true;
+}
+
+bool
+SoftTonemappingHandler::set_temporal_smooth (float smooth)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, smooth > 0.0f && smooth <= 1.0f, false,
+        "SoftTonemappingHandler(%s) temporal smooth(%.3f) need be in range (0, 1]",
+        XCAM_STR (get_name ()), smooth);
+
+    SmartLock locker (_config_mutex);
+    _smooth = smooth;
+    return true;
+}
+
+XCamReturn
+SoftTonemappingHandler::tonemap (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in, out);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftTonemappingHandler::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        ERROR, in_info.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftTonemappingHandler(%s) only support format(NV12) but input format is %s",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (in_info.format));
+
+    set_out_video_info (in_info);
+
+    const uint32_t grid_width = xcam_ceil (in_info.width, XCAM_SOFT_TONEMAP_GRID_CELL) / XCAM_SOFT_TONEMAP_GRID_CELL;
+    const uint32_t grid_height = xcam_ceil (in_info.height, XCAM_SOFT_TONEMAP_GRID_CELL) / XCAM_SOFT_TONEMAP_GRID_CELL;
+    _splat = new XCamSoftTasks::TonemapGrid;
+    _base = new XCamSoftTasks::TonemapGrid;
+    _gain = new XCamSoftTasks::TonemapGrid;
+    _table = new XCamSoftTasks::TonemapSliceTable;
+    XCAM_ASSERT (_splat.ptr () && _base.ptr () && _gain.ptr () && _table.ptr ());
+    _splat->init (grid_width, grid_height, true);
+    _base->init (grid_width, grid_height, false);
+    _gain->init (grid_width, grid_height, false);
+    _table->init (in_info.width, grid_width);
+    _grid_valid = false;
+
+    XCAM_ASSERT (!_splat_task.ptr () && !_slice_task.ptr ());
+    _splat_task = new XCamSoftTasks::TonemapSplatTask (new CbTonemapSplat (this));
+    _slice_task = new XCamSoftTasks::TonemapSliceTask (new CbTonemapSlice (this));
+    XCAM_ASSERT (_splat_task.ptr () && _slice_task.ptr ());
+    share_threads (_splat_task);
+    share_threads (_slice_task);
+
+    set_work_size (_splat_task, grid_height);
+    set_work_size (_slice_task, in_info.height / 2);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftTonemappingHandler::set_work_size (const SmartPtr<SoftWorker> &worker, uint32_t height)
+{
+    uint32_t thread_x = 1, thread_y = 4;
+
+    WorkSize global_size (1, height);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    worker->set_local_size (local_size);
+    worker->set_global_size (global_size);
+}
+
+XCamReturn
+SoftTonemappingHandler::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_splat_task.ptr () && _splat.ptr ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    SmartPtr<XCamSoftTasks::TonemapSplatTask::Args> args = new XCamSoftTasks::TonemapSplatTask::Args (param);
+    args->in_luma = new UcharImage (param->in_buf, 0);
+    args->grid = _splat;
+    args->table = _table;
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = _splat_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftTonemappingHandler(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+void
+SoftTonemappingHandler::splat_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _splat_task.ptr ());
+
+    SmartPtr<XCamSoftTasks::TonemapSplatTask::Args> args =
+        base.dynamic_cast_ptr<XCamSoftTasks::TonemapSplatTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    float strength, smooth;
+    {
+        SmartLock locker (_config_mutex);
+        strength = _strength;
+        smooth = _smooth;
+    }
+
+    // small grid, run in place
+    const float mean = XCamSoftTasks::tonemap_grid_update (*_splat.ptr (), smooth, !_grid_valid, *_base.ptr ());
+    _anchor = _grid_valid ? _anchor + (mean - _anchor) * smooth : mean;
+    _grid_valid = true;
+    XCamSoftTasks::tonemap_grid_gain (*_base.ptr (), _anchor, strength, TONEMAP_MAX_STOPS, *_gain.ptr ());
+
+    XCAM_LOG_DEBUG (
+        "SoftTonemappingHandler(%s) frame mean:%.3f, anchor:%.3f stops",
+        XCAM_STR (get_name ()), mean, _anchor);
+
+    SmartPtr<XCamSoftTasks::TonemapSliceTask::Args> next = new XCamSoftTasks::TonemapSliceTask::Args (param);
+    next->in_luma = args->in_luma;
+    next->in_uv = new Uchar2Image (param->in_buf, 1);
+    next->out_luma = new UcharImage (param->out_buf, 0);
+    next->out_uv = new Uchar2Image (param->out_buf, 1);
+    next->gain = _gain;
+    next->table = _table;
+
+    XCamReturn ret = _slice_task->work (next);
+    if (!xcam_ret_is_ok (ret)) {
+        work_broken (param, ret);
+    }
+}
+
+void
+SoftTonemappingHandler::slice_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _slice_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    work_well_done (param, error);
+}
+
+XCamReturn
+SoftTonemappingHandler::terminate ()
+{
+    if (_splat_task.ptr ()) {
+        _splat_task->stop ();
+        _splat_task.release ();
+    }
+    if (_slice_task.ptr ()) {
+        _slice_task->stop ();
+        _slice_task.release ();
+    }
+
+    return SoftHandler::terminate ();
+}
+
+SmartPtr<SoftHandler>
+create_soft_tonemapping_handler ()
+{
+    SmartPtr<SoftTonemappingHandler> tonemapping = new SoftTonemappingHandler ();
+    XCAM_ASSERT (tonemapping.ptr ());
+
+    return tonemapping;
+}
+
+}
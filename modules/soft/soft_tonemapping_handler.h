@@ -0,0 +1,95 @@
+/*
+ * soft_tonemapping_handler.h - soft local tone mapping handler class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_TONEMAPPING_HANDLER_H
+#define XCAM_SOFT_TONEMAPPING_HANDLER_H
+
+#include <xcam_std.h>
+#include <soft/soft_handler.h>
+
+namespace XCam {
+
+class SoftWorker;
+
+namespace XCamSoftTasks {
+struct TonemapGrid;
+struct TonemapSliceTable;
+};
+
+/* local tone mapping on NV12 with a bilateral grid of log2 luma.
+ * pass 1 splats sampled luma into grid cells, grid is blurred and blended
+ * with grid of former frames, then each node gets a gain compressing its
+ * local mean towards frame mean. pass 2 slices gains at every pixel and
+ * scales luma and chroma, so local details are kept.
+ * grid carries over frames, frames need be processed one after another.
+ */
+class SoftTonemappingHandler
+    : public SoftHandler
+{
+public:
+    explicit SoftTonemappingHandler (const char *name = "SoftTonemappingHandler");
+    ~SoftTonemappingHandler ();
+
+    // strength in [0, 1], 0 keeps image, 1 maps every local mean to frame mean
+    bool set_strength (float strength);
+    // weight of current frame in (0, 1], 1 disables temporal smoothing
+    bool set_temporal_smooth (float smooth);
+
+    XCamReturn tonemap (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+
+    void splat_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+    void slice_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    void set_work_size (const SmartPtr<SoftWorker> &worker, uint32_t height);
+
+    XCAM_DEAD_COPY (SoftTonemappingHandler);
+
+private:
+    SmartPtr<SoftWorker>                        _splat_task;
+    SmartPtr<SoftWorker>                        _slice_task;
+
+    SmartPtr<XCamSoftTasks::TonemapGrid>        _splat;
+    SmartPtr<XCamSoftTasks::TonemapGrid>        _base;
+    SmartPtr<XCamSoftTasks::TonemapGrid>        _gain;
+    SmartPtr<XCamSoftTasks::TonemapSliceTable>  _table;
+
+    Mutex                                       _config_mutex;
+    float                                       _strength;
+    float                                       _smooth;
+    float                                       _anchor;
+    bool                                        _grid_valid;
+};
+
+extern SmartPtr<SoftHandler> create_soft_tonemapping_handler ();
+
+}
+
+#endif //XCAM_SOFT_TONEMAPPING_HANDLER_H
@@ -0,0 +1,261 @@
+/*
+ * soft_tonemapping_tasks_priv.cpp - soft local tone mapping tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_tonemapping_tasks_priv.h"
+#include <math.h>
+
+#define TONEMAP_BIN_STOPS (-XCAM_SOFT_TONEMAP_LOG_MIN / XCAM_SOFT_TONEMAP_GRID_BINS)
+// samples count of bin center prior, keeps sparse nodes close to their own intensity
+#define TONEMAP_PRIOR_WEIGHT 1.0f
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+void
+TonemapGrid::init (uint32_t w, uint32_t h, bool has_weight)
+{
+    width = w;
+    height = h;
+    value.assign (w * h * XCAM_SOFT_TONEMAP_GRID_BINS, 0.0f);
+    if (has_weight)
+        weight.assign (w * h * XCAM_SOFT_TONEMAP_GRID_BINS, 0.0f);
+}
+
+static inline float
+get_grid_pos (uint32_t pos, uint32_t grid_size)
+{
+    const float grid_pos = (pos + 0.5f) / XCAM_SOFT_TONEMAP_GRID_CELL - 0.5f;
+    return XCAM_CLAMP (grid_pos, 0.0f, (float)(grid_size - 1));
+}
+
+void
+TonemapSliceTable::init (uint32_t width, uint32_t grid_width)
+{
+    x0.resize (width);
+    wx.resize (width);
+    for (uint32_t x = 0; x < width; ++x) {
+        const float fx = get_grid_pos (x, grid_width);
+        x0[x] = (uint32_t)fx;
+        wx[x] = fx - x0[x];
+    }
+
+    for (uint32_t i = 0; i < 256; ++i) {
+        log_luma[i] = log2f ((i + 1) / 256.0f);
+        const float pos = (log_luma[i] - XCAM_SOFT_TONEMAP_LOG_MIN) / TONEMAP_BIN_STOPS;
+        splat_bin[i] = (uint8_t)XCAM_CLAMP ((int32_t)pos, 0, XCAM_SOFT_TONEMAP_GRID_BINS - 1);
+
+        const float fb = XCAM_CLAMP (pos - 0.5f, 0.0f, (float)(XCAM_SOFT_TONEMAP_GRID_BINS - 1));
+        bin0[i] = (uint8_t)XCAM_MIN ((uint32_t)fb, XCAM_SOFT_TONEMAP_GRID_BINS - 2);
+        wbin[i] = fb - bin0[i];
+    }
+}
+
+XCamReturn
+TonemapSplatTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<TonemapSplatTask::Args> args = base.dynamic_cast_ptr<TonemapSplatTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    const UcharImage *in_luma = args->in_luma.ptr ();
+    TonemapGrid *grid = args->grid.ptr ();
+    const TonemapSliceTable *table = args->table.ptr ();
+    XCAM_ASSERT (in_luma && grid && table);
+
+    const uint32_t width = in_luma->get_width ();
+    const uint32_t height = in_luma->get_height ();
+    const uint32_t row_nodes = grid->width * XCAM_SOFT_TONEMAP_GRID_BINS;
+
+    for (uint32_t gy = range.pos[1]; gy < range.pos[1] + range.pos_len[1]; ++gy) {
+        float *value = &grid->value[gy * row_nodes];
+        float *weight = &grid->weight[gy * row_nodes];
+        std::fill (value, value + row_nodes, 0.0f);
+        std::fill (weight, weight + row_nodes, 0.0f);
+
+        const uint32_t y_end = XCAM_MIN ((gy + 1) * XCAM_SOFT_TONEMAP_GRID_CELL, height);
+        for (uint32_t y = gy * XCAM_SOFT_TONEMAP_GRID_CELL; y < y_end; y += XCAM_SOFT_TONEMAP_SPLAT_STEP) {
+            const uint8_t *luma = in_luma->get_buf_ptr (0, y);
+            for (uint32_t x0 = 0, gx = 0; x0 < width; x0 += XCAM_SOFT_TONEMAP_GRID_CELL, ++gx) {
+                float *cell_value = value + gx * XCAM_SOFT_TONEMAP_GRID_BINS;
+                float *cell_weight = weight + gx * XCAM_SOFT_TONEMAP_GRID_BINS;
+                const uint32_t x_end = XCAM_MIN (x0 + XCAM_SOFT_TONEMAP_GRID_CELL, width);
+                for (uint32_t x = x0; x < x_end; x += XCAM_SOFT_TONEMAP_SPLAT_STEP) {
+                    const uint8_t bin = table->splat_bin[luma[x]];
+                    cell_value[bin] += table->log_luma[luma[x]];
+                    cell_weight[bin] += 1.0f;
+                }
+            }
+        }
+    }
+
+    XCAM_LOG_DEBUG (
+        "TonemapSplatTask work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+/* gain nodes of luma line @y interpolated between grid rows into @line,
+ * last column repeated so x0 + 1 is always readable.
+ */
+static void
+interpolate_gain_line (const TonemapGrid &gain, uint32_t y, std::vector<float> &line)
+{
+    const uint32_t row_nodes = gain.width * XCAM_SOFT_TONEMAP_GRID_BINS;
+    const float fy = get_grid_pos (y, gain.height);
+    const uint32_t y0 = (uint32_t)fy;
+    const uint32_t y1 = XCAM_MIN (y0 + 1, gain.height - 1);
+    const float wy = fy - y0;
+
+    const float *row0 = gain.get_node (0, y0);
+    const float *row1 = gain.get_node (0, y1);
+    for (uint32_t i = 0; i < row_nodes; ++i)
+        line[i] = row0[i] + (row1[i] - row0[i]) * wy;
+    for (uint32_t i = 0; i < XCAM_SOFT_TONEMAP_GRID_BINS; ++i)
+        line[row_nodes + i] = line[row_nodes - XCAM_SOFT_TONEMAP_GRID_BINS + i];
+}
+
+XCamReturn
+TonemapSliceTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<TonemapSliceTask::Args> args = base.dynamic_cast_ptr<TonemapSliceTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    UcharImage *in_luma = args->in_luma.ptr (), *out_luma = args->out_luma.ptr ();
+    Uchar2Image *in_uv = args->in_uv.ptr (), *out_uv = args->out_uv.ptr ();
+    const TonemapGrid *gain = args->gain.ptr ();
+    const TonemapSliceTable *table = args->table.ptr ();
+    XCAM_ASSERT (in_luma && out_luma && in_uv && out_uv && gain && table);
+
+    const uint32_t width = in_luma->get_width ();
+    const uint32_t height = in_luma->get_height ();
+    const uint32_t uv_width = in_uv->get_width ();
+
+    std::vector<float> line ((gain->width + 1) * XCAM_SOFT_TONEMAP_GRID_BINS);
+    std::vector<float> uv_gain (uv_width);
+
+    for (uint32_t uv_y = range.pos[1]; uv_y < range.pos[1] + range.pos_len[1]; ++uv_y) {
+        const uint32_t y_end = XCAM_MIN (uv_y * 2 + 2, height);
+        for (uint32_t y = uv_y * 2; y < y_end; ++y) {
+            interpolate_gain_line (*gain, y, line);
+
+            const uint8_t *in = in_luma->get_buf_ptr (0, y);
+            uint8_t *out = out_luma->get_buf_ptr (0, y);
+            for (uint32_t x = 0; x < width; ++x) {
+                const uint8_t luma = in[x];
+                const float wb = table->wbin[luma];
+                const float *node = &line[table->x0[x] * XCAM_SOFT_TONEMAP_GRID_BINS + table->bin0[luma]];
+                const float g0 = node[0] + (node[1] - node[0]) * wb;
+                const float g1 =
+                    node[XCAM_SOFT_TONEMAP_GRID_BINS] +
+                    (node[XCAM_SOFT_TONEMAP_GRID_BINS + 1] - node[XCAM_SOFT_TONEMAP_GRID_BINS]) * wb;
+                const float g = g0 + (g1 - g0) * table->wx[x];
+
+                const float value = luma * g + 0.5f;
+                out[x] = (uint8_t)XCAM_MIN (value, 255.0f);
+                if (y == uv_y * 2 && !(x % 2))
+                    uv_gain[x / 2] = g;
+            }
+        }
+
+        const Uchar2 *in = in_uv->get_buf_ptr (0, uv_y);
+        Uchar2 *out = out_uv->get_buf_ptr (0, uv_y);
+        for (uint32_t x = 0; x < uv_width; ++x) {
+            const float u = (in[x].x - 128.0f) * uv_gain[x] + 128.5f;
+            const float v = (in[x].y - 128.0f) * uv_gain[x] + 128.5f;
+            out[x].x = (uint8_t)XCAM_CLAMP (u, 0.0f, 255.0f);
+            out[x].y = (uint8_t)XCAM_CLAMP (v, 0.0f, 255.0f);
+        }
+    }
+
+    XCAM_LOG_DEBUG (
+        "TonemapSliceTask work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+// [1 2 1] along axis of @size nodes @stride apart, edges repeated
+static void
+blur_axis (std::vector<float> &data, std::vector<float> &tmp, uint32_t size, uint32_t stride)
+{
+    const uint32_t outer = data.size () / (size * stride);
+    for (uint32_t o = 0; o < outer; ++o) {
+        const float *src = &data[o * size * stride];
+        float *dst = &tmp[o * size * stride];
+        for (uint32_t p = 0; p < size; ++p) {
+            const float *prev = src + (p ? p - 1 : p) * stride;
+            const float *cur = src + p * stride;
+            const float *next = src + (p + 1 < size ? p + 1 : p) * stride;
+            for (uint32_t i = 0; i < stride; ++i)
+                dst[p * stride + i] = (prev[i] + cur[i] * 2.0f + next[i]) * 0.25f;
+        }
+    }
+    data.swap (tmp);
+}
+
+static void
+blur_grid (std::vector<float> &data, uint32_t width, uint32_t height, std::vector<float> &tmp)
+{
+    blur_axis (data, tmp, XCAM_SOFT_TONEMAP_GRID_BINS, 1);
+    blur_axis (data, tmp, width, XCAM_SOFT_TONEMAP_GRID_BINS);
+    blur_axis (data, tmp, height, width * XCAM_SOFT_TONEMAP_GRID_BINS);
+}
+
+float
+tonemap_grid_update (TonemapGrid &splat, float smooth, bool reset, TonemapGrid &base)
+{
+    XCAM_ASSERT (splat.width == base.width && splat.height == base.height);
+    const uint32_t count = splat.value.size ();
+
+    double sum = 0.0, samples = 0.0;
+    for (uint32_t i = 0; i < count; ++i) {
+        sum += splat.value[i];
+        samples += splat.weight[i];
+    }
+
+    std::vector<float> tmp (count);
+    blur_grid (splat.value, splat.width, splat.height, tmp);
+    blur_grid (splat.weight, splat.width, splat.height, tmp);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t bin = i % XCAM_SOFT_TONEMAP_GRID_BINS;
+        const float center = XCAM_SOFT_TONEMAP_LOG_MIN + (bin + 0.5f) * TONEMAP_BIN_STOPS;
+        const float mean =
+            (splat.value[i] + center * TONEMAP_PRIOR_WEIGHT) / (splat.weight[i] + TONEMAP_PRIOR_WEIGHT);
+        base.value[i] = reset ? mean : base.value[i] + (mean - base.value[i]) * smooth;
+    }
+
+    return samples > 0.0 ? (float)(sum / samples) : XCAM_SOFT_TONEMAP_LOG_MIN / 2.0f;
+}
+
+void
+tonemap_grid_gain (
+    const TonemapGrid &base, float anchor, float strength, float max_stops, TonemapGrid &gain)
+{
+    XCAM_ASSERT (base.width == gain.width && base.height == gain.height);
+
+    for (uint32_t i = 0; i < base.value.size (); ++i) {
+        const float stops = (anchor - base.value[i]) * strength;
+        gain.value[i] = exp2f (XCAM_CLAMP (stops, -max_stops, max_stops));
+    }
+}
+
+}
+
+}
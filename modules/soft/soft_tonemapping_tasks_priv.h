@@ -0,0 +1,149 @@
+/*
+ * soft_tonemapping_tasks_priv.h - soft local tone mapping tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_TONEMAPPING_TASKS_PRIV_H
+#define XCAM_SOFT_TONEMAPPING_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_handler.h>
+#include <vector>
+
+// luma pixels of one grid cell side
+#define XCAM_SOFT_TONEMAP_GRID_CELL 32
+// intensity bins over log2 luma in [-8, 0], half a stop each
+#define XCAM_SOFT_TONEMAP_GRID_BINS 16
+#define XCAM_SOFT_TONEMAP_LOG_MIN (-8.0f)
+// one of step luma pixels in both directions goes into grid
+#define XCAM_SOFT_TONEMAP_SPLAT_STEP 2
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+/* bilateral grid over luma, node (x, y, b) sits at the center of cell (x, y)
+ * and bin b, nodes of one cell are contiguous.
+ * splat fills value with sums of log2 luma and weight with counts,
+ * later grids keep value only.
+ */
+struct TonemapGrid {
+    uint32_t                width;
+    uint32_t                height;
+    std::vector<float>      value;
+    std::vector<float>      weight;
+
+    TonemapGrid () : width (0), height (0) {}
+    void init (uint32_t w, uint32_t h, bool has_weight);
+    float *get_node (uint32_t x, uint32_t y) {
+        return &value[(y * width + x) * XCAM_SOFT_TONEMAP_GRID_BINS];
+    }
+    const float *get_node (uint32_t x, uint32_t y) const {
+        return &value[(y * width + x) * XCAM_SOFT_TONEMAP_GRID_BINS];
+    }
+};
+
+// per-column and per-luma-value slice positions, fixed on configure
+struct TonemapSliceTable {
+    std::vector<uint32_t>   x0;
+    std::vector<float>      wx;
+    uint8_t                 splat_bin[256];
+    uint8_t                 bin0[256];
+    float                   wbin[256];
+    float                   log_luma[256];
+
+    void init (uint32_t width, uint32_t grid_width);
+};
+
+/* pass 1, one work item is one grid row.
+ * sums log2 luma of sampled pixels into nearest node of its cell, no blending
+ * between rows so work items never share nodes.
+ */
+class TonemapSplatTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>            in_luma;
+        SmartPtr<TonemapGrid>           grid;
+        SmartPtr<TonemapSliceTable>     table;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {}
+    };
+
+public:
+    explicit TonemapSplatTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("TonemapSplatTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+/* pass 2, one work item is one uv line and its two luma lines.
+ * interpolates gain grid trilinearly at each luma pixel, scales luma by it
+ * and chroma around 128 by gain of the top-left luma pixel.
+ */
+class TonemapSliceTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>            in_luma, out_luma;
+        SmartPtr<Uchar2Image>           in_uv, out_uv;
+        SmartPtr<TonemapGrid>           gain;
+        SmartPtr<TonemapSliceTable>     table;
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+        {}
+    };
+
+public:
+    explicit TonemapSliceTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("TonemapSliceTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+/* blurs splat grid by [1 2 1] in three directions and normalizes it into
+ * local mean of log2 luma, blended into @base by @smooth unless @reset.
+ * nodes without samples take log2 luma of bin center.
+ * returns mean log2 luma of all samples.
+ */
+float tonemap_grid_update (TonemapGrid &splat, float smooth, bool reset, TonemapGrid &base);
+
+/* gain at each node compresses its local mean towards @anchor by @strength,
+ * limited to @max_stops in both directions.
+ */
+void tonemap_grid_gain (
+    const TonemapGrid &base, float anchor, float strength, float max_stops, TonemapGrid &gain);
+
+}
+
+}
+
+#endif //XCAM_SOFT_TONEMAPPING_TASKS_PRIV_H
@@ -0,0 +1,335 @@
+/*
+ * soft_video_stabilizer.cpp - soft video stabilizer class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_video_stabilizer.h"
+
+namespace XCam {
+
+SoftVideoStabilizer::SoftVideoStabilizer (const char *name)
+    : SoftGeoMapper (name)
+    , _world_to_device (AXIS_X, AXIS_MINUS_Z, AXIS_NONE)
+    , _device_to_image (AXIS_X, AXIS_Y, AXIS_Y)
+    , _input_frame_id (-1)
+    , _filter_radius (15)
+    , _lut_width (0)
+    , _lut_height (0)
+{
+    _projector = new ImageProjector ();
+    _motion_filter = new MotionFilter (_filter_radius, 10);
+}
+
+SoftVideoStabilizer::~SoftVideoStabilizer ()
+{
+    _frames.clear ();
+}
+
+void
+SoftVideoStabilizer::reset_counter ()
+{
+    XCAM_LOG_DEBUG ("SoftVideoStabilizer(%s) reset counter", XCAM_STR (get_name ()));
+
+    _input_frame_id = -1;
+    _frames.clear ();
+    _motions.clear ();
+}
+
+XCamReturn
+SoftVideoStabilizer::set_sensor_calibration (CalibrationParams &params)
+{
+    _calib_params = params;
+    return _projector->set_sensor_calibration (params);
+}
+
+XCamReturn
+SoftVideoStabilizer::set_camera_intrinsics (
+    double focal_x,
+    double focal_y,
+    double offset_x,
+    double offset_y,
+    double skew)
+{
+    _calib_params.focal_x = focal_x;
+    _calib_params.focal_y = focal_y;
+    _calib_params.offset_x = offset_x;
+    _calib_params.offset_y = offset_y;
+    _calib_params.skew = skew;
+    return _projector->set_camera_intrinsics (focal_x, focal_y, offset_x, offset_y, skew);
+}
+
+XCamReturn
+SoftVideoStabilizer::align_coordinate_system (
+    CoordinateSystemConv &world_to_device,
+    CoordinateSystemConv &device_to_image)
+{
+    _world_to_device = world_to_device;
+    _device_to_image = device_to_image;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftVideoStabilizer::set_motion_filter (uint32_t radius, float stdev)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, _input_frame_id < 0, XCAM_RETURN_ERROR_PARAM,
+        "SoftVideoStabilizer(%s) motion filter can NOT be changed while running, reset counter first",
+        XCAM_STR (get_name ()));
+
+    _filter_radius = radius;
+    _motion_filter->set_filters (radius, stdev);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftVideoStabilizer::stabilize (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out_buf)
+{
+    bool out_given = out_buf.ptr ();
+    XCamReturn ret = remap (in, out_buf);
+
+    // remap takes the pool buffer of a bypassed frame as output, nothing was written into it
+    if (ret == XCAM_RETURN_BYPASS && !out_given)
+        out_buf.release ();
+
+    return ret;
+}
+
+XCamReturn
+SoftVideoStabilizer::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+
+    uint32_t width, height;
+    get_output_size (width, height);
+    if (!width || !height) {
+        width = in_info.width;
+        height = in_info.height;
+        set_output_size (width, height);
+    }
+
+    _lut_width = XCAM_ALIGN_UP (width - 1, XCAM_SOFT_VIDEO_STAB_LUT_STEP) / XCAM_SOFT_VIDEO_STAB_LUT_STEP + 1;
+    _lut_height = XCAM_ALIGN_UP (height - 1, XCAM_SOFT_VIDEO_STAB_LUT_STEP) / XCAM_SOFT_VIDEO_STAB_LUT_STEP + 1;
+
+    // identity table allocated once, rewritten in place by each frame before remapping
+    std::vector<PointFloat2> lut_data (_lut_width * _lut_height);
+    float step_x = (in_info.width - 1.0f) / (_lut_width - 1.0f);
+    float step_y = (in_info.height - 1.0f) / (_lut_height - 1.0f);
+    for (uint32_t y = 0; y < _lut_height; ++y) {
+        for (uint32_t x = 0; x < _lut_width; ++x) {
+            lut_data[y * _lut_width + x] = PointFloat2 (x * step_x, y * step_y);
+        }
+    }
+    XCAM_FAIL_RETURN (
+        ERROR, set_lookup_table (&lut_data[0], _lut_width, _lut_height), XCAM_RETURN_ERROR_PARAM,
+        "SoftVideoStabilizer(%s) init lookup table failed", XCAM_STR (get_name ()));
+
+    return SoftGeoMapper::configure_resource (param);
+}
+
+Mat3d
+SoftVideoStabilizer::calc_extrinsics (int64_t ts, DevicePoseList &poses)
+{
+    Mat3d ext = _projector->calc_camera_extrinsics (ts, poses);
+    return _projector->align_coordinate_system (_world_to_device, ext, _device_to_image);
+}
+
+Mat3d
+SoftVideoStabilizer::analyze_motion (StabFrame &frame0, StabFrame &frame1)
+{
+    if (frame0.poses.empty () || frame1.poses.empty ())
+        return Mat3d ();
+    XCAM_ASSERT (frame0.timestamp < frame1.timestamp);
+
+    Mat3d extrinsic0 = calc_extrinsics (frame0.timestamp, frame0.poses);
+    Mat3d extrinsic1 = calc_extrinsics (frame1.timestamp, frame1.poses);
+
+    return _projector->calc_projective (extrinsic0, extrinsic1);
+}
+
+void
+SoftVideoStabilizer::calc_rolling_shutter (StabFrame &frame, std::vector<Mat3d> &row_mats)
+{
+    row_mats.clear ();
+    if (XCAM_DOUBLE_EQUAL_AROUND (_calib_params.readout_time, 0.0) || frame.poses.empty ())
+        return;
+
+    // frame timestamp is the first row, sampled rows are evenly spread over readout time,
+    // each row maps the frame-time image onto its own capture time
+    Mat3d ref = calc_extrinsics (frame.timestamp, frame.poses);
+    row_mats.resize (_lut_height);
+    for (uint32_t i = 0; i < _lut_height; ++i) {
+        int64_t row_ts = frame.timestamp + (int64_t)(_calib_params.readout_time * i / (_lut_height - 1.0));
+        Mat3d row_ext = calc_extrinsics (row_ts, frame.poses);
+        row_mats[i] = _projector->calc_projective (row_ext, ref);
+    }
+}
+
+static inline void
+project_point (const Mat3d &mat, double x, double y, double &out_x, double &out_y)
+{
+    double px = mat (0, 0) * x + mat (0, 1) * y + mat (0, 2);
+    double py = mat (1, 0) * x + mat (1, 1) * y + mat (1, 2);
+    double pz = mat (2, 0) * x + mat (2, 1) * y + mat (2, 2);
+    if (!XCAM_DOUBLE_EQUAL_AROUND (pz, 0.0)) {
+        px /= pz;
+        py /= pz;
+    }
+    out_x = px;
+    out_y = py;
+}
+
+bool
+SoftVideoStabilizer::update_lookup_table (const Mat3d &proj_inv, StabFrame &frame)
+{
+    const VideoBufferInfo &in_info = frame.buf->get_video_info ();
+    const double max_x = in_info.width - 1.0;
+    const double max_y = in_info.height - 1.0;
+
+    uint32_t out_width, out_height;
+    get_output_size (out_width, out_height);
+    const double step_x = (out_width - 1.0) / (_lut_width - 1.0);
+    const double step_y = (out_height - 1.0) / (_lut_height - 1.0);
+
+    std::vector<Mat3d> row_mats;
+    calc_rolling_shutter (frame, row_mats);
+    const double row_step = max_y / (_lut_height - 1.0);
+
+    SmartPtr<Float2Image> &table = get_lookup_table ();
+    XCAM_FAIL_RETURN (
+        ERROR,
+        table.ptr () && table->get_width () == _lut_width && table->get_height () == _lut_height,
+        false,
+        "SoftVideoStabilizer(%s) lookup table was not configured", XCAM_STR (get_name ()));
+
+    for (uint32_t y = 0; y < _lut_height; ++y) {
+        Float2 *line = table->get_buf_ptr (0, y);
+        for (uint32_t x = 0; x < _lut_width; ++x) {
+            double pos_x, pos_y;
+            project_point (proj_inv, x * step_x, y * step_y, pos_x, pos_y);
+
+            if (!row_mats.empty ()) {
+                double row = XCAM_CLAMP (pos_y, 0.0, max_y) / row_step;
+                uint32_t idx = XCAM_MIN ((uint32_t)row, _lut_height - 2);
+                double weight = row - idx;
+                Mat3d row_mat = row_mats[idx] * (1.0 - weight) + row_mats[idx + 1] * weight;
+                project_point (row_mat, pos_x, pos_y, pos_x, pos_y);
+            }
+
+            // clamp to edge as CLVideoStabilizer does
+            line[x] = Float2 (XCAM_CLAMP (pos_x, 0.0, max_x), XCAM_CLAMP (pos_y, 0.0, max_y));
+        }
+    }
+
+    return true;
+}
+
+XCamReturn
+SoftVideoStabilizer::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    StabFrame frame;
+    frame.buf = param->in_buf;
+    frame.timestamp = param->in_buf->get_timestamp ();
+    SmartPtr<DevicePose> pose = frame.buf->find_typed_metadata<DevicePose> ();
+    while (pose.ptr ()) {
+        frame.poses.push_back (pose);
+        frame.buf->remove_metadata (pose);
+        pose = frame.buf->find_typed_metadata<DevicePose> ();
+    }
+
+    ++_input_frame_id;
+    if (!_frames.empty ()) {
+        if (_motions.size () >= 2 * _filter_radius + 1)
+            _motions.pop_front ();
+        _motions.push_back (analyze_motion (_frames.back (), frame));
+    }
+    _frames.push_back (frame);
+
+    // not enough frames to smooth the oldest one yet
+    if (_frames.size () <= _filter_radius) {
+        param->in_buf.release ();
+        work_well_done (param, XCAM_RETURN_BYPASS);
+        return XCAM_RETURN_NO_ERROR;
+    }
+
+    int64_t stab_frame_id = _input_frame_id - _filter_radius;
+    int32_t stab_pos = (int32_t) XCAM_MIN (stab_frame_id, (int64_t) _filter_radius + 1);
+    XCAM_LOG_DEBUG (
+        "SoftVideoStabilizer(%s) input id(%" PRId64 "), stab id(%" PRId64 "), stab pos(%d), filter r(%d)",
+        XCAM_STR (get_name ()), _input_frame_id, stab_frame_id, stab_pos, _filter_radius);
+
+    Mat3d proj_mat = _motion_filter->stabilize (stab_pos, _motions, (int32_t) _input_frame_id);
+
+    StabFrame &stab_frame = _frames.front ();
+    XCAM_FAIL_RETURN (
+        ERROR, update_lookup_table (proj_mat.inverse (), stab_frame), XCAM_RETURN_ERROR_PARAM,
+        "SoftVideoStabilizer(%s) update lookup table failed", XCAM_STR (get_name ()));
+
+    param->in_buf = stab_frame.buf;
+    param->out_buf->set_timestamp (stab_frame.timestamp);
+    _frames.pop_front ();
+
+    XCamReturn ret = start_remap_task (param);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftVideoStabilizer(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+XCamReturn
+SoftVideoStabilizer::execute_buffer (const SmartPtr<Parameters> &param, bool sync)
+{
+    XCAM_UNUSED (sync);
+    return SoftGeoMapper::execute_buffer (param, true);
+}
+
+XCamReturn
+SoftVideoStabilizer::execute_buffers (const ParametersList &params, bool sync)
+{
+    XCAM_UNUSED (sync);
+
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    for (ParametersList::const_iterator i = params.begin (); i != params.end (); ++i) {
+        ret = execute_buffer (*i, true);
+        XCAM_FAIL_RETURN (
+            ERROR, xcam_ret_is_ok (ret), ret,
+            "SoftVideoStabilizer(%s) execute buffers failed", XCAM_STR (get_name ()));
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftVideoStabilizer::terminate ()
+{
+    reset_counter ();
+    return SoftGeoMapper::terminate ();
+}
+
+SmartPtr<SoftHandler>
+create_soft_video_stabilizer ()
+{
+    SmartPtr<SoftHandler> stabilizer = new SoftVideoStabilizer ();
+    XCAM_ASSERT (stabilizer.ptr ());
+
+    return stabilizer;
+}
+
+}
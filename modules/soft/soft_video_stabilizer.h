@@ -0,0 +1,114 @@
+/*
+ * soft_video_stabilizer.h - soft video stabilizer class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_VIDEO_STABILIZER_H
+#define XCAM_SOFT_VIDEO_STABILIZER_H
+
+#include <xcam_std.h>
+#include <meta_data.h>
+#include <vec_mat.h>
+#include <image_projector.h>
+#include <motion_filter.h>
+#include <soft/soft_geo_mapper.h>
+#include <list>
+
+#define XCAM_SOFT_VIDEO_STAB_LUT_STEP 16
+
+namespace XCam {
+
+/* gyro based video stabilization on CPU, NV12 only.
+ * per-frame homographies come from ImageProjector and MotionFilter like CLVideoStabilizer,
+ * they are sampled into the geomap lookup table every XCAM_SOFT_VIDEO_STAB_LUT_STEP pixels,
+ * rows are corrected for rolling shutter when CalibrationParams::readout_time is set.
+ * output is delayed by filter radius frames, device poses are read from DevicePose metadata.
+ */
+class SoftVideoStabilizer
+    : public SoftGeoMapper
+{
+    struct StabFrame {
+        SmartPtr<VideoBuffer>   buf;
+        int64_t                 timestamp;
+        DevicePoseList          poses;
+    };
+    typedef std::list<StabFrame> StabFrameList;
+
+public:
+    explicit SoftVideoStabilizer (const char *name = "SoftVideoStabilizer");
+    ~SoftVideoStabilizer ();
+
+    void reset_counter ();
+
+    XCamReturn set_sensor_calibration (CalibrationParams &params);
+    XCamReturn set_camera_intrinsics (
+        double focal_x,
+        double focal_y,
+        double offset_x,
+        double offset_y,
+        double skew);
+    XCamReturn align_coordinate_system (
+        CoordinateSystemConv &world_to_device,
+        CoordinateSystemConv &device_to_image);
+
+    XCamReturn set_motion_filter (uint32_t radius, float stdev);
+    uint32_t filter_radius () const {
+        return _filter_radius;
+    }
+
+    // return XCAM_RETURN_BYPASS until filter radius frames collected, @out_buf is left NULL
+    // then, or untouched if it was given by caller
+    XCamReturn stabilize (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out_buf);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+    // lookup table is rewritten in place for each frame, frames always run one by one in sync
+    virtual XCamReturn execute_buffer (const SmartPtr<Parameters> &param, bool sync);
+    virtual XCamReturn execute_buffers (const ParametersList &params, bool sync);
+
+protected:
+    //derived from SoftGeoMapper
+    XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    Mat3d calc_extrinsics (int64_t ts, DevicePoseList &poses);
+    Mat3d analyze_motion (StabFrame &frame0, StabFrame &frame1);
+    void calc_rolling_shutter (StabFrame &frame, std::vector<Mat3d> &row_mats);
+    bool update_lookup_table (const Mat3d &proj_inv, StabFrame &frame);
+
+    XCAM_DEAD_COPY (SoftVideoStabilizer);
+
+private:
+    CalibrationParams           _calib_params;
+    SmartPtr<ImageProjector>    _projector;
+    SmartPtr<MotionFilter>      _motion_filter;
+    CoordinateSystemConv        _world_to_device;
+    CoordinateSystemConv        _device_to_image;
+    int64_t                     _input_frame_id;
+    uint32_t                    _filter_radius;
+    StabFrameList               _frames;
+    std::list<Mat3d>            _motions; //motions[i] calculated from frame i to i+1
+    uint32_t                    _lut_width, _lut_height;
+};
+
+extern SmartPtr<SoftHandler> create_soft_video_stabilizer ();
+
+}
+
+#endif //XCAM_SOFT_VIDEO_STABILIZER_H
@@ -0,0 +1,234 @@
+/*
+ * soft_wavelet_denoise_handler.cpp - soft wavelet denoise handler class implementation
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_wavelet_denoise_handler.h"
+#include "soft_wavelet_denoise_tasks_priv.h"
+
+// one of sample step 2x2 block lines estimates noise for BayesShrink
+#define WAVELET_NOISE_SAMPLE_STEP 4
+
+namespace XCam {
+
+// per level thresholds in normalized pixel, same as kernel_wavelet_haar_reconstruction
+static const float y_threshold_const[XCAM_SOFT_WAVELET_MAX_LEVELS] = {0.06129f, 0.027319f, 0.012643f, 0.006513f};
+static const float uv_threshold_const[XCAM_SOFT_WAVELET_MAX_LEVELS] = {0.1659f, 0.06719f, 0.03343f, 0.01713f};
+
+DECLARE_WORK_CALLBACK (CbWaveletDenoiseTask, SoftWaveletDenoiseHandler, denoise_task_done);
+
+SoftWaveletDenoiseHandler::SoftWaveletDenoiseHandler (SoftWaveletBasis basis, const char *name)
+    : SoftHandler (name)
+    , _basis (basis)
+    , _channel (XCAM_SOFT_WAVELET_CHANNEL_Y | XCAM_SOFT_WAVELET_CHANNEL_UV)
+    , _bayes_shrink (false)
+{
+    // same as CLNewWaveletDenoiseImageHandler
+    xcam_mem_clear (_config);
+    _config.decomposition_levels = XCAM_SOFT_WAVELET_MAX_LEVELS;
+    _config.threshold[0] = 0.5;
+    _config.threshold[1] = 5.0;
+}
+
+SoftWaveletDenoiseHandler::~SoftWaveletDenoiseHandler ()
+{
+}
+
+bool
+SoftWaveletDenoiseHandler::set_channel (uint32_t channel)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, !(channel & ~(XCAM_SOFT_WAVELET_CHANNEL_Y | XCAM_SOFT_WAVELET_CHANNEL_UV)), false,
+        "SoftWaveletDenoiseHandler(%s) unknown channel(%d)", XCAM_STR (get_name ()), channel);
+
+    _channel = channel;
+    return true;
+}
+
+void
+SoftWaveletDenoiseHandler::set_bayes_shrink (bool enable)
+{
+    _bayes_shrink = enable;
+}
+
+bool
+SoftWaveletDenoiseHandler::set_denoise_config (const XCam3aResultWaveletNoiseReduction &config)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, config.threshold[0] >= 0.0 && config.threshold[0] <= 1.0 && config.threshold[1] >= 0.0, false,
+        "SoftWaveletDenoiseHandler(%s) invalid config, soft:%.3f, hard:%.3f",
+        XCAM_STR (get_name ()), config.threshold[0], config.threshold[1]);
+
+    SmartLock locker (_config_mutex);
+    _config = config;
+
+    XCAM_LOG_DEBUG (
+        "SoftWaveletDenoiseHandler(%s) set config, soft:%.3f, hard:%.3f",
+        XCAM_STR (get_name ()), config.threshold[0], config.threshold[1]);
+
+    return true;
+}
+
+XCamReturn
+SoftWaveletDenoiseHandler::denoise (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in, out);
+    XCamReturn ret = execute_buffer (param, true);
+    if (xcam_ret_is_ok (ret)) {
+        out = param->out_buf;
+        XCAM_ASSERT (out.ptr ());
+    }
+
+    return ret;
+}
+
+XCamReturn
+SoftWaveletDenoiseHandler::configure_resource (const SmartPtr<Parameters> &param)
+{
+    const VideoBufferInfo &in_info = param->in_buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        ERROR, in_info.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftWaveletDenoiseHandler(%s) only support format(NV12) but input format is %s",
+        XCAM_STR (get_name ()), xcam_fourcc_to_string (in_info.format));
+
+    set_out_video_info (in_info);
+
+    XCAM_ASSERT (!_denoise_task.ptr ());
+    _denoise_task = new XCamSoftTasks::WaveletDenoiseTask (new CbWaveletDenoiseTask (this));
+    XCAM_ASSERT (_denoise_task.ptr ());
+    share_threads (_denoise_task);
+
+    set_work_size (in_info.width, in_info.height);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftWaveletDenoiseHandler::set_work_size (uint32_t width, uint32_t height)
+{
+    uint32_t thread_x = 1, thread_y = 4;
+
+    WorkSize global_size (
+        xcam_ceil (width, XCAM_SOFT_WAVELET_TILE_SIZE) / XCAM_SOFT_WAVELET_TILE_SIZE,
+        xcam_ceil (height, XCAM_SOFT_WAVELET_TILE_SIZE) / XCAM_SOFT_WAVELET_TILE_SIZE);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], thread_x) / thread_x,
+        xcam_ceil (global_size.value[1], thread_y) / thread_y);
+
+    _denoise_task->set_local_size (local_size);
+    _denoise_task->set_global_size (global_size);
+}
+
+XCamReturn
+SoftWaveletDenoiseHandler::start_work (const SmartPtr<Parameters> &param)
+{
+    XCAM_ASSERT (_denoise_task.ptr ());
+    XCAM_ASSERT (param->in_buf.ptr () && param->out_buf.ptr ());
+
+    XCam3aResultWaveletNoiseReduction config;
+    {
+        SmartLock locker (_config_mutex);
+        config = _config;
+    }
+
+    SmartPtr<XCamSoftTasks::WaveletDenoiseTask::Args> args = new XCamSoftTasks::WaveletDenoiseTask::Args (param);
+    args->in_luma = new UcharImage (param->in_buf, 0);
+    args->in_uv = new Uchar2Image (param->in_buf, 1);
+    args->out_luma = new UcharImage (param->out_buf, 0);
+    args->out_uv = new Uchar2Image (param->out_buf, 1);
+    args->basis = _basis;
+    // decomposition levels of config is not used, same as CL handlers
+    args->levels = XCAM_SOFT_WAVELET_MAX_LEVELS;
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        XCamSoftTasks::WaveletPlaneParam &plane = args->planes[i];
+        const float *level_const = i ? uv_threshold_const : y_threshold_const;
+        plane.enable = _channel & (i ? XCAM_SOFT_WAVELET_CHANNEL_UV : XCAM_SOFT_WAVELET_CHANNEL_Y);
+        plane.bayes_shrink = _bayes_shrink;
+        plane.soft_ratio = (float)config.threshold[0];
+        for (uint32_t level = 0; level < XCAM_SOFT_WAVELET_MAX_LEVELS; ++level)
+            plane.threshold[level] = (float)config.threshold[1] * level_const[level] * 255.0f;
+    }
+
+    if (_bayes_shrink) {
+        if (args->planes[0].enable)
+            args->planes[0].noise_sigma =
+                XCamSoftTasks::wavelet_estimate_luma_noise (*args->in_luma.ptr (), WAVELET_NOISE_SAMPLE_STEP);
+        if (args->planes[1].enable) {
+            args->planes[1].noise_sigma =
+                XCamSoftTasks::wavelet_estimate_uv_noise (*args->in_uv.ptr (), 0, WAVELET_NOISE_SAMPLE_STEP);
+            args->planes[2].noise_sigma =
+                XCamSoftTasks::wavelet_estimate_uv_noise (*args->in_uv.ptr (), 1, WAVELET_NOISE_SAMPLE_STEP);
+        }
+        XCAM_LOG_DEBUG (
+            "SoftWaveletDenoiseHandler(%s) noise sigma y:%.2f, u:%.2f, v:%.2f", XCAM_STR (get_name ()),
+            args->planes[0].noise_sigma, args->planes[1].noise_sigma, args->planes[2].noise_sigma);
+    }
+
+    param->out_buf->set_timestamp (param->in_buf->get_timestamp ());
+
+    XCamReturn ret = _denoise_task->work (args);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftWaveletDenoiseHandler(%s) start_work failed", XCAM_STR (get_name ()));
+
+    return ret;
+}
+
+XCamReturn
+SoftWaveletDenoiseHandler::terminate ()
+{
+    if (_denoise_task.ptr ()) {
+        _denoise_task->stop ();
+        _denoise_task.release ();
+    }
+
+    return SoftHandler::terminate ();
+}
+
+void
+SoftWaveletDenoiseHandler::denoise_task_done (
+    const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &base, const XCamReturn error)
+{
+    XCAM_UNUSED (worker);
+    XCAM_ASSERT (worker.ptr () == _denoise_task.ptr ());
+
+    SmartPtr<SoftArgs> args = base.dynamic_cast_ptr<SoftArgs> ();
+    XCAM_ASSERT (args.ptr ());
+
+    const SmartPtr<ImageHandler::Parameters> param = args->get_param ();
+    if (!check_work_continue (param, error))
+        return;
+
+    work_well_done (param, error);
+}
+
+SmartPtr<SoftHandler>
+create_soft_wavelet_denoise_handler (SoftWaveletBasis basis, uint32_t channel, bool bayes_shrink)
+{
+    SmartPtr<SoftWaveletDenoiseHandler> wavelet = new SoftWaveletDenoiseHandler (basis);
+    XCAM_ASSERT (wavelet.ptr ());
+    XCAM_FAIL_RETURN (
+        ERROR, wavelet->set_channel (channel), NULL,
+        "create soft wavelet denoise handler failed with channel(%d)", channel);
+    wavelet->set_bayes_shrink (bayes_shrink);
+
+    return wavelet;
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+ * soft_wavelet_denoise_handler.h - soft wavelet denoise handler class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_WAVELET_DENOISE_HANDLER_H
+#define XCAM_SOFT_WAVELET_DENOISE_HANDLER_H
+
+#include <xcam_std.h>
+#include <base/xcam_3a_result.h>
+#include <soft/soft_handler.h>
+
+// channel bits, same as CL_IMAGE_CHANNEL_Y and CL_IMAGE_CHANNEL_UV
+#define XCAM_SOFT_WAVELET_CHANNEL_Y 1
+#define XCAM_SOFT_WAVELET_CHANNEL_UV 2
+
+#define XCAM_SOFT_WAVELET_MAX_LEVELS 4
+
+namespace XCam {
+
+class SoftWorker;
+
+enum SoftWaveletBasis {
+    SoftWaveletHaar = 0,
+    // CDF 5/3, synthesis scaling function is the hat function
+    SoftWaveletCdf53,
+};
+
+/* wavelet denoise on NV12 with in-place lifting on tiles.
+ * each work item loads one tile (plus halo for CDF 5/3) of luma and uv into
+ * cache-sized float blocks, decomposes, thresholds and reconstructs there, and
+ * writes the tile back, no full frame coefficient images.
+ * thresholds follow kernel_wavelet_haar_reconstruction, or BayesShrink per tile
+ * subband with noise estimated from finest HH coefficients of sampled lines.
+ */
+class SoftWaveletDenoiseHandler
+    : public SoftHandler
+{
+public:
+    explicit SoftWaveletDenoiseHandler (
+        SoftWaveletBasis basis = SoftWaveletHaar, const char *name = "SoftWaveletDenoiseHandler");
+    ~SoftWaveletDenoiseHandler ();
+
+    // XCAM_SOFT_WAVELET_CHANNEL_Y and/or XCAM_SOFT_WAVELET_CHANNEL_UV
+    bool set_channel (uint32_t channel);
+    void set_bayes_shrink (bool enable);
+    // threshold[0] soft ratio, threshold[1] hard threshold, thread safe
+    bool set_denoise_config (const XCam3aResultWaveletNoiseReduction &config);
+
+    XCamReturn denoise (const SmartPtr<VideoBuffer> &in, SmartPtr<VideoBuffer> &out);
+
+    //derived from SoftHandler
+    virtual XCamReturn terminate ();
+
+    void denoise_task_done (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error);
+
+protected:
+    //derived from SoftHandler
+    virtual XCamReturn configure_resource (const SmartPtr<Parameters> &param);
+    virtual XCamReturn start_work (const SmartPtr<Parameters> &param);
+
+private:
+    void set_work_size (uint32_t width, uint32_t height);
+
+    XCAM_DEAD_COPY (SoftWaveletDenoiseHandler);
+
+private:
+    SmartPtr<SoftWorker>                _denoise_task;
+    SoftWaveletBasis                    _basis;
+    uint32_t                            _channel;
+    bool                                _bayes_shrink;
+
+    Mutex                               _config_mutex;
+    XCam3aResultWaveletNoiseReduction   _config;
+};
+
+extern SmartPtr<SoftHandler>
+create_soft_wavelet_denoise_handler (SoftWaveletBasis basis, uint32_t channel, bool bayes_shrink);
+
+}
+
+#endif //XCAM_SOFT_WAVELET_DENOISE_HANDLER_H
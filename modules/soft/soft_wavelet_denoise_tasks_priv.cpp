@@ -0,0 +1,459 @@
+/*
+ * soft_wavelet_denoise_tasks_priv.cpp - soft wavelet denoise tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_wavelet_denoise_tasks_priv.h"
+#include <math.h>
+#include <vector>
+
+// median absolute deviation over noise std
+#define WAVELET_MAD_SCALE 0.6745f
+// |a - b - c + d| of 2x2 block, 4 times of hh coefficient
+#define WAVELET_NOISE_HIST_SIZE 512
+// subband signal std below it is taken as pure noise
+#define WAVELET_MIN_SIGNAL 0.001f
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+/* in-place lifting along one direction.
+ * @count samples are @sample_stride apart, each sample is a line of @width
+ * floats @elem_stride apart, so one call transforms rows (width 1) or all
+ * columns of a block at once. evens become low-pass, odds high-pass.
+ */
+typedef void (*LiftFunc) (
+    float *data, uint32_t count, uint32_t sample_stride, uint32_t width, uint32_t elem_stride);
+
+static void
+haar_forward (float *data, uint32_t count, uint32_t sample_stride, uint32_t width, uint32_t elem_stride)
+{
+    const uint32_t end = width * elem_stride;
+    for (uint32_t i = 0; i + 1 < count; i += 2) {
+        float *e = data + i * sample_stride;
+        float *o = e + sample_stride;
+        for (uint32_t j = 0; j < end; j += elem_stride) {
+            const float d = (o[j] - e[j]) * 0.5f;
+            e[j] += d;
+            o[j] = d;
+        }
+    }
+}
+
+static void
+haar_inverse (float *data, uint32_t count, uint32_t sample_stride, uint32_t width, uint32_t elem_stride)
+{
+    const uint32_t end = width * elem_stride;
+    for (uint32_t i = 0; i + 1 < count; i += 2) {
+        float *e = data + i * sample_stride;
+        float *o = e + sample_stride;
+        for (uint32_t j = 0; j < end; j += elem_stride) {
+            const float s = e[j];
+            e[j] = s - o[j];
+            o[j] = s + o[j];
+        }
+    }
+}
+
+// d = (o - (l + r) / 2) / 2 on one sample line
+inline static void
+cdf53_predict (float *o, const float *l, const float *r, uint32_t end, uint32_t elem_stride)
+{
+    for (uint32_t j = 0; j < end; j += elem_stride)
+        o[j] = (o[j] - (l[j] + r[j]) * 0.5f) * 0.5f;
+}
+
+// s = e + sign * (l + r) / 2 on one sample line
+inline static void
+cdf53_update (float *e, const float *l, const float *r, float sign, uint32_t end, uint32_t elem_stride)
+{
+    for (uint32_t j = 0; j < end; j += elem_stride)
+        e[j] += (l[j] + r[j]) * (0.5f * sign);
+}
+
+// o = 2 * d + (l + r) / 2 on one sample line
+inline static void
+cdf53_unpredict (float *o, const float *l, const float *r, uint32_t end, uint32_t elem_stride)
+{
+    for (uint32_t j = 0; j < end; j += elem_stride)
+        o[j] = o[j] * 2.0f + (l[j] + r[j]) * 0.5f;
+}
+
+/* CDF 5/3 with symmetric extension, details halved to keep same scale as haar.
+ * first and last samples are peeled off, so interior loops have no extension checks.
+ */
+static void
+cdf53_forward (float *data, uint32_t count, uint32_t sample_stride, uint32_t width, uint32_t elem_stride)
+{
+    const uint32_t end = width * elem_stride;
+    const uint32_t last = count - 1;
+    if (count < 2)
+        return;
+
+    uint32_t i = 1;
+    for (; i < last; i += 2) {
+        float *o = data + i * sample_stride;
+        cdf53_predict (o, o - sample_stride, o + sample_stride, end, elem_stride);
+    }
+    if (i == last) {
+        float *o = data + i * sample_stride;
+        cdf53_predict (o, o - sample_stride, o - sample_stride, end, elem_stride);
+    }
+
+    cdf53_update (data, data + sample_stride, data + sample_stride, 1.0f, end, elem_stride);
+    for (i = 2; i < last; i += 2) {
+        float *e = data + i * sample_stride;
+        cdf53_update (e, e - sample_stride, e + sample_stride, 1.0f, end, elem_stride);
+    }
+    if (i == last) {
+        float *e = data + i * sample_stride;
+        cdf53_update (e, e - sample_stride, e - sample_stride, 1.0f, end, elem_stride);
+    }
+}
+
+static void
+cdf53_inverse (float *data, uint32_t count, uint32_t sample_stride, uint32_t width, uint32_t elem_stride)
+{
+    const uint32_t end = width * elem_stride;
+    const uint32_t last = count - 1;
+    if (count < 2)
+        return;
+
+    cdf53_update (data, data + sample_stride, data + sample_stride, -1.0f, end, elem_stride);
+    uint32_t i = 2;
+    for (; i < last; i += 2) {
+        float *e = data + i * sample_stride;
+        cdf53_update (e, e - sample_stride, e + sample_stride, -1.0f, end, elem_stride);
+    }
+    if (i == last) {
+        float *e = data + i * sample_stride;
+        cdf53_update (e, e - sample_stride, e - sample_stride, -1.0f, end, elem_stride);
+    }
+
+    for (i = 1; i < last; i += 2) {
+        float *o = data + i * sample_stride;
+        cdf53_unpredict (o, o - sample_stride, o + sample_stride, end, elem_stride);
+    }
+    if (i == last) {
+        float *o = data + i * sample_stride;
+        cdf53_unpredict (o, o - sample_stride, o - sample_stride, end, elem_stride);
+    }
+}
+
+/* same as thresholding of kernel_wavelet_haar_reconstruction, ratio 0 is soft thresholding.
+ * written as coeff * ratio + sign * max (|coeff| - threshold, 0) * (1 - ratio), no branches.
+ */
+inline static float
+shrink (float coeff, float threshold, float ratio)
+{
+    const float magnitude = XCAM_MAX (fabsf (coeff) - threshold, 0.0f) * (1.0f - ratio);
+    return coeff * ratio + copysignf (magnitude, coeff);
+}
+
+/* details of one level, block samples are @step apart.
+ * hl: odd x on even y, lh: even x on odd y, hh: odd x on odd y
+ */
+static void
+threshold_level (
+    float *block, uint32_t pitch, uint32_t nx, uint32_t ny, uint32_t level,
+    const WaveletPlaneParam &param)
+{
+    const uint32_t step = 1 << level;
+    float threshold[3], ratio = param.soft_ratio;
+
+    if (param.bayes_shrink) {
+        double sum[3] = {0.0, 0.0, 0.0};
+        uint32_t count[3] = {0, 0, 0};
+        for (uint32_t i = 0; i < ny; ++i) {
+            const float *line = block + i * step * pitch;
+            float line_sum[3] = {0.0f, 0.0f, 0.0f};
+            if (i & 1) {
+                for (uint32_t j = 0; j < nx; j += 2)
+                    line_sum[1] += line[j * step] * line[j * step];
+                for (uint32_t j = 1; j < nx; j += 2)
+                    line_sum[2] += line[j * step] * line[j * step];
+                count[1] += (nx + 1) / 2;
+                count[2] += nx / 2;
+            } else {
+                for (uint32_t j = 1; j < nx; j += 2)
+                    line_sum[0] += line[j * step] * line[j * step];
+                count[0] += nx / 2;
+            }
+            sum[0] += line_sum[0];
+            sum[1] += line_sum[1];
+            sum[2] += line_sum[2];
+        }
+
+        // BayesShrink, noise variance over signal std
+        const float noise = param.noise_sigma / step;
+        const float noise_var = noise * noise;
+        for (uint32_t k = 0; k < 3; ++k) {
+            const float var = count[k] ? (float)(sum[k] / count[k]) : 0.0f;
+            const float signal = sqrtf (XCAM_MAX (var - noise_var, 0.0f));
+            threshold[k] = (signal > WAVELET_MIN_SIGNAL) ? noise_var / signal : 256.0f;
+        }
+        ratio = 0.0f;
+    } else {
+        threshold[0] = threshold[1] = threshold[2] = param.threshold[level];
+    }
+
+    for (uint32_t i = 0; i < ny; ++i) {
+        float *line = block + i * step * pitch;
+        if (i & 1) {
+            for (uint32_t j = 0; j < nx; j += 2)
+                line[j * step] = shrink (line[j * step], threshold[1], ratio);
+            for (uint32_t j = 1; j < nx; j += 2)
+                line[j * step] = shrink (line[j * step], threshold[2], ratio);
+        } else {
+            for (uint32_t j = 1; j < nx; j += 2)
+                line[j * step] = shrink (line[j * step], threshold[0], ratio);
+        }
+    }
+}
+
+static void
+denoise_block (
+    float *block, uint32_t pitch, uint32_t width, uint32_t height,
+    SoftWaveletBasis basis, uint32_t levels, const WaveletPlaneParam &param)
+{
+    const LiftFunc forward = (basis == SoftWaveletCdf53) ? cdf53_forward : haar_forward;
+    const LiftFunc inverse = (basis == SoftWaveletCdf53) ? cdf53_inverse : haar_inverse;
+    uint32_t nx[XCAM_SOFT_WAVELET_MAX_LEVELS], ny[XCAM_SOFT_WAVELET_MAX_LEVELS];
+
+    // level n works on low-pass samples of level n - 1, in place
+    uint32_t decomposed = 0;
+    for (; decomposed < levels; ++decomposed) {
+        const uint32_t step = 1 << decomposed;
+        nx[decomposed] = xcam_ceil (width, step) / step;
+        ny[decomposed] = xcam_ceil (height, step) / step;
+        if (nx[decomposed] < 2 || ny[decomposed] < 2)
+            break;
+
+        for (uint32_t y = 0; y < ny[decomposed]; ++y)
+            forward (block + y * step * pitch, nx[decomposed], step, 1, 1);
+        forward (block, ny[decomposed], step * pitch, nx[decomposed], step);
+    }
+
+    for (uint32_t level = 0; level < decomposed; ++level)
+        threshold_level (block, pitch, nx[level], ny[level], level, param);
+
+    for (uint32_t level = decomposed; level-- > 0; ) {
+        const uint32_t step = 1 << level;
+        inverse (block, ny[level], step * pitch, nx[level], step);
+        for (uint32_t y = 0; y < ny[level]; ++y)
+            inverse (block + y * step * pitch, nx[level], step, 1, 1);
+    }
+}
+
+// tile of [x0, x0 + w) x [y0, y0 + h) with halo, clipped to plane
+struct BlockRect {
+    uint32_t    x, y, width, height;
+
+    BlockRect (uint32_t x0, uint32_t y0, uint32_t w, uint32_t h, uint32_t halo, uint32_t plane_w, uint32_t plane_h)
+        : x (x0 > halo ? x0 - halo : 0)
+        , y (y0 > halo ? y0 - halo : 0)
+    {
+        width = XCAM_MIN (x0 + w + halo, plane_w) - x;
+        height = XCAM_MIN (y0 + h + halo, plane_h) - y;
+    }
+};
+
+static void
+denoise_luma_tile (
+    WaveletDenoiseTask::Args *args, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h,
+    uint32_t halo, std::vector<float> &block, uint32_t pitch)
+{
+    UcharImage *in = args->in_luma.ptr (), *out = args->out_luma.ptr ();
+
+    if (!args->planes[0].enable) {
+        for (uint32_t y = y0; y < y0 + h; ++y)
+            memcpy (out->get_buf_ptr (x0, y), in->get_buf_ptr (x0, y), w);
+        return;
+    }
+
+    const BlockRect rect (x0, y0, w, h, halo, in->get_width (), in->get_height ());
+    for (uint32_t y = 0; y < rect.height; ++y) {
+        const Uchar *src = in->get_buf_ptr (rect.x, rect.y + y);
+        float *dst = &block[y * pitch];
+        for (uint32_t x = 0; x < rect.width; ++x)
+            dst[x] = src[x];
+    }
+
+    denoise_block (&block[0], pitch, rect.width, rect.height, args->basis, args->levels, args->planes[0]);
+
+    for (uint32_t y = y0; y < y0 + h; ++y) {
+        const float *src = &block[(y - rect.y) * pitch + (x0 - rect.x)];
+        Uchar *dst = out->get_buf_ptr (x0, y);
+        for (uint32_t x = 0; x < w; ++x)
+            dst[x] = convert_to_uchar (src[x]);
+    }
+}
+
+static void
+denoise_uv_tile (
+    WaveletDenoiseTask::Args *args, uint32_t x0, uint32_t y0, uint32_t w, uint32_t h,
+    uint32_t halo, std::vector<float> &block_u, std::vector<float> &block_v, uint32_t pitch)
+{
+    Uchar2Image *in = args->in_uv.ptr (), *out = args->out_uv.ptr ();
+    const WaveletPlaneParam &param_u = args->planes[1];
+    const WaveletPlaneParam &param_v = args->planes[2];
+
+    if (!param_u.enable && !param_v.enable) {
+        for (uint32_t y = y0; y < y0 + h; ++y)
+            memcpy ((void *)out->get_buf_ptr (x0, y), (const void *)in->get_buf_ptr (x0, y), w * sizeof (Uchar2));
+        return;
+    }
+
+    const BlockRect rect (x0, y0, w, h, halo, in->get_width (), in->get_height ());
+    for (uint32_t y = 0; y < rect.height; ++y) {
+        const Uchar2 *src = in->get_buf_ptr (rect.x, rect.y + y);
+        float *dst_u = &block_u[y * pitch];
+        float *dst_v = &block_v[y * pitch];
+        for (uint32_t x = 0; x < rect.width; ++x) {
+            dst_u[x] = src[x].x;
+            dst_v[x] = src[x].y;
+        }
+    }
+
+    if (param_u.enable)
+        denoise_block (&block_u[0], pitch, rect.width, rect.height, args->basis, args->levels, param_u);
+    if (param_v.enable)
+        denoise_block (&block_v[0], pitch, rect.width, rect.height, args->basis, args->levels, param_v);
+
+    for (uint32_t y = y0; y < y0 + h; ++y) {
+        const uint32_t offset = (y - rect.y) * pitch + (x0 - rect.x);
+        const float *src_u = &block_u[offset];
+        const float *src_v = &block_v[offset];
+        Uchar2 *dst = out->get_buf_ptr (x0, y);
+        for (uint32_t x = 0; x < w; ++x) {
+            dst[x].x = convert_to_uchar (src_u[x]);
+            dst[x].y = convert_to_uchar (src_v[x]);
+        }
+    }
+}
+
+XCamReturn
+WaveletDenoiseTask::work_range (const SmartPtr<Arguments> &base, const WorkRange &range)
+{
+    SmartPtr<WaveletDenoiseTask::Args> args = base.dynamic_cast_ptr<WaveletDenoiseTask::Args> ();
+    XCAM_ASSERT (args.ptr ());
+    XCAM_ASSERT (args->in_luma.ptr () && args->out_luma.ptr ());
+    XCAM_ASSERT (args->in_uv.ptr () && args->out_uv.ptr ());
+    XCAM_ASSERT (args->levels && args->levels <= XCAM_SOFT_WAVELET_MAX_LEVELS);
+
+    const uint32_t width = args->in_luma->get_width ();
+    const uint32_t height = args->in_luma->get_height ();
+    const uint32_t uv_width = args->in_uv->get_width ();
+    const uint32_t uv_height = args->in_uv->get_height ();
+
+    // haar has no overlap between tiles, cdf 5/3 needs enough support for all levels
+    const uint32_t halo = (args->basis == SoftWaveletCdf53) ? (1 << args->levels) : 0;
+    const uint32_t pitch = XCAM_SOFT_WAVELET_TILE_SIZE + halo * 2;
+    const uint32_t uv_pitch = XCAM_SOFT_WAVELET_TILE_SIZE / 2 + halo * 2;
+    std::vector<float> block (pitch * pitch);
+    std::vector<float> block_u (uv_pitch * uv_pitch), block_v (uv_pitch * uv_pitch);
+
+    for (uint32_t ty = range.pos[1]; ty < range.pos[1] + range.pos_len[1]; ++ty) {
+        for (uint32_t tx = range.pos[0]; tx < range.pos[0] + range.pos_len[0]; ++tx) {
+            const uint32_t x0 = tx * XCAM_SOFT_WAVELET_TILE_SIZE;
+            const uint32_t y0 = ty * XCAM_SOFT_WAVELET_TILE_SIZE;
+            const uint32_t w = XCAM_MIN (XCAM_SOFT_WAVELET_TILE_SIZE, width - x0);
+            const uint32_t h = XCAM_MIN (XCAM_SOFT_WAVELET_TILE_SIZE, height - y0);
+            denoise_luma_tile (args.ptr (), x0, y0, w, h, halo, block, pitch);
+
+            const uint32_t uv_x0 = x0 / 2, uv_y0 = y0 / 2;
+            const uint32_t uv_w = XCAM_MIN (XCAM_SOFT_WAVELET_TILE_SIZE / 2, uv_width - uv_x0);
+            const uint32_t uv_h = XCAM_MIN (XCAM_SOFT_WAVELET_TILE_SIZE / 2, uv_height - uv_y0);
+            denoise_uv_tile (args.ptr (), uv_x0, uv_y0, uv_w, uv_h, halo, block_u, block_v, uv_pitch);
+        }
+    }
+
+    XCAM_LOG_DEBUG (
+        "WaveletDenoiseTask work on range:[x:%d, y:%d, len:%dx%d]",
+        range.pos[0], range.pos[1], range.pos_len[0], range.pos_len[1]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+static float
+get_noise_sigma (const uint32_t *hist, uint32_t count)
+{
+    if (!count)
+        return 0.0f;
+
+    // median with linear interpolation inside its bin
+    const float half = count * 0.5f;
+    uint32_t sum = 0;
+    float median = 0.0f;
+    for (uint32_t i = 0; i < WAVELET_NOISE_HIST_SIZE; ++i) {
+        if (sum + hist[i] >= half) {
+            median = i + (half - sum) / hist[i] - 0.5f;
+            break;
+        }
+        sum += hist[i];
+    }
+
+    return XCAM_MAX (median, 0.0f) / 4.0f / WAVELET_MAD_SCALE;
+}
+
+float
+wavelet_estimate_luma_noise (const UcharImage &luma, uint32_t sample_step)
+{
+    uint32_t hist[WAVELET_NOISE_HIST_SIZE];
+    uint32_t count = 0;
+    xcam_mem_clear (hist);
+
+    for (uint32_t y = 0; y + 1 < luma.get_height (); y += 2 * sample_step) {
+        const Uchar *line0 = luma.get_buf_ptr (0, y);
+        const Uchar *line1 = luma.get_buf_ptr (0, y + 1);
+        for (uint32_t x = 0; x + 1 < luma.get_width (); x += 2) {
+            const int32_t hh = (int32_t)line0[x] - line0[x + 1] - line1[x] + line1[x + 1];
+            ++hist[abs (hh)];
+        }
+        count += luma.get_width () / 2;
+    }
+
+    return get_noise_sigma (hist, count);
+}
+
+float
+wavelet_estimate_uv_noise (const Uchar2Image &uv, uint32_t comp, uint32_t sample_step)
+{
+    uint32_t hist[WAVELET_NOISE_HIST_SIZE];
+    uint32_t count = 0;
+    xcam_mem_clear (hist);
+
+    for (uint32_t y = 0; y + 1 < uv.get_height (); y += 2 * sample_step) {
+        const Uchar2 *line0 = uv.get_buf_ptr (0, y);
+        const Uchar2 *line1 = uv.get_buf_ptr (0, y + 1);
+        for (uint32_t x = 0; x + 1 < uv.get_width (); x += 2) {
+            const int32_t hh = comp ?
+                               (int32_t)line0[x].y - line0[x + 1].y - line1[x].y + line1[x + 1].y :
+                               (int32_t)line0[x].x - line0[x + 1].x - line1[x].x + line1[x + 1].x;
+            ++hist[abs (hh)];
+        }
+        count += uv.get_width () / 2;
+    }
+
+    return get_noise_sigma (hist, count);
+}
+
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+ * soft_wavelet_denoise_tasks_priv.h - soft wavelet denoise tasks private class
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_WAVELET_DENOISE_TASKS_PRIV_H
+#define XCAM_SOFT_WAVELET_DENOISE_TASKS_PRIV_H
+
+#include <xcam_std.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_handler.h>
+#include <soft/soft_wavelet_denoise_handler.h>
+
+// luma tile size, uv tile is half of it on each of u and v
+#define XCAM_SOFT_WAVELET_TILE_SIZE 128
+
+namespace XCam {
+
+namespace XCamSoftTasks {
+
+/* thresholds of one plane, coefficients are in pixel levels and scaled as
+ * kernel_wavelet_haar_decomposition, ll is average, details are half differences.
+ */
+struct WaveletPlaneParam {
+    bool        enable;
+    bool        bayes_shrink;
+    // soft ratio applied inside threshold, same as kernel_wavelet_haar_reconstruction
+    float       soft_ratio;
+    float       threshold[XCAM_SOFT_WAVELET_MAX_LEVELS];
+    // noise std of level 1 details, level n is 1 / 2^(n-1) of it
+    float       noise_sigma;
+
+    WaveletPlaneParam ()
+        : enable (false)
+        , bayes_shrink (false)
+        , soft_ratio (0.0f)
+        , noise_sigma (0.0f)
+    {
+        xcam_mem_clear (threshold);
+    }
+};
+
+// one work item is one luma tile and its uv tile
+class WaveletDenoiseTask
+    : public SoftWorker
+{
+public:
+    struct Args : SoftArgs {
+        SmartPtr<UcharImage>        in_luma, out_luma;
+        SmartPtr<Uchar2Image>       in_uv, out_uv;
+        SoftWaveletBasis            basis;
+        uint32_t                    levels;
+        // luma, u, v
+        WaveletPlaneParam           planes[3];
+
+        Args (
+            const SmartPtr<ImageHandler::Parameters> &param)
+            : SoftArgs (param)
+            , basis (SoftWaveletHaar)
+            , levels (XCAM_SOFT_WAVELET_MAX_LEVELS)
+        {}
+    };
+
+public:
+    explicit WaveletDenoiseTask (const SmartPtr<Worker::Callback> &cb)
+        : SoftWorker ("WaveletDenoiseTask", cb)
+    {}
+
+private:
+    virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
+};
+
+/* noise std of level 1 detail coefficients by median absolute HH,
+ * one of @sample_step 2x2 block lines is sampled, @comp selects u(0) or v(1) for uv.
+ */
+float wavelet_estimate_luma_noise (const UcharImage &luma, uint32_t sample_step);
+float wavelet_estimate_uv_noise (const Uchar2Image &uv, uint32_t comp, uint32_t sample_step);
+
+}
+
+}
+
+#endif //XCAM_SOFT_WAVELET_DENOISE_TASKS_PRIV_H
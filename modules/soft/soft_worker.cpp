@@ -137,52 +137,55 @@ SoftWorker::set_threads (const SmartPtr<ThreadPool> &threads)
 XCamReturn
 SoftWorker::stop ()
 {
-    _threads->stop ();
+    if (_threads.ptr ())
+        _threads->stop ();
     return XCAM_RETURN_NO_ERROR;
 }
 
-XCamReturn
-SoftWorker::work (const SmartPtr<Worker::Arguments> &args)
+uint32_t
+SoftWorker::get_items (WorkSize &items) const
 {
-    XCamReturn ret = XCAM_RETURN_NO_ERROR;
-
     const WorkSize &global = get_global_size ();
     const WorkSize &local = get_local_size ();
 
     XCAM_ASSERT (local.value[0] && local.value[1] && local.value[2]);
     XCAM_ASSERT (global.value[0] && global.value[1] && global.value[2]);
 
-    WorkSize items;
     uint32_t max_items = 1;
-
     for (uint32_t i = 0; i < WORK_MAX_DIM; ++i) {
         items.value[i] = xcam_ceil (global.value[i],  local.value[i]) / local.value[i];
         max_items *= items.value[i];
     }
 
-    XCAM_FAIL_RETURN (
-        ERROR, max_items, XCAM_RETURN_ERROR_PARAM,
-        "SoftWorker(%s) max item is zero. work failed.", XCAM_STR (get_name ()));
+    return max_items;
+}
 
-    if (max_items == 1) {
-        ret = work_impl (args, WorkSize(0, 0, 0));
-        status_check (args, ret);
-        return ret;
-    }
+XCamReturn
+SoftWorker::start_threads (uint32_t count)
+{
+    if (_threads.ptr ())
+        return XCAM_RETURN_NO_ERROR;
 
-    if (!_threads.ptr ()) {
-        char thr_name [XCAM_MAX_STR_SIZE];
-        snprintf (thr_name, XCAM_MAX_STR_SIZE, "%s-thrs", XCAM_STR(get_name ()));
+    char thr_name [XCAM_MAX_STR_SIZE];
+    snprintf (thr_name, XCAM_MAX_STR_SIZE, "%s-thrs", XCAM_STR(get_name ()));
 
-        SmartPtr<ThreadPool> threads = new ThreadPool (thr_name);
-        XCAM_ASSERT (threads.ptr ());
-        _threads = threads;
-        _threads->set_threads (max_items, max_items + 1); //extra thread to process all_items_done
-        ret = _threads->start ();
-        XCAM_FAIL_RETURN (
-            ERROR, xcam_ret_is_ok (ret), ret,
-            "SoftWorker(%s) work failed when starting threads", XCAM_STR(get_name()));
-    }
+    SmartPtr<ThreadPool> threads = new ThreadPool (thr_name);
+    XCAM_ASSERT (threads.ptr ());
+    _threads = threads;
+    _threads->set_threads (count, count + 1); //extra thread to process all_items_done
+    XCamReturn ret = _threads->start ();
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftWorker(%s) work failed when starting threads", XCAM_STR(get_name()));
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftWorker::queue_items (
+    const SmartPtr<Arguments> &args, const WorkSize &items, uint32_t max_items)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
 
     SmartPtr<ItemSynch> sync = new ItemSynch (max_items);
     for (uint32_t z = 0; z < items.value[2]; ++z)
@@ -205,6 +208,75 @@ SoftWorker::work (const SmartPtr<Worker::Arguments> &args)
     return XCAM_RETURN_NO_ERROR;
 }
 
+XCamReturn
+SoftWorker::work (const SmartPtr<Worker::Arguments> &args)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    WorkSize items;
+    uint32_t max_items = get_items (items);
+
+    XCAM_FAIL_RETURN (
+        ERROR, max_items, XCAM_RETURN_ERROR_PARAM,
+        "SoftWorker(%s) max item is zero. work failed.", XCAM_STR (get_name ()));
+
+    if (max_items == 1) {
+        ret = work_impl (args, WorkSize(0, 0, 0));
+        status_check (args, ret);
+        return ret;
+    }
+
+    ret = start_threads (max_items);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftWorker(%s) start threads failed", XCAM_STR(get_name()));
+
+    return queue_items (args, items, max_items);
+}
+
+XCamReturn
+SoftWorker::work_batch (const ArgumentsList &args_list, uint32_t *queued)
+{
+    if (queued)
+        *queued = 0;
+
+    XCAM_FAIL_RETURN (
+        ERROR, !args_list.empty (), XCAM_RETURN_ERROR_PARAM,
+        "SoftWorker(%s) work batch failed, arguments list is empty", XCAM_STR (get_name ()));
+
+    if (args_list.size () == 1) {
+        XCamReturn ret = work (args_list.front ());
+        if (queued && xcam_ret_is_ok (ret))
+            *queued = 1;
+        return ret;
+    }
+
+    WorkSize items;
+    uint32_t max_items = get_items (items);
+
+    XCAM_FAIL_RETURN (
+        ERROR, max_items, XCAM_RETURN_ERROR_PARAM,
+        "SoftWorker(%s) max item is zero. work batch failed.", XCAM_STR (get_name ()));
+
+    // items of all frames are queued in one go, threads move on to next frame
+    // without waiting for the previous frame finished
+    XCamReturn ret = start_threads (max_items);
+    XCAM_FAIL_RETURN (
+        ERROR, xcam_ret_is_ok (ret), ret,
+        "SoftWorker(%s) start threads failed", XCAM_STR(get_name()));
+
+    for (ArgumentsList::const_iterator i = args_list.begin (); i != args_list.end (); ++i) {
+        ret = queue_items (*i, items, max_items);
+        XCAM_FAIL_RETURN (
+            ERROR, xcam_ret_is_ok (ret), ret,
+            "SoftWorker(%s) work batch failed in queuing items", XCAM_STR(get_name()));
+        if (queued)
+            ++(*queued);
+    }
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
 void
 SoftWorker::all_items_done (const SmartPtr<Arguments> &args, XCamReturn error)
 {
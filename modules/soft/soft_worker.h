@@ -23,6 +23,7 @@
 
 #include <xcam_std.h>
 #include <worker.h>
+#include <vector>
 
 namespace XCam {
 
@@ -44,6 +45,9 @@ class SoftWorker
 {
     friend class WorkItem;
 
+public:
+    typedef std::vector<SmartPtr<Arguments> > ArgumentsList;
+
 public:
     explicit SoftWorker (const char *name, const SmartPtr<Callback> &cb = NULL);
     virtual ~SoftWorker ();
@@ -59,6 +63,11 @@ public:
     virtual XCamReturn work (const SmartPtr<Arguments> &args);
     virtual XCamReturn stop ();
 
+    // run same global/local size on a batch of frames in one dispatch,
+    // callback is still called once per arguments
+    // @queued, optional, count of leading arguments whose items were all queued
+    virtual XCamReturn work_batch (const ArgumentsList &args_list, uint32_t *queued = NULL);
+
 private:
     //new virtual functions
     virtual XCamReturn work_range (const SmartPtr<Arguments> &args, const WorkRange &range);
@@ -66,6 +75,10 @@ private:
     virtual XCamReturn work_unit (const SmartPtr<Arguments> &args, const WorkSize &unit);
 
     XCamReturn work_impl (const SmartPtr<Arguments> &args, const WorkSize &item);
+    uint32_t get_items (WorkSize &items) const;
+    XCamReturn start_threads (uint32_t count);
+    XCamReturn queue_items (
+        const SmartPtr<Arguments> &args, const WorkSize &items, uint32_t max_items);
     void all_items_done (const SmartPtr<Arguments> &args, XCamReturn error);
 
     XCAM_DEAD_COPY (SoftWorker);
@@ -29,7 +29,7 @@ struct DigitalVideoStabilizer : DvsInterface
 {
     virtual ~DigitalVideoStabilizer() {}
 
-    int init(int width, int height, bool twoPass);
+    int init(int width, int height, DvsMode mode);
 
     void setConfig(DvsConfig* config);
 
@@ -39,23 +39,32 @@ struct DigitalVideoStabilizer : DvsInterface
 
 
     VideoStabilizer* _videoStab;
+    StreamVideoStabilizer* _streamStab;
 
     DigitalVideoStabilizer () {
         _videoStab = NULL;
+        _streamStab = NULL;
     }
 };
 
-int DigitalVideoStabilizer::init(int width, int height, bool twoPass)
+int DigitalVideoStabilizer::init(int width, int height, DvsMode mode)
 {
     cv::Size frameSize;
     frameSize.width = width;
     frameSize.height = height;
 
-    if (_videoStab != NULL) {
-        delete _videoStab;
-        _videoStab = NULL;
+    release();
+
+    if (mode == DVS_MODE_STREAM) {
+        _streamStab = new StreamVideoStabilizer();
+        if (_streamStab == NULL) {
+            return -1;
+        }
+        _streamStab->setFrameSize(frameSize);
+        return 0;
     }
-    _videoStab = new VideoStabilizer(twoPass, false, false, false);
+
+    _videoStab = new VideoStabilizer(mode == DVS_MODE_TWO_PASS, false, false, false);
     if (_videoStab == NULL) {
         return -1;
     }
@@ -69,6 +78,13 @@ int DigitalVideoStabilizer::init(int width, int height, bool twoPass)
 
 void DigitalVideoStabilizer::setConfig(DvsConfig* config)
 {
+    if (_streamStab != NULL) {
+        _streamStab->setFrameSize(cv::Size(config->frame_width, config->frame_height));
+        _streamStab->setTrackWidth(config->track_width);
+        _streamStab->configMotionFilter(config->process_noise, config->measure_noise);
+        _streamStab->configFeatureDetector(config->features, config->minDistance);
+        return;
+    }
     if (NULL == _videoStab) {
         return;
     }
@@ -82,19 +98,31 @@ void DigitalVideoStabilizer::release()
 {
     if (_videoStab != NULL) {
         delete _videoStab;
+        _videoStab = NULL;
+    }
+    if (_streamStab != NULL) {
+        delete _streamStab;
+        _streamStab = NULL;
     }
 }
 
 void DigitalVideoStabilizer::nextStabilizedMotion(DvsData* frame, DvsResult* result)
 {
-    if ((NULL == _videoStab) || (NULL == result)) {
+    if (((NULL == _videoStab) && (NULL == _streamStab)) || (NULL == result)) {
         return;
     }
     result->frame_id = -1;
-    result->frame_width = _videoStab->getFrameSize().width;
-    result->frame_height = _videoStab->getFrameSize().height;
 
-    cv::Mat HMatrix = _videoStab->nextStabilizedMotion(frame, result->frame_id);
+    cv::Mat HMatrix;
+    if (_streamStab != NULL) {
+        result->frame_width = _streamStab->getFrameSize().width;
+        result->frame_height = _streamStab->getFrameSize().height;
+        HMatrix = _streamStab->nextStabilizedMotion(frame, result->frame_id);
+    } else {
+        result->frame_width = _videoStab->getFrameSize().width;
+        result->frame_height = _videoStab->getFrameSize().height;
+        HMatrix = _videoStab->nextStabilizedMotion(frame, result->frame_id);
+    }
 
     if (HMatrix.empty()) {
         result->valid = false;
@@ -22,11 +22,22 @@
 #define _LIB_DVS_HPP
 
 #include <stdio.h>
+#include "stream_motion_filter.h"
 
 #if (defined __linux__)
 #define DVSAPI __attribute__((visibility("default")))
 #endif
 
+// stream mode tracks motion on luma downscaled to this width
+#define DVS_STREAM_TRACK_WIDTH    320
+
+typedef enum DvsMode
+{
+    DVS_MODE_ONE_PASS = 0,  // smooth with radius frames look-ahead
+    DVS_MODE_TWO_PASS,
+    DVS_MODE_STREAM,        // causal filter, no frame delay
+} DvsMode;
+
 typedef struct DvsData
 {
     cv::UMat data;
@@ -57,6 +68,10 @@ typedef struct  DvsConfig
     float stdev;
     int features;
     double minDistance;
+    // stream mode only
+    int track_width;
+    float process_noise;
+    float measure_noise;
 
     DvsConfig()
     {
@@ -67,6 +82,9 @@ typedef struct  DvsConfig
         stdev = 10.0f;
         features = 1000;
         minDistance = 15.0f;
+        track_width = DVS_STREAM_TRACK_WIDTH;
+        process_noise = DVS_STREAM_PROCESS_NOISE;
+        measure_noise = DVS_STREAM_MEASURE_NOISE;
     }
 } DvsConfig;
 
@@ -74,7 +92,7 @@ typedef struct DvsInterface
 {
     virtual ~DvsInterface() {}
     /// initialize model from memory
-    virtual int init(int width, int height, bool twoPass) = 0;
+    virtual int init(int width, int height, DvsMode mode) = 0;
 
     /// set detection parameters, if config = NULL, default parameters will be used
     virtual void setConfig(DvsConfig* config) = 0;
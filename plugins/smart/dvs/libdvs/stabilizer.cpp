@@ -20,6 +20,8 @@
 
 #include "stabilizer.h"
 
+#define STREAM_DVS_MIN_TRACK_POINTS 8
+
 using namespace cv;
 using namespace cv::videostab;
 using namespace std;
@@ -250,6 +252,173 @@ TwoPassVideoStabilizer::setUpFrame(const Mat &firstFrame)
     StabilizerBase::setUp(firstFrame);
 }
 
+StreamVideoStabilizer::StreamVideoStabilizer()
+    : trimRatio_ (0.05f)
+    , trackWidth_ (DVS_STREAM_TRACK_WIDTH)
+    , trackScale_ (1.0)
+    , maxFeatures_ (200)
+    , minDistance_ (8.0)
+{
+    reset();
+}
+
+void
+StreamVideoStabilizer::reset()
+{
+    frameId_ = -1;
+    prevGray_.release();
+    prevPts_.clear();
+    filter_.reset();
+}
+
+void
+StreamVideoStabilizer::setFrameSize(Size frameSize)
+{
+    frameSize_ = frameSize;
+}
+
+void
+StreamVideoStabilizer::configFeatureDetector(int features, double minDistance)
+{
+    // features are detected on the downscaled frame, a few hundred corners are enough
+    maxFeatures_ = std::min(features, 200);
+    minDistance_ = minDistance;
+}
+
+void
+StreamVideoStabilizer::configMotionFilter(float processNoise, float measureNoise)
+{
+    filter_.setNoise(processNoise, measureNoise);
+}
+
+void
+StreamVideoStabilizer::setTrackWidth(int width)
+{
+    if (width > 0 && width != trackWidth_) {
+        trackWidth_ = width;
+        reset();
+    }
+}
+
+void
+StreamVideoStabilizer::downscaleLuma(const UMat& frame, Mat& gray)
+{
+    // only the downscaled luma is read back, full frame stays where it is
+    if (frame.cols <= trackWidth_) {
+        trackScale_ = 1.0;
+        frame.copyTo(gray);
+        return;
+    }
+
+    trackScale_ = (double)frame.cols / trackWidth_;
+    Size trackSize(trackWidth_, cvRound(frame.rows / trackScale_));
+
+    UMat small;
+    resize(frame, small, trackSize, 0, 0, INTER_AREA);
+    small.copyTo(gray);
+}
+
+bool
+StreamVideoStabilizer::estimateMotion(const Mat& gray, double motion[ParamCount])
+{
+    motion[ParamX] = 0.0;
+    motion[ParamY] = 0.0;
+    motion[ParamAngle] = 0.0;
+    motion[ParamScale] = 0.0;
+
+    if (prevPts_.size() < STREAM_DVS_MIN_TRACK_POINTS)
+        return false;
+
+    std::vector<Point2f> curPts;
+    std::vector<uchar> status;
+    std::vector<float> error;
+    calcOpticalFlowPyrLK(prevGray_, gray, prevPts_, curPts, status, error, Size(21, 21), 3);
+
+    // center points so rotation and scale are around image center
+    Point2f center(gray.cols * 0.5f, gray.rows * 0.5f);
+    std::vector<Point2f> srcPts, dstPts;
+    srcPts.reserve(curPts.size());
+    dstPts.reserve(curPts.size());
+    for (size_t i = 0; i < status.size(); ++i) {
+        if (!status[i])
+            continue;
+        srcPts.push_back(prevPts_[i] - center);
+        dstPts.push_back(curPts[i] - center);
+    }
+    if (srcPts.size() < STREAM_DVS_MIN_TRACK_POINTS)
+        return false;
+
+    Mat rigid = estimateRigidTransform(srcPts, dstPts, false);
+    if (rigid.empty())
+        return false;
+
+    double a = rigid.at<double>(0, 0);
+    double b = rigid.at<double>(1, 0);
+    motion[ParamX] = rigid.at<double>(0, 2);
+    motion[ParamY] = rigid.at<double>(1, 2);
+    motion[ParamAngle] = atan2(b, a);
+    motion[ParamScale] = log(sqrt(a * a + b * b));
+
+    return true;
+}
+
+Mat
+StreamVideoStabilizer::calcCorrection()
+{
+    double delta[ParamCount];
+
+    // keep correction inside the trimmed border
+    delta[ParamX] = filter_.correction(ParamX, trimRatio_ * frameSize_.width / trackScale_);
+    delta[ParamY] = filter_.correction(ParamY, trimRatio_ * frameSize_.height / trackScale_);
+    delta[ParamAngle] = filter_.correction(ParamAngle);
+    delta[ParamScale] = filter_.correction(ParamScale);
+
+    double scale = exp(delta[ParamScale]);
+    double a = scale * cos(delta[ParamAngle]);
+    double b = scale * sin(delta[ParamAngle]);
+    double cx = frameSize_.width * 0.5;
+    double cy = frameSize_.height * 0.5;
+
+    // rotate and scale around center, translation back to full resolution
+    Mat motion = Mat::eye(3, 3, CV_32F);
+    motion.at<float>(0, 0) = (float)a;
+    motion.at<float>(0, 1) = (float)-b;
+    motion.at<float>(1, 0) = (float)b;
+    motion.at<float>(1, 1) = (float)a;
+    motion.at<float>(0, 2) = (float)(cx - a * cx + b * cy + delta[ParamX] * trackScale_);
+    motion.at<float>(1, 2) = (float)(cy - b * cx - a * cy + delta[ParamY] * trackScale_);
+
+    return motion;
+}
+
+Mat
+StreamVideoStabilizer::nextStabilizedMotion(DvsData* frame, int& stablizedPos)
+{
+    if (frame->data.empty())
+        return Mat();
+
+    Mat gray;
+    downscaleLuma(frame->data, gray);
+    if (frameSize_.width <= 1 || frameSize_.height <= 1)
+        frameSize_ = frame->data.size();
+
+    if (prevGray_.size() != gray.size())
+        prevPts_.clear();
+
+    double motion[ParamCount];
+    estimateMotion(gray, motion);
+    filter_.update(motion);
+
+    // features of this frame are tracked into the next one
+    goodFeaturesToTrack(gray, prevPts_, maxFeatures_, 0.01, std::max(minDistance_ / trackScale_, 1.0));
+    prevGray_ = gray;
+
+    frameId_++;
+    stablizedPos = frameId_;
+
+    return calcCorrection();
+}
+
 VideoStabilizer::VideoStabilizer(
     bool isTwoPass,
     bool wobbleSuppress,
@@ -27,6 +27,7 @@
 #include <opencv2/videostab.hpp>
 
 #include "libdvs.h"
+#include "stream_motion_filter.h"
 
 class OnePassVideoStabilizer : public cv::videostab::OnePassStabilizer
 {
@@ -58,6 +59,63 @@ private:
 
 };
 
+/*
+ * causal stabilizer for live streams, correction of frame n is emitted with frame n.
+ * similarity motion is estimated by sparse optical flow on downscaled luma,
+ * camera trajectory is smoothed by StreamMotionFilter.
+ * only the previous downscaled frame is kept, memory does not grow with radius.
+ */
+class StreamVideoStabilizer
+{
+public:
+    enum {
+        ParamX = StreamMotionFilter::ParamX,
+        ParamY = StreamMotionFilter::ParamY,
+        ParamAngle = StreamMotionFilter::ParamAngle,
+        ParamScale = StreamMotionFilter::ParamScale,
+        ParamCount = StreamMotionFilter::ParamCount
+    };
+
+    StreamVideoStabilizer();
+    virtual ~StreamVideoStabilizer() {};
+
+    cv::Mat nextStabilizedMotion(DvsData* frame, int& stablizedPos);
+    void reset();
+
+    void setFrameSize(cv::Size frameSize);
+    cv::Size getFrameSize() const {
+        return frameSize_;
+    }
+
+    void configFeatureDetector(int features, double minDistance);
+    // larger processNoise follows camera motion faster, larger measureNoise smooths more
+    void configMotionFilter(float processNoise, float measureNoise);
+    void setTrackWidth(int width);
+    void setTrimRatio(float trimRatio) {
+        trimRatio_ = trimRatio;
+    }
+
+private:
+    void downscaleLuma(const cv::UMat& frame, cv::Mat& gray);
+    bool estimateMotion(const cv::Mat& gray, double motion[ParamCount]);
+    cv::Mat calcCorrection();
+
+private:
+    cv::Size frameSize_;
+    float trimRatio_;
+    int trackWidth_;
+    double trackScale_;
+
+    int maxFeatures_;
+    double minDistance_;
+
+    int frameId_;
+    cv::Mat prevGray_;
+    std::vector<cv::Point2f> prevPts_;
+
+    StreamMotionFilter filter_;
+};
+
 class VideoStabilizer
 {
 public:
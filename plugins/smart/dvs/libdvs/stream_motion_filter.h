@@ -0,0 +1,107 @@
+/*
+ * stream_motion_filter.h - causal trajectory filter of stream DVS
+ *
+ *    Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef _STREAM_MOTION_FILTER_H_
+#define _STREAM_MOTION_FILTER_H_
+
+#include <algorithm>
+
+// default noise of stream mode, shared by DvsConfig
+#define DVS_STREAM_PROCESS_NOISE  4e-3f
+#define DVS_STREAM_MEASURE_NOISE  0.25f
+
+/*
+ * smooths the accumulated camera trajectory by a 1-D Kalman filter per motion parameter,
+ * random walk model with one predict and update step per frame.
+ * no OpenCV dependency, so it can be checked without the stabilizer.
+ */
+class StreamMotionFilter
+{
+public:
+    enum {
+        ParamX = 0,
+        ParamY,
+        ParamAngle,
+        ParamScale,
+        ParamCount
+    };
+
+    explicit StreamMotionFilter(
+        float processNoise = DVS_STREAM_PROCESS_NOISE, float measureNoise = DVS_STREAM_MEASURE_NOISE)
+        : processNoise_ (processNoise)
+        , measureNoise_ (measureNoise)
+    {
+        reset();
+    }
+
+    void reset() {
+        for (int i = 0; i < ParamCount; ++i) {
+            trajectory_[i] = 0.0;
+            smoothed_[i] = 0.0;
+            errorCov_[i] = 1.0;
+        }
+    }
+
+    // larger processNoise follows camera motion faster, larger measureNoise smooths more
+    void setNoise(float processNoise, float measureNoise) {
+        if (processNoise > 0.0f)
+            processNoise_ = processNoise;
+        if (measureNoise > 0.0f)
+            measureNoise_ = measureNoise;
+    }
+
+    // accumulates @motion between last frame and this one, then filters the trajectory
+    void update(const double motion[ParamCount]) {
+        for (int i = 0; i < ParamCount; ++i) {
+            trajectory_[i] += motion[i];
+
+            double predCov = errorCov_[i] + processNoise_;
+            double gain = predCov / (predCov + measureNoise_);
+            smoothed_[i] += gain * (trajectory_[i] - smoothed_[i]);
+            errorCov_[i] = (1.0 - gain) * predCov;
+        }
+    }
+
+    // correction from trajectory to smoothed path, clamped to [-@maxDelta, @maxDelta],
+    // smoothed path follows the clamp so it never drifts out of range
+    double correction(int param, double maxDelta) {
+        double delta = std::max(-maxDelta, std::min(smoothed_[param] - trajectory_[param], maxDelta));
+        smoothed_[param] = trajectory_[param] + delta;
+        return delta;
+    }
+
+    double correction(int param) const {
+        return smoothed_[param] - trajectory_[param];
+    }
+
+    double trajectory(int param) const {
+        return trajectory_[param];
+    }
+
+private:
+    float processNoise_;
+    float measureNoise_;
+
+    double trajectory_[ParamCount];
+    double smoothed_[ParamCount];
+    double errorCov_[ParamCount];
+};
+
+#endif // _STREAM_MOTION_FILTER_H_
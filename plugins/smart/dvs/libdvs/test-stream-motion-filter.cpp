@@ -0,0 +1,133 @@
+/*
+ * test-stream-motion-filter.cpp - test trajectory smoothing of stream DVS
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "stream_motion_filter.h"
+
+#define TEST_FRAMES         600
+#define TEST_JITTER         3.0
+
+// uniform jitter in [-amplitude, amplitude], fixed seed
+static double
+nextJitter(unsigned int& state, double amplitude)
+{
+    state = state * 1103515245u + 12345u;
+    return amplitude * (((state >> 8) & 0xFFFF) / 32767.5 - 1.0);
+}
+
+// mean squared change of frame to frame motion of @path, first @skip frames settle the filter
+static double
+getRoughness(const std::vector<double>& path, size_t skip)
+{
+    double sum = 0.0;
+    for (size_t i = skip; i < path.size(); ++i) {
+        double accel = path[i] - 2.0 * path[i - 1] + path[i - 2];
+        sum += accel * accel;
+    }
+    return sum / (path.size() - skip);
+}
+
+// camera pans at @velocity pixels per frame with hand jitter,
+// output path is trajectory plus correction of each frame
+static int
+checkJitteredPan(double velocity)
+{
+    StreamMotionFilter filter;
+    std::vector<double> raw, stabilized;
+    unsigned int state = 1;
+    double lastPos = 0.0, maxCorrection = 0.0, maxDrift = 0.0;
+
+    for (int i = 0; i < TEST_FRAMES; ++i) {
+        double pos = velocity * i + nextJitter(state, TEST_JITTER);
+        double motion[StreamMotionFilter::ParamCount] = {0.0, 0.0, 0.0, 0.0};
+        motion[StreamMotionFilter::ParamX] = i ? pos - lastPos : 0.0;
+        lastPos = pos;
+
+        filter.update(motion);
+        double correction = filter.correction(StreamMotionFilter::ParamX, 1000.0);
+        double output = filter.trajectory(StreamMotionFilter::ParamX) + correction;
+
+        raw.push_back(filter.trajectory(StreamMotionFilter::ParamX));
+        stabilized.push_back(output);
+        if (i >= 100) {
+            maxCorrection = std::max(maxCorrection, fabs(correction));
+            maxDrift = std::max(maxDrift, fabs(output - velocity * i));
+        }
+
+        if (fabs(filter.correction(StreamMotionFilter::ParamY)) > 0.0) {
+            printf("pan %.1f: static parameter got correction\n", velocity);
+            return -1;
+        }
+    }
+
+    double rawRoughness = getRoughness(raw, 100);
+    double stabRoughness = getRoughness(stabilized, 100);
+    printf("pan %.1f px/frame: roughness raw %.3f stabilized %.4f, max correction %.2f, max drift from pan %.2f\n",
+           velocity, rawRoughness, stabRoughness, maxCorrection, maxDrift);
+
+    // jitter is smoothed out, intended pan is followed with a bounded lag
+    if (stabRoughness * 50.0 > rawRoughness) {
+        printf("pan %.1f: jitter was not smoothed\n", velocity);
+        return -1;
+    }
+    if (maxDrift > 8.0 * fabs(velocity) + 2.0 * TEST_JITTER) {
+        printf("pan %.1f: stabilized path does not follow the pan\n", velocity);
+        return -1;
+    }
+    return 0;
+}
+
+static int
+checkClamp()
+{
+    StreamMotionFilter filter;
+    double motion[StreamMotionFilter::ParamCount] = {40.0, 0.0, 0.0, 0.0};
+
+    // a sudden jump wants a large correction, it is clamped and smoothed path follows the clamp
+    filter.update(motion);
+    double clamped = filter.correction(StreamMotionFilter::ParamX, 5.0);
+    double after = filter.correction(StreamMotionFilter::ParamX);
+    printf("jump 40: correction %.2f clamped to %.2f\n", clamped, after);
+    if (fabs(clamped + 5.0) > 1e-9 || fabs(after + 5.0) > 1e-9) {
+        printf("jump correction was not clamped to 5\n");
+        return -1;
+    }
+
+    filter.reset();
+    if (filter.trajectory(StreamMotionFilter::ParamX) != 0.0 || filter.correction(StreamMotionFilter::ParamX) != 0.0) {
+        printf("reset did not clear the trajectory\n");
+        return -1;
+    }
+    return 0;
+}
+
+int main()
+{
+    if (checkJitteredPan(0.0) || checkJitteredPan(2.0) || checkJitteredPan(-1.5) || checkClamp()) {
+        printf("stream motion filter test failed\n");
+        return -1;
+    }
+
+    printf("stream motion filter test passed\n");
+    return 0;
+}
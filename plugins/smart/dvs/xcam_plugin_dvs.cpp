@@ -40,6 +40,18 @@
 
 #define DVS_MOTION_FILTER_RADIUS   15
 
+static DvsMode
+dvs_get_mode ()
+{
+    // one-pass stays default, XCAM_DVS_MODE=stream opts in to causal mode without radius frames delay
+    const char *mode = getenv ("XCAM_DVS_MODE");
+    if (mode && !strcasecmp (mode, "stream"))
+        return DVS_MODE_STREAM;
+    if (mode && !strcasecmp (mode, "two-pass"))
+        return DVS_MODE_TWO_PASS;
+    return DVS_MODE_ONE_PASS;
+}
+
 struct DvsBuffer : public DvsData
 {
     XCamVideoBuffer* buffer = NULL;
@@ -69,7 +81,7 @@ XCamReturn dvs_create_context(XCamSmartAnalysisContext **context, uint32_t *asyn
     if (theDVS == NULL) {
         return XCAM_RETURN_ERROR_MEM;
     }
-    theDVS->init(640, 480, false);
+    theDVS->init(640, 480, dvs_get_mode ());
 
     *context = (XCamSmartAnalysisContext *)theDVS;
 
@@ -205,6 +217,9 @@ XCamSmartAnalysisDescription xcam_smart_analysis_desciption =
     dvs_update_params,
     dvs_analyze,
     dvs_free_results,
+    0,
+    0,
+    1,
 };
 
 XCAM_END_DECLARE
@@ -444,7 +444,10 @@ XCamSmartAnalysisDescription xcam_smart_analysis_desciption = {
     xcam_destroy_context,
     xcam_update_params,
     xcam_analyze,
-    xcam_free_results
+    xcam_free_results,
+    0,
+    0,
+    1,
 };
 
 XCAM_END_DECLARE
@@ -0,0 +1,797 @@
+/*
+ * bench-soft.cpp - micro-benchmark of soft kernels
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "test_common.h"
+#include <soft/soft_video_buf_allocator.h>
+#include <soft/soft_worker.h>
+#include <soft/soft_image.h>
+#include <soft/soft_copy_task.h>
+#include <soft/soft_geo_tasks_priv.h>
+#include <soft/soft_blender_tasks_priv.h>
+#include <soft/soft_3a_stats_tasks_priv.h>
+#include <soft/soft_tnr_handler.h>
+#include <soft/soft_scaler.h>
+#include <soft/soft_tonemapping_handler.h>
+#include <soft/soft_bayer_pipe_handler.h>
+#include <soft/soft_defog_dcp_handler.h>
+#include <soft/soft_retinex_handler.h>
+#include <x3a_stats_pool.h>
+#include <thread_pool.h>
+#include <xcam_mutex.h>
+#include <sys/time.h>
+#include <vector>
+
+#define BENCH_ALIGNMENT_X 16
+#define BENCH_ALIGNMENT_Y 4
+
+#define BENCH_MAP_FACTOR 16
+#define BENCH_STATS_GRID 16
+
+// scale case makes half size and this extra output
+#define BENCH_SCALE_EXTRA_WIDTH 640
+#define BENCH_SCALE_EXTRA_HEIGHT 360
+
+using namespace XCam;
+using namespace XCamSoftTasks;
+
+enum BenchKernel {
+    BenchGeoMap = 0,
+    BenchGaussDownScale,
+    BenchLaplace,
+    BenchBlend,
+    BenchReconstruct,
+    BenchCopy,
+    BenchStats3a,
+    // handler cases from here, whole frames through handler
+    BenchTnr,
+    BenchScale,
+    BenchTonemapping,
+    BenchBayer,
+    BenchDcp,
+    BenchRetinex,
+    BenchKernelCount
+};
+
+static const char *kernel_names[BenchKernelCount] = {
+    "geomap", "gaussdownscale", "laplace", "blend", "reconstruct", "copy", "stats",
+    "tnr", "scale", "tonemapping", "bayer", "dcp", "retinex"
+};
+
+struct BenchSize {
+    uint32_t width;
+    uint32_t height;
+
+    BenchSize (uint32_t w = 0, uint32_t h = 0) : width (w), height (h) {}
+};
+
+struct BenchResult {
+    BenchKernel       kernel;
+    BenchSize         size;
+    BenchSize         threads;
+    WorkSize          work_unit;
+    WorkSize          global_size;
+    WorkSize          local_size;
+    uint32_t          iterations;
+    double            mean_us;
+    double            stddev_us;
+    double            min_us;
+    double            max_us;
+    double            mpix_per_sec;
+    double            ns_per_pixel;
+    double            ns_per_pixel_var;
+};
+typedef std::vector<BenchResult> BenchResults;
+
+class BenchSync
+    : public Worker::Callback
+{
+public:
+    BenchSync ()
+        : _done (false)
+        , _error (XCAM_RETURN_NO_ERROR)
+    {}
+
+    void reset () {
+        SmartLock locker (_mutex);
+        _done = false;
+        _error = XCAM_RETURN_NO_ERROR;
+    }
+
+    XCamReturn wait () {
+        SmartLock locker (_mutex);
+        while (!_done)
+            _cond.wait (_mutex);
+        return _error;
+    }
+
+protected:
+    void work_status (
+        const SmartPtr<Worker> &worker, const SmartPtr<Worker::Arguments> &args, const XCamReturn error) {
+        XCAM_UNUSED (worker);
+        XCAM_UNUSED (args);
+        SmartLock locker (_mutex);
+        _done = true;
+        _error = error;
+        _cond.broadcast ();
+    }
+
+private:
+    Mutex         _mutex;
+    Cond          _cond;
+    bool          _done;
+    XCamReturn    _error;
+};
+
+static SmartPtr<VideoBuffer>
+create_nv12_buf (uint32_t width, uint32_t height, uint32_t seed)
+{
+    VideoBufferInfo info;
+    info.init (
+        V4L2_PIX_FMT_NV12, width, height,
+        XCAM_ALIGN_UP (width, BENCH_ALIGNMENT_X), XCAM_ALIGN_UP (height, BENCH_ALIGNMENT_Y));
+
+    SmartPtr<BufferPool> pool = new SoftVideoBufAllocator (info);
+    XCAM_ASSERT (pool.ptr ());
+    if (!pool->reserve (1)) {
+        XCAM_LOG_ERROR ("bench-soft reserve buffer(w:%d, h:%d) failed", width, height);
+        return NULL;
+    }
+
+    SmartPtr<VideoBuffer> buf = pool->get_buffer (pool);
+    XCAM_ASSERT (buf.ptr ());
+
+    // synthetic content, gradient with pseudo-random noise
+    const VideoBufferInfo &buf_info = buf->get_video_info ();
+    uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+    uint32_t rand_state = seed * 2654435761u + 1;
+    for (uint32_t y = 0; y < buf_info.aligned_height; ++y) {
+        uint8_t *line = mem + buf_info.offsets[0] + y * buf_info.strides[0];
+        for (uint32_t x = 0; x < buf_info.strides[0]; ++x) {
+            rand_state = rand_state * 1103515245u + 12345u;
+            line[x] = (uint8_t)((x + y + seed) / 4 + ((rand_state >> 16) & 0x1F));
+        }
+    }
+    for (uint32_t y = 0; y < buf_info.aligned_height / 2; ++y) {
+        uint8_t *line = mem + buf_info.offsets[1] + y * buf_info.strides[1];
+        for (uint32_t x = 0; x < buf_info.strides[1]; ++x) {
+            rand_state = rand_state * 1103515245u + 12345u;
+            line[x] = (uint8_t)(112 + ((rand_state >> 16) & 0x1F));
+        }
+    }
+    buf->unmap ();
+
+    return buf;
+}
+
+// 10 bits BGGR raw in 16 bits storage, gradient with pseudo-random noise
+static SmartPtr<VideoBuffer>
+create_bayer_buf (uint32_t width, uint32_t height, uint32_t seed)
+{
+    VideoBufferInfo info;
+    info.init (V4L2_PIX_FMT_SBGGR10, width, height);
+
+    SmartPtr<BufferPool> pool = new SoftVideoBufAllocator (info);
+    XCAM_ASSERT (pool.ptr ());
+    if (!pool->reserve (1)) {
+        XCAM_LOG_ERROR ("bench-soft reserve bayer buffer(w:%d, h:%d) failed", width, height);
+        return NULL;
+    }
+
+    SmartPtr<VideoBuffer> buf = pool->get_buffer (pool);
+    XCAM_ASSERT (buf.ptr ());
+
+    const VideoBufferInfo &buf_info = buf->get_video_info ();
+    uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+    uint32_t rand_state = seed * 2654435761u + 1;
+    for (uint32_t y = 0; y < buf_info.height; ++y) {
+        uint16_t *line = (uint16_t *)(mem + buf_info.offsets[0] + y * buf_info.strides[0]);
+        for (uint32_t x = 0; x < buf_info.width; ++x) {
+            rand_state = rand_state * 1103515245u + 12345u;
+            line[x] = (uint16_t)(((x + y + seed) + ((rand_state >> 16) & 0x7F)) & 0x3FF);
+        }
+    }
+    buf->unmap ();
+
+    return buf;
+}
+
+static SmartPtr<UcharImage>
+create_mask (uint32_t width, uint32_t height)
+{
+    SmartPtr<UcharImage> mask = new UcharImage (width, height, XCAM_ALIGN_UP (width, BENCH_ALIGNMENT_X));
+    XCAM_ASSERT (mask.ptr () && mask->is_valid ());
+
+    for (uint32_t y = 0; y < height; ++y) {
+        Uchar *line = mask->get_buf_ptr (0, y);
+        for (uint32_t x = 0; x < mask->get_pitch (); ++x) {
+            line[x] = (Uchar)(x < width ? 255 - x * 255 / width : 0);
+        }
+    }
+    return mask;
+}
+
+static SmartPtr<Float2Image>
+create_lookup_table (uint32_t out_width, uint32_t out_height, uint32_t in_width, uint32_t in_height)
+{
+    uint32_t table_w = out_width / BENCH_MAP_FACTOR + 1;
+    uint32_t table_h = out_height / BENCH_MAP_FACTOR + 1;
+    SmartPtr<Float2Image> table = new Float2Image (table_w, table_h);
+    XCAM_ASSERT (table.ptr () && table->is_valid ());
+
+    // mild barrel distortion, keeps sampling positions inside input image
+    float cx = (in_width - 1.0f) / 2.0f, cy = (in_height - 1.0f) / 2.0f;
+    for (uint32_t y = 0; y < table_h; ++y) {
+        Float2 *line = table->get_buf_ptr (0, y);
+        for (uint32_t x = 0; x < table_w; ++x) {
+            float nx = x / (table_w - 1.0f) * 2.0f - 1.0f;
+            float ny = y / (table_h - 1.0f) * 2.0f - 1.0f;
+            float r = 1.0f - 0.1f * (nx * nx + ny * ny);
+            line[x].x = cx + nx * r * cx;
+            line[x].y = cy + ny * r * cy;
+        }
+    }
+    return table;
+}
+
+static BenchSize
+half_size (const BenchSize &size)
+{
+    return BenchSize (
+        XCAM_ALIGN_UP ((size.width + 1) / 2, SOFT_BLENDER_ALIGNMENT_X),
+        XCAM_ALIGN_UP ((size.height + 1) / 2, SOFT_BLENDER_ALIGNMENT_Y));
+}
+
+static void
+set_work_size (
+    const SmartPtr<SoftWorker> &worker, const BenchSize &threads,
+    uint32_t luma_width, uint32_t luma_height)
+{
+    WorkSize work_unit = worker->get_work_unit ();
+    WorkSize global_size (
+        xcam_ceil (luma_width, work_unit.value[0]) / work_unit.value[0],
+        xcam_ceil (luma_height, work_unit.value[1]) / work_unit.value[1]);
+    WorkSize local_size (
+        xcam_ceil (global_size.value[0], threads.width) / threads.width,
+        xcam_ceil (global_size.value[1], threads.height) / threads.height);
+
+    worker->set_local_size (local_size);
+    worker->set_global_size (global_size);
+}
+
+static SmartPtr<SoftWorker>
+create_kernel (
+    BenchKernel kernel, const BenchSize &size, const BenchSize &threads,
+    const SmartPtr<Worker::Callback> &cb, SmartPtr<Worker::Arguments> &out_args)
+{
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters ();
+    SmartPtr<SoftWorker> worker;
+
+    SmartPtr<VideoBuffer> in0 = create_nv12_buf (size.width, size.height, 0);
+    SmartPtr<VideoBuffer> in1 = create_nv12_buf (size.width, size.height, 1);
+    SmartPtr<VideoBuffer> out = create_nv12_buf (size.width, size.height, 2);
+    XCAM_FAIL_RETURN (
+        ERROR, in0.ptr () && in1.ptr () && out.ptr (), NULL,
+        "bench-soft create buffers failed");
+
+    switch (kernel) {
+    case BenchGeoMap: {
+        SmartPtr<GeoMapTask::Args> args = new GeoMapTask::Args (param);
+        args->in_luma = new UcharImage (in0, 0);
+        args->in_uv = new Uchar2Image (in0, 1);
+        args->out_luma = new UcharImage (out, 0);
+        args->out_uv = new Uchar2Image (out, 1);
+        args->lookup_table = create_lookup_table (size.width, size.height, size.width, size.height);
+        args->factors.x = (size.width - 1.0f) / (args->lookup_table->get_width () - 1.0f);
+        args->factors.y = (size.height - 1.0f) / (args->lookup_table->get_height () - 1.0f);
+
+        worker = new GeoMapTask (cb);
+        set_work_size (worker, threads, size.width, size.height);
+        out_args = args;
+        break;
+    }
+    case BenchGaussDownScale: {
+        BenchSize gauss_size = half_size (size);
+        SmartPtr<VideoBuffer> gauss = create_nv12_buf (gauss_size.width, gauss_size.height, 3);
+        SmartPtr<GaussDownScale::Args> args = new GaussDownScale::Args (param, 0, SoftBlender::Idx0, in0, gauss);
+        args->in_luma = new UcharImage (in0, 0);
+        args->in_uv = new Uchar2Image (in0, 1);
+        args->out_luma = new UcharImage (gauss, 0);
+        args->out_uv = new Uchar2Image (gauss, 1);
+
+        worker = new GaussDownScale (cb);
+        set_work_size (worker, threads, gauss_size.width, gauss_size.height);
+        out_args = args;
+        break;
+    }
+    case BenchLaplace: {
+        BenchSize gauss_size = half_size (size);
+        SmartPtr<VideoBuffer> gauss = create_nv12_buf (gauss_size.width, gauss_size.height, 3);
+        SmartPtr<LaplaceTask::Args> args = new LaplaceTask::Args (param, 0, SoftBlender::Idx0, out);
+        args->orig_luma = new UcharImage (in0, 0);
+        args->orig_uv = new Uchar2Image (in0, 1);
+        args->gauss_luma = new UcharImage (gauss, 0);
+        args->gauss_uv = new Uchar2Image (gauss, 1);
+        args->out_luma = new UcharImage (out, 0);
+        args->out_uv = new Uchar2Image (out, 1);
+
+        worker = new LaplaceTask (cb);
+        set_work_size (worker, threads, size.width, size.height);
+        out_args = args;
+        break;
+    }
+    case BenchBlend: {
+        SmartPtr<BlendTask::Args> args = new BlendTask::Args (param, create_mask (size.width, size.height), out);
+        args->in_luma[SoftBlender::Idx0] = new UcharImage (in0, 0);
+        args->in_uv[SoftBlender::Idx0] = new Uchar2Image (in0, 1);
+        args->in_luma[SoftBlender::Idx1] = new UcharImage (in1, 0);
+        args->in_uv[SoftBlender::Idx1] = new Uchar2Image (in1, 1);
+        args->out_luma = new UcharImage (out, 0);
+        args->out_uv = new Uchar2Image (out, 1);
+
+        worker = new BlendTask (cb);
+        set_work_size (worker, threads, size.width, size.height);
+        out_args = args;
+        break;
+    }
+    case BenchReconstruct: {
+        BenchSize gauss_size = half_size (size);
+        SmartPtr<VideoBuffer> gauss = create_nv12_buf (gauss_size.width, gauss_size.height, 3);
+        SmartPtr<ReconstructTask::Args> args = new ReconstructTask::Args (param, 0, out);
+        args->gauss_luma = new UcharImage (gauss, 0);
+        args->gauss_uv = new Uchar2Image (gauss, 1);
+        args->lap_luma[SoftBlender::Idx0] = new UcharImage (in0, 0);
+        args->lap_uv[SoftBlender::Idx0] = new Uchar2Image (in0, 1);
+        args->lap_luma[SoftBlender::Idx1] = new UcharImage (in1, 0);
+        args->lap_uv[SoftBlender::Idx1] = new Uchar2Image (in1, 1);
+        args->out_luma = new UcharImage (out, 0);
+        args->out_uv = new Uchar2Image (out, 1);
+        args->mask = create_mask (size.width, size.height);
+
+        worker = new ReconstructTask (cb);
+        set_work_size (worker, threads, size.width, size.height);
+        out_args = args;
+        break;
+    }
+    case BenchCopy: {
+        SmartPtr<CopyTask::Args> args = new CopyTask::Args (param);
+        args->in_luma = new UcharImage (in0, 0);
+        args->in_uv = new Uchar2Image (in0, 1);
+        args->out_luma = new UcharImage (out, 0);
+        args->out_uv = new Uchar2Image (out, 1);
+
+        // copy task works on 2 lines each unit, only split on y
+        worker = new CopyTask (cb);
+        WorkSize global_size (1, xcam_ceil (size.height, 2) / 2);
+        uint32_t thread_y = threads.width * threads.height;
+        WorkSize local_size (1, xcam_ceil (global_size.value[1], thread_y) / thread_y);
+        worker->set_local_size (local_size);
+        worker->set_global_size (global_size);
+        out_args = args;
+        break;
+    }
+    case BenchStats3a: {
+        SmartPtr<X3aStatsPool> pool = new X3aStatsPool ();
+        pool->set_grid_pixel_size (BENCH_STATS_GRID);
+        pool->set_video_info (in0->get_video_info ());
+        XCAM_FAIL_RETURN (
+            ERROR, pool->reserve (1), NULL,
+            "bench-soft reserve stats buffer failed");
+        SmartPtr<X3aStats> stats = pool->get_buffer ().dynamic_cast_ptr<X3aStats> ();
+        XCAM_ASSERT (stats.ptr ());
+
+        // param holds the stats buffer during benchmark
+        param->out_buf = stats;
+        SmartPtr<Stats3aNV12Task::Args> args = new Stats3aNV12Task::Args (param);
+        args->in_luma = new UcharImage (in0, 0);
+        args->in_uv = new Uchar2Image (in0, 1);
+        args->stats = stats->get_stats ();
+
+        worker = new Stats3aNV12Task (cb);
+        const XCam3AStatsInfo &info = args->stats->info;
+        WorkSize global_size (info.aligned_width, info.aligned_height);
+        WorkSize local_size (
+            xcam_ceil (global_size.value[0], threads.width) / threads.width,
+            xcam_ceil (global_size.value[1], threads.height) / threads.height);
+        worker->set_local_size (local_size);
+        worker->set_global_size (global_size);
+        out_args = args;
+        break;
+    }
+    default:
+        XCAM_LOG_ERROR ("bench-soft unsupported kernel:%d", kernel);
+        break;
+    }
+
+    return worker;
+}
+
+static inline int64_t
+get_time_us ()
+{
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+    return XCAM_TIMEVAL_2_USEC (tv);
+}
+
+// fills timing fields of @result, work sizes are set by caller
+static void
+set_result (
+    BenchKernel kernel, const BenchSize &size, const BenchSize &threads,
+    const std::vector<double> &times, BenchResult &result)
+{
+    double pixels = (double)size.width * size.height;
+    double sum = 0.0, sum_sq = 0.0, min_us = times[0], max_us = times[0];
+    for (uint32_t i = 0; i < times.size (); ++i) {
+        sum += times[i];
+        sum_sq += times[i] * times[i];
+        min_us = XCAM_MIN (min_us, times[i]);
+        max_us = XCAM_MAX (max_us, times[i]);
+    }
+    double mean = sum / times.size ();
+    double var = sum_sq / times.size () - mean * mean;
+    if (var < 0.0)
+        var = 0.0;
+
+    result.kernel = kernel;
+    result.size = size;
+    result.threads = threads;
+    result.iterations = times.size ();
+    result.mean_us = mean;
+    result.stddev_us = sqrt (var);
+    result.min_us = min_us;
+    result.max_us = max_us;
+    result.mpix_per_sec = pixels / mean;
+    result.ns_per_pixel = mean * 1000.0 / pixels;
+    result.ns_per_pixel_var = var * 1000000.0 / (pixels * pixels);
+}
+
+static XCamReturn
+run_kernel (
+    BenchKernel kernel, const BenchSize &size, const BenchSize &threads,
+    uint32_t warmup, uint32_t iterations, BenchResult &result)
+{
+    SmartPtr<BenchSync> sync = new BenchSync;
+    SmartPtr<Worker::Arguments> args;
+    SmartPtr<SoftWorker> worker = create_kernel (kernel, size, threads, sync, args);
+    XCAM_FAIL_RETURN (
+        ERROR, worker.ptr () && args.ptr (), XCAM_RETURN_ERROR_PARAM,
+        "bench-soft create kernel(%s) failed", kernel_names[kernel]);
+
+    std::vector<double> times;
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    for (uint32_t i = 0; i < warmup + iterations; ++i) {
+        sync->reset ();
+        int64_t start = get_time_us ();
+        ret = worker->work (args);
+        if (xcam_ret_is_ok (ret))
+            ret = sync->wait ();
+        int64_t end = get_time_us ();
+
+        XCAM_FAIL_RETURN (
+            ERROR, xcam_ret_is_ok (ret), ret,
+            "bench-soft kernel(%s) work failed", kernel_names[kernel]);
+        if (i >= warmup)
+            times.push_back ((double)(end - start));
+    }
+    worker->stop ();
+
+    result.work_unit = worker->get_work_unit ();
+    result.global_size = worker->get_global_size ();
+    result.local_size = worker->get_local_size ();
+    set_result (kernel, size, threads, times, result);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+static SmartPtr<SoftHandler>
+create_handler (BenchKernel kernel, const BenchSize &size, SmartPtr<VideoBuffer> &in)
+{
+    SmartPtr<SoftHandler> handler;
+    if (kernel == BenchBayer)
+        in = create_bayer_buf (size.width, size.height, 0);
+    else
+        in = create_nv12_buf (size.width, size.height, 0);
+    XCAM_FAIL_RETURN (
+        ERROR, in.ptr (), NULL,
+        "bench-soft create buffers failed");
+
+    switch (kernel) {
+    case BenchTnr:
+        handler = create_soft_tnr_handler ();
+        break;
+    case BenchScale: {
+        SmartPtr<SoftScaler> scaler = new SoftScaler (SoftScaleBicubic);
+        XCAM_ASSERT (scaler.ptr ());
+        scaler->set_output_size (XCAM_ALIGN_UP (size.width / 2, 2), XCAM_ALIGN_UP (size.height / 2, 2));
+        scaler->add_extra_output_size (BENCH_SCALE_EXTRA_WIDTH, BENCH_SCALE_EXTRA_HEIGHT);
+        handler = scaler;
+        break;
+    }
+    case BenchTonemapping:
+        handler = create_soft_tonemapping_handler ();
+        break;
+    case BenchBayer:
+        handler = create_soft_bayer_pipe_handler ();
+        break;
+    case BenchDcp:
+        handler = create_soft_defog_dcp_handler ();
+        break;
+    case BenchRetinex:
+        handler = create_soft_retinex_handler ();
+        break;
+    default:
+        XCAM_LOG_ERROR ("bench-soft unsupported handler:%d", kernel);
+        break;
+    }
+
+    return handler;
+}
+
+// params can not be reused, outputs come from handler pools
+static SmartPtr<ImageHandler::Parameters>
+create_handler_param (BenchKernel kernel, const SmartPtr<VideoBuffer> &in)
+{
+    if (kernel == BenchScale)
+        return new SoftScaler::ScaleParam (in);
+
+    return new ImageHandler::Parameters (in);
+}
+
+// handler runs on threads.width * threads.height threads, work sizes are chosen by handler
+static XCamReturn
+run_handler (
+    BenchKernel kernel, const BenchSize &size, const BenchSize &threads,
+    uint32_t warmup, uint32_t iterations, BenchResult &result)
+{
+    SmartPtr<VideoBuffer> in;
+    SmartPtr<SoftHandler> handler = create_handler (kernel, size, in);
+    XCAM_FAIL_RETURN (
+        ERROR, handler.ptr () && in.ptr (), XCAM_RETURN_ERROR_PARAM,
+        "bench-soft create handler(%s) failed", kernel_names[kernel]);
+
+    const uint32_t thread_count = threads.width * threads.height;
+    SmartPtr<ThreadPool> pool = new ThreadPool ("bench_soft_thrs");
+    XCAM_ASSERT (pool.ptr ());
+    pool->set_threads (thread_count, thread_count + 1);
+    handler->set_threads (pool);
+
+    std::vector<double> times;
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    for (uint32_t i = 0; i < warmup + iterations; ++i) {
+        SmartPtr<ImageHandler::Parameters> param = create_handler_param (kernel, in);
+        int64_t start = get_time_us ();
+        ret = handler->execute_buffer (param, true);
+        int64_t end = get_time_us ();
+
+        XCAM_FAIL_RETURN (
+            ERROR, xcam_ret_is_ok (ret), ret,
+            "bench-soft handler(%s) execute failed", kernel_names[kernel]);
+        if (i >= warmup)
+            times.push_back ((double)(end - start));
+    }
+    handler->terminate ();
+    pool->stop ();
+
+    result.work_unit = WorkSize (0, 0);
+    result.global_size = WorkSize (0, 0);
+    result.local_size = WorkSize (0, 0);
+    set_result (kernel, size, threads, times, result);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+static void
+print_result (const BenchResult &result)
+{
+    printf ("%-15s %5dx%-5d threads:%dx%d unit:%dx%d  mean:%10.1fus  stddev:%8.1fus  "
+            "%8.2f Mpix/s  %7.3f ns/pixel\n",
+            kernel_names[result.kernel], result.size.width, result.size.height,
+            result.threads.width, result.threads.height,
+            result.work_unit.value[0], result.work_unit.value[1],
+            result.mean_us, result.stddev_us, result.mpix_per_sec, result.ns_per_pixel);
+}
+
+static bool
+write_json (const char *file_name, const BenchResults &results)
+{
+    FILE *fp = fopen (file_name, "wb");
+    XCAM_FAIL_RETURN (
+        ERROR, fp, false,
+        "bench-soft open json file(%s) failed", file_name);
+
+    fprintf (fp, "{\n");
+    fprintf (fp, "  \"benchmark\": \"bench-soft\",\n");
+    fprintf (fp, "  \"workunit_pixels\": %d,\n", XCAM_SOFT_WORKUNIT_PIXELS);
+    fprintf (fp, "  \"results\": [\n");
+    for (uint32_t i = 0; i < results.size (); ++i) {
+        const BenchResult &r = results[i];
+        fprintf (fp, "    {\"kernel\": \"%s\", \"width\": %d, \"height\": %d, "
+                 "\"threads_x\": %d, \"threads_y\": %d, \"unit_x\": %d, \"unit_y\": %d, "
+                 "\"global_x\": %d, \"global_y\": %d, \"local_x\": %d, \"local_y\": %d, "
+                 "\"iterations\": %d, \"mean_us\": %.3f, \"stddev_us\": %.3f, "
+                 "\"min_us\": %.3f, \"max_us\": %.3f, \"mpix_per_sec\": %.3f, "
+                 "\"ns_per_pixel\": %.4f, \"ns_per_pixel_var\": %.6f}%s\n",
+                 kernel_names[r.kernel], r.size.width, r.size.height,
+                 r.threads.width, r.threads.height, r.work_unit.value[0], r.work_unit.value[1],
+                 r.global_size.value[0], r.global_size.value[1], r.local_size.value[0], r.local_size.value[1],
+                 r.iterations, r.mean_us, r.stddev_us,
+                 r.min_us, r.max_us, r.mpix_per_sec,
+                 r.ns_per_pixel, r.ns_per_pixel_var, (i + 1 < results.size ()) ? "," : "");
+    }
+    fprintf (fp, "  ]\n");
+    fprintf (fp, "}\n");
+    fclose (fp);
+
+    return true;
+}
+
+static bool
+parse_sizes (const char *str, std::vector<BenchSize> &sizes)
+{
+    sizes.clear ();
+    std::string list (str);
+    size_t start = 0;
+    while (start < list.size ()) {
+        size_t end = list.find (',', start);
+        if (end == std::string::npos)
+            end = list.size ();
+
+        uint32_t w = 0, h = 0;
+        std::string item = list.substr (start, end - start);
+        if (sscanf (item.c_str (), "%ux%u", &w, &h) != 2 || !w || !h) {
+            XCAM_LOG_ERROR ("bench-soft invalid size:%s", item.c_str ());
+            return false;
+        }
+        sizes.push_back (BenchSize (w, h));
+        start = end + 1;
+    }
+    return !sizes.empty ();
+}
+
+static void usage(const char* arg0)
+{
+    printf ("Usage:\n"
+            "%s --kernel KERNEL --res 1920x1080,3840x2160 --threads 1x1,2x2,4x4 ...\n"
+            "\t--kernel            optional, kernel to benchmark, select from\n"
+            "\t                    [all/geomap/gaussdownscale/laplace/blend/reconstruct/copy/stats/tnr/scale/\n"
+            "\t                    tonemapping/bayer/dcp/retinex], default: all\n"
+            "\t                    kernels after stats are handlers, run whole frames on x by y threads,\n"
+            "\t                    scale makes half size and 640x360 outputs in one pass,\n"
+            "\t                    bayer takes 10 bits BGGR input\n"
+            "\t--res               optional, comma-separated resolutions, default: 1280x800,1920x1080,3840x2160\n"
+            "\t--threads           optional, comma-separated thread grids(x by y), default: 1x1,2x2,4x4\n"
+            "\t--warmup            optional, warmup iterations before timing, default: 3\n"
+            "\t--iterations        optional, timed iterations, default: 20\n"
+            "\t--json              optional, save results into json file\n"
+            "\t--help              usage\n",
+            arg0);
+}
+
+int main (int argc, char *argv[])
+{
+    int32_t kernel_sel = -1;
+    std::vector<BenchSize> sizes;
+    std::vector<BenchSize> threads;
+    uint32_t warmup = 3;
+    uint32_t iterations = 20;
+    const char *json_file = NULL;
+
+    parse_sizes ("1280x800,1920x1080,3840x2160", sizes);
+    parse_sizes ("1x1,2x2,4x4", threads);
+
+    const struct option long_opts[] = {
+        {"kernel", required_argument, NULL, 'k'},
+        {"res", required_argument, NULL, 'r'},
+        {"threads", required_argument, NULL, 't'},
+        {"warmup", required_argument, NULL, 'w'},
+        {"iterations", required_argument, NULL, 'n'},
+        {"json", required_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'e'},
+        {NULL, 0, NULL, 0},
+    };
+
+    int opt = -1;
+    while ((opt = getopt_long(argc, argv, "", long_opts, NULL)) != -1) {
+        switch (opt) {
+        case 'k':
+            XCAM_ASSERT (optarg);
+            if (!strcasecmp (optarg, "all")) {
+                kernel_sel = -1;
+                break;
+            }
+            kernel_sel = BenchKernelCount;
+            for (int32_t i = 0; i < BenchKernelCount; ++i) {
+                if (!strcasecmp (optarg, kernel_names[i]))
+                    kernel_sel = i;
+            }
+            if (kernel_sel == BenchKernelCount) {
+                XCAM_LOG_ERROR ("unknown kernel:%s", optarg);
+                usage (argv[0]);
+                return -1;
+            }
+            break;
+        case 'r':
+            CHECK_EXP (parse_sizes (optarg, sizes), "invalid resolutions:%s", optarg);
+            break;
+        case 't':
+            CHECK_EXP (parse_sizes (optarg, threads), "invalid thread grids:%s", optarg);
+            break;
+        case 'w':
+            warmup = atoi (optarg);
+            break;
+        case 'n':
+            iterations = atoi (optarg);
+            break;
+        case 'j':
+            json_file = optarg;
+            break;
+        case 'e':
+            usage (argv[0]);
+            return 0;
+        default:
+            XCAM_LOG_ERROR ("getopt_long return unknown value:%c", opt);
+            usage (argv[0]);
+            return -1;
+        }
+    }
+
+    if (optind < argc) {
+        XCAM_LOG_ERROR ("unknown option %s", argv[optind]);
+        usage (argv[0]);
+        return -1;
+    }
+    CHECK_EXP (iterations > 0, "iterations must be greater than 0");
+
+    printf ("kernel:\t\t\t%s\n", kernel_sel < 0 ? "all" : kernel_names[kernel_sel]);
+    printf ("warmup:\t\t\t%d\n", warmup);
+    printf ("iterations:\t\t%d\n", iterations);
+    printf ("json file:\t\t%s\n", json_file ? json_file : "none");
+
+    BenchResults results;
+    for (int32_t k = 0; k < BenchKernelCount; ++k) {
+        if (kernel_sel >= 0 && kernel_sel != k)
+            continue;
+
+        for (uint32_t s = 0; s < sizes.size (); ++s) {
+            for (uint32_t t = 0; t < threads.size (); ++t) {
+                BenchResult result;
+                if (k >= BenchTnr) {
+                    CHECK (
+                        run_handler ((BenchKernel)k, sizes[s], threads[t], warmup, iterations, result),
+                        "bench-soft run handler(%s) failed", kernel_names[k]);
+                } else {
+                    CHECK (
+                        run_kernel ((BenchKernel)k, sizes[s], threads[t], warmup, iterations, result),
+                        "bench-soft run kernel(%s) failed", kernel_names[k]);
+                }
+                print_result (result);
+                results.push_back (result);
+            }
+        }
+    }
+
+    if (json_file) {
+        CHECK_EXP (write_json (json_file, results), "write json file(%s) failed", json_file);
+    }
+
+    return 0;
+}
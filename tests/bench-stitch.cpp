@@ -0,0 +1,740 @@
+/*
+ * bench-stitch.cpp - end-to-end stitching benchmark with synthetic scenes
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "test_common.h"
+#include <interface/stitcher.h>
+#include <soft/soft_video_buf_allocator.h>
+#include <fisheye_dewarp.h>
+#include <xcam_utils.h>
+#include <image_file_handle.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <algorithm>
+
+// synthetic scene sampling density, samples per degree
+#define BENCH_BOWL_SAMPLES_PER_DEGREE    8
+#define BENCH_HOLE_FILL_RANGE            4
+
+using namespace XCam;
+
+struct ModeConfig {
+    StitchResMode         res_mode;
+    const char           *name;
+    bool                  supported;
+    FisheyeDewarpMode     dewarp_mode;
+    StitchScopicMode      scopic_mode;
+    uint32_t              camera_num;
+    uint32_t              in_buf_num;
+    uint32_t              in_width, in_height;
+    uint32_t              out_width, out_height;
+    float                 fisheye_radius;
+    float                 viewpoints_range[XCAM_STITCH_MAX_CAMERAS];
+};
+
+static const ModeConfig mode_configs[] = {
+    {
+        StitchRes1080P2Cams, "1080p2cams", true, DewarpSphere, ScopicMono,
+        2, 1, 1920, 960, 1920, 960, 480.0f, {202.8f, 202.8f}
+    },
+    {
+        StitchRes1080P4Cams, "1080p4cams", true, DewarpBowl, ScopicMono,
+        4, 4, 1280, 800, 1920, 640, 0.0f, {64.0f, 160.0f, 64.0f, 160.0f}
+    },
+    {
+        StitchRes4K2Cams, "4k2cams", false, DewarpSphere, ScopicMono,
+        2, 2, 3840, 2160, 3840, 1920, 1080.0f, {202.8f, 202.8f}
+    },
+    {
+        StitchRes8K3Cams, "8k3cams", true, DewarpSphere, ScopicStereoLeft,
+        3, 3, 3840, 2880, 7680, 3840, 1984.0f, {144.0f, 144.0f, 144.0f}
+    },
+    {
+        StitchRes8K6Cams, "8k6cams", false, DewarpSphere, ScopicMono,
+        6, 6, 3840, 2160, 7680, 3840, 1080.0f, {72.0f, 72.0f, 72.0f, 72.0f, 72.0f, 72.0f}
+    },
+};
+
+struct BenchResult {
+    const ModeConfig     *mode;
+    bool                  skipped;
+    uint32_t              frames;
+    double                fps;
+    double                mean_ms;
+    double                p50_ms;
+    double                p99_ms;
+    double                max_ms;
+    double                geomap_ms;
+    double                blend_ms;
+    double                copy_ms;
+    double                fm_ms;
+    long                  peak_rss_kb;
+    double                setup_ms;
+};
+typedef std::vector<BenchResult> BenchResults;
+
+class NV12Canvas
+{
+public:
+    explicit NV12Canvas (const SmartPtr<VideoBuffer> &buf)
+        : _buf (buf)
+    {
+        const VideoBufferInfo &info = buf->get_video_info ();
+        _width = info.width;
+        _height = info.height;
+        _mem = buf->map ();
+        XCAM_ASSERT (_mem);
+        _luma = _mem + info.offsets[0];
+        _uv = _mem + info.offsets[1];
+        _luma_stride = info.strides[0];
+        _uv_stride = info.strides[1];
+        _written.resize (_width * _height, 0);
+    }
+    ~NV12Canvas () {
+        _buf->unmap ();
+    }
+
+    uint32_t get_width () const {
+        return _width;
+    }
+    uint32_t get_height () const {
+        return _height;
+    }
+
+    void put (float fx, float fy, uint8_t y, uint8_t u, uint8_t v) {
+        int32_t x = (int32_t)(fx + 0.5f), py = (int32_t)(fy + 0.5f);
+        if (x < 0 || py < 0 || x >= (int32_t)_width || py >= (int32_t)_height)
+            return;
+        _luma[py * _luma_stride + x] = y;
+        uint8_t *uv = _uv + (py / 2) * _uv_stride + (x / 2) * 2;
+        uv[0] = u;
+        uv[1] = v;
+        _written[py * _width + x] = 1;
+    }
+
+    // fill sampling holes from nearby samples, regions never seen become background
+    void fill_holes (uint8_t bg_y);
+
+private:
+    XCAM_DEAD_COPY (NV12Canvas);
+
+private:
+    SmartPtr<VideoBuffer>    _buf;
+    uint8_t                 *_mem;
+    uint8_t                 *_luma;
+    uint8_t                 *_uv;
+    uint32_t                 _width, _height;
+    uint32_t                 _luma_stride, _uv_stride;
+    std::vector<uint8_t>     _written;
+};
+
+void
+NV12Canvas::fill_holes (uint8_t bg_y)
+{
+    for (uint32_t y = 0; y < _height; ++y) {
+        uint8_t *line = _luma + y * _luma_stride;
+        uint8_t *mark = &_written[y * _width];
+        int32_t last = -BENCH_HOLE_FILL_RANGE - 1;
+        for (uint32_t x = 0; x < _width; ++x) {
+            if (mark[x] == 1) {
+                last = x;
+                continue;
+            }
+            if ((int32_t)x - last <= BENCH_HOLE_FILL_RANGE) {
+                line[x] = line[last];
+                mark[x] = 2;
+            }
+        }
+    }
+
+    for (uint32_t x = 0; x < _width; ++x) {
+        int32_t last = -BENCH_HOLE_FILL_RANGE - 1;
+        for (uint32_t y = 0; y < _height; ++y) {
+            uint8_t &mark = _written[y * _width + x];
+            if (mark) {
+                last = y;
+                continue;
+            }
+            if ((int32_t)y - last <= BENCH_HOLE_FILL_RANGE) {
+                _luma[y * _luma_stride + x] = _luma[last * _luma_stride + x];
+                mark = 2;
+            } else {
+                _luma[y * _luma_stride + x] = bg_y;
+                uint8_t *uv = _uv + (y / 2) * _uv_stride + (x / 2) * 2;
+                uv[0] = 128;
+                uv[1] = 128;
+            }
+        }
+    }
+}
+
+static inline uint8_t
+clamp_u8 (float value)
+{
+    return (uint8_t) XCAM_CLAMP (value, 0.0f, 255.0f);
+}
+
+// procedural bowl scene, checkerboard ground and striped wall
+static void
+bowl_scene (const PointFloat3 &world, uint8_t &y, uint8_t &u, uint8_t &v)
+{
+    if (world.z <= 1.0f) {
+        int32_t cell = (int32_t) floorf (world.x / 500.0f) + (int32_t) floorf (world.y / 500.0f);
+        float luma = (cell & 1) ? 190.0f : 70.0f;
+        luma += 20.0f * sinf (world.x / 37.0f) * sinf (world.y / 53.0f);
+        y = clamp_u8 (luma);
+        u = 118;
+        v = 124;
+    } else {
+        float angle = atan2f (world.y, world.x);
+        float degree = angle * 180.0f / XCAM_PI + 180.0f;
+        float luma = (((int32_t)(degree / 10.0f)) & 1) ? 150.0f : 90.0f;
+        luma += ((((int32_t)(world.z / 400.0f)) & 1) ? 20.0f : -20.0f);
+        luma += 10.0f * sinf (world.z / 29.0f);
+        y = clamp_u8 (luma);
+        u = clamp_u8 (128.0f + 40.0f * cosf (angle));
+        v = clamp_u8 (128.0f + 40.0f * sinf (angle));
+    }
+}
+
+// procedural sphere scene, longitude/latitude grid
+static void
+sphere_scene (float longitude, float latitude, uint8_t &y, uint8_t &u, uint8_t &v)
+{
+    int32_t cell = (int32_t) floorf (longitude / 10.0f) + (int32_t) floorf (latitude / 10.0f);
+    float luma = (cell & 1) ? 170.0f : 80.0f;
+    luma += 25.0f * sinf (degree2radian (longitude * 9.0f)) * cosf (degree2radian (latitude * 13.0f));
+    y = clamp_u8 (luma);
+    u = clamp_u8 (128.0f + 40.0f * cosf (degree2radian (longitude)));
+    v = clamp_u8 (128.0f + 40.0f * sinf (degree2radian (latitude * 2.0f)));
+}
+
+static BowlDataConfig
+bench_bowl_config ()
+{
+    BowlDataConfig bowl;
+    bowl.wall_height = 1800.0f;
+    bowl.ground_length = 3000.0f;
+    bowl.angle_start = 0.0f;
+    bowl.angle_end = 360.0f;
+    return bowl;
+}
+
+/*
+ * synthetic calibration of a car with front/right/rear/left cameras,
+ * equidistant fisheye lens with ~190 degree field of view, in bowl coordinates
+ */
+static CalibrationInfo
+bench_calibration (uint32_t idx, uint32_t width, uint32_t height)
+{
+    static const float trans[4][3] = {
+        {2000.0f, 0.0f, 800.0f}, {0.0f, -1000.0f, 1000.0f},
+        {-2200.0f, 0.0f, 900.0f}, {0.0f, 1000.0f, 1000.0f}
+    };
+    static const float yaw[4] = {0.0f, -90.0f, 180.0f, 90.0f};
+
+    CalibrationInfo calib;
+    calib.extrinsic.trans_x = trans[idx][0];
+    calib.extrinsic.trans_y = trans[idx][1];
+    calib.extrinsic.trans_z = trans[idx][2];
+    calib.extrinsic.roll = 0.0f;
+    calib.extrinsic.pitch = 30.0f;
+    calib.extrinsic.yaw = yaw[idx];
+
+    float focal = width / 2.0f / degree2radian (95.0f);
+    calib.intrinsic.xc = width / 2.0f;
+    calib.intrinsic.yc = height / 2.0f;
+    calib.intrinsic.c = 1.0f;
+    calib.intrinsic.d = 0.0f;
+    calib.intrinsic.e = 0.0f;
+    calib.intrinsic.poly_length = 2;
+    calib.intrinsic.poly_coeff[0] = focal * XCAM_PI / 2.0f;
+    calib.intrinsic.poly_coeff[1] = focal;
+
+    return calib;
+}
+
+static void
+synth_bowl_segment (
+    NV12Canvas &canvas, const CalibrationInfo &calib, const BowlDataConfig &bowl_cfg,
+    float angle_start, float angle_end)
+{
+    BowlDataConfig bowl = bowl_cfg;
+    bowl.angle_start = angle_start;
+    bowl.angle_end = angle_end;
+
+    uint32_t table_w = (uint32_t)((angle_end - angle_start) * BENCH_BOWL_SAMPLES_PER_DEGREE);
+    uint32_t table_h = canvas.get_height () * 3 / 2;
+    if (table_w < 2)
+        return;
+
+    PolyBowlFisheyeDewarp dewarper;
+    dewarper.set_intr_param (calib.intrinsic);
+    dewarper.set_extr_param (calib.extrinsic);
+    dewarper.set_bowl_config (bowl);
+    dewarper.set_out_size (table_w, table_h);
+    dewarper.set_table_size (table_w, table_h);
+
+    FisheyeDewarp::MapTable table (table_w * table_h);
+    dewarper.gen_table (table);
+
+    const ExtrinsicParameter &extr = calib.extrinsic;
+    float pitch = degree2radian (extr.pitch), yaw = degree2radian (extr.yaw);
+    PointFloat3 forward (cosf (yaw) * cosf (pitch), sinf (yaw) * cosf (pitch), -sinf (pitch));
+    // points more than 95 degree off the optical axis are invisible
+    float min_cos = cosf (degree2radian (95.0f));
+
+    uint8_t y, u, v;
+    for (uint32_t row = 0; row < table_h; ++row) {
+        for (uint32_t col = 0; col < table_w; ++col) {
+            PointFloat3 world = bowl_view_image_to_world (bowl, table_w, table_h, PointFloat2 (col, row));
+            PointFloat3 dir (world.x - extr.trans_x, world.y - extr.trans_y, world.z - extr.trans_z);
+            float len = sqrtf (dir.x * dir.x + dir.y * dir.y + dir.z * dir.z);
+            if (len < 1.0f ||
+                    (dir.x * forward.x + dir.y * forward.y + dir.z * forward.z) < min_cos * len)
+                continue;
+
+            bowl_scene (world, y, u, v);
+            const PointFloat2 &pos = table[row * table_w + col];
+            canvas.put (pos.x, pos.y, y, u, v);
+        }
+    }
+}
+
+static void
+synth_bowl_camera (
+    NV12Canvas &canvas, const CalibrationInfo &calib, const BowlDataConfig &bowl, float center_angle)
+{
+    // bowl angles are only valid in [0, 360), split the view at 0 degree
+    float start = center_angle - 100.0f;
+    float end = center_angle + 100.0f;
+    if (start < 0.0f) {
+        synth_bowl_segment (canvas, calib, bowl, start + 360.0f, 360.0f);
+        start = 0.0f;
+    }
+    if (end > 360.0f) {
+        synth_bowl_segment (canvas, calib, bowl, 0.0f, end - 360.0f);
+        end = 360.0f;
+    }
+    synth_bowl_segment (canvas, calib, bowl, start, end);
+}
+
+static void
+synth_sphere_camera (NV12Canvas &canvas, const FisheyeInfo &info, float center_longitude)
+{
+    const float range_lon = 220.0f, range_lat = 180.0f;
+    uint32_t samples = (uint32_t) ceilf (info.radius / 100.0f * 1.5f);
+    uint32_t table_w = (uint32_t)(range_lon * samples);
+    uint32_t table_h = (uint32_t)(range_lat * samples);
+
+    SphereFisheyeDewarp dewarper;
+    dewarper.set_fisheye_info (info);
+    dewarper.set_dst_range (range_lon, range_lat);
+    dewarper.set_table_size (table_w, table_h);
+
+    FisheyeDewarp::MapTable table (table_w * table_h);
+    dewarper.gen_table (table);
+
+    uint8_t y, u, v;
+    float max_dist2 = (info.radius - 0.5f) * (info.radius - 0.5f);
+    for (uint32_t row = 0; row < table_h; ++row) {
+        for (uint32_t col = 0; col < table_w; ++col) {
+            const PointFloat2 &pos = table[row * table_w + col];
+            float dx = pos.x - info.center_x, dy = pos.y - info.center_y;
+            if (dx * dx + dy * dy > max_dist2)
+                continue;
+
+            float longitude = center_longitude + (col - table_w / 2.0f) * range_lon / table_w;
+            float latitude = (row - table_h / 2.0f) * range_lat / table_h;
+            sphere_scene (longitude, latitude, y, u, v);
+            canvas.put (pos.x, pos.y, y, u, v);
+        }
+    }
+}
+
+static SmartPtr<VideoBuffer>
+create_nv12_buf (uint32_t width, uint32_t height)
+{
+    VideoBufferInfo info;
+    info.init (V4L2_PIX_FMT_NV12, width, height);
+
+    SmartPtr<BufferPool> pool = new SoftVideoBufAllocator (info);
+    XCAM_ASSERT (pool.ptr ());
+    XCAM_FAIL_RETURN (
+        ERROR, pool->reserve (1), NULL,
+        "bench-stitch reserve buffer(w:%d, h:%d) failed", width, height);
+
+    return pool->get_buffer (pool);
+}
+
+static XCamReturn
+synth_inputs (const ModeConfig &mode, VideoBufferList &in_bufs)
+{
+    in_bufs.clear ();
+
+    if (mode.dewarp_mode == DewarpBowl) {
+        BowlDataConfig bowl = bench_bowl_config ();
+        for (uint32_t i = 0; i < mode.camera_num; ++i) {
+            SmartPtr<VideoBuffer> buf = create_nv12_buf (mode.in_width, mode.in_height);
+            XCAM_FAIL_RETURN (ERROR, buf.ptr (), XCAM_RETURN_ERROR_MEM, "bench-stitch create input failed");
+
+            NV12Canvas canvas (buf);
+            CalibrationInfo calib = bench_calibration (i, mode.in_width, mode.in_height);
+            synth_bowl_camera (canvas, calib, bowl, i * 360.0f / mode.camera_num);
+            canvas.fill_holes (40);
+            in_bufs.push_back (buf);
+        }
+        return XCAM_RETURN_NO_ERROR;
+    }
+
+    // sphere modes, ideal fisheye lenses centered in each circle
+    uint32_t fisheye_per_buf = mode.camera_num / mode.in_buf_num;
+    uint32_t circle_width = mode.in_width / fisheye_per_buf;
+    for (uint32_t b = 0; b < mode.in_buf_num; ++b) {
+        SmartPtr<VideoBuffer> buf = create_nv12_buf (mode.in_width, mode.in_height);
+        XCAM_FAIL_RETURN (ERROR, buf.ptr (), XCAM_RETURN_ERROR_MEM, "bench-stitch create input failed");
+
+        NV12Canvas canvas (buf);
+        for (uint32_t f = 0; f < fisheye_per_buf; ++f) {
+            uint32_t idx = b * fisheye_per_buf + f;
+            FisheyeInfo info;
+            info.center_x = circle_width * f + circle_width / 2.0f;
+            info.center_y = mode.in_height / 2.0f;
+            info.radius = mode.fisheye_radius;
+            info.wide_angle = mode.viewpoints_range[idx] > 180.0f ? mode.viewpoints_range[idx] : 200.0f;
+            info.rotate_angle = (fisheye_per_buf > 1 && f == 0) ? -90.0f : 90.0f;
+
+            synth_sphere_camera (canvas, info, idx * 360.0f / mode.camera_num);
+        }
+        canvas.fill_holes (40);
+        in_bufs.push_back (buf);
+    }
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+static inline int64_t
+get_time_us ()
+{
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+    return XCAM_TIMEVAL_2_USEC (tv);
+}
+
+static void
+reset_peak_rss ()
+{
+    // supported since linux 4.0, ignore failures and fall back to process peak
+    FILE *fp = fopen ("/proc/self/clear_refs", "w");
+    if (fp) {
+        fputs ("5", fp);
+        fclose (fp);
+    }
+}
+
+static long
+get_peak_rss_kb ()
+{
+    long peak = -1;
+    char line[256];
+    FILE *fp = fopen ("/proc/self/status", "r");
+    if (fp) {
+        while (fgets (line, sizeof (line), fp)) {
+            if (!strncmp (line, "VmHWM:", 6)) {
+                peak = atol (line + 6);
+                break;
+            }
+        }
+        fclose (fp);
+    }
+
+    if (peak < 0) {
+        struct rusage usage;
+        getrusage (RUSAGE_SELF, &usage);
+        peak = usage.ru_maxrss;
+    }
+    return peak;
+}
+
+static double
+percentile (const std::vector<double> &sorted, double ratio)
+{
+    XCAM_ASSERT (!sorted.empty ());
+    uint32_t idx = (uint32_t)((sorted.size () - 1) * ratio + 0.5);
+    return sorted[XCAM_MIN (idx, sorted.size () - 1)];
+}
+
+static XCamReturn
+run_mode (
+    const ModeConfig &mode, uint32_t warmup, uint32_t frames,
+    uint32_t blend_pyr_levels, bool save, BenchResult &result)
+{
+    result.mode = &mode;
+    result.skipped = !mode.supported;
+    if (!mode.supported) {
+        printf ("%-12s skipped, unsupported by soft stitcher\n", mode.name);
+        return XCAM_RETURN_NO_ERROR;
+    }
+
+    reset_peak_rss ();
+    int64_t setup_start = get_time_us ();
+
+    VideoBufferList in_bufs;
+    XCamReturn ret = synth_inputs (mode, in_bufs);
+    XCAM_FAIL_RETURN (ERROR, xcam_ret_is_ok (ret), ret, "bench-stitch synthesize %s inputs failed", mode.name);
+
+    SmartPtr<VideoBuffer> out_buf = create_nv12_buf (mode.out_width, mode.out_height);
+    XCAM_FAIL_RETURN (ERROR, out_buf.ptr (), XCAM_RETURN_ERROR_MEM, "bench-stitch create output failed");
+
+    SmartPtr<Stitcher> stitcher = Stitcher::create_soft_stitcher ();
+    XCAM_ASSERT (stitcher.ptr ());
+    stitcher->set_camera_num (mode.camera_num);
+    stitcher->set_output_size (mode.out_width, mode.out_height);
+    stitcher->set_res_mode (mode.res_mode);
+    stitcher->set_dewarp_mode (mode.dewarp_mode);
+    stitcher->set_scopic_mode (mode.scopic_mode);
+    stitcher->set_blend_pyr_levels (blend_pyr_levels);
+    stitcher->set_viewpoints_range (mode.viewpoints_range);
+    if (mode.dewarp_mode == DewarpBowl) {
+        stitcher->set_bowl_config (bench_bowl_config ());
+        for (uint32_t i = 0; i < mode.camera_num; ++i)
+            stitcher->set_calibration_info (i, bench_calibration (i, mode.in_width, mode.in_height));
+    }
+
+    // first frame configures the stitcher, count it into setup time
+    ret = stitcher->stitch_buffers (in_bufs, out_buf);
+    XCAM_FAIL_RETURN (ERROR, xcam_ret_is_ok (ret), ret, "bench-stitch %s stitch buffers failed", mode.name);
+    result.setup_ms = (get_time_us () - setup_start) / 1000.0;
+
+    for (uint32_t i = 0; i < warmup; ++i) {
+        ret = stitcher->stitch_buffers (in_bufs, out_buf);
+        XCAM_FAIL_RETURN (ERROR, xcam_ret_is_ok (ret), ret, "bench-stitch %s stitch buffers failed", mode.name);
+    }
+
+    std::vector<double> latency;
+    double geomap = 0.0, blend = 0.0, copy = 0.0, fm = 0.0;
+    int64_t run_start = get_time_us ();
+    for (uint32_t i = 0; i < frames; ++i) {
+        int64_t start = get_time_us ();
+        ret = stitcher->stitch_buffers (in_bufs, out_buf);
+        int64_t end = get_time_us ();
+        XCAM_FAIL_RETURN (ERROR, xcam_ret_is_ok (ret), ret, "bench-stitch %s stitch buffers failed", mode.name);
+
+        latency.push_back ((end - start) / 1000.0);
+        const StitchStageTime &stage = stitcher->get_stage_time ();
+        geomap += stage.geomap / 1000.0;
+        blend += stage.blend / 1000.0;
+        copy += stage.copy / 1000.0;
+        fm += stage.feature_match / 1000.0;
+    }
+    double run_ms = (get_time_us () - run_start) / 1000.0;
+
+    if (save) {
+        char file_name[256] = {'\0'};
+        snprintf (file_name, 256, "bench-stitch-%s-%dx%d.nv12", mode.name, mode.out_width, mode.out_height);
+        ImageFileHandle file;
+        if (xcam_ret_is_ok (file.open (file_name, "wb")))
+            file.write_buf (out_buf);
+    }
+
+    std::sort (latency.begin (), latency.end ());
+    double sum = 0.0;
+    for (uint32_t i = 0; i < latency.size (); ++i)
+        sum += latency[i];
+
+    result.frames = frames;
+    result.fps = frames * 1000.0 / run_ms;
+    result.mean_ms = sum / frames;
+    result.p50_ms = percentile (latency, 0.5);
+    result.p99_ms = percentile (latency, 0.99);
+    result.max_ms = latency.back ();
+    result.geomap_ms = geomap / frames;
+    result.blend_ms = blend / frames;
+    result.copy_ms = copy / frames;
+    result.fm_ms = fm / frames;
+    result.peak_rss_kb = get_peak_rss_kb ();
+
+    printf ("%-12s %dx%d -> %dx%d  fps:%7.2f  mean:%8.2fms  p50:%8.2fms  p99:%8.2fms  peak rss:%ldKB\n"
+            "%-12s stages(end since frame start) geomap:%.2fms  blend:%.2fms  copy:%.2fms  feature match:%.2fms  setup:%.2fms\n",
+            mode.name, mode.in_width, mode.in_height, mode.out_width, mode.out_height,
+            result.fps, result.mean_ms, result.p50_ms, result.p99_ms, result.peak_rss_kb,
+            "", result.geomap_ms, result.blend_ms, result.copy_ms, result.fm_ms, result.setup_ms);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+static bool
+write_json (const char *file_name, const BenchResults &results)
+{
+    FILE *fp = fopen (file_name, "wb");
+    XCAM_FAIL_RETURN (
+        ERROR, fp, false,
+        "bench-stitch open json file(%s) failed", file_name);
+
+    fprintf (fp, "{\n");
+    fprintf (fp, "  \"benchmark\": \"bench-stitch\",\n");
+    fprintf (fp, "  \"results\": [\n");
+    for (uint32_t i = 0; i < results.size (); ++i) {
+        const BenchResult &r = results[i];
+        const char *end = (i + 1 < results.size ()) ? "," : "";
+        if (r.skipped) {
+            fprintf (fp, "    {\"res_mode\": \"%s\", \"skipped\": true}%s\n", r.mode->name, end);
+            continue;
+        }
+        fprintf (fp, "    {\"res_mode\": \"%s\", \"skipped\": false, \"cameras\": %d, "
+                 "\"in_width\": %d, \"in_height\": %d, \"out_width\": %d, \"out_height\": %d, "
+                 "\"frames\": %d, \"fps\": %.3f, \"mean_ms\": %.3f, \"p50_ms\": %.3f, \"p99_ms\": %.3f, "
+                 "\"max_ms\": %.3f, \"geomap_ms\": %.3f, \"blend_ms\": %.3f, \"copy_ms\": %.3f, "
+                 "\"feature_match_ms\": %.3f, \"setup_ms\": %.3f, \"peak_rss_kb\": %ld}%s\n",
+                 r.mode->name, r.mode->camera_num,
+                 r.mode->in_width, r.mode->in_height, r.mode->out_width, r.mode->out_height,
+                 r.frames, r.fps, r.mean_ms, r.p50_ms, r.p99_ms,
+                 r.max_ms, r.geomap_ms, r.blend_ms, r.copy_ms,
+                 r.fm_ms, r.setup_ms, r.peak_rss_kb, end);
+    }
+    fprintf (fp, "  ]\n");
+    fprintf (fp, "}\n");
+    fclose (fp);
+
+    return true;
+}
+
+static void usage(const char* arg0)
+{
+    printf ("Usage:\n"
+            "%s --res-mode 1080p2cams,1080p4cams --frames 100 ...\n"
+            "\t--res-mode          optional, comma-separated resolution modes, select from\n"
+            "\t                    [all/1080p2cams/1080p4cams/4k2cams/8k3cams/8k6cams], default: all\n"
+            "\t--frames            optional, timed frames of each mode, default: 60\n"
+            "\t--warmup            optional, warmup frames before timing, default: 5\n"
+            "\t--blend-pyr-levels  optional, the pyramid levels of blender, default: 2\n"
+            "\t--save              optional, save last stitched frame of each mode, select from [true/false], default: false\n"
+            "\t--json              optional, save results into json file\n"
+            "\t--help              usage\n",
+            arg0);
+}
+
+int main (int argc, char *argv[])
+{
+    const uint32_t mode_count = sizeof (mode_configs) / sizeof (mode_configs[0]);
+    bool selected[mode_count];
+    for (uint32_t i = 0; i < mode_count; ++i)
+        selected[i] = true;
+
+    uint32_t frames = 60;
+    uint32_t warmup = 5;
+    uint32_t blend_pyr_levels = 2;
+    bool save = false;
+    const char *json_file = NULL;
+
+    const struct option long_opts[] = {
+        {"res-mode", required_argument, NULL, 'R'},
+        {"frames", required_argument, NULL, 'n'},
+        {"warmup", required_argument, NULL, 'w'},
+        {"blend-pyr-levels", required_argument, NULL, 'b'},
+        {"save", required_argument, NULL, 's'},
+        {"json", required_argument, NULL, 'j'},
+        {"help", no_argument, NULL, 'e'},
+        {NULL, 0, NULL, 0},
+    };
+
+    int opt = -1;
+    while ((opt = getopt_long(argc, argv, "", long_opts, NULL)) != -1) {
+        switch (opt) {
+        case 'R': {
+            XCAM_ASSERT (optarg);
+            if (!strcasecmp (optarg, "all"))
+                break;
+
+            for (uint32_t i = 0; i < mode_count; ++i)
+                selected[i] = false;
+
+            char *saveptr = NULL;
+            for (char *name = strtok_r (optarg, ",", &saveptr); name; name = strtok_r (NULL, ",", &saveptr)) {
+                uint32_t i = 0;
+                for (; i < mode_count; ++i) {
+                    if (!strcasecmp (name, mode_configs[i].name))
+                        break;
+                }
+                if (i == mode_count) {
+                    XCAM_LOG_ERROR ("unknown resolution mode:%s", name);
+                    usage (argv[0]);
+                    return -1;
+                }
+                selected[i] = true;
+            }
+            break;
+        }
+        case 'n':
+            frames = atoi (optarg);
+            break;
+        case 'w':
+            warmup = atoi (optarg);
+            break;
+        case 'b':
+            blend_pyr_levels = atoi (optarg);
+            break;
+        case 's':
+            save = (strcasecmp (optarg, "false") == 0 ? false : true);
+            break;
+        case 'j':
+            json_file = optarg;
+            break;
+        case 'e':
+            usage (argv[0]);
+            return 0;
+        default:
+            XCAM_LOG_ERROR ("getopt_long return unknown value:%c", opt);
+            usage (argv[0]);
+            return -1;
+        }
+    }
+
+    if (optind < argc) {
+        XCAM_LOG_ERROR ("unknown option %s", argv[optind]);
+        usage (argv[0]);
+        return -1;
+    }
+    CHECK_EXP (frames > 0, "frames must be greater than 0");
+
+    printf ("frames:\t\t\t%d\n", frames);
+    printf ("warmup:\t\t\t%d\n", warmup);
+    printf ("blend pyr levels:\t%d\n", blend_pyr_levels);
+    printf ("save output:\t\t%s\n", save ? "true" : "false");
+    printf ("json file:\t\t%s\n", json_file ? json_file : "none");
+
+    BenchResults results;
+    for (uint32_t i = 0; i < mode_count; ++i) {
+        if (!selected[i])
+            continue;
+
+        BenchResult result;
+        xcam_mem_clear (result);
+        CHECK (
+            run_mode (mode_configs[i], warmup, frames, blend_pyr_levels, save, result),
+            "bench-stitch run mode(%s) failed", mode_configs[i].name);
+        results.push_back (result);
+    }
+
+    if (json_file) {
+        CHECK_EXP (write_json (json_file, results), "write json file(%s) failed", json_file);
+    }
+
+    return 0;
+}
@@ -46,6 +46,11 @@
 #include "drm_display.h"
 #endif
 #include "fake_poll_thread.h"
+#include "soft/soft_downscaler.h"
+#include "soft/soft_post_image_processor.h"
+#include "soft/soft_video_buf_allocator.h"
+#include "soft/soft_wavelet_denoise_handler.h"
+#include "soft/soft_3d_denoise_handler.h"
 #include "image_file_handle.h"
 #include <base/xcam_3a_types.h>
 #include <unistd.h>
@@ -63,6 +68,14 @@ static Mutex g_mutex;
 static Cond  g_cond;
 static bool  g_stop = false;
 
+#if HAVE_LIBCL
+static SmartPtr<ImageHandler>
+create_smart_scaler (uint32_t width, uint32_t height)
+{
+    return create_soft_downscaler (width, height);
+}
+#endif
+
 class MainDeviceManager
     : public DeviceManager
 {
@@ -250,6 +263,50 @@ void dev_stop_handler(int sig)
     //exit(0);
 }
 
+static SmartPtr<SoftPostImageProcessor>
+create_soft_post_processor (const std::string &stages)
+{
+    SmartPtr<SoftPostImageProcessor> processor = new SoftPostImageProcessor ();
+    XCAM_ASSERT (processor.ptr ());
+
+    size_t start = 0;
+    while (start < stages.size ()) {
+        size_t end = stages.find (',', start);
+        if (end == std::string::npos)
+            end = stages.size ();
+
+        std::string stage = stages.substr (start, end - start);
+        if (stage == "none")
+            ;
+        else if (stage == "tnr")
+            processor->set_tnr (SoftPostImageProcessor::TnrYuv);
+        else if (stage == "retinex")
+            processor->set_defog_mode (SoftPostImageProcessor::DefogRetinex);
+        else if (stage == "dcp")
+            processor->set_defog_mode (SoftPostImageProcessor::DefogDarkChannelPrior);
+        else if (stage == "wavelet")
+            processor->set_wavelet (
+                SoftPostImageProcessor::WaveletHaar,
+                XCAM_SOFT_WAVELET_CHANNEL_Y | XCAM_SOFT_WAVELET_CHANNEL_UV, false);
+        else if (stage == "3d-denoise")
+            processor->set_3ddenoise_mode (
+                SoftPostImageProcessor::Denoise3DYuv, XCAM_SOFT_3D_DENOISE_DEFAULT_REF_COUNT);
+        else if (stage == "tonemapping")
+            processor->set_tonemapping (true);
+        else if (stage == "wireframe")
+            processor->set_wireframe (true);
+        else if (stage == "warp")
+            processor->set_image_warp (true);
+        else {
+            XCAM_LOG_ERROR ("unknown soft post stage:%s", stage.c_str ());
+            return NULL;
+        }
+        start = end + 1;
+    }
+
+    return processor;
+}
+
 void print_help (const char *bin_name)
 {
     printf ("Usage: %s [-a analyzer]\n"
@@ -281,6 +338,9 @@ void print_help (const char *bin_name)
             "\t                 select from [primary, overlay], default is [primary]\n"
             "\t --sync          set analyzer in sync mode\n"
             "\t -r raw_input    specify the path of raw image as fake source instead of live camera\n"
+            "\t --soft-post     process image with soft post image processor on CPU, replaces cl post image processor\n"
+            "\t                 comma-separated stages select from [none, tnr, retinex, dcp, wavelet, 3d-denoise,\n"
+            "\t                 tonemapping, wireframe, warp], NV12 and bayer input are supported\n"
             "\t -h              help\n"
 #if HAVE_LIBCL
             "CL features:\n"
@@ -306,6 +366,7 @@ void print_help (const char *bin_name)
             "\t --pipeline      specify pipe mode\n"
             "\t                 select from [basic, advance, extreme], default is [basic]\n"
             "\t --disable-post  disable cl post image processor\n"
+            "\t --smart-parallel  run smart analysis plugins in parallel\n"
 #endif
             , bin_name
             , DEFAULT_SAVE_FILE_NAME);
@@ -327,6 +388,7 @@ int main (int argc, char *argv[])
 #if HAVE_LIBCL
     bool have_cl_processor = false;
     SmartPtr<SmartAnalyzer> smart_analyzer;
+    bool smart_parallel = false;
     bool have_cl_post_processor = true;
     uint32_t tnr_type = CL_TNR_DISABLE;
     uint32_t denoise_type = 0;
@@ -348,6 +410,9 @@ int main (int argc, char *argv[])
     bool image_warp_type = false;
 #endif
 
+    bool have_soft_post_processor = false;
+    std::string soft_post_stages;
+
     bool need_display = false;
 #if HAVE_LIBDRM
     DrmDisplayMode display_mode = DRM_DISPLAY_MODE_PRIMARY;
@@ -385,6 +450,8 @@ int main (int argc, char *argv[])
         {"capture", required_argument, NULL, 'C'},
         {"pipeline", required_argument, NULL, 'P'},
         {"disable-post", no_argument, NULL, 'O'},
+        {"smart-parallel", no_argument, NULL, 'S'},
+        {"soft-post", required_argument, NULL, 'Q'},
         {0, 0, 0, 0},
     };
 
@@ -628,7 +695,20 @@ int main (int argc, char *argv[])
             have_cl_post_processor = false;
             break;
         }
+        case 'S': {
+            smart_parallel = true;
+            break;
+        }
+#endif
+        case 'Q': {
+            XCAM_ASSERT (optarg);
+            have_soft_post_processor = true;
+            soft_post_stages = optarg;
+#if HAVE_LIBCL
+            have_cl_post_processor = false;
 #endif
+            break;
+        }
         case 'r': {
             XCAM_ASSERT (optarg);
             XCAM_LOG_INFO ("use raw image %s as input source", optarg);
@@ -736,6 +816,8 @@ int main (int argc, char *argv[])
                 XCAM_ASSERT ((*i_handler).ptr ());
                 smart_analyzer->add_handler (*i_handler);
             }
+            smart_analyzer->set_parallel_mode (smart_parallel);
+            smart_analyzer->set_scaler_creator (create_smart_scaler);
         } else {
             XCAM_LOG_WARNING ("load smart analyzer(%s) failed, please check.", DEFAULT_SMART_ANALYSIS_LIB_DIR);
         }
@@ -874,11 +956,38 @@ int main (int argc, char *argv[])
     }
 #endif
 
+    if (have_soft_post_processor) {
+        SmartPtr<SoftPostImageProcessor> soft_post_processor = create_soft_post_processor (soft_post_stages);
+        if (!soft_post_processor.ptr ()) {
+            print_help (bin_name);
+            return -1;
+        }
+        soft_post_processor->set_stats_callback (device_manager);
+#if HAVE_LIBCL
+        if (smart_analyzer.ptr ()) {
+            soft_post_processor->set_scaler (true);
+            soft_post_processor->set_scaler_factor (640.0 / frame_width);
+        }
+#endif
+
+        if (need_display) {
+            need_display = false;
+            XCAM_LOG_WARNING ("soft post image processor doesn't support local preview, disable local preview now");
+        }
+        device_manager->enable_display (need_display);
+
+        device_manager->add_image_processor (soft_post_processor);
+    }
+
     SmartPtr<PollThread> poll_thread;
     if (have_usbcam) {
         poll_thread = new PollThread ();
     } else if (path_to_fake.c_str ()) {
-        poll_thread = new FakePollThread (path_to_fake.c_str ());
+        SmartPtr<FakePollThread> fake_poll_thread = new FakePollThread (path_to_fake.c_str ());
+        // without drm bo, raw frames are read into soft buffers
+        if (have_soft_post_processor)
+            fake_poll_thread->set_buf_pool (new SoftVideoBufAllocator ());
+        poll_thread = fake_poll_thread;
     }
 #if HAVE_IA_AIQ
     else {
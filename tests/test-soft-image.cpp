@@ -22,8 +22,25 @@
 #include "test_inline.h"
 #include "test_stream.h"
 #include <soft/soft_video_buf_allocator.h>
+#include <soft/soft_handler.h>
+#include <soft/soft_tnr_handler.h>
+#include <soft/soft_wavelet_denoise_handler.h>
+#include <soft/soft_scaler.h>
+#include <soft/soft_tonemapping_handler.h>
+#include <soft/soft_3d_denoise_handler.h>
+#include <soft/soft_csc.h>
+#include <soft/soft_csc_tasks_priv.h>
+#include <soft/soft_bayer_pipe_handler.h>
+#include <soft/soft_3a_stats.h>
+#include <soft/soft_downscaler.h>
+#include <soft/soft_feature_match.h>
+#include <soft/soft_video_stabilizer.h>
+#include <soft/soft_defog_dcp_handler.h>
+#include <soft/soft_retinex_handler.h>
 #include <interface/blender.h>
 #include <interface/geo_mapper.h>
+#include <interface/stitch_quality.h>
+#include <math.h>
 
 #define MAP_WIDTH 3
 #define MAP_HEIGHT 4
@@ -40,9 +57,26 @@ using namespace XCam;
 enum SoftType {
     SoftTypeNone    = 0,
     SoftTypeBlender,
-    SoftTypeRemap
+    SoftTypeRemap,
+    SoftTypeTnr,
+    SoftTypeWavelet,
+    SoftTypeScale,
+    SoftTypeTonemapping,
+    SoftType3DDenoise,
+    SoftTypeCsc,
+    SoftTypeBayer,
+    SoftTypeStitchQuality,
+    SoftType3aStats,
+    SoftTypeDownscale,
+    SoftTypeFeatureMatch,
+    SoftTypeVideoStab,
+    SoftTypeDcp,
+    SoftTypeRetinex,
 };
 
+#define CHECK_WIDTH 640
+#define CHECK_HEIGHT 480
+
 class SoftStream
     : public Stream
 {
@@ -51,14 +85,21 @@ public:
     virtual ~SoftStream () {}
 
     virtual XCamReturn create_buf_pool (uint32_t reserve_count);
+    void set_format (uint32_t format) {
+        _format = format;
+    }
 
 private:
     XCAM_DEAD_COPY (SoftStream);
+
+private:
+    uint32_t    _format;
 };
 typedef std::vector<SmartPtr<SoftStream>> SoftStreams;
 
 SoftStream::SoftStream (const char *file_name, uint32_t width, uint32_t height)
     :  Stream (file_name, width, height)
+    , _format (V4L2_PIX_FMT_NV12)
 {
 }
 
@@ -68,7 +109,7 @@ SoftStream::create_buf_pool (uint32_t reserve_count)
     XCAM_ASSERT (get_width () && get_height ());
 
     VideoBufferInfo info;
-    info.init (V4L2_PIX_FMT_NV12, get_width (), get_height ());
+    info.init (_format, get_width (), get_height ());
 
     SmartPtr<BufferPool> pool = new SoftVideoBufAllocator ();
     XCAM_ASSERT (pool.ptr ());
@@ -81,20 +122,1370 @@ SoftStream::create_buf_pool (uint32_t reserve_count)
     return XCAM_RETURN_NO_ERROR;
 }
 
+static SmartPtr<BufferPool>
+create_check_pool (uint32_t format, uint32_t width, uint32_t height, uint32_t count)
+{
+    VideoBufferInfo info;
+    info.init (format, width, height);
+
+    SmartPtr<BufferPool> pool = new SoftVideoBufAllocator (info);
+    XCAM_ASSERT (pool.ptr ());
+    if (!pool->reserve (count)) {
+        XCAM_LOG_ERROR ("reserve check buffers failed");
+        return NULL;
+    }
+    return pool;
+}
+
+// pseudo gaussian noise of unit variance, sum of 4 uniforms
+static inline float
+get_noise (uint32_t &state)
+{
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < 4; ++i) {
+        state = state * 1103515245u + 12345u;
+        sum += ((state >> 8) & 0xFFFF) / 65535.0f;
+    }
+    return (sum - 2.0f) * sqrtf (3.0f);
+}
+
+// smooth gradients on NV12 plus noise of @sigma levels, same @seed same noise
+static void
+fill_check_nv12 (const SmartPtr<VideoBuffer> &buf, float sigma, uint32_t seed)
+{
+    const VideoBufferInfo &info = buf->get_video_info ();
+    uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+
+    uint32_t state = seed * 2654435761u + 1;
+    for (uint32_t y = 0; y < info.height; ++y) {
+        uint8_t *line = mem + info.offsets[0] + y * info.strides[0];
+        for (uint32_t x = 0; x < info.width; ++x) {
+            const float value = 64.0f + 128.0f * (x + y) / (info.width + info.height);
+            line[x] = (uint8_t)XCAM_CLAMP (value + sigma * get_noise (state) + 0.5f, 0.0f, 255.0f);
+        }
+    }
+    for (uint32_t y = 0; y < info.height / 2; ++y) {
+        uint8_t *line = mem + info.offsets[1] + y * info.strides[1];
+        for (uint32_t x = 0; x < info.width; x += 2) {
+            const float u = 96.0f + 64.0f * x / info.width;
+            const float v = 160.0f - 64.0f * y * 2 / info.height;
+            line[x] = (uint8_t)XCAM_CLAMP (u + sigma * get_noise (state) + 0.5f, 0.0f, 255.0f);
+            line[x + 1] = (uint8_t)XCAM_CLAMP (v + sigma * get_noise (state) + 0.5f, 0.0f, 255.0f);
+        }
+    }
+    buf->unmap ();
+}
+
+static void
+fill_const_nv12 (const SmartPtr<VideoBuffer> &buf, uint8_t y_value, uint8_t u_value, uint8_t v_value)
+{
+    const VideoBufferInfo &info = buf->get_video_info ();
+    uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+
+    for (uint32_t y = 0; y < info.height; ++y)
+        memset (mem + info.offsets[0] + y * info.strides[0], y_value, info.width);
+    for (uint32_t y = 0; y < info.height / 2; ++y) {
+        uint8_t *line = mem + info.offsets[1] + y * info.strides[1];
+        for (uint32_t x = 0; x < info.width; x += 2) {
+            line[x] = u_value;
+            line[x + 1] = v_value;
+        }
+    }
+    buf->unmap ();
+}
+
+// max abs difference of NV12 @buf to constant color
+static uint32_t
+get_const_nv12_diff (const SmartPtr<VideoBuffer> &buf, uint8_t y_value, uint8_t u_value, uint8_t v_value)
+{
+    const VideoBufferInfo &info = buf->get_video_info ();
+    const uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+
+    uint32_t max_diff = 0;
+    for (uint32_t y = 0; y < info.height; ++y) {
+        const uint8_t *line = mem + info.offsets[0] + y * info.strides[0];
+        for (uint32_t x = 0; x < info.width; ++x)
+            max_diff = XCAM_MAX (max_diff, (uint32_t)abs ((int32_t)line[x] - y_value));
+    }
+    for (uint32_t y = 0; y < info.height / 2; ++y) {
+        const uint8_t *line = mem + info.offsets[1] + y * info.strides[1];
+        for (uint32_t x = 0; x < info.width; x += 2) {
+            max_diff = XCAM_MAX (max_diff, (uint32_t)abs ((int32_t)line[x] - u_value));
+            max_diff = XCAM_MAX (max_diff, (uint32_t)abs ((int32_t)line[x + 1] - v_value));
+        }
+    }
+    buf->unmap ();
+
+    return max_diff;
+}
+
+// mean squared error and max abs difference of one plane
+static double
+get_plane_mse (
+    const SmartPtr<VideoBuffer> &buf0, const SmartPtr<VideoBuffer> &buf1, uint32_t plane,
+    uint32_t *max_diff = NULL)
+{
+    const VideoBufferInfo &info0 = buf0->get_video_info ();
+    const VideoBufferInfo &info1 = buf1->get_video_info ();
+    VideoBufferPlanarInfo planar;
+    info0.get_planar_info (planar, plane);
+    const uint32_t line_bytes = planar.width * planar.pixel_bytes;
+
+    const uint8_t *mem0 = buf0->map ();
+    const uint8_t *mem1 = buf1->map ();
+    XCAM_ASSERT (mem0 && mem1);
+
+    double sum = 0.0;
+    uint32_t max_value = 0;
+    for (uint32_t y = 0; y < planar.height; ++y) {
+        const uint8_t *line0 = mem0 + info0.offsets[plane] + y * info0.strides[plane];
+        const uint8_t *line1 = mem1 + info1.offsets[plane] + y * info1.strides[plane];
+        for (uint32_t x = 0; x < line_bytes; ++x) {
+            const int32_t diff = (int32_t)line0[x] - line1[x];
+            sum += diff * diff;
+            max_value = XCAM_MAX (max_value, (uint32_t)abs (diff));
+        }
+    }
+    buf0->unmap ();
+    buf1->unmap ();
+
+    if (max_diff)
+        *max_diff = max_value;
+    return sum / (line_bytes * planar.height);
+}
+
+static int
+check_tnr ()
+{
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, 4);
+    CHECK_EXP (pool.ptr (), "tnr check create buffer pool failed");
+    SmartPtr<VideoBuffer> clean = pool->get_buffer (pool);
+    fill_check_nv12 (clean, 0.0f, 0);
+
+    // static input converges to input
+    SmartPtr<SoftHandler> tnr = create_soft_tnr_handler ();
+    XCAM_ASSERT (tnr.ptr ());
+    SmartPtr<ImageHandler::Parameters> param;
+    for (uint32_t i = 0; i < 8; ++i) {
+        param = new ImageHandler::Parameters (clean);
+        CHECK (tnr->execute_buffer (param, true), "tnr check denoise static frame(%d) failed", i);
+    }
+    uint32_t max_y = 0, max_uv = 0;
+    get_plane_mse (param->out_buf, clean, 0, &max_y);
+    get_plane_mse (param->out_buf, clean, 1, &max_uv);
+    printf ("tnr static input, max diff y:%d uv:%d\n", max_y, max_uv);
+    CHECK_EXP (max_y <= 1 && max_uv <= 1, "tnr check static input does not converge to input");
+    tnr->terminate ();
+
+    // noise variance drops on a noisy static scene
+    tnr = create_soft_tnr_handler ();
+    XCAM_ASSERT (tnr.ptr ());
+    double in_mse = 0.0, out_mse = 0.0;
+    for (uint32_t i = 0; i < 8; ++i) {
+        SmartPtr<VideoBuffer> noisy = pool->get_buffer (pool);
+        fill_check_nv12 (noisy, 4.0f, i + 1);
+        param = new ImageHandler::Parameters (noisy);
+        CHECK (tnr->execute_buffer (param, true), "tnr check denoise noisy frame(%d) failed", i);
+        in_mse = get_plane_mse (noisy, clean, 0);
+        out_mse = get_plane_mse (param->out_buf, clean, 0);
+    }
+    printf ("tnr noisy input, luma noise variance in:%.2f out:%.2f\n", in_mse, out_mse);
+    CHECK_EXP (out_mse < in_mse * 0.6, "tnr check noise variance does not drop");
+    tnr->terminate ();
+
+    return 0;
+}
+
+static inline double
+get_psnr (double mse)
+{
+    return 10.0 * log10 (255.0 * 255.0 / XCAM_MAX (mse, 1e-6));
+}
+
+static int
+check_wavelet ()
+{
+    static const char *basis_names[] = {"haar", "cdf53"};
+    static const SoftWaveletBasis bases[] = {SoftWaveletHaar, SoftWaveletCdf53};
+
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, 2);
+    CHECK_EXP (pool.ptr (), "wavelet check create buffer pool failed");
+    SmartPtr<VideoBuffer> clean = pool->get_buffer (pool);
+    SmartPtr<VideoBuffer> noisy = pool->get_buffer (pool);
+    fill_check_nv12 (clean, 0.0f, 0);
+    fill_check_nv12 (noisy, 8.0f, 1);
+    const double in_psnr = get_psnr (get_plane_mse (noisy, clean, 0));
+
+    // PSNR of luma improves on synthetic noise, for both bases with and without BayesShrink
+    for (uint32_t b = 0; b < sizeof (bases) / sizeof (bases[0]); ++b) {
+        for (uint32_t shrink = 0; shrink < 2; ++shrink) {
+            SmartPtr<SoftHandler> wavelet = create_soft_wavelet_denoise_handler (
+                bases[b], XCAM_SOFT_WAVELET_CHANNEL_Y | XCAM_SOFT_WAVELET_CHANNEL_UV, shrink);
+            XCAM_ASSERT (wavelet.ptr ());
+            SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (noisy);
+            CHECK (wavelet->execute_buffer (param, true), "wavelet check %s denoise failed", basis_names[b]);
+
+            const double out_psnr = get_psnr (get_plane_mse (param->out_buf, clean, 0));
+            printf ("wavelet %s bayes shrink:%s, luma PSNR in:%.2fdB out:%.2fdB\n",
+                    basis_names[b], shrink ? "on" : "off", in_psnr, out_psnr);
+            CHECK_EXP (
+                out_psnr > in_psnr + 3.0, "wavelet check %s bayes shrink:%s PSNR does not improve",
+                basis_names[b], shrink ? "on" : "off");
+            wavelet->terminate ();
+        }
+    }
+
+    return 0;
+}
+
+static int
+check_scale ()
+{
+    static const char *filter_names[] = {"bilinear", "bicubic", "lanczos"};
+    static const SoftScaleFilter filters[] = {SoftScaleBilinear, SoftScaleBicubic, SoftScaleLanczos};
+    // main output, then extra outputs of downscale and upscale
+    static const uint32_t out_sizes[][2] = {{960, 540}, {320, 180}, {1600, 900}};
+    const uint32_t out_count = sizeof (out_sizes) / sizeof (out_sizes[0]);
+
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, 1280, 720, 2);
+    CHECK_EXP (pool.ptr (), "scale check create buffer pool failed");
+    SmartPtr<VideoBuffer> flat = pool->get_buffer (pool);
+    SmartPtr<VideoBuffer> noisy = pool->get_buffer (pool);
+    fill_const_nv12 (flat, 100, 80, 170);
+    fill_check_nv12 (noisy, 8.0f, 1);
+
+    for (uint32_t f = 0; f < sizeof (filters) / sizeof (filters[0]); ++f) {
+        SmartPtr<SoftScaler> scaler = new SoftScaler (filters[f]);
+        XCAM_ASSERT (scaler.ptr ());
+        scaler->set_output_size (out_sizes[0][0], out_sizes[0][1]);
+        for (uint32_t i = 1; i < out_count; ++i)
+            scaler->add_extra_output_size (out_sizes[i][0], out_sizes[i][1]);
+
+        // constant image stays constant on every output
+        SmartPtr<VideoBuffer> out;
+        std::vector<SmartPtr<VideoBuffer> > extra_outs;
+        CHECK (scaler->scale (flat, out, extra_outs), "scale check %s flat frame failed", filter_names[f]);
+        CHECK_EXP (extra_outs.size () + 1 == out_count, "scale check %s extra outputs missing", filter_names[f]);
+        for (uint32_t i = 0; i < out_count; ++i) {
+            const SmartPtr<VideoBuffer> &buf = i ? extra_outs[i - 1] : out;
+            const uint32_t max_diff = get_const_nv12_diff (buf, 100, 80, 170);
+            printf ("scale %s flat to %dx%d, max diff:%d\n",
+                    filter_names[f], out_sizes[i][0], out_sizes[i][1], max_diff);
+            CHECK_EXP (!max_diff, "scale check %s constant image changed", filter_names[f]);
+        }
+
+        // extra outputs match single output runs
+        out.release ();
+        extra_outs.clear ();
+        CHECK (scaler->scale (noisy, out, extra_outs), "scale check %s noisy frame failed", filter_names[f]);
+        scaler->terminate ();
+        for (uint32_t i = 0; i < out_count; ++i) {
+            SmartPtr<SoftHandler> single = create_soft_scaler (filters[f], out_sizes[i][0], out_sizes[i][1]);
+            XCAM_ASSERT (single.ptr ());
+            SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (noisy);
+            CHECK (single->execute_buffer (param, true), "scale check %s single output failed", filter_names[f]);
+
+            const SmartPtr<VideoBuffer> &buf = i ? extra_outs[i - 1] : out;
+            uint32_t max_y = 0, max_uv = 0;
+            get_plane_mse (buf, param->out_buf, 0, &max_y);
+            get_plane_mse (buf, param->out_buf, 1, &max_uv);
+            CHECK_EXP (
+                !max_y && !max_uv, "scale check %s output %dx%d differs from single output run",
+                filter_names[f], out_sizes[i][0], out_sizes[i][1]);
+            single->terminate ();
+        }
+        printf ("scale %s extra outputs match single output runs\n", filter_names[f]);
+    }
+
+    return 0;
+}
+
+// mean luma of [x0, x1) columns in middle half rows
+static double
+get_luma_mean (const SmartPtr<VideoBuffer> &buf, uint32_t x0, uint32_t x1)
+{
+    const VideoBufferInfo &info = buf->get_video_info ();
+    const uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+
+    double sum = 0.0;
+    for (uint32_t y = info.height / 4; y < info.height * 3 / 4; ++y) {
+        const uint8_t *line = mem + info.offsets[0] + y * info.strides[0];
+        for (uint32_t x = x0; x < x1; ++x)
+            sum += line[x];
+    }
+    buf->unmap ();
+
+    return sum / ((x1 - x0) * (info.height * 3 / 4 - info.height / 4));
+}
+
+static int
+check_tonemapping ()
+{
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, 2);
+    CHECK_EXP (pool.ptr (), "tonemapping check create buffer pool failed");
+
+    // flat frame passes through unchanged
+    SmartPtr<VideoBuffer> flat = pool->get_buffer (pool);
+    fill_const_nv12 (flat, 100, 110, 150);
+    SmartPtr<SoftHandler> tonemap = create_soft_tonemapping_handler ();
+    XCAM_ASSERT (tonemap.ptr ());
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (flat);
+    CHECK (tonemap->execute_buffer (param, true), "tonemapping check flat frame failed");
+    const uint32_t max_diff = get_const_nv12_diff (param->out_buf, 100, 110, 150);
+    printf ("tonemapping flat frame, max diff:%d\n", max_diff);
+    CHECK_EXP (max_diff <= 1, "tonemapping check flat frame changed");
+    tonemap->terminate ();
+
+    // dark left half and bright right half, anchor is frame mean of log2 luma
+    const uint8_t dark = 32, bright = 192;
+    SmartPtr<VideoBuffer> split = pool->get_buffer (pool);
+    fill_const_nv12 (split, dark, 128, 128);
+    {
+        const VideoBufferInfo &info = split->get_video_info ();
+        uint8_t *mem = split->map ();
+        for (uint32_t y = 0; y < info.height; ++y)
+            memset (mem + info.offsets[0] + y * info.strides[0] + info.width / 2, bright, info.width / 2);
+        split->unmap ();
+    }
+    const double anchor = pow (2.0, (log2 ((double)dark) + log2 ((double)bright)) / 2.0);
+
+    tonemap = create_soft_tonemapping_handler ();
+    XCAM_ASSERT (tonemap.ptr ());
+    param = new ImageHandler::Parameters (split);
+    CHECK (tonemap->execute_buffer (param, true), "tonemapping check split frame failed");
+    const double dark_mean = get_luma_mean (param->out_buf, CHECK_WIDTH / 8, CHECK_WIDTH * 3 / 8);
+    const double bright_mean = get_luma_mean (param->out_buf, CHECK_WIDTH * 5 / 8, CHECK_WIDTH * 7 / 8);
+    printf ("tonemapping split frame %d/%d, anchor:%.1f, out dark:%.1f bright:%.1f\n",
+            dark, bright, anchor, dark_mean, bright_mean);
+    CHECK_EXP (
+        dark_mean > dark + 2.0 && dark_mean < anchor && bright_mean < bright - 2.0 && bright_mean > anchor,
+        "tonemapping check split frame does not compress toward anchor");
+    tonemap->terminate ();
+
+    return 0;
+}
+
+static int
+check_3d_denoise ()
+{
+    const uint32_t frame_count = 8;
+    const uint32_t channel = XCAM_SOFT_3D_DENOISE_CHANNEL_Y | XCAM_SOFT_3D_DENOISE_CHANNEL_UV;
+
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, 2);
+    SmartPtr<BufferPool> held_pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, frame_count);
+    CHECK_EXP (pool.ptr () && held_pool.ptr (), "3d-denoise check create buffer pool failed");
+    SmartPtr<VideoBuffer> clean = pool->get_buffer (pool);
+    fill_check_nv12 (clean, 0.0f, 0);
+
+    // outputs given by caller and all held, no output buffer is reused
+    SmartPtr<SoftHandler> denoise = create_soft_3d_denoise_handler (channel, 2);
+    XCAM_ASSERT (denoise.ptr ());
+    std::vector<SmartPtr<VideoBuffer> > held_outs;
+    double in_mse = 0.0, out_mse = 0.0;
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        SmartPtr<VideoBuffer> noisy = pool->get_buffer (pool);
+        fill_check_nv12 (noisy, 4.0f, i + 1);
+        SmartPtr<ImageHandler::Parameters> param =
+            new ImageHandler::Parameters (noisy, held_pool->get_buffer (held_pool));
+        CHECK (denoise->execute_buffer (param, true), "3d-denoise check frame(%d) failed", i);
+        held_outs.push_back (param->out_buf);
+
+        in_mse = get_plane_mse (noisy, clean, 0);
+        out_mse = get_plane_mse (param->out_buf, clean, 0);
+    }
+    denoise->terminate ();
+
+    // noise drops on a static noisy sequence
+    printf ("3d-denoise noisy input, luma noise variance in:%.2f out:%.2f\n", in_mse, out_mse);
+    CHECK_EXP (out_mse < in_mse * 0.6, "3d-denoise check noise variance does not drop");
+
+    /* outputs from handler pool are dropped at once, so pool recycles them while
+     * handler holds former outputs as iir references, results need be same.
+     */
+    denoise = create_soft_3d_denoise_handler (channel, 2);
+    XCAM_ASSERT (denoise.ptr ());
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        SmartPtr<VideoBuffer> noisy = pool->get_buffer (pool);
+        fill_check_nv12 (noisy, 4.0f, i + 1);
+        SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (noisy);
+        CHECK (denoise->execute_buffer (param, true), "3d-denoise check recycled frame(%d) failed", i);
+
+        uint32_t max_y = 0, max_uv = 0;
+        get_plane_mse (param->out_buf, held_outs[i], 0, &max_y);
+        get_plane_mse (param->out_buf, held_outs[i], 1, &max_uv);
+        CHECK_EXP (
+            !max_y && !max_uv, "3d-denoise check frame(%d) differs when output pool recycles, y:%d uv:%d",
+            i, max_y, max_uv);
+    }
+    denoise->terminate ();
+    printf ("3d-denoise iir references survive output pool recycling\n");
+
+    return 0;
+}
+
+// every csc kernel variant gives same bytes as c variant on random lines
+static int
+check_csc_kernels ()
+{
+    static const uint32_t counts[] = {1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 1920};
+    const uint32_t max_count = 1920 * 4;
+
+    std::vector<XCamSoftTasks::CscKernels> variants;
+    XCamSoftTasks::get_csc_kernel_variants (variants);
+    CHECK_EXP (!variants.empty () && !strcmp (variants[0].isa, "c"), "csc check c kernels missing");
+
+    std::vector<uint8_t> src0 (max_count), src1 (max_count), expect (max_count), result (max_count);
+    uint32_t state = 1;
+    for (uint32_t round = 0; round < 16; ++round) {
+        for (uint32_t i = 0; i < max_count; ++i) {
+            state = state * 1103515245u + 12345u;
+            src0[i] = (uint8_t)(state >> 16);
+            state = state * 1103515245u + 12345u;
+            src1[i] = (uint8_t)(state >> 16);
+        }
+        state = state * 1103515245u + 12345u;
+        const uint16_t weight = (uint16_t)((state >> 16) % 257);
+        // random 3x4 matrix with offsets, results also go beyond [0, 255]
+        float matrix[12];
+        for (uint32_t i = 0; i < 12; ++i) {
+            state = state * 1103515245u + 12345u;
+            const float unit = ((state >> 8) & 0xFFFF) / 65535.0f * 2.0f - 1.0f;
+            matrix[i] = (i % 4 == 3) ? unit * 256.0f : unit * 2.0f;
+        }
+
+        for (uint32_t c = 0; c < sizeof (counts) / sizeof (counts[0]); ++c) {
+            const uint32_t count = counts[c];
+            variants[0].blend (&src0[0], &src1[0], weight, count * 4, &expect[0]);
+            for (uint32_t v = 1; v < variants.size (); ++v) {
+                variants[v].blend (&src0[0], &src1[0], weight, count * 4, &result[0]);
+                CHECK_EXP (
+                    !memcmp (&expect[0], &result[0], count * 4),
+                    "csc check %s blend differs from c on %d bytes, weight:%d", variants[v].isa, count * 4, weight);
+            }
+
+            variants[0].matrix (&src0[0], count, matrix, &expect[0]);
+            for (uint32_t v = 1; v < variants.size (); ++v) {
+                variants[v].matrix (&src0[0], count, matrix, &result[0]);
+                CHECK_EXP (
+                    !memcmp (&expect[0], &result[0], count * 4),
+                    "csc check %s matrix differs from c on %d pixels", variants[v].isa, count);
+
+                // in place
+                memcpy (&result[0], &src0[0], count * 4);
+                variants[v].matrix (&result[0], count, matrix, &result[0]);
+                CHECK_EXP (
+                    !memcmp (&expect[0], &result[0], count * 4),
+                    "csc check %s matrix in place differs from c on %d pixels", variants[v].isa, count);
+            }
+        }
+    }
+
+    for (uint32_t v = 0; v < variants.size (); ++v)
+        printf ("csc %s kernels match c kernels\n", variants[v].isa);
+    return 0;
+}
+
+// NV12 to @format of @width x @height and back to NV12 of input size, max diff to input
+static int
+check_csc_round_trip (
+    const SmartPtr<VideoBuffer> &nv12, uint32_t format, uint32_t width, uint32_t height, uint32_t tolerance)
+{
+    const VideoBufferInfo &in_info = nv12->get_video_info ();
+    SmartPtr<BufferPool> mid_pool = create_check_pool (format, width, height, 1);
+    SmartPtr<BufferPool> back_pool = create_check_pool (V4L2_PIX_FMT_NV12, in_info.width, in_info.height, 1);
+    CHECK_EXP (mid_pool.ptr () && back_pool.ptr (), "csc check create buffer pool failed");
+
+    SmartPtr<VideoBuffer> mid = mid_pool->get_buffer (mid_pool);
+    SmartPtr<VideoBuffer> back = back_pool->get_buffer (back_pool);
+    CHECK (soft_csc_convert (nv12, mid), "csc check NV12 to %s failed", xcam_fourcc_to_string (format));
+    CHECK (soft_csc_convert (mid, back), "csc check %s to NV12 failed", xcam_fourcc_to_string (format));
+
+    uint32_t max_y = 0, max_uv = 0;
+    get_plane_mse (back, nv12, 0, &max_y);
+    get_plane_mse (back, nv12, 1, &max_uv);
+    printf ("csc NV12 %dx%d to %s %dx%d and back, max diff y:%d uv:%d\n",
+            in_info.width, in_info.height, xcam_fourcc_to_string (format), width, height, max_y, max_uv);
+    CHECK_EXP (
+        max_y <= tolerance && max_uv <= tolerance, "csc check round trip through %s %dx%d is off",
+        xcam_fourcc_to_string (format), width, height);
+    return 0;
+}
+
+static int
+check_csc ()
+{
+    CHECK_EXP (check_csc_kernels () == 0, "csc check kernels failed");
+
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, 2);
+    CHECK_EXP (pool.ptr (), "csc check create buffer pool failed");
+    SmartPtr<VideoBuffer> smooth = pool->get_buffer (pool);
+    SmartPtr<VideoBuffer> flat = pool->get_buffer (pool);
+    fill_check_nv12 (smooth, 0.0f, 0);
+    fill_const_nv12 (flat, 100, 80, 170);
+
+    // same size round trips lose rounding only, smooth chroma survives 4:2:0
+    static const uint32_t formats[] = {V4L2_PIX_FMT_RGB24, V4L2_PIX_FMT_BGR32};
+    for (uint32_t i = 0; i < sizeof (formats) / sizeof (formats[0]); ++i) {
+        CHECK_EXP (
+            check_csc_round_trip (smooth, formats[i], CHECK_WIDTH, CHECK_HEIGHT, 2) == 0,
+            "csc check round trip failed");
+    }
+
+    // resize, upscaled smooth image comes back close, constant image stays constant
+    CHECK_EXP (
+        check_csc_round_trip (smooth, V4L2_PIX_FMT_BGR32, CHECK_WIDTH * 2, CHECK_HEIGHT * 2, 2) == 0,
+        "csc check resize round trip failed");
+
+    static const uint32_t sizes[][2] = {{CHECK_WIDTH / 2, CHECK_HEIGHT / 2}, {1000, 750}};
+    for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); ++i) {
+        SmartPtr<BufferPool> out_pool = create_check_pool (V4L2_PIX_FMT_NV12, sizes[i][0], sizes[i][1], 1);
+        CHECK_EXP (out_pool.ptr (), "csc check create buffer pool failed");
+        SmartPtr<VideoBuffer> out = out_pool->get_buffer (out_pool);
+        CHECK (soft_csc_convert (flat, out), "csc check resize to %dx%d failed", sizes[i][0], sizes[i][1]);
+
+        const uint32_t max_diff = get_const_nv12_diff (out, 100, 80, 170);
+        printf ("csc flat NV12 resized to %dx%d, max diff:%d\n", sizes[i][0], sizes[i][1], max_diff);
+        CHECK_EXP (!max_diff, "csc check resize changed constant image");
+    }
+
+    return 0;
+}
+
+// uniform color of @rgb in [0, 1] on BGGR raw, 8 bits or 16 bits storage
+static void
+fill_bayer (const SmartPtr<VideoBuffer> &buf, const float *rgb)
+{
+    const VideoBufferInfo &info = buf->get_video_info ();
+    const float max_value = (float)(1 << info.color_bits);
+    const uint32_t b = (uint32_t)(rgb[2] * max_value), g = (uint32_t)(rgb[1] * max_value);
+    const uint32_t r = (uint32_t)(rgb[0] * max_value);
+    const uint32_t pattern[2][2] = {{b, g}, {g, r}};
+
+    uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+    for (uint32_t y = 0; y < info.height; ++y) {
+        uint8_t *line = mem + info.offsets[0] + y * info.strides[0];
+        for (uint32_t x = 0; x < info.width; ++x) {
+            const uint32_t value = pattern[y % 2][x % 2];
+            if (info.color_bits > 8)
+                ((uint16_t *)line)[x] = (uint16_t)value;
+            else
+                line[x] = (uint8_t)value;
+        }
+    }
+    buf->unmap ();
+}
+
+static int
+check_bayer ()
+{
+    static const char *mode_names[] = {"bilinear", "edge-aware"};
+    static const SoftDemosaicMode modes[] = {SoftDemosaicBilinear, SoftDemosaicEdgeAware};
+    static const uint32_t formats[] = {V4L2_PIX_FMT_SBGGR8, V4L2_PIX_FMT_SBGGR10, V4L2_PIX_FMT_SBGGR12};
+    static const float rgb[3] = {0.5f, 0.25f, 0.125f};
+
+    // full range BT.601 of rgb
+    const double r = rgb[0] * 255.0, g = rgb[1] * 255.0, b = rgb[2] * 255.0;
+    const uint8_t expect_y = (uint8_t)(0.299 * r + 0.587 * g + 0.114 * b + 0.5);
+    const uint8_t expect_u = (uint8_t)(-0.168736 * r - 0.331264 * g + 0.5 * b + 128.5);
+    const uint8_t expect_v = (uint8_t)(0.5 * r - 0.418688 * g - 0.081312 * b + 128.5);
+
+    // linear gamma, so output is rgb2yuv of input color
+    XCam3aResultGammaTable gamma;
+    xcam_mem_clear (gamma);
+    for (uint32_t i = 0; i < XCAM_GAMMA_TABLE_SIZE; ++i)
+        gamma.table[i] = i * 256.0 / 255.0;
+
+    for (uint32_t f = 0; f < sizeof (formats) / sizeof (formats[0]); ++f) {
+        SmartPtr<BufferPool> pool = create_check_pool (formats[f], CHECK_WIDTH, CHECK_HEIGHT, 1);
+        CHECK_EXP (pool.ptr (), "bayer check create buffer pool failed");
+        SmartPtr<VideoBuffer> raw = pool->get_buffer (pool);
+        fill_bayer (raw, rgb);
+        const uint32_t bits = raw->get_video_info ().color_bits;
+
+        for (uint32_t m = 0; m < sizeof (modes) / sizeof (modes[0]); ++m) {
+            SmartPtr<SoftBayerPipeHandler> bayer = new SoftBayerPipeHandler (modes[m]);
+            XCAM_ASSERT (bayer.ptr ());
+            bayer->set_gamma_table (gamma);
+
+            SmartPtr<VideoBuffer> out;
+            CHECK (bayer->process (raw, out), "bayer check %s %d bits failed", mode_names[m], bits);
+            const uint32_t max_diff = get_const_nv12_diff (out, expect_y, expect_u, expect_v);
+            printf ("bayer %s %d bits, rgb %.3f/%.3f/%.3f expect yuv %d/%d/%d, max diff:%d\n",
+                    mode_names[m], bits, rgb[0], rgb[1], rgb[2], expect_y, expect_u, expect_v, max_diff);
+            CHECK_EXP (
+                max_diff <= 1, "bayer check %s %d bits uniform color does not give BT.601 yuv",
+                mode_names[m], bits);
+            bayer->terminate ();
+        }
+    }
+
+    return 0;
+}
+
+static int
+check_stitch_quality ()
+{
+    const uint32_t budget = 10000;
+    StitchQuality best;
+    best.blend_pyr_levels = 2;
+    best.fm_interval = 1;
+    best.map_factor = 16;
+
+    StitchQualityCtrl ctrl;
+    ctrl.set_frame_budget (budget);
+    ctrl.reset (best);
+    // fm interval 1->8, pyr levels 2->1, map factor 16->64
+    CHECK_EXP (ctrl.get_max_level () == 6, "stitch quality check max level:%d, expect 6", ctrl.get_max_level ());
+
+    // frame time inside the band keeps the level
+    for (uint32_t i = 0; i < 100; ++i)
+        ctrl.update (budget * 9 / 10);
+    CHECK_EXP (ctrl.get_level () == 0, "stitch quality check level changed inside budget band");
+
+    // over budget, steps down one level at a time
+    uint32_t level = 0;
+    for (uint32_t i = 0; i < 100 && level < ctrl.get_max_level (); ++i) {
+        if (!ctrl.update (budget * 2))
+            continue;
+        CHECK_EXP (
+            ctrl.get_level () == level + 1, "stitch quality check level stepped %d->%d on over budget",
+            level, ctrl.get_level ());
+        level = ctrl.get_level ();
+    }
+    const StitchQuality &worst = ctrl.get_quality ();
+    printf ("stitch quality over budget, level:%d pyr_levels:%d fm_interval:%d map_factor:%d\n",
+            level, worst.blend_pyr_levels, worst.fm_interval, worst.map_factor);
+    CHECK_EXP (
+        level == ctrl.get_max_level () && worst.blend_pyr_levels == 1 &&
+        worst.fm_interval == XCAM_STITCH_MAX_FM_INTERVAL && worst.map_factor == XCAM_STITCH_MAX_MAP_FACTOR,
+        "stitch quality check did not reach lowest quality on over budget");
+    CHECK_EXP (!ctrl.update (budget * 2), "stitch quality check stepped below max level");
+
+    // under budget, steps back up one level at a time
+    for (uint32_t i = 0; i < 1000 && level > 0; ++i) {
+        if (!ctrl.update (budget / 5))
+            continue;
+        CHECK_EXP (
+            ctrl.get_level () + 1 == level, "stitch quality check level stepped %d->%d on under budget",
+            level, ctrl.get_level ());
+        level = ctrl.get_level ();
+    }
+    printf ("stitch quality under budget, level:%d\n", level);
+    CHECK_EXP (
+        level == 0 && ctrl.get_quality () == best, "stitch quality check did not restore best quality on under budget");
+
+    return 0;
+}
+
+// random bytes on all planes, regions are brighter or darker per 8x8 block so grid means differ
+static void
+fill_random_blocks (const SmartPtr<VideoBuffer> &buf, uint32_t seed)
+{
+    const VideoBufferInfo &info = buf->get_video_info ();
+    uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+
+    uint32_t state = seed * 2654435761u + 1;
+    for (uint32_t plane = 0; plane < info.components; ++plane) {
+        VideoBufferPlanarInfo planar;
+        info.get_planar_info (planar, plane);
+        const uint32_t line_bytes = planar.width * planar.pixel_bytes;
+        for (uint32_t y = 0; y < planar.height; ++y) {
+            uint8_t *line = mem + info.offsets[plane] + y * info.strides[plane];
+            for (uint32_t x = 0; x < line_bytes; ++x) {
+                state = state * 1103515245u + 12345u;
+                const uint32_t base = ((x / 8 + y / 8) % 4) * 64;
+                line[x] = (uint8_t)(base + ((state >> 16) & 0x3F) + ((state >> 24) & 0x3));
+            }
+        }
+    }
+    buf->unmap ();
+}
+
+static inline uint32_t
+stats_to_uchar (float value)
+{
+    return (uint32_t) XCAM_CLAMP (value + 0.5f, 0.0f, 255.0f);
+}
+
+// scalar reference of one grid of NV12, grid may be cut by frame border
+static void
+get_nv12_grid_stat (
+    const uint8_t *mem, const VideoBufferInfo &info, uint32_t x0, uint32_t y0, uint32_t grid,
+    uint32_t low, uint32_t high, XCamGridStat &stat)
+{
+    const uint32_t x1 = XCAM_MIN (x0 + grid, info.width), y1 = XCAM_MIN (y0 + grid, info.height);
+    const uint32_t uv_y1 = XCAM_MIN ((y1 + 1) / 2, info.height / 2);
+    uint64_t sum_y = 0, sum_u = 0, sum_v = 0, f1 = 0, f2 = 0;
+    uint32_t valid = 0;
+
+    for (uint32_t y = y0; y < y1; ++y) {
+        const uint8_t *line = mem + info.offsets[0] + y * info.strides[0];
+        for (uint32_t x = x0; x < x1; ++x) {
+            sum_y += line[x];
+            valid += (line[x] >= low && line[x] <= high);
+            if (x + 1 < info.width)
+                f1 += abs ((int32_t)line[x + 1] - line[x]);
+            if (x + 2 < info.width)
+                f2 += abs ((int32_t)line[x + 2] - line[x]);
+        }
+    }
+    for (uint32_t y = y0 / 2; y < uv_y1; ++y) {
+        const uint8_t *line = mem + info.offsets[1] + y * info.strides[1];
+        for (uint32_t x = x0; x < x1; x += 2) {
+            sum_u += line[x];
+            sum_v += line[x + 1];
+        }
+    }
+
+    const uint32_t count = (x1 - x0) * (y1 - y0);
+    const uint32_t uv_count = XCAM_MAX (((x1 - x0) / 2) * (uv_y1 - y0 / 2), 1u);
+    const float avg_y = (float)sum_y / count;
+    const float u = (float)sum_u / uv_count - 128.0f;
+    const float v = (float)sum_v / uv_count - 128.0f;
+    stat.avg_y = stats_to_uchar (avg_y);
+    stat.avg_r = stats_to_uchar (avg_y + 1.402f * v);
+    stat.avg_gr = stats_to_uchar (avg_y - 0.344f * u - 0.714f * v);
+    stat.avg_gb = stat.avg_gr;
+    stat.avg_b = stats_to_uchar (avg_y + 1.772f * u);
+    stat.valid_wb_count = valid;
+    stat.f_value1 = f1 / count;
+    stat.f_value2 = f2 / count;
+}
+
+// scalar reference of one grid of BGGR8
+static void
+get_bggr_grid_stat (
+    const uint8_t *mem, const VideoBufferInfo &info, uint32_t x0, uint32_t y0, uint32_t grid,
+    uint32_t low, uint32_t high, XCamGridStat &stat)
+{
+    const uint32_t width = XCAM_ALIGN_DOWN (info.width, 2), height = XCAM_ALIGN_DOWN (info.height, 2);
+    const uint32_t x1 = XCAM_MIN (x0 + grid, width), y1 = XCAM_MIN (y0 + grid, height);
+    uint64_t sum[2][2] = {{0, 0}, {0, 0}}, f1 = 0, f2 = 0;
+    uint32_t valid = 0;
+
+    for (uint32_t y = y0; y + 1 < y1; y += 2) {
+        const uint8_t *line0 = mem + info.offsets[0] + y * info.strides[0];
+        const uint8_t *line1 = line0 + info.strides[0];
+        for (uint32_t x = x0; x < x1; ++x) {
+            sum[0][x % 2] += line0[x];
+            sum[1][x % 2] += line1[x];
+            if (x % 2 == 0 && x + 1 < width) {
+                const uint8_t quad[4] = {line0[x], line0[x + 1], line1[x], line1[x + 1]};
+                bool in_range = true;
+                for (uint32_t i = 0; i < 4; ++i)
+                    in_range = in_range && quad[i] >= low && quad[i] <= high;
+                valid += in_range;
+            }
+            if (x + 2 < width)
+                f1 += abs ((int32_t)line0[x + 2] - line0[x]);
+            if (x + 4 < width)
+                f2 += abs ((int32_t)line0[x + 4] - line0[x]);
+        }
+    }
+
+    const uint32_t quads = XCAM_MAX (((x1 - x0) / 2) * ((y1 - y0) / 2), 1u);
+    const float b = (float)sum[0][0] / quads, gb = (float)sum[0][1] / quads;
+    const float gr = (float)sum[1][0] / quads, r = (float)sum[1][1] / quads;
+    stat.avg_y = stats_to_uchar (0.299f * r + 0.587f * ((gr + gb) * 0.5f) + 0.114f * b);
+    stat.avg_r = stats_to_uchar (r);
+    stat.avg_gr = stats_to_uchar (gr);
+    stat.avg_gb = stats_to_uchar (gb);
+    stat.avg_b = stats_to_uchar (b);
+    stat.valid_wb_count = valid;
+    stat.f_value1 = f1 / (quads * 2);
+    stat.f_value2 = f2 / (quads * 2);
+}
+
+static int
+check_3a_stats_case (uint32_t format, uint32_t width, uint32_t height, uint32_t grid)
+{
+    const uint32_t low = 16, high = 235;
+
+    SmartPtr<BufferPool> pool = create_check_pool (format, width, height, 1);
+    CHECK_EXP (pool.ptr (), "3a-stats check create buffer pool failed");
+    SmartPtr<VideoBuffer> in = pool->get_buffer (pool);
+    fill_random_blocks (in, grid);
+
+    SmartPtr<Soft3aStatsCalculator> calculator = new Soft3aStatsCalculator ();
+    XCAM_ASSERT (calculator.ptr ());
+    CHECK_EXP (calculator->set_grid_size (grid), "3a-stats check set grid size(%d) failed", grid);
+    CHECK_EXP (calculator->set_valid_range (low, high), "3a-stats check set valid range failed");
+
+    SmartPtr<X3aStats> out;
+    CHECK (calculator->calculate (in, out), "3a-stats check calculate failed");
+    const XCam3AStats *stats = out->get_stats ();
+    const XCam3AStatsInfo &stats_info = stats->info;
+    CHECK_EXP (
+        stats_info.aligned_width == xcam_ceil (width, grid) / grid &&
+        stats_info.aligned_height == xcam_ceil (height, grid) / grid,
+        "3a-stats check grids %dx%d do not cover %dx%d", stats_info.aligned_width, stats_info.aligned_height,
+        width, height);
+
+    const VideoBufferInfo &info = in->get_video_info ();
+    const uint8_t *mem = in->map ();
+    XCAM_ASSERT (mem);
+
+    std::vector<uint32_t> hist_y (stats_info.histogram_bins, 0);
+    std::vector<uint32_t> hist_r (stats_info.histogram_bins, 0), hist_b (stats_info.histogram_bins, 0);
+    uint32_t mismatch = 0;
+    for (uint32_t gy = 0; gy < stats_info.aligned_height; ++gy) {
+        for (uint32_t gx = 0; gx < stats_info.aligned_width; ++gx) {
+            XCamGridStat expect;
+            if (format == V4L2_PIX_FMT_NV12)
+                get_nv12_grid_stat (mem, info, gx * grid, gy * grid, grid, low, high, expect);
+            else
+                get_bggr_grid_stat (mem, info, gx * grid, gy * grid, grid, low, high, expect);
+
+            const XCamGridStat &stat = stats->stats[gy * stats_info.aligned_width + gx];
+            if (memcmp (&stat, &expect, sizeof (expect))) {
+                if (!mismatch)
+                    printf ("3a-stats grid(%d, %d) y:%d/%d r:%d/%d gr:%d/%d gb:%d/%d b:%d/%d "
+                            "valid:%d/%d f1:%d/%d f2:%d/%d\n", gx, gy,
+                            stat.avg_y, expect.avg_y, stat.avg_r, expect.avg_r, stat.avg_gr, expect.avg_gr,
+                            stat.avg_gb, expect.avg_gb, stat.avg_b, expect.avg_b,
+                            stat.valid_wb_count, expect.valid_wb_count,
+                            stat.f_value1, expect.f_value1, stat.f_value2, expect.f_value2);
+                ++mismatch;
+            }
+
+            // histogram only counts whole grids
+            if (gx < stats_info.width && gy < stats_info.height) {
+                hist_y[expect.avg_y]++;
+                hist_r[expect.avg_r]++;
+                hist_b[expect.avg_b]++;
+            }
+        }
+    }
+    in->unmap ();
+
+    uint32_t hist_mismatch = 0;
+    for (uint32_t i = 0; i < stats_info.histogram_bins; ++i) {
+        hist_mismatch += (stats->hist_y[i] != hist_y[i]) + (stats->hist_rgb[i].r != hist_r[i]) +
+                         (stats->hist_rgb[i].b != hist_b[i]);
+    }
+
+    printf ("3a-stats %s %dx%d grid:%d, grids %dx%d, mismatched grids:%d histogram bins:%d\n",
+            xcam_fourcc_to_string (format), width, height, grid,
+            stats_info.aligned_width, stats_info.aligned_height, mismatch, hist_mismatch);
+    CHECK_EXP (
+        !mismatch && !hist_mismatch, "3a-stats check %s grid:%d differs from scalar reference",
+        xcam_fourcc_to_string (format), grid);
+
+    calculator->terminate ();
+    return 0;
+}
+
+static int
+check_3a_stats ()
+{
+    static const uint32_t formats[] = {V4L2_PIX_FMT_NV12, V4L2_PIX_FMT_SBGGR8};
+
+    for (uint32_t f = 0; f < sizeof (formats) / sizeof (formats[0]); ++f) {
+        // grid divides frame, then grid of odd cells which does not divide frame
+        CHECK_EXP (
+            check_3a_stats_case (formats[f], CHECK_WIDTH, CHECK_HEIGHT, 16) == 0, "3a-stats check grid 16 failed");
+        CHECK_EXP (
+            check_3a_stats_case (formats[f], CHECK_WIDTH + 12, CHECK_HEIGHT + 10, 24) == 0,
+            "3a-stats check grid 24 failed");
+    }
+
+    return 0;
+}
+
+// max abs difference of @out to area average of @in on all NV12 planes,
+// output pixel x covers input pixels [x * in_w / out_w, (x + 1) * in_w / out_w)
+static uint32_t
+get_area_average_diff (const SmartPtr<VideoBuffer> &in, const SmartPtr<VideoBuffer> &out)
+{
+    const VideoBufferInfo &in_info = in->get_video_info ();
+    const VideoBufferInfo &out_info = out->get_video_info ();
+    const uint8_t *in_mem = in->map ();
+    const uint8_t *out_mem = out->map ();
+    XCAM_ASSERT (in_mem && out_mem);
+
+    uint32_t max_diff = 0;
+    for (uint32_t plane = 0; plane < 2; ++plane) {
+        VideoBufferPlanarInfo in_planar, out_planar;
+        in_info.get_planar_info (in_planar, plane);
+        out_info.get_planar_info (out_planar, plane);
+        // uv plane is interleaved, one pixel of 2 channels
+        const uint32_t channels = plane ? 2 : 1;
+        const uint32_t in_width = in_planar.width / channels, out_width = out_planar.width / channels;
+
+        for (uint32_t y = 0; y < out_planar.height; ++y) {
+            const uint32_t y0 = y * in_planar.height / out_planar.height;
+            const uint32_t y1 = (y + 1) * in_planar.height / out_planar.height;
+            const uint8_t *out_line = out_mem + out_info.offsets[plane] + y * out_info.strides[plane];
+            for (uint32_t x = 0; x < out_width; ++x) {
+                const uint32_t x0 = x * in_width / out_width;
+                const uint32_t x1 = (x + 1) * in_width / out_width;
+                const uint32_t area = (x1 - x0) * (y1 - y0);
+                for (uint32_t c = 0; c < channels; ++c) {
+                    uint32_t sum = 0;
+                    for (uint32_t sy = y0; sy < y1; ++sy) {
+                        const uint8_t *in_line = in_mem + in_info.offsets[plane] + sy * in_info.strides[plane];
+                        for (uint32_t sx = x0; sx < x1; ++sx)
+                            sum += in_line[sx * channels + c];
+                    }
+                    const uint32_t expect = (sum + area / 2) / area;
+                    max_diff = XCAM_MAX (max_diff, (uint32_t)abs ((int32_t)out_line[x * channels + c] - (int32_t)expect));
+                }
+            }
+        }
+    }
+    in->unmap ();
+    out->unmap ();
+
+    return max_diff;
+}
+
+static int
+check_downscale ()
+{
+    // integer ratios, then non-integer ratios
+    static const uint32_t sizes[][2] = {{320, 240}, {160, 120}, {416, 312}, {250, 146}};
+
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, 1);
+    CHECK_EXP (pool.ptr (), "downscale check create buffer pool failed");
+    SmartPtr<VideoBuffer> in = pool->get_buffer (pool);
+    fill_check_nv12 (in, 16.0f, 1);
+
+    for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); ++i) {
+        SmartPtr<SoftDownscaler> downscaler = new SoftDownscaler ();
+        XCAM_ASSERT (downscaler.ptr ());
+        CHECK_EXP (
+            downscaler->set_output_size (sizes[i][0], sizes[i][1]), "downscale check set output size %dx%d failed",
+            sizes[i][0], sizes[i][1]);
+
+        SmartPtr<VideoBuffer> out;
+        CHECK (downscaler->scale (in, out), "downscale check %dx%d failed", sizes[i][0], sizes[i][1]);
+        const uint32_t max_diff = get_area_average_diff (in, out);
+        printf ("downscale %dx%d -> %dx%d, max diff to area average:%d\n",
+                CHECK_WIDTH, CHECK_HEIGHT, sizes[i][0], sizes[i][1], max_diff);
+        CHECK_EXP (
+            max_diff == 0, "downscale check %dx%d differs from area average", sizes[i][0], sizes[i][1]);
+        downscaler->terminate ();
+    }
+
+    return 0;
+}
+
+// random 8x8 blocks softened by 3x3 box, corners at block junctions
+static void
+fill_texture (Uchar *mem, uint32_t width, uint32_t height, uint32_t pitch, uint32_t seed)
+{
+    std::vector<Uchar> blocks (width * height);
+    uint32_t state = seed * 2654435761u + 1;
+    const uint32_t blocks_x = XCAM_ALIGN_UP (width, 8) / 8;
+    std::vector<Uchar> values (blocks_x * (XCAM_ALIGN_UP (height, 8) / 8));
+    for (size_t i = 0; i < values.size (); ++i) {
+        state = state * 1103515245u + 12345u;
+        values[i] = (Uchar)(32 + ((state >> 16) % 192));
+    }
+    for (uint32_t y = 0; y < height; ++y)
+        for (uint32_t x = 0; x < width; ++x)
+            blocks[y * width + x] = values[(y / 8) * blocks_x + x / 8];
+
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            uint32_t sum = 0;
+            for (int32_t j = -1; j <= 1; ++j)
+                for (int32_t i = -1; i <= 1; ++i)
+                    sum += blocks[XCAM_CLAMP ((int32_t)y + j, 0, (int32_t)height - 1) * width +
+                                  XCAM_CLAMP ((int32_t)x + i, 0, (int32_t)width - 1)];
+            mem[y * pitch + x] = (Uchar)((sum + 4) / 9);
+        }
+    }
+}
+
+static int
+check_feature_match_shift (
+    const SmartPtr<VideoBuffer> &buf, int32_t left_x, int32_t shift)
+{
+    // crops of one image, content of right crop moves by @shift to the right
+    const Rect left_rect (left_x, 0, 160, CHECK_HEIGHT);
+    const Rect right_rect (left_x - shift, 0, 160, CHECK_HEIGHT);
+
+    // take offset of one frame as it is, no smoothing or clamping
+    FMConfig config;
+    config.offset_factor = 0.0f;
+    config.delta_mean_offset = 64.0f;
+    config.max_adjusted_offset = 64.0f;
+
+    SmartPtr<FeatureMatch> matcher = FeatureMatch::create_soft_feature_match ();
+    XCAM_ASSERT (matcher.ptr ());
+    matcher->set_config (config);
+    matcher->set_crop_rect (left_rect, right_rect);
+    matcher->feature_match (buf, buf);
+
+    const float offset = matcher->get_current_left_offset_x ();
+    printf ("feature-match shift:%d, recovered offset:%.3f\n", shift, offset);
+    CHECK_EXP (
+        fabs (offset - shift) < 0.5f, "feature-match recovered offset:%.3f, expect %d", offset, shift);
+    return 0;
+}
+
+static int
+check_feature_match ()
+{
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, 1);
+    CHECK_EXP (pool.ptr (), "feature-match check create buffer pool failed");
+    SmartPtr<VideoBuffer> buf = pool->get_buffer (pool);
+    const VideoBufferInfo &info = buf->get_video_info ();
+    uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+    fill_texture (mem + info.offsets[0], info.width, info.height, info.strides[0], 1);
+    memset (mem + info.offsets[1], 128, info.strides[1] * info.height / 2);
+    buf->unmap ();
+
+    CHECK_EXP (check_feature_match_shift (buf, 240, 8) == 0, "feature-match shift 8 failed");
+    CHECK_EXP (check_feature_match_shift (buf, 240, -5) == 0, "feature-match shift -5 failed");
+    CHECK_EXP (check_feature_match_shift (buf, 240, 0) == 0, "feature-match shift 0 failed");
+
+    // SSE2 pre-check and scalar path find the same corners, sizes stay under corner limit
+    // and odd width leaves a scalar tail
+    SoftFeatureMatch detector;
+    static const uint32_t sizes[][2] = {{160, 120}, {173, 118}};
+    for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); ++i) {
+        UcharImage image (sizes[i][0], sizes[i][1]);
+        fill_texture (image.get_buf_ptr (0, 0), image.get_width (), image.get_height (), image.get_pitch (), i + 2);
+
+        std::vector<Float2> simd_corners, scalar_corners;
+        detector.detect_corners (image, simd_corners, true);
+        detector.detect_corners (image, scalar_corners, false);
+        printf ("feature-match %dx%d corners simd:%d scalar:%d\n",
+                sizes[i][0], sizes[i][1], (int)simd_corners.size (), (int)scalar_corners.size ());
+        CHECK_EXP (
+            !scalar_corners.empty () && simd_corners.size () == scalar_corners.size (),
+            "feature-match corner count differs, simd:%d scalar:%d",
+            (int)simd_corners.size (), (int)scalar_corners.size ());
+        for (size_t c = 0; c < scalar_corners.size (); ++c) {
+            CHECK_EXP (
+                simd_corners[c].x == scalar_corners[c].x && simd_corners[c].y == scalar_corners[c].y,
+                "feature-match corner %d differs, simd:(%.0f, %.0f) scalar:(%.0f, %.0f)", (int)c,
+                simd_corners[c].x, simd_corners[c].y, scalar_corners[c].x, scalar_corners[c].y);
+        }
+    }
+
+    return 0;
+}
+
+// mean luma difference of @out to @in moved by (@dx, @dy), border is left out
+static float
+get_shifted_luma_diff (
+    const SmartPtr<VideoBuffer> &in, const SmartPtr<VideoBuffer> &out, int32_t dx, int32_t dy)
+{
+    const VideoBufferInfo &in_info = in->get_video_info ();
+    const VideoBufferInfo &out_info = out->get_video_info ();
+    const uint8_t *in_mem = in->map () + in_info.offsets[0];
+    const uint8_t *out_mem = out->map () + out_info.offsets[0];
+    XCAM_ASSERT (in_info.width == out_info.width && in_info.height == out_info.height);
+
+    const int32_t border = 16;
+    uint64_t sum = 0, count = 0;
+    for (int32_t y = border; y < (int32_t)out_info.height - border; ++y) {
+        for (int32_t x = border; x < (int32_t)out_info.width - border; ++x) {
+            sum += abs (out_mem[y * out_info.strides[0] + x] - in_mem[(y - dy) * in_info.strides[0] + x - dx]);
+            ++count;
+        }
+    }
+    in->unmap ();
+    out->unmap ();
+
+    return (float)sum / count;
+}
+
+// rotation of frame 0 about one axis which moves image by @shift in focal @focal
+static int
+check_video_stab_pose (uint32_t axis, int32_t dx, int32_t dy, double focal, double shift)
+{
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, 4);
+    CHECK_EXP (pool.ptr (), "video-stab check create buffer pool failed");
+
+    // filter of radius 1 with tiny stdev keeps weight of last frame only,
+    // frame 0 is warped onto pose of frame 1 which is identity
+    SmartPtr<SoftVideoStabilizer> stab = new SoftVideoStabilizer ();
+    XCAM_ASSERT (stab.ptr ());
+    stab->set_camera_intrinsics (focal, focal, CHECK_WIDTH / 2.0, CHECK_HEIGHT / 2.0, 0.0);
+    CHECK (stab->set_motion_filter (1, 0.01f), "video-stab check set motion filter failed");
+
+    const double half_angle = atan (shift / focal) / 2.0;
+    SmartPtr<VideoBuffer> first, out;
+    for (int32_t i = 0; i < 2; ++i) {
+        SmartPtr<VideoBuffer> in = pool->get_buffer (pool);
+        const VideoBufferInfo &info = in->get_video_info ();
+        uint8_t *mem = in->map ();
+        XCAM_ASSERT (mem);
+        fill_texture (mem + info.offsets[0], info.width, info.height, info.strides[0], 1);
+        memset (mem + info.offsets[1], 128, info.strides[1] * info.height / 2);
+        in->unmap ();
+        in->set_timestamp (i * 33333);
+
+        SmartPtr<DevicePose> pose = new DevicePose ();
+        pose->timestamp = in->get_timestamp ();
+        pose->orientation[3] = 1.0;
+        if (i == 0) {
+            pose->orientation[axis] = sin (half_angle);
+            pose->orientation[3] = cos (half_angle);
+            first = in;
+        }
+        in->add_metadata (pose);
+
+        out.release ();
+        XCamReturn ret = stab->stabilize (in, out);
+        CHECK_EXP (
+            (i == 0 && ret == XCAM_RETURN_BYPASS && !out.ptr ()) || (i == 1 && ret == XCAM_RETURN_NO_ERROR && out.ptr ()),
+            "video-stab check frame %d got unexpected result:%d", i, ret);
+    }
+    stab->terminate ();
+
+    const float diff = get_shifted_luma_diff (first, out, dx, dy);
+    const float unshifted_diff = get_shifted_luma_diff (first, out, 0, 0);
+    printf ("video-stab axis:%d shift (%d, %d) mean diff:%.3f, unshifted mean diff:%.3f\n",
+            axis, dx, dy, diff, unshifted_diff);
+    CHECK_EXP (
+        diff < 0.1f && unshifted_diff > 10.0f, "video-stab check output is not shifted by (%d, %d)", dx, dy);
+    return 0;
+}
+
+static int
+check_video_stab ()
+{
+    // long focal keeps homography of small rotation a pure translation
+    CHECK_EXP (check_video_stab_pose (0, 0, -8, 8000.0, 8.0) == 0, "video-stab vertical shift failed");
+    CHECK_EXP (check_video_stab_pose (2, -8, 0, 8000.0, 8.0) == 0, "video-stab horizontal shift failed");
+    CHECK_EXP (check_video_stab_pose (2, 5, 0, 8000.0, -5.0) == 0, "video-stab negative shift failed");
+    return 0;
+}
+
+// luma standard deviation in middle half rows and columns
+static double
+get_luma_stddev (const SmartPtr<VideoBuffer> &buf)
+{
+    const VideoBufferInfo &info = buf->get_video_info ();
+    const uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+
+    double sum = 0.0, square = 0.0;
+    for (uint32_t y = info.height / 4; y < info.height * 3 / 4; ++y) {
+        const uint8_t *line = mem + info.offsets[0] + y * info.strides[0];
+        for (uint32_t x = info.width / 4; x < info.width * 3 / 4; ++x) {
+            sum += line[x];
+            square += line[x] * line[x];
+        }
+    }
+    buf->unmap ();
+
+    const double count = (info.width * 3 / 4 - info.width / 4) * (info.height * 3 / 4 - info.height / 4);
+    const double mean = sum / count;
+    return sqrt (XCAM_MAX (square / count - mean * mean, 0.0));
+}
+
+static int
+check_dcp ()
+{
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, 2);
+    CHECK_EXP (pool.ptr (), "dcp check create buffer pool failed");
+
+    // gray texture with black grid lines as shadows, every patch of dark channel
+    // min filter holds black pixels, so dark channel of haze-free frame is zero
+    const uint32_t grid = 16;
+    SmartPtr<VideoBuffer> clear = pool->get_buffer (pool);
+    fill_const_nv12 (clear, 0, 128, 128);
+    {
+        const VideoBufferInfo &info = clear->get_video_info ();
+        uint8_t *mem = clear->map ();
+        fill_texture (mem + info.offsets[0], info.width, info.height, info.strides[0], 7);
+        for (uint32_t y = 0; y < info.height; ++y) {
+            uint8_t *line = mem + info.offsets[0] + y * info.strides[0];
+            for (uint32_t x = 0; x < info.width; ++x) {
+                if (x % grid == 0 || y % grid == 0)
+                    line[x] = 0;
+            }
+        }
+        clear->unmap ();
+    }
+
+    // haze-free frame stays nearly unchanged
+    SmartPtr<SoftHandler> defog = create_soft_defog_dcp_handler ();
+    XCAM_ASSERT (defog.ptr ());
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (clear);
+    CHECK (defog->execute_buffer (param, true), "dcp check haze-free frame failed");
+    const double clear_mse = get_plane_mse (param->out_buf, clear, 0);
+    const double clear_uv_mse = get_plane_mse (param->out_buf, clear, 1);
+    printf ("dcp haze-free frame, luma mse:%.2f uv mse:%.2f\n", clear_mse, clear_uv_mse);
+    CHECK_EXP (clear_mse < 9.0 && clear_uv_mse < 1.0, "dcp check haze-free frame changed");
+    defog->terminate ();
+
+    // same scene under haze, i = j * t + a * (1 - t)
+    const float transmit = 0.4f, atmos = 220.0f;
+    SmartPtr<VideoBuffer> hazed = pool->get_buffer (pool);
+    fill_const_nv12 (hazed, 0, 128, 128);
+    {
+        const VideoBufferInfo &info = hazed->get_video_info ();
+        const uint8_t *src = clear->map ();
+        uint8_t *mem = hazed->map ();
+        for (uint32_t y = 0; y < info.height; ++y) {
+            const uint8_t *in = src + info.offsets[0] + y * info.strides[0];
+            uint8_t *out = mem + info.offsets[0] + y * info.strides[0];
+            for (uint32_t x = 0; x < info.width; ++x)
+                out[x] = (uint8_t)(in[x] * transmit + atmos * (1.0f - transmit) + 0.5f);
+        }
+        hazed->unmap ();
+        clear->unmap ();
+    }
+
+    defog = create_soft_defog_dcp_handler ();
+    XCAM_ASSERT (defog.ptr ());
+    param = new ImageHandler::Parameters (hazed);
+    CHECK (defog->execute_buffer (param, true), "dcp check hazed frame failed");
+    const double clear_stddev = get_luma_stddev (clear);
+    const double hazed_stddev = get_luma_stddev (hazed);
+    const double out_stddev = get_luma_stddev (param->out_buf);
+    printf ("dcp hazed frame, luma stddev clear:%.1f hazed:%.1f out:%.1f\n", clear_stddev, hazed_stddev, out_stddev);
+    CHECK_EXP (out_stddev > hazed_stddev * 1.5, "dcp check hazed frame gains no contrast");
+    defog->terminate ();
+
+    return 0;
+}
+
+// mean abs difference of luma to its 9x9 box mean in middle half rows and columns
+static double
+get_local_contrast (const SmartPtr<VideoBuffer> &buf)
+{
+    const VideoBufferInfo &info = buf->get_video_info ();
+    const uint8_t *mem = buf->map ();
+    XCAM_ASSERT (mem);
+
+    double sum = 0.0;
+    for (uint32_t y = info.height / 4; y < info.height * 3 / 4; ++y) {
+        for (uint32_t x = info.width / 4; x < info.width * 3 / 4; ++x) {
+            uint32_t box = 0;
+            for (uint32_t j = y - 4; j <= y + 4; ++j) {
+                const uint8_t *line = mem + info.offsets[0] + j * info.strides[0];
+                for (uint32_t i = x - 4; i <= x + 4; ++i)
+                    box += line[i];
+            }
+            sum += fabs (mem[info.offsets[0] + y * info.strides[0] + x] - box / 81.0);
+        }
+    }
+    buf->unmap ();
+
+    return sum / ((info.width * 3 / 4 - info.width / 4) * (info.height * 3 / 4 - info.height / 4));
+}
+
+static int
+check_retinex ()
+{
+    SmartPtr<BufferPool> pool = create_check_pool (V4L2_PIX_FMT_NV12, CHECK_WIDTH, CHECK_HEIGHT, 2);
+    CHECK_EXP (pool.ptr (), "retinex check create buffer pool failed");
+
+    // flat frame has no ratio to its blurs, output is one constant, chroma copied
+    SmartPtr<VideoBuffer> flat = pool->get_buffer (pool);
+    fill_const_nv12 (flat, 80, 110, 150);
+    SmartPtr<SoftHandler> retinex = create_soft_retinex_handler ();
+    XCAM_ASSERT (retinex.ptr ());
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (flat);
+    CHECK (retinex->execute_buffer (param, true), "retinex check flat frame failed");
+    uint32_t min_y = 255, max_y = 0;
+    {
+        const VideoBufferInfo &info = param->out_buf->get_video_info ();
+        const uint8_t *mem = param->out_buf->map ();
+        for (uint32_t y = 0; y < info.height; ++y) {
+            const uint8_t *line = mem + info.offsets[0] + y * info.strides[0];
+            for (uint32_t x = 0; x < info.width; ++x) {
+                min_y = XCAM_MIN (min_y, (uint32_t)line[x]);
+                max_y = XCAM_MAX (max_y, (uint32_t)line[x]);
+            }
+        }
+        param->out_buf->unmap ();
+    }
+    uint32_t max_uv = 0;
+    get_plane_mse (param->out_buf, flat, 1, &max_uv);
+    printf ("retinex flat frame, luma range [%d, %d], uv max diff:%d\n", min_y, max_y, max_uv);
+    CHECK_EXP (max_y - min_y <= 1 && max_uv == 0, "retinex check flat frame output is not constant");
+    retinex->terminate ();
+
+    // low contrast texture on a dark to bright gradient
+    SmartPtr<VideoBuffer> dim = pool->get_buffer (pool);
+    fill_const_nv12 (dim, 0, 128, 128);
+    {
+        const VideoBufferInfo &info = dim->get_video_info ();
+        uint8_t *mem = dim->map ();
+        fill_texture (mem + info.offsets[0], info.width, info.height, info.strides[0], 11);
+        for (uint32_t y = 0; y < info.height; ++y) {
+            uint8_t *line = mem + info.offsets[0] + y * info.strides[0];
+            for (uint32_t x = 0; x < info.width; ++x)
+                line[x] = (uint8_t)(40 + 120 * x / info.width + line[x] / 16);
+        }
+        dim->unmap ();
+    }
+
+    retinex = create_soft_retinex_handler ();
+    XCAM_ASSERT (retinex.ptr ());
+    param = new ImageHandler::Parameters (dim);
+    CHECK (retinex->execute_buffer (param, true), "retinex check gradient frame failed");
+    const double in_contrast = get_local_contrast (dim);
+    const double out_contrast = get_local_contrast (param->out_buf);
+    printf ("retinex gradient frame, local contrast in:%.2f out:%.2f\n", in_contrast, out_contrast);
+    CHECK_EXP (out_contrast > in_contrast * 1.5, "retinex check gradient frame gains no local contrast");
+    retinex->terminate ();
+
+    return 0;
+}
+
+// runs @handler on frames of @in one by one, input file is rewound at end
+static int
+run_handler (
+    const SmartPtr<SoftHandler> &handler, SmartPtr<SoftStream> &in, SmartPtr<SoftStream> &out,
+    int loop, bool save_output)
+{
+    for (int i = 0; i < loop; ++i) {
+        XCamReturn ret = in->read_buf ();
+        if (ret == XCAM_RETURN_BYPASS) {
+            CHECK (in->rewind (), "rewind file(%s) failed", in->get_file_name ());
+            ret = in->read_buf ();
+        }
+        CHECK (ret, "read buffer from file(%s) failed.", in->get_file_name ());
+
+        SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (in->get_buf ());
+        CHECK (handler->execute_buffer (param, true), "%s execute buffer failed", handler->get_name ());
+        if (save_output) {
+            out->get_buf () = param->out_buf;
+            out->write_buf ();
+        }
+        FPS_CALCULATION (soft-handler, XCAM_OBJ_DUR_FRAME_NUM);
+    }
+    return 0;
+}
+
 static void usage(const char* arg0)
 {
     printf ("Usage:\n"
             "%s --type TYPE --input0 input.nv12 --input1 input1.nv12 --output output.nv12 ...\n"
-            "\t--type              processing type, selected from: blend, remap\n"
+            "\t--type              processing type, selected from: blend, remap, tnr, wavelet, scale,\n"
+            "\t                    tonemapping, 3d-denoise, csc, bayer, stitch-quality(check only),\n"
+            "\t                    3a-stats(check only), downscale, feature-match(check only),\n"
+            "\t                    video-stab(check only), dcp, retinex\n"
             "\t--input0            input image(NV12)\n"
             "\t--input1            input image(NV12)\n"
             "\t--output            output image(NV12/MP4)\n"
+            "\t--in-format         optional, input format, select from [nv12/bggr8/bggr10/bggr12], default: nv12\n"
+            "\t                    bayer formats are only for bayer type\n"
             "\t--in-w              optional, input width, default: 1280\n"
             "\t--in-h              optional, input height, default: 800\n"
             "\t--out-w             optional, output width, default: 1280\n"
             "\t--out-h             optional, output height, default: 800\n"
             "\t--save              optional, save file or not, select from [true/false], default: true\n"
+            "\t--batch             optional, frames processed in one batch, only for remap, default: 1\n"
             "\t--loop              optional, how many loops need to run, default: 1\n"
+            "\t--check             optional, run built-in checks of type on synthetic images, no file needed\n"
             "\t--help              usage\n",
             arg0);
 }
@@ -109,21 +1500,27 @@ int main (int argc, char *argv[])
     SoftStreams ins;
     SoftStreams outs;
     SoftType type = SoftTypeNone;
+    uint32_t input_format = V4L2_PIX_FMT_NV12;
 
     int loop = 1;
+    uint32_t batch = 1;
     bool save_output = true;
+    bool check = false;
 
     const struct option long_opts[] = {
         {"type", required_argument, NULL, 't'},
         {"input0", required_argument, NULL, 'i'},
         {"input1", required_argument, NULL, 'j'},
         {"output", required_argument, NULL, 'o'},
+        {"in-format", required_argument, NULL, 'f'},
         {"in-w", required_argument, NULL, 'w'},
         {"in-h", required_argument, NULL, 'h'},
         {"out-w", required_argument, NULL, 'W'},
         {"out-h", required_argument, NULL, 'H'},
         {"save", required_argument, NULL, 's'},
+        {"batch", required_argument, NULL, 'b'},
         {"loop", required_argument, NULL, 'l'},
+        {"check", no_argument, NULL, 'c'},
         {"help", no_argument, NULL, 'e'},
         {NULL, 0, NULL, 0},
     };
@@ -137,6 +1534,34 @@ int main (int argc, char *argv[])
                 type = SoftTypeBlender;
             else if (!strcasecmp (optarg, "remap"))
                 type = SoftTypeRemap;
+            else if (!strcasecmp (optarg, "tnr"))
+                type = SoftTypeTnr;
+            else if (!strcasecmp (optarg, "wavelet"))
+                type = SoftTypeWavelet;
+            else if (!strcasecmp (optarg, "scale"))
+                type = SoftTypeScale;
+            else if (!strcasecmp (optarg, "tonemapping"))
+                type = SoftTypeTonemapping;
+            else if (!strcasecmp (optarg, "3d-denoise"))
+                type = SoftType3DDenoise;
+            else if (!strcasecmp (optarg, "csc"))
+                type = SoftTypeCsc;
+            else if (!strcasecmp (optarg, "bayer"))
+                type = SoftTypeBayer;
+            else if (!strcasecmp (optarg, "stitch-quality"))
+                type = SoftTypeStitchQuality;
+            else if (!strcasecmp (optarg, "3a-stats"))
+                type = SoftType3aStats;
+            else if (!strcasecmp (optarg, "downscale"))
+                type = SoftTypeDownscale;
+            else if (!strcasecmp (optarg, "feature-match"))
+                type = SoftTypeFeatureMatch;
+            else if (!strcasecmp (optarg, "video-stab"))
+                type = SoftTypeVideoStab;
+            else if (!strcasecmp (optarg, "dcp"))
+                type = SoftTypeDcp;
+            else if (!strcasecmp (optarg, "retinex"))
+                type = SoftTypeRetinex;
             else {
                 XCAM_LOG_ERROR ("unknown type:%s", optarg);
                 usage (argv[0]);
@@ -155,6 +1580,22 @@ int main (int argc, char *argv[])
             XCAM_ASSERT (optarg);
             PUSH_STREAM (SoftStream, outs, optarg);
             break;
+        case 'f':
+            XCAM_ASSERT (optarg);
+            if (!strcasecmp (optarg, "nv12"))
+                input_format = V4L2_PIX_FMT_NV12;
+            else if (!strcasecmp (optarg, "bggr8"))
+                input_format = V4L2_PIX_FMT_SBGGR8;
+            else if (!strcasecmp (optarg, "bggr10"))
+                input_format = V4L2_PIX_FMT_SBGGR10;
+            else if (!strcasecmp (optarg, "bggr12"))
+                input_format = V4L2_PIX_FMT_SBGGR12;
+            else {
+                XCAM_LOG_ERROR ("unknown input format:%s", optarg);
+                usage (argv[0]);
+                return -1;
+            }
+            break;
         case 'w':
             input_width = atoi(optarg);
             break;
@@ -170,9 +1611,15 @@ int main (int argc, char *argv[])
         case 's':
             save_output = (strcasecmp (optarg, "false") == 0 ? false : true);
             break;
+        case 'b':
+            batch = atoi(optarg);
+            break;
         case 'l':
             loop = atoi(optarg);
             break;
+        case 'c':
+            check = true;
+            break;
         case 'e':
             usage (argv[0]);
             return 0;
@@ -189,6 +1636,58 @@ int main (int argc, char *argv[])
         return -1;
     }
 
+    if (check) {
+        switch (type) {
+        case SoftTypeTnr:
+            CHECK_EXP (check_tnr () == 0, "tnr check failed");
+            break;
+        case SoftTypeWavelet:
+            CHECK_EXP (check_wavelet () == 0, "wavelet check failed");
+            break;
+        case SoftTypeScale:
+            CHECK_EXP (check_scale () == 0, "scale check failed");
+            break;
+        case SoftTypeTonemapping:
+            CHECK_EXP (check_tonemapping () == 0, "tonemapping check failed");
+            break;
+        case SoftType3DDenoise:
+            CHECK_EXP (check_3d_denoise () == 0, "3d-denoise check failed");
+            break;
+        case SoftTypeCsc:
+            CHECK_EXP (check_csc () == 0, "csc check failed");
+            break;
+        case SoftTypeBayer:
+            CHECK_EXP (check_bayer () == 0, "bayer check failed");
+            break;
+        case SoftTypeStitchQuality:
+            CHECK_EXP (check_stitch_quality () == 0, "stitch quality check failed");
+            break;
+        case SoftType3aStats:
+            CHECK_EXP (check_3a_stats () == 0, "3a-stats check failed");
+            break;
+        case SoftTypeDownscale:
+            CHECK_EXP (check_downscale () == 0, "downscale check failed");
+            break;
+        case SoftTypeFeatureMatch:
+            CHECK_EXP (check_feature_match () == 0, "feature-match check failed");
+            break;
+        case SoftTypeVideoStab:
+            CHECK_EXP (check_video_stab () == 0, "video-stab check failed");
+            break;
+        case SoftTypeDcp:
+            CHECK_EXP (check_dcp () == 0, "dcp check failed");
+            break;
+        case SoftTypeRetinex:
+            CHECK_EXP (check_retinex () == 0, "retinex check failed");
+            break;
+        default:
+            XCAM_LOG_ERROR ("type:%d has no built-in checks", type);
+            return -1;
+        }
+        printf ("check passed\n");
+        return 0;
+    }
+
     if (ins.empty () || outs.empty () ||
             !strlen (ins[0]->get_file_name ()) || !strlen (outs[0]->get_file_name ())) {
         XCAM_LOG_ERROR ("input or output file name was not set");
@@ -200,14 +1699,20 @@ int main (int argc, char *argv[])
         printf ("input%d file:\t\t%s\n", i, ins[i]->get_file_name ());
     }
     printf ("output file:\t\t%s\n", outs[0]->get_file_name ());
+    printf ("input format:\t\t%s\n", xcam_fourcc_to_string (input_format));
     printf ("input width:\t\t%d\n", input_width);
     printf ("input height:\t\t%d\n", input_height);
     printf ("output width:\t\t%d\n", output_width);
     printf ("output height:\t\t%d\n", output_height);
     printf ("save output:\t\t%s\n", save_output ? "true" : "false");
+    printf ("batch:\t\t\t%d\n", batch);
     printf ("loop count:\t\t%d\n", loop);
 
+    CHECK_EXP (
+        input_format == V4L2_PIX_FMT_NV12 || type == SoftTypeBayer,
+        "input format %s is only for bayer type", xcam_fourcc_to_string (input_format));
     for (uint32_t i = 0; i < ins.size (); ++i) {
+        ins[i]->set_format (input_format);
         ins[i]->set_buf_size (input_width, input_height);
         CHECK (ins[i]->create_buf_pool (6), "create buffer pool failed");
         CHECK (ins[i]->open_reader ("rb"), "open input file(%s) failed", ins[i]->get_file_name ());
@@ -261,12 +1766,109 @@ int main (int argc, char *argv[])
         //mapper->set_factors ((output_width - 1.0f) / (MAP_WIDTH - 1.0f), (output_height - 1.0f) / (MAP_HEIGHT - 1.0f));
 
         CHECK (ins[0]->read_buf(), "read buffer from file(%s) failed.", ins[0]->get_file_name ());
-        for (int i = 0; i < loop; ++i) {
-            CHECK (mapper->remap (ins[0]->get_buf (), outs[0]->get_buf ()), "remap buffer failed");
-            if (save_output)
-                outs[0]->write_buf ();
-            FPS_CALCULATION (soft-remap, XCAM_OBJ_DUR_FRAME_NUM);
+        if (batch <= 1) {
+            for (int i = 0; i < loop; ++i) {
+                CHECK (mapper->remap (ins[0]->get_buf (), outs[0]->get_buf ()), "remap buffer failed");
+                if (save_output)
+                    outs[0]->write_buf ();
+                FPS_CALCULATION (soft-remap, XCAM_OBJ_DUR_FRAME_NUM);
+            }
+            break;
         }
+
+        SmartPtr<SoftHandler> handler = mapper.dynamic_cast_ptr<SoftHandler> ();
+        XCAM_ASSERT (handler.ptr ());
+        handler->enable_allocator (true, batch + 2);
+
+        // per-frame remap of same input as reference of batched outputs
+        SmartPtr<ImageHandler::Parameters> ref_param = new ImageHandler::Parameters (ins[0]->get_buf ());
+        CHECK (handler->execute_buffer (ref_param, true), "remap reference buffer failed");
+        for (int i = 0; i < loop; i += batch) {
+            SoftHandler::ParametersList params;
+            for (uint32_t k = 0; k < batch; ++k) {
+                params.push_back (new ImageHandler::Parameters (ins[0]->get_buf ()));
+            }
+            CHECK (handler->execute_buffers (params, true), "remap buffers in batch failed");
+
+            for (uint32_t k = 0; k < batch; ++k) {
+                uint32_t max_diff[2] = {0, 0};
+                get_plane_mse (params[k]->out_buf, ref_param->out_buf, 0, &max_diff[0]);
+                get_plane_mse (params[k]->out_buf, ref_param->out_buf, 1, &max_diff[1]);
+                CHECK_EXP (
+                    max_diff[0] == 0 && max_diff[1] == 0,
+                    "remap batch output %d differs from per-frame remap, max diff y:%d uv:%d",
+                    k, max_diff[0], max_diff[1]);
+                if (save_output) {
+                    outs[0]->get_buf () = params[k]->out_buf;
+                    outs[0]->write_buf ();
+                }
+                FPS_CALCULATION (soft-remap, XCAM_OBJ_DUR_FRAME_NUM);
+            }
+        }
+        break;
+    }
+    case SoftTypeTnr: {
+        SmartPtr<SoftHandler> tnr = create_soft_tnr_handler ();
+        XCAM_ASSERT (tnr.ptr ());
+        CHECK_EXP (run_handler (tnr, ins[0], outs[0], loop, save_output) == 0, "tnr failed");
+        break;
+    }
+    case SoftTypeWavelet: {
+        SmartPtr<SoftHandler> wavelet = create_soft_wavelet_denoise_handler (
+            SoftWaveletHaar, XCAM_SOFT_WAVELET_CHANNEL_Y | XCAM_SOFT_WAVELET_CHANNEL_UV, true);
+        XCAM_ASSERT (wavelet.ptr ());
+        CHECK_EXP (run_handler (wavelet, ins[0], outs[0], loop, save_output) == 0, "wavelet failed");
+        break;
+    }
+    case SoftTypeScale: {
+        SmartPtr<SoftHandler> scaler = create_soft_scaler (SoftScaleBicubic, output_width, output_height);
+        XCAM_ASSERT (scaler.ptr ());
+        CHECK_EXP (run_handler (scaler, ins[0], outs[0], loop, save_output) == 0, "scale failed");
+        break;
+    }
+    case SoftTypeTonemapping: {
+        SmartPtr<SoftHandler> tonemap = create_soft_tonemapping_handler ();
+        XCAM_ASSERT (tonemap.ptr ());
+        CHECK_EXP (run_handler (tonemap, ins[0], outs[0], loop, save_output) == 0, "tonemapping failed");
+        break;
+    }
+    case SoftType3DDenoise: {
+        SmartPtr<SoftHandler> denoise = create_soft_3d_denoise_handler (
+            XCAM_SOFT_3D_DENOISE_CHANNEL_Y | XCAM_SOFT_3D_DENOISE_CHANNEL_UV, XCAM_SOFT_3D_DENOISE_DEFAULT_REF_COUNT);
+        XCAM_ASSERT (denoise.ptr ());
+        CHECK_EXP (run_handler (denoise, ins[0], outs[0], loop, save_output) == 0, "3d-denoise failed");
+        break;
+    }
+    case SoftTypeCsc: {
+        // NV12 resize through csc
+        SmartPtr<SoftHandler> csc = create_soft_csc_handler (V4L2_PIX_FMT_NV12, output_width, output_height);
+        XCAM_ASSERT (csc.ptr ());
+        CHECK_EXP (run_handler (csc, ins[0], outs[0], loop, save_output) == 0, "csc failed");
+        break;
+    }
+    case SoftTypeBayer: {
+        CHECK_EXP (SoftBayerPipeHandler::is_supported_format (input_format), "bayer needs bayer input format");
+        SmartPtr<SoftHandler> bayer = create_soft_bayer_pipe_handler ();
+        XCAM_ASSERT (bayer.ptr ());
+        CHECK_EXP (run_handler (bayer, ins[0], outs[0], loop, save_output) == 0, "bayer failed");
+        break;
+    }
+    case SoftTypeDownscale: {
+        SmartPtr<SoftHandler> downscaler = create_soft_downscaler (output_width, output_height);
+        XCAM_ASSERT (downscaler.ptr ());
+        CHECK_EXP (run_handler (downscaler, ins[0], outs[0], loop, save_output) == 0, "downscale failed");
+        break;
+    }
+    case SoftTypeDcp: {
+        SmartPtr<SoftHandler> defog = create_soft_defog_dcp_handler ();
+        XCAM_ASSERT (defog.ptr ());
+        CHECK_EXP (run_handler (defog, ins[0], outs[0], loop, save_output) == 0, "dcp failed");
+        break;
+    }
+    case SoftTypeRetinex: {
+        SmartPtr<SoftHandler> retinex = create_soft_retinex_handler ();
+        XCAM_ASSERT (retinex.ptr ());
+        CHECK_EXP (run_handler (retinex, ins[0], outs[0], loop, save_output) == 0, "retinex failed");
         break;
     }
     default: {
@@ -0,0 +1,275 @@
+/*
+ * test-spsc-queue.cpp - test single producer single consumer queue
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "test_common.h"
+#include <spsc_queue.h>
+#include <xcam_thread.h>
+#include <sched.h>
+#include <sys/time.h>
+
+#define STRESS_CAPACITY 8
+#define STRESS_ITEMS 200000
+
+using namespace XCam;
+
+struct Item {
+    uint32_t value;
+    explicit Item (uint32_t v) : value (v) {}
+};
+typedef SpscQueue<Item> ItemQueue;
+
+static int64_t
+get_time_us ()
+{
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+    return tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+// pops @count items with @timeout, records order errors, NULL pops and when it returned
+class ConsumerThread
+    : public Thread
+{
+public:
+    ConsumerThread (ItemQueue &queue, uint32_t count, int32_t timeout)
+        : Thread ("spsc_consumer")
+        , _queue (queue)
+        , _count (count)
+        , _timeout (timeout)
+        , _popped (0)
+        , _null_pops (0)
+        , _order_errors (0)
+        , _done (false)
+    {}
+
+    uint32_t get_popped () const {
+        return _popped;
+    }
+    uint32_t get_null_pops () const {
+        return _null_pops;
+    }
+    uint32_t get_order_errors () const {
+        return _order_errors;
+    }
+    bool is_done () const {
+        return _done;
+    }
+
+protected:
+    virtual bool loop () {
+        SmartPtr<Item> item = _queue.pop (_timeout);
+        if (!item.ptr ()) {
+            ++_null_pops;
+        } else {
+            if (item->value != _popped)
+                ++_order_errors;
+            ++_popped;
+        }
+
+        if (_popped < _count && _null_pops == 0)
+            return true;
+        _done = true;
+        return false;
+    }
+
+private:
+    ItemQueue               &_queue;
+    uint32_t                 _count;
+    int32_t                  _timeout;
+    std::atomic<uint32_t>    _popped;
+    std::atomic<uint32_t>    _null_pops;
+    std::atomic<uint32_t>    _order_errors;
+    std::atomic<bool>        _done;
+};
+
+static void
+wait_done (const ConsumerThread &consumer, int32_t timeout_ms)
+{
+    for (int32_t i = 0; i < timeout_ms && !consumer.is_done (); ++i)
+        usleep (1000);
+}
+
+static int
+test_wrap_around ()
+{
+    ItemQueue queue (4);
+    CHECK_EXP (queue.get_capacity () == 4, "capacity:%d, expect 4", queue.get_capacity ());
+
+    // head and tail run many times around the ring
+    uint32_t pushed = 0, popped = 0;
+    for (uint32_t round = 0; round < 1000; ++round) {
+        const uint32_t count = round % 4 + 1;
+        for (uint32_t i = 0; i < count; ++i)
+            CHECK_EXP (queue.push (new Item (pushed++)), "push failed at round %d", round);
+        for (uint32_t i = 0; i < count; ++i) {
+            SmartPtr<Item> item = queue.pop (0);
+            CHECK_EXP (item.ptr () && item->value == popped, "pop out of order at round %d", round);
+            ++popped;
+        }
+    }
+    CHECK_EXP (queue.is_empty (), "queue not empty after wrap-around");
+    printf ("wrap-around: %d items through capacity 4 in order\n", popped);
+    return 0;
+}
+
+static int
+test_full ()
+{
+    ItemQueue queue (5);
+    const uint32_t capacity = queue.get_capacity ();
+    CHECK_EXP (capacity == 8, "capacity 5 is rounded to %d, expect 8", capacity);
+
+    for (uint32_t i = 0; i < capacity; ++i)
+        CHECK_EXP (queue.push (new Item (i)), "push %d failed before full", i);
+    CHECK_EXP (!queue.push (new Item (capacity)), "push succeeded on full queue");
+    CHECK_EXP (queue.size () == capacity, "full queue size:%d", queue.size ());
+
+    // one pop frees one slot, items pushed before full are kept
+    SmartPtr<Item> item = queue.pop (0);
+    CHECK_EXP (item.ptr () && item->value == 0, "pop of full queue failed");
+    CHECK_EXP (queue.push (new Item (capacity)), "push failed after a pop");
+    for (uint32_t i = 1; i <= capacity; ++i) {
+        item = queue.pop (0);
+        CHECK_EXP (item.ptr () && item->value == i, "pop %d after full failed", i);
+    }
+    CHECK_EXP (!queue.pop (0).ptr (), "pop of empty queue returned an item");
+
+    queue.push (new Item (0));
+    queue.clear ();
+    CHECK_EXP (queue.is_empty (), "queue not empty after clear");
+    printf ("full: push fails at capacity %d, recovers after pop\n", capacity);
+    return 0;
+}
+
+static int
+test_stress ()
+{
+    ItemQueue queue (STRESS_CAPACITY);
+    std::vector<SmartPtr<Item> > items;
+    for (uint32_t i = 0; i < STRESS_ITEMS; ++i)
+        items.push_back (new Item (i));
+
+    ConsumerThread consumer (queue, STRESS_ITEMS, -1);
+    CHECK_EXP (consumer.start (), "start consumer failed");
+
+    // small ring keeps producer hitting full queue and consumer hitting empty queue
+    uint32_t full_count = 0;
+    const int64_t start = get_time_us ();
+    for (uint32_t i = 0; i < STRESS_ITEMS; ++i) {
+        while (!queue.push (items[i])) {
+            ++full_count;
+            sched_yield ();
+        }
+        if (i % 4096 == 0)
+            usleep (100);
+    }
+    wait_done (consumer, 10000);
+    const int64_t duration = get_time_us () - start;
+    consumer.stop ();
+
+    printf ("stress: %d items popped, order errors:%d, producer found queue full %d times, %.1fms\n",
+            consumer.get_popped (), consumer.get_order_errors (), full_count, duration / 1000.0f);
+    CHECK_EXP (
+        consumer.get_popped () == STRESS_ITEMS && consumer.get_null_pops () == 0 && consumer.get_order_errors () == 0,
+        "stress lost or reordered items");
+    CHECK_EXP (queue.is_empty (), "queue not empty after stress");
+    return 0;
+}
+
+static int
+test_blocking ()
+{
+    ItemQueue queue;
+
+    // pop with timeout on empty queue
+    int64_t start = get_time_us ();
+    CHECK_EXP (!queue.pop (20000).ptr (), "pop with timeout returned an item from empty queue");
+    const int64_t waited = get_time_us () - start;
+    CHECK_EXP (waited >= 15000, "pop with 20ms timeout returned after %dus", (int32_t)waited);
+
+    // pop blocks while empty, wakeup alone does not return it, push does
+    ConsumerThread consumer (queue, 1, -1);
+    CHECK_EXP (consumer.start (), "start consumer failed");
+    usleep (50000);
+    CHECK_EXP (!consumer.is_done (), "pop returned on empty queue");
+    queue.wakeup ();
+    usleep (50000);
+    CHECK_EXP (!consumer.is_done (), "pop returned on wakeup without item");
+    start = get_time_us ();
+    queue.push (new Item (0));
+    wait_done (consumer, 1000);
+    const int64_t latency = get_time_us () - start;
+    consumer.stop ();
+    CHECK_EXP (
+        consumer.get_popped () == 1 && consumer.get_null_pops () == 0, "blocked pop did not get the pushed item");
+
+    printf ("blocking: timeout pop waited %.1fms, blocked pop woke %.1fms after push\n",
+            waited / 1000.0f, latency / 1000.0f);
+    return 0;
+}
+
+static int
+test_pause_resume ()
+{
+    ItemQueue queue;
+
+    // pause releases a blocked pop with NULL
+    ConsumerThread consumer (queue, 1, -1);
+    CHECK_EXP (consumer.start (), "start consumer failed");
+    usleep (50000);
+    CHECK_EXP (!consumer.is_done (), "pop returned on empty queue");
+    queue.pause_pop ();
+    wait_done (consumer, 1000);
+    consumer.stop ();
+    CHECK_EXP (consumer.is_done () && consumer.get_null_pops () == 1, "pause did not release blocked pop");
+
+    // paused queue returns NULL but keeps items
+    CHECK_EXP (queue.push (new Item (0)), "push to paused queue failed");
+    CHECK_EXP (!queue.pop (-1).ptr (), "paused pop returned an item");
+    CHECK_EXP (queue.size () == 1, "paused pop dropped the item");
+
+    queue.resume_pop ();
+    SmartPtr<Item> item = queue.pop (0);
+    CHECK_EXP (item.ptr () && item->value == 0, "pop after resume failed");
+
+    // restart after resume, blocked pop gets next item
+    ConsumerThread restarted (queue, 1, -1);
+    CHECK_EXP (restarted.start (), "start consumer failed");
+    usleep (20000);
+    queue.push (new Item (0));
+    wait_done (restarted, 1000);
+    restarted.stop ();
+    CHECK_EXP (restarted.get_popped () == 1, "pop after resume did not block for next item");
+
+    printf ("pause/resume: pause releases blocked pop, items kept until resume\n");
+    return 0;
+}
+
+int main ()
+{
+    CHECK_EXP (test_wrap_around () == 0, "wrap-around test failed");
+    CHECK_EXP (test_full () == 0, "full queue test failed");
+    CHECK_EXP (test_blocking () == 0, "blocking test failed");
+    CHECK_EXP (test_pause_resume () == 0, "pause/resume test failed");
+    CHECK_EXP (test_stress () == 0, "stress test failed");
+
+    printf ("spsc queue test passed\n");
+    return 0;
+}
@@ -453,22 +453,26 @@ static void usage(const char* arg0)
             "\t--res-mode          optional, image resolution mode\n"
             "\t                    select from [1080p2cams/1080p4cams/8k3cams], default: 1080p4cams\n"
             "\t--blend-pyr-levels  optional, the pyramid levels of blender, default: 2\n"
+            "\t--frame-budget      optional, per-frame time budget(ms) of adaptive quality scaling, only for soft module\n"
+            "\t                    0 disables adaptive quality scaling, default: 0\n"
             "\t--dewarp-mode       optional, fisheye dewarp mode, select from [sphere/bowl], default: bowl\n"
             "\t--scopic-mode       optional, scopic mode, select from [mono/stereoleft/stereoright], default: mono\n"
             "\t--scale-mode        optional, scaling mode for geometric mapping,\n"
             "\t                    select from [singleconst/dualconst/dualcurve], default: singleconst\n"
 #if HAVE_OPENCV
             "\t--fm-mode           optional, feature match mode,\n"
-            "\t                    select from [none/default/cluster/capi], default: none\n"
+            "\t                    select from [none/default/cluster/capi/soft], default: none\n"
+#else
+            "\t--fm-mode           optional, feature match mode, select from [none/soft], default: none\n"
+#endif
+            "\t                    soft: OpenCV free feature match, only for soft module\n"
             "\t--fm-frames         optional, how many frames need to run feature match at the beginning, default: 100\n"
             "\t--fm-status         optional, running status of feature match,\n"
             "\t                    select from [wholeway/halfway/fmfirst], default: wholeway\n"
             "\t                    wholeway: run feature match during the entire runtime\n"
             "\t                    halfway: run feature match with stitching in the first --fm-frames frames\n"
             "\t                    fmfirst: run feature match without stitching in the first --fm-frames frames\n"
-#else
-            "\t--fm-mode           optional, feature match mode, select from [none], default: none\n"
-#endif
+            "\t--fm-lag            optional, frames between feature match and applying its result, only for soft, default: 1\n"
             "\t--frame-mode        optional, times of buffer reading, select from [single/multi], default: multi\n"
             "\t--save              optional, save file or not, select from [true/false], default: true\n"
             "\t--save-topview      optional, save top view video, select from [true/false], default: false\n"
@@ -499,11 +503,11 @@ int main (int argc, char *argv[])
     StitchScopicMode scopic_mode = ScopicMono;
 
     uint32_t blend_pyr_levels = 2;
+    uint32_t frame_budget = 0;
 
-#if HAVE_OPENCV
     uint32_t fm_frames = 100;
+    uint32_t fm_lag = 1;
     FeatureMatchStatus fm_status = FMStatusWholeWay;
-#endif
 
     int loop = 1;
     bool save_output = true;
@@ -522,14 +526,14 @@ int main (int argc, char *argv[])
         {"fisheye-num", required_argument, NULL, 'N'},
         {"res-mode", required_argument, NULL, 'R'},
         {"blend-pyr-levels", required_argument, NULL, 'b'},
+        {"frame-budget", required_argument, NULL, 'B'},
         {"dewarp-mode", required_argument, NULL, 'd'},
         {"scopic-mode", required_argument, NULL, 'c'},
         {"scale-mode", required_argument, NULL, 'S'},
         {"fm-mode", required_argument, NULL, 'F'},
-#if HAVE_OPENCV
         {"fm-frames", required_argument, NULL, 'n'},
         {"fm-status", required_argument, NULL, 'T'},
-#endif
+        {"fm-lag", required_argument, NULL, 'G'},
         {"frame-mode", required_argument, NULL, 'f'},
         {"save", required_argument, NULL, 's'},
         {"save-topview", required_argument, NULL, 't'},
@@ -603,6 +607,9 @@ int main (int argc, char *argv[])
         case 'b':
             blend_pyr_levels = atoi(optarg);
             break;
+        case 'B':
+            frame_budget = atoi(optarg);
+            break;
         case 'd':
             if (!strcasecmp (optarg, "sphere"))
                 dewarp_mode = DewarpSphere;
@@ -651,16 +658,20 @@ int main (int argc, char *argv[])
             else if (!strcasecmp (optarg, "capi"))
                 fm_mode = FMCapi;
 #endif
+            else if (!strcasecmp (optarg, "soft"))
+                fm_mode = FMSoft;
             else {
                 XCAM_LOG_ERROR ("surround view unsupported feature match mode: %s", optarg);
                 usage (argv[0]);
                 return -1;
             }
             break;
-#if HAVE_OPENCV
         case 'n':
             fm_frames = atoi(optarg);
             break;
+        case 'G':
+            fm_lag = atoi(optarg);
+            break;
         case 'T':
             XCAM_ASSERT (optarg);
             if (!strcasecmp (optarg, "wholeway"))
@@ -675,7 +686,6 @@ int main (int argc, char *argv[])
                 return -1;
             }
             break;
-#endif
         case 'f':
             XCAM_ASSERT (optarg);
             if (!strcasecmp (optarg, "single"))
@@ -726,6 +736,7 @@ int main (int argc, char *argv[])
 
     CHECK_EXP (outs.size () == 1 && outs[IdxStitch].ptr (), "surrond view needs 1 output stream");
     CHECK_EXP (strlen (outs[IdxStitch]->get_file_name ()), "output file name was not set");
+    CHECK_EXP (fm_mode != FMSoft || module == SVModuleSoft, "soft feature match only supports soft module");
 
     for (uint32_t i = 0; i < ins.size (); ++i) {
         printf ("input%d file:\t\t%s\n", i, ins[i]->get_file_name ());
@@ -741,18 +752,19 @@ int main (int argc, char *argv[])
     printf ("resolution mode:\t%s\n", res_mode == StitchRes1080P2Cams ? "1080p2cams" :
             (res_mode == StitchRes1080P4Cams ? "1080p4cams" : "8k3cams"));
     printf ("blend pyr levels:\t%d\n", blend_pyr_levels);
+    printf ("frame budget:\t\t%dms\n", frame_budget);
     printf ("dewarp mode: \t\t%s\n", dewarp_mode == DewarpSphere ? "sphere" : "bowl");
     printf ("scopic mode:\t\t%s\n", (scopic_mode == ScopicMono) ? "mono" :
             ((scopic_mode == ScopicStereoLeft) ? "stereoleft" : "stereoright"));
     printf ("scaling mode:\t\t%s\n", (scale_mode == ScaleSingleConst) ? "singleconst" :
             ((scale_mode == ScaleDualConst) ? "dualconst" : "dualcurve"));
     printf ("feature match:\t\t%s\n", (fm_mode == FMNone) ? "none" :
-            ((fm_mode == FMDefault ) ? "default" : ((fm_mode == FMCluster) ? "cluster" : "capi")));
-#if HAVE_OPENCV
+            ((fm_mode == FMDefault ) ? "default" : ((fm_mode == FMCluster) ? "cluster" :
+                    ((fm_mode == FMCapi) ? "capi" : "soft"))));
     printf ("feature match frames:\t%d\n", fm_frames);
+    printf ("feature match lag:\t%d\n", fm_lag);
     printf ("feature match status:\t%s\n", (fm_status == FMStatusWholeWay) ? "wholeway" :
             ((fm_status == FMStatusHalfWay) ? "halfway" : "fmfirst"));
-#endif
     printf ("frame mode:\t\t%s\n", (frame_mode == FrameSingle) ? "singleframe" : "multiframe");
     printf ("save output:\t\t%s\n", save_output ? "true" : "false");
     printf ("save topview:\t\t%s\n", save_topview ? "true" : "false");
@@ -820,11 +832,11 @@ int main (int argc, char *argv[])
     stitcher->set_scopic_mode (scopic_mode);
     stitcher->set_scale_mode (scale_mode);
     stitcher->set_blend_pyr_levels (blend_pyr_levels);
+    stitcher->set_frame_time_budget (frame_budget * 1000);
     stitcher->set_fm_mode (fm_mode);
-#if HAVE_OPENCV
     stitcher->set_fm_frames (fm_frames);
+    stitcher->set_fm_lag (fm_lag);
     stitcher->set_fm_status (fm_status);
-#endif
 
     if (dewarp_mode == DewarpSphere) {
         if (res_mode == StitchRes1080P2Cams) {
@@ -22,13 +22,18 @@
 #include "test_inline.h"
 #include <unistd.h>
 #include <getopt.h>
+#include <image_file_handle.h>
+#include <dma_video_buffer.h>
+#include <soft/soft_video_buf_allocator.h>
+#include <soft/soft_video_stabilizer.h>
+
+#if HAVE_LIBCL
 #include <ocl/cl_utils.h>
 #include <ocl/cl_device.h>
 #include <ocl/cl_context.h>
 #include <ocl/cl_blender.h>
-#include <image_file_handle.h>
 #include <ocl/cl_video_stabilizer.h>
-#include <dma_video_buffer.h>
+#endif
 
 #if HAVE_OPENCV
 #include <opencv2/opencv.hpp>
@@ -38,6 +43,12 @@
 
 using namespace XCam;
 
+enum StabModule {
+    StabModuleNone = 0,
+    StabModuleOCL,
+    StabModuleSoft
+};
+
 static int read_device_pose (const char *file, DevicePoseList &pose, uint32_t pose_size);
 
 static void
@@ -49,6 +60,8 @@ usage(const char* arg0)
             "\t--input, input image(NV12)\n"
             "\t--gyro, input gyro pose data;\n"
             "\t--output, output image(NV12) PREFIX\n"
+            "\t--module,  optional, stabilization module, select from [ocl/soft], default: ocl if OpenCL enabled, else soft\n"
+            "\t--readout, optional, sensor readout time in microseconds for rolling shutter correction, soft only, default: 0\n"
             "\t--input-w, optional, input width; default:1920\n"
             "\t--input-h,  optional, input height; default:1080\n"
             "\t--save,     optional, save file or not, default true; select from [true/false]\n"
@@ -61,8 +74,15 @@ int main (int argc, char *argv[])
 {
     XCamReturn ret = XCAM_RETURN_NO_ERROR;
 
+#if HAVE_LIBCL
+    StabModule module = StabModuleOCL;
     SmartPtr<CLVideoStabilizer> video_stab;
     SmartPtr<CLContext> context;
+#else
+    StabModule module = StabModuleSoft;
+#endif
+    SmartPtr<SoftVideoStabilizer> soft_stab;
+    double readout_time = 0.0;
     VideoBufferInfo input_buf_info;
     VideoBufferInfo output_buf_info;
     SmartPtr<VideoBuffer> input_buf;
@@ -87,6 +107,8 @@ int main (int argc, char *argv[])
         {"input", required_argument, NULL, 'i'},
         {"gyro", required_argument, NULL, 'g'},
         {"output", required_argument, NULL, 'o'},
+        {"module", required_argument, NULL, 'm'},
+        {"readout", required_argument, NULL, 'r'},
         {"input-w", required_argument, NULL, 'w'},
         {"input-h", required_argument, NULL, 'h'},
         {"save", required_argument, NULL, 's'},
@@ -107,6 +129,22 @@ int main (int argc, char *argv[])
         case 'o':
             file_out_name = optarg;
             break;
+        case 'm':
+            if (!strcasecmp (optarg, "soft"))
+                module = StabModuleSoft;
+#if HAVE_LIBCL
+            else if (!strcasecmp (optarg, "ocl"))
+                module = StabModuleOCL;
+#endif
+            else {
+                XCAM_LOG_ERROR ("unsupported module:%s", optarg);
+                usage (argv[0]);
+                return -1;
+            }
+            break;
+        case 'r':
+            readout_time = atof(optarg);
+            break;
         case 'w':
             input_width = atoi(optarg);
             output_width = input_width;
@@ -143,11 +181,13 @@ int main (int argc, char *argv[])
     }
 
     printf ("Description-----------\n");
+    printf ("module:%s\n", module == StabModuleSoft ? "soft" : "ocl");
     printf ("input video file:%s\n", file_in_name);
     printf ("gyro pose file:%s\n", gyro_data);
     printf ("output file PREFIX:%s\n", file_out_name);
     printf ("input width:%d\n", input_width);
     printf ("input height:%d\n", input_height);
+    printf ("readout time:%.1fus\n", readout_time);
     printf ("need save file:%s\n", need_save_output ? "true" : "false");
     printf ("loop count:\t\t%d\n", loop);
     printf ("----------------------\n");
@@ -164,11 +204,6 @@ int main (int argc, char *argv[])
         return -1;
     }
 
-    context = CLDevice::instance ()->get_context ();
-    video_stab = create_cl_video_stab_handler (context).dynamic_cast_ptr<CLVideoStabilizer> ();
-    XCAM_ASSERT (video_stab.ptr ());
-    video_stab->set_pool_type (CLImageHandler::CLVideoPoolType);
-
     /*
         Color CameraIntrinsics:
                  image_width: 1920, image_height :1080,
@@ -185,21 +220,49 @@ int main (int argc, char *argv[])
     double offset_x = 940.413257;
     double offset_y = 540.198348;
     double skew = 0;
-    video_stab->set_camera_intrinsics (focal_x, focal_y, offset_x, offset_y, skew);
-
     CoordinateSystemConv world_to_device (AXIS_X, AXIS_MINUS_Z, AXIS_NONE);
     CoordinateSystemConv device_to_image (AXIS_X, AXIS_Y, AXIS_Y);
-    video_stab->align_coordinate_system (world_to_device, device_to_image);
-
     uint32_t radius = 15;
     float stdev = 10;
-    video_stab->set_motion_filter (radius, stdev);
 
     input_buf_info.init (input_format, input_width, input_height);
     output_buf_info.init (input_format, output_width, output_height);
-    SmartPtr<BufferPool> buf_pool = new CLVideoBufferPool ();
+    SmartPtr<BufferPool> buf_pool;
+
+    if (module == StabModuleSoft) {
+        CalibrationParams calib;
+        calib.focal_x = focal_x;
+        calib.focal_y = focal_y;
+        calib.offset_x = offset_x;
+        calib.offset_y = offset_y;
+        calib.skew = skew;
+        calib.readout_time = readout_time;
+
+        soft_stab = create_soft_video_stabilizer ().dynamic_cast_ptr<SoftVideoStabilizer> ();
+        XCAM_ASSERT (soft_stab.ptr ());
+        soft_stab->set_sensor_calibration (calib);
+        soft_stab->align_coordinate_system (world_to_device, device_to_image);
+        soft_stab->set_motion_filter (radius, stdev);
+        soft_stab->set_output_size (output_width, output_height);
+
+        // stabilizer holds filter radius input frames
+        buf_pool = new SoftVideoBufAllocator (input_buf_info);
+    }
+#if HAVE_LIBCL
+    else {
+        context = CLDevice::instance ()->get_context ();
+        video_stab = create_cl_video_stab_handler (context).dynamic_cast_ptr<CLVideoStabilizer> ();
+        XCAM_ASSERT (video_stab.ptr ());
+        video_stab->set_pool_type (CLImageHandler::CLVideoPoolType);
+        video_stab->set_camera_intrinsics (focal_x, focal_y, offset_x, offset_y, skew);
+        video_stab->align_coordinate_system (world_to_device, device_to_image);
+        video_stab->set_motion_filter (radius, stdev);
+
+        buf_pool = new CLVideoBufferPool ();
+        buf_pool->set_video_info (input_buf_info);
+    }
+#endif
     XCAM_ASSERT (buf_pool.ptr ());
-    buf_pool->set_video_info (input_buf_info);
     if (!buf_pool->reserve (36)) {
         XCAM_LOG_ERROR ("init buffer pool failed");
         return -1;
@@ -217,6 +280,11 @@ int main (int argc, char *argv[])
             return -1;
         }
     }
+#else
+    if (need_save_output) {
+        ret = file_out.open (file_out_name, "wb");
+        CHECK (ret, "open %s failed", file_out_name);
+    }
 #endif
 
     int i = 0;
@@ -224,7 +292,12 @@ int main (int argc, char *argv[])
         ret = file_in.rewind ();
         CHECK (ret, "video stabilization stitch rewind file(%s) failed", file_in_name);
 
-        video_stab->reset_counter ();
+        if (soft_stab.ptr ())
+            soft_stab->reset_counter ();
+#if HAVE_LIBCL
+        else
+            video_stab->reset_counter ();
+#endif
 
         DevicePoseList::iterator pose_iterator = device_pose.begin ();
         do {
@@ -243,13 +316,21 @@ int main (int argc, char *argv[])
             input_buf->add_metadata (pose_data);
             input_buf->set_timestamp (pose_data->timestamp);
 
-            ret = video_stab->execute (input_buf, output_buf);
+            if (soft_stab.ptr ()) {
+                output_buf.release ();
+                ret = soft_stab->stabilize (input_buf, output_buf);
+            }
+#if HAVE_LIBCL
+            else
+                ret = video_stab->execute (input_buf, output_buf);
+#endif
             if (++pose_iterator == device_pose.end ()) {
                 break;
             }
             if (ret == XCAM_RETURN_BYPASS) {
                 continue;
             }
+            CHECK (ret, "video stabilization failed");
 
 #if HAVE_OPENCV
             if (need_save_output) {
@@ -257,6 +338,11 @@ int main (int argc, char *argv[])
                 convert_to_mat (output_buf, out_mat);
                 writer.write (out_mat);
             } else
+#else
+            if (need_save_output) {
+                ret = file_out.write_buf (output_buf);
+                CHECK (ret, "write buffer to %s failed", file_out_name);
+            } else
 #endif
                 ensure_gpu_buffer_done (output_buf);
 
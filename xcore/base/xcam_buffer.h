@@ -53,6 +53,8 @@ XCAM_BEGIN_DECLARE
  * XCAM_PIX_FMT_RGB48: RGB with color-bits = 16
  * XCAM_PIX_FMT_RGBA64, RGBA with color-bits = 16
  * XCAM_PIX_FMT_SGRBG16, Bayer, with color-bits = 16
+ * XCAM_PIX_FMT_RGBF32_planar, RGB planes of 32 bit float, values in [0, 255]
+ * XCAM_PIX_FMT_BGRF32_planar, same as above with planes in BGR order
  */
 
 #define XCAM_PIX_FMT_RGB48     v4l2_fourcc('w', 'R', 'G', 'B')
@@ -63,6 +65,8 @@ XCAM_BEGIN_DECLARE
 #define XCAM_PIX_FMT_RGB24_planar     v4l2_fourcc('n', 'R', 'G', 0x24)
 #define XCAM_PIX_FMT_SGRBG16_planar   v4l2_fourcc('n', 'B', 'A', '0')
 #define XCAM_PIX_FMT_SGRBG8_planar   v4l2_fourcc('n', 'B', 'A', '8')
+#define XCAM_PIX_FMT_RGBF32_planar   v4l2_fourcc('n', 'R', 'G', 'F')
+#define XCAM_PIX_FMT_BGRF32_planar   v4l2_fourcc('n', 'B', 'G', 'F')
 
 #define XCAM_VIDEO_MAX_COMPONENTS 4
 
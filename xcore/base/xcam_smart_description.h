@@ -48,6 +48,10 @@ typedef XCamReturn (*XcamPostResultsFunc) (
   *     <size>               description structure size, sizeof (XCamSmartAnalysisDescription)
   *     <priority>           smart plugin priority; the less value the higher priority; 0, highest priority
   *     <name>             smart pluign name, or use file name if NULL
+  *     <width/height>    desired analysis resolution, 0 means input resolution; NV12 frames are
+  *                                 downscaled by the core and shared among plugins requesting the same size
+  *     <frame_interval> analyze one frame of every frame_interval frames, 0 or 1 means every frame
+  *     new fields are appended at the end, plugins built with older headers have smaller <size>
   */
 typedef struct _XCamSmartAnalysisDescription {
     uint32_t                        version;
@@ -93,8 +97,15 @@ typedef struct _XCamSmartAnalysisDescription {
     * \param[in]        res_count         analysis results count
     */
     void       (*free_results)    (XCamSmartAnalysisContext *context, XCam3aResultHead *results[], uint32_t res_count);
+
+    uint32_t                        width;
+    uint32_t                        height;
+    uint32_t                        frame_interval;
 } XCamSmartAnalysisDescription;
 
+#define XCAM_SMART_ANALYSIS_DESCRIPTION_MIN_SIZE \
+    ((uint32_t)offsetof (XCamSmartAnalysisDescription, width))
+
 XCAM_END_DECLARE
 
 #endif //C_XCAM_SMART_ANALYSIS_DESCRIPTION_H
@@ -46,6 +46,17 @@ FakePollThread::~FakePollThread ()
         fclose (_raw);
 }
 
+bool
+FakePollThread::set_buf_pool (const SmartPtr<BufferPool> &pool)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, pool.ptr () && !_buf_pool.ptr (), false,
+        "FakePollThread set buffer pool failed, pool is NULL or buffers already allocated");
+
+    _user_pool = pool;
+    return true;
+}
+
 XCamReturn
 FakePollThread::start()
 {
@@ -144,6 +155,14 @@ FakePollThread::init_buffer_pool ()
     info.init(format.fmt.pix.pixelformat,
               format.fmt.pix.width,
               format.fmt.pix.height, 0, 0, 0);
+
+    if (_user_pool.ptr ()) {
+        _buf_pool = _user_pool;
+        if (_buf_pool->set_video_info (info) && _buf_pool->reserve (DEFAULT_FPT_BUF_COUNT))
+            return XCAM_RETURN_NO_ERROR;
+        return XCAM_RETURN_ERROR_MEM;
+    }
+
 #if HAVE_LIBDRM
     SmartPtr<DrmDisplay> drm_disp = DrmDisplay::instance ();
     SmartPtr<BufferPool> pool = new DrmBoBufferPool (drm_disp);
@@ -33,6 +33,9 @@ public:
     explicit FakePollThread (const char *raw_path);
     ~FakePollThread ();
 
+    // optional, pool to read raw frames into, drm bo pool is used if not set
+    bool set_buf_pool (const SmartPtr<BufferPool> &pool);
+
     virtual XCamReturn start();
     virtual XCamReturn stop ();
 
@@ -52,6 +55,7 @@ private:
     char                        *_raw_path;
     FILE                        *_raw;
     SmartPtr<BufferPool>         _buf_pool;
+    SmartPtr<BufferPool>         _user_pool;
 };
 
 };
@@ -57,6 +57,7 @@ public:
         virtual ~Parameters() {}
         bool add_meta (const SmartPtr<MetaBase> &meta);
         template <typename MType> SmartPtr<MType> find_meta ();
+        template <typename MType> bool remove_meta ();
 
     private:
         MetaBaseList       _metas;
@@ -153,6 +154,20 @@ ImageHandler::Parameters::find_meta ()
     return NULL;
 }
 
+template <typename MType>
+bool
+ImageHandler::Parameters::remove_meta ()
+{
+    for (MetaBaseList::iterator i = _metas.begin (); i != _metas.end (); ++i) {
+        SmartPtr<MType> m = (*i).dynamic_cast_ptr<MType> ();
+        if (m.ptr ()) {
+            _metas.erase (i);
+            return true;
+        }
+    }
+    return false;
+}
+
 };
 
 #endif //XCAM_IMAGE_HANDLER_H
@@ -21,6 +21,8 @@
 #include "image_processor.h"
 #include "xcam_thread.h"
 
+#define XCAM_RESULTS_QUEUE_CAPACITY 128
+
 namespace XCam {
 
 void
@@ -70,7 +72,7 @@ class ImageProcessorThread
 {
 public:
     ImageProcessorThread (ImageProcessor *processor)
-        : Thread ("image_processor")
+        : Thread ("image_processor", ThreadRoleProcessor)
         , _processor (processor)
     {}
     ~ImageProcessorThread () {}
@@ -92,27 +94,42 @@ bool ImageProcessorThread::loop ()
 class X3aResultsProcessThread
     : public Thread
 {
-    typedef SafeList<X3aResult> ResultQueue;
+    typedef SpscQueue<X3aResult> ResultQueue;
 public:
     X3aResultsProcessThread (ImageProcessor *processor)
-        : Thread ("x3a_results_process_thread")
+        : Thread ("x3a_results_process_thread", ThreadRoleProcessor)
         , _processor (processor)
+        , _queue (XCAM_RESULTS_QUEUE_CAPACITY)
     {}
     ~X3aResultsProcessThread () {}
 
     XCamReturn push_result (SmartPtr<X3aResult> &result) {
-        _queue.push (result);
+        // results come from 3a and smart analyzer threads, serialize producers
+        SmartLock locker (_push_mutex);
+        XCAM_FAIL_RETURN (
+            WARNING, _queue.push (result), XCAM_RETURN_ERROR_MEM,
+            "processor(%s) results queue is full", XCAM_STR (_processor->get_name ()));
         return XCAM_RETURN_NO_ERROR;
     }
 
+    void triger_start () {
+        _queue.resume_pop ();
+    }
+
     void triger_stop () {
         _queue.pause_pop ();
     }
 
+    // after thread stopped
+    void clear () {
+        _queue.clear ();
+    }
+
     virtual bool loop ();
 
 private:
     ImageProcessor  *_processor;
+    Mutex            _push_mutex;
     ResultQueue      _queue;
 };
 
@@ -171,6 +188,10 @@ XCamReturn
 ImageProcessor::start()
 {
     XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    // queues were paused by former stop
+    _video_buf_queue.resume_pop ();
+    _results_thread->triger_start ();
     if (!_results_thread->start ()) {
         return XCAM_RETURN_ERROR_THREAD;
     }
@@ -200,6 +221,10 @@ ImageProcessor::stop()
 
     _processor_thread->stop ();
     _results_thread->stop ();
+
+    // drop pending buffers and results, they are stale to next start
+    _video_buf_queue.clear ();
+    _results_thread->clear ();
     XCAM_LOG_DEBUG ("ImageProcessor(%s) stopped", XCAM_STR (_name));
     return XCAM_RETURN_NO_ERROR;
 }
@@ -210,8 +235,9 @@ ImageProcessor::push_buffer (SmartPtr<VideoBuffer> &buf)
     if (_video_buf_queue.push (buf))
         return XCAM_RETURN_NO_ERROR;
 
-    XCAM_LOG_DEBUG ("processor push buffer failed");
-    return XCAM_RETURN_ERROR_UNKNOWN;
+    // input queue is bounded, drop the new buffer so capture keeps running and gets it back
+    XCAM_LOG_WARNING ("processor(%s) input queue is full, drop buffer", XCAM_STR (_name));
+    return XCAM_RETURN_BYPASS;
 }
 
 XCamReturn
@@ -25,6 +25,7 @@
 #include <video_buffer.h>
 #include <x3a_result.h>
 #include <safe_list.h>
+#include <spsc_queue.h>
 
 namespace XCam {
 
@@ -52,7 +53,8 @@ class ImageProcessor
     friend class ImageProcessorThread;
     friend class X3aResultsProcessThread;
 
-    typedef SafeList<VideoBuffer> VideoBufQueue;
+    // buffers are pushed by one upstream thread, poll thread or previous processor
+    typedef SpscQueue<VideoBuffer> VideoBufQueue;
 
 public:
     explicit ImageProcessor (const char* name);
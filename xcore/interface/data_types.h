@@ -35,7 +35,8 @@ enum FeatureMatchMode {
     FMNone = 0,
     FMDefault,
     FMCluster,
-    FMCapi
+    FMCapi,
+    FMSoft
 };
 
 enum FeatureMatchStatus {
@@ -99,6 +99,14 @@ FeatureMatch::enable_adjust_crop_area ()
     XCAM_ASSERT (false);
 }
 
+void
+FeatureMatch::enable_corner_tracking (bool enable)
+{
+    if (enable) {
+        XCAM_LOG_WARNING ("corner tracking is not supported");
+    }
+}
+
 bool
 FeatureMatch::get_mean_offset (
     const std::vector<float> &offsets, float sum, int &count, float &mean_offset)
@@ -37,6 +37,7 @@ struct FMConfig {
     float max_adjusted_offset; // maximum offset of each adjustment
     float max_valid_offset_y;  // valid maximum offset in vertical direction
     float max_track_error;     // maximum track error
+    int match_level;           // pyramid level corners are matched on, refined in full resolution
 
     FMConfig ()
         : stitch_min_width (56)
@@ -47,6 +48,7 @@ struct FMConfig {
         , max_adjusted_offset (12.0f)
         , max_valid_offset_y (8.0f)
         , max_track_error (24.0f)
+        , match_level (0)
     {}
 };
 
@@ -59,6 +61,7 @@ public:
     static SmartPtr<FeatureMatch> create_default_feature_match ();
     static SmartPtr<FeatureMatch> create_cluster_feature_match ();
     static SmartPtr<FeatureMatch> create_capi_feature_match ();
+    static SmartPtr<FeatureMatch> create_soft_feature_match ();
 
     virtual void feature_match (
         const SmartPtr<VideoBuffer> &left_buf, const SmartPtr<VideoBuffer> &right_buf) = 0;
@@ -75,6 +78,8 @@ public:
 
     virtual void set_dst_width (int width);
     virtual void enable_adjust_crop_area ();
+    // reuse corners tracked from last frame, re-detect only when fewer than min_corners are left
+    virtual void enable_corner_tracking (bool enable);
 
 protected:
     bool get_mean_offset (const std::vector<float> &offsets, float sum, int &count, float &mean_offset);
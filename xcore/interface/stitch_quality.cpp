@@ -0,0 +1,146 @@
+/*
+ * stitch_quality.cpp - adaptive stitching quality controller
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "stitch_quality.h"
+
+// weight of current frame time in moving average
+#define QUALITY_AVG_WEIGHT      0.2f
+// degrade after budget was exceeded for continuous frames
+#define QUALITY_DEGRADE_FRAMES  3
+// restore after average time kept below headroom ratio for continuous frames
+#define QUALITY_RESTORE_FRAMES  30
+#define QUALITY_HEADROOM_RATIO  0.7f
+
+namespace XCam {
+
+StitchQualityCtrl::StitchQualityCtrl ()
+    : _budget_us (0)
+    , _level (0)
+    , _max_level (0)
+    , _avg_time (0.0f)
+    , _over_count (0)
+    , _under_count (0)
+{
+}
+
+uint32_t
+StitchQualityCtrl::fm_steps () const
+{
+    uint32_t steps = 0;
+    if (_best.fm_interval == 0)
+        return 0;
+
+    for (uint32_t interval = _best.fm_interval; interval < XCAM_STITCH_MAX_FM_INTERVAL; interval *= 2)
+        ++steps;
+    return steps;
+}
+
+uint32_t
+StitchQualityCtrl::pyr_steps () const
+{
+    return _best.blend_pyr_levels > 1 ? (_best.blend_pyr_levels - 1) : 0;
+}
+
+uint32_t
+StitchQualityCtrl::map_steps () const
+{
+    uint32_t steps = 0;
+    for (uint32_t factor = _best.map_factor; factor < XCAM_STITCH_MAX_MAP_FACTOR; factor *= 2)
+        ++steps;
+    return steps;
+}
+
+void
+StitchQualityCtrl::reset (const StitchQuality &best)
+{
+    XCAM_ASSERT (best.blend_pyr_levels >= 1 && best.map_factor >= 1);
+
+    _best = best;
+    _cur = best;
+    _level = 0;
+    _max_level = fm_steps () + pyr_steps () + map_steps ();
+    _avg_time = 0.0f;
+    _over_count = 0;
+    _under_count = 0;
+}
+
+StitchQuality
+StitchQualityCtrl::quality_at_level (uint32_t level) const
+{
+    StitchQuality quality = _best;
+
+    uint32_t steps = XCAM_MIN (level, fm_steps ());
+    for (uint32_t i = 0; i < steps; ++i)
+        quality.fm_interval *= 2;
+    level -= steps;
+
+    steps = XCAM_MIN (level, pyr_steps ());
+    quality.blend_pyr_levels -= steps;
+    level -= steps;
+
+    steps = XCAM_MIN (level, map_steps ());
+    for (uint32_t i = 0; i < steps; ++i)
+        quality.map_factor *= 2;
+
+    return quality;
+}
+
+bool
+StitchQualityCtrl::update (int64_t frame_time_us)
+{
+    if (!is_enabled () || frame_time_us <= 0)
+        return false;
+
+    if (_avg_time <= 0.0f)
+        _avg_time = (float) frame_time_us;
+    else
+        _avg_time = _avg_time * (1.0f - QUALITY_AVG_WEIGHT) + frame_time_us * QUALITY_AVG_WEIGHT;
+
+    uint32_t level = _level;
+    if (_avg_time > _budget_us) {
+        _under_count = 0;
+        if (++_over_count >= QUALITY_DEGRADE_FRAMES && _level < _max_level)
+            level = _level + 1;
+    } else if (_avg_time < _budget_us * QUALITY_HEADROOM_RATIO) {
+        _over_count = 0;
+        if (++_under_count >= QUALITY_RESTORE_FRAMES && _level > 0)
+            level = _level - 1;
+    } else {
+        _over_count = 0;
+        _under_count = 0;
+    }
+
+    if (level == _level)
+        return false;
+
+    _level = level;
+    _cur = quality_at_level (level);
+    _over_count = 0;
+    _under_count = 0;
+
+    XCAM_LOG_INFO (
+        "stitch quality level:%d/%d (avg time:%.2fms budget:%.2fms), pyr_levels:%d fm_interval:%d map_factor:%d",
+        _level, _max_level, _avg_time / 1000.0f, _budget_us / 1000.0f,
+        _cur.blend_pyr_levels, _cur.fm_interval, _cur.map_factor);
+
+    return true;
+}
+
+}
@@ -0,0 +1,112 @@
+/*
+ * stitch_quality.h - adaptive stitching quality controller
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_INTERFACE_STITCH_QUALITY_H
+#define XCAM_INTERFACE_STITCH_QUALITY_H
+
+#include <xcam_std.h>
+
+#define XCAM_STITCH_MAX_FM_INTERVAL      8
+#define XCAM_STITCH_MAX_MAP_FACTOR       64
+
+namespace XCam {
+
+struct StitchQuality {
+    uint32_t blend_pyr_levels;
+    uint32_t fm_interval;     // run feature match every fm_interval frames, 0: feature match disabled
+    uint32_t map_factor;      // geomap lookup table down-scale factor
+
+    StitchQuality ()
+        : blend_pyr_levels (2)
+        , fm_interval (0)
+        , map_factor (16)
+    {}
+    bool operator == (const StitchQuality &other) const {
+        return blend_pyr_levels == other.blend_pyr_levels &&
+               fm_interval == other.fm_interval &&
+               map_factor == other.map_factor;
+    }
+    bool operator != (const StitchQuality &other) const {
+        return !(*this == other);
+    }
+};
+
+/*
+ * closed-loop controller, watches per-frame processing time.
+ * quality is degraded step by step when the frame time budget is exceeded:
+ *   feature match interval -> blend pyramid levels -> geomap lookup table resolution
+ * and restored in reverse order when there is enough headroom.
+ */
+class StitchQualityCtrl
+{
+public:
+    explicit StitchQualityCtrl ();
+
+    // budget in microseconds, 0 disables the controller
+    void set_frame_budget (uint32_t budget_us) {
+        _budget_us = budget_us;
+    }
+    uint32_t get_frame_budget () const {
+        return _budget_us;
+    }
+    bool is_enabled () const {
+        return _budget_us > 0;
+    }
+
+    void reset (const StitchQuality &best);
+
+    // feed frame processing time, return true if quality changed
+    bool update (int64_t frame_time_us);
+
+    const StitchQuality &get_quality () const {
+        return _cur;
+    }
+    uint32_t get_level () const {
+        return _level;
+    }
+    uint32_t get_max_level () const {
+        return _max_level;
+    }
+    float get_average_time () const {
+        return _avg_time;
+    }
+
+private:
+    StitchQuality quality_at_level (uint32_t level) const;
+    uint32_t fm_steps () const;
+    uint32_t pyr_steps () const;
+    uint32_t map_steps () const;
+
+    XCAM_DEAD_COPY (StitchQualityCtrl);
+
+private:
+    uint32_t         _budget_us;
+    StitchQuality    _best;
+    StitchQuality    _cur;
+    uint32_t         _level;
+    uint32_t         _max_level;
+    float            _avg_time;
+    uint32_t         _over_count;
+    uint32_t         _under_count;
+};
+
+}
+
+#endif //XCAM_INTERFACE_STITCH_QUALITY_H
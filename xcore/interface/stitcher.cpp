@@ -90,6 +90,7 @@ Stitcher::Stitcher (uint32_t align_x, uint32_t align_y)
     , _output_height (0)
     , _out_start_angle (OUT_WINDOWS_START)
     , _camera_num (0)
+    , _is_calibration_set (false)
     , _is_round_view_set (false)
     , _is_overlap_set (false)
     , _is_crop_set (false)
@@ -101,8 +102,10 @@ Stitcher::Stitcher (uint32_t align_x, uint32_t align_y)
     , _fm_mode (FMNone)
     , _fm_status (FMStatusWholeWay)
     , _fm_frames (100)
+    , _fm_lag (1)
     , _fm_frame_count (UINT32_MAX)
     , _blend_pyr_levels (2)
+    , _frame_time_budget (0)
 {
     XCAM_ASSERT (align_x >= 1);
     XCAM_ASSERT (align_y >= 1);
@@ -147,6 +150,18 @@ Stitcher::set_camera_info (uint32_t index, const CameraInfo &info)
     return true;
 }
 
+bool
+Stitcher::set_calibration_info (uint32_t index, const CalibrationInfo &info)
+{
+    XCAM_FAIL_RETURN (
+        ERROR, index < _camera_num, false,
+        "stitcher: set calibration info failed, index(%d) exceed max camera num(%d)",
+        index, _camera_num);
+    _camera_info[index].calibration = info;
+    _is_calibration_set = true;
+    return true;
+}
+
 bool
 Stitcher::set_crop_info (uint32_t index, const ImageCropInfo &info)
 {
@@ -257,6 +272,13 @@ Stitcher::init_camera_info ()
             info.angle_range = _viewpoints_range[i];
             info.round_angle_start = (i * 360.0f / _camera_num) - info.angle_range / 2.0f;
         }
+    } else if (_is_calibration_set) {
+        XCAM_LOG_INFO ("stitcher use calibration info set by user");
+        for (uint32_t i = 0; i < _camera_num; ++i) {
+            CameraInfo &info = _camera_info[i];
+            info.angle_range = _viewpoints_range[i];
+            info.round_angle_start = (i * 360.0f / _camera_num) - info.angle_range / 2.0f;
+        }
     } else {
         const char* cfg_path = std::getenv (FISHEYE_CONFIG_ENV_VAR);
         XCAM_FAIL_RETURN (
@@ -78,6 +78,20 @@ struct CameraInfo {
     float             angle_range;;
 };
 
+// per-frame stage timing in microseconds, measured from the start of the frame
+struct StitchStageTime {
+    int64_t geomap;          // all fisheye geomap tasks done
+    int64_t blend;           // all overlap blenders done
+    int64_t copy;            // all copy tasks done
+    int64_t feature_match;   // accumulated feature match time
+    int64_t total;
+
+    StitchStageTime ()
+        : geomap (0), blend (0), copy (0)
+        , feature_match (0), total (0)
+    {}
+};
+
 class VKDevice;
 
 class Stitcher
@@ -150,6 +164,12 @@ public:
     bool set_camera_info (uint32_t index, const CameraInfo &info);
     bool get_camera_info (uint32_t index, CameraInfo &info) const;
 
+    // calibration already in bowl coordinates, overrides calibration files of FISHEYE_CONFIG_PATH
+    bool set_calibration_info (uint32_t index, const CalibrationInfo &info);
+    bool is_calibration_info_set () const {
+        return _is_calibration_set;
+    }
+
     bool set_crop_info (uint32_t index, const ImageCropInfo &info);
     bool get_crop_info (uint32_t index, ImageCropInfo &info) const;
     bool is_crop_info_set () const {
@@ -219,6 +239,14 @@ public:
         return _fm_frames;
     }
 
+    // result of feature match on frame n is applied to frame n + lag at the earliest, soft stitcher only
+    void set_fm_lag (uint32_t fm_lag) {
+        _fm_lag = fm_lag;
+    }
+    uint32_t get_fm_lag () {
+        return _fm_lag;
+    }
+
     void set_fm_frame_count (uint32_t frame_count) {
         _fm_frame_count = frame_count;
     }
@@ -233,6 +261,18 @@ public:
         return _blend_pyr_levels;
     }
 
+    // per-frame processing time budget in microseconds, 0 disables adaptive quality scaling
+    void set_frame_time_budget (uint32_t budget_us) {
+        _frame_time_budget = budget_us;
+    }
+    uint32_t get_frame_time_budget () {
+        return _frame_time_budget;
+    }
+
+    const StitchStageTime &get_stage_time () const {
+        return _stage_time;
+    }
+
     bool set_viewpoints_range (const float *range);
     bool set_instrinsic_names (const char *instr_names[]);
     bool set_exstrinsic_names (const char *exstr_names[]);
@@ -263,6 +303,10 @@ protected:
         return _copy_areas;
     }
 
+    void set_stage_time (const StitchStageTime &stage_time) {
+        _stage_time = stage_time;
+    }
+
 private:
     XCAM_DEAD_COPY (Stitcher);
 
@@ -272,6 +316,7 @@ private:
     float                       _out_start_angle;
     uint32_t                    _camera_num;
     CameraInfo                  _camera_info[XCAM_STITCH_MAX_CAMERAS];
+    bool                        _is_calibration_set;
     char                       *_instr_names[XCAM_STITCH_MAX_CAMERAS];
     char                       *_exstr_names[XCAM_STITCH_MAX_CAMERAS];
 
@@ -304,9 +349,12 @@ private:
     FeatureMatchMode            _fm_mode;
     FeatureMatchStatus          _fm_status;
     uint32_t                    _fm_frames;
+    uint32_t                    _fm_lag;
     uint32_t                    _fm_frame_count;
 
     uint32_t                    _blend_pyr_levels;
+    uint32_t                    _frame_time_budget;
+    StitchStageTime             _stage_time;
 };
 
 class BowlModel {
@@ -31,7 +31,7 @@ class EventPollThread
 {
 public:
     EventPollThread (PollThread *poll)
-        : Thread ("event_poll")
+        : Thread ("event_poll", ThreadRoleCapture)
         , _poll (poll)
     {}
 
@@ -59,7 +59,7 @@ class CapturePollThread
 {
 public:
     CapturePollThread (PollThread *poll)
-        : Thread ("capture_poll")
+        : Thread ("capture_poll", ThreadRoleCapture)
         , _poll (poll)
     {}
 
@@ -36,9 +36,14 @@ SmartAnalysisHandler::SmartAnalysisHandler (XCamSmartAnalysisDescription *desc,
     , _name (NULL)
     , _context (NULL)
     , _async_mode (false)
+    , _frame_skip (0)
+    , _frame_count (0)
 {
     if (name)
         _name = strndup (name, XCAM_MAX_STR_SIZE);
+
+    if (_desc && _desc->size >= sizeof (XCamSmartAnalysisDescription) && _desc->frame_interval > 1)
+        _frame_skip = _desc->frame_interval - 1;
 }
 
 SmartAnalysisHandler::~SmartAnalysisHandler ()
@@ -134,6 +139,30 @@ SmartAnalysisHandler::post_smart_results (const XCamVideoBuffer *buffer, XCam3aR
     return XCAM_RETURN_NO_ERROR;
 }
 
+bool
+SmartAnalysisHandler::get_analysis_size (uint32_t &width, uint32_t &height) const
+{
+    if (!_desc || _desc->size < sizeof (XCamSmartAnalysisDescription))
+        return false;
+    if (!_desc->width || !_desc->height)
+        return false;
+
+    width = _desc->width;
+    height = _desc->height;
+    return true;
+}
+
+bool
+SmartAnalysisHandler::check_frame_skip ()
+{
+    bool need_analyze = (_frame_count == 0);
+
+    if (++_frame_count > _frame_skip)
+        _frame_count = 0;
+
+    return need_analyze;
+}
+
 XCamReturn
 SmartAnalysisHandler::update_params (XCamSmartAnalysisParam &params)
 {
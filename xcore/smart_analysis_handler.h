@@ -63,6 +63,19 @@ public:
         return 0;
     }
 
+    // desired analysis resolution from plugin description, false if plugin takes input resolution
+    bool get_analysis_size (uint32_t &width, uint32_t &height) const;
+
+    // analyze one frame then skip next frame_skip frames, 0 means analyze every frame
+    void set_frame_skip (uint32_t frame_skip) {
+        _frame_skip = frame_skip;
+    }
+    uint32_t get_frame_skip () const {
+        return _frame_skip;
+    }
+    // count an incoming frame, return true if it need be analyzed
+    bool check_frame_skip ();
+
 protected:
     XCamReturn post_smart_results (const XCamVideoBuffer *buffer, XCam3aResultHead *results[], uint32_t res_count);
     static XCamReturn post_aync_results (
@@ -86,6 +99,8 @@ private:
     char                           *_name;
     XCamSmartAnalysisContext       *_context;
     bool                            _async_mode;
+    uint32_t                        _frame_skip;
+    uint32_t                        _frame_count;
 };
 
 }
@@ -21,13 +21,117 @@
 #include "smart_analyzer_loader.h"
 #include "smart_analyzer.h"
 #include "smart_analysis_handler.h"
+#include "thread_pool.h"
 
 #include "xcam_obj_debug.h"
 
 namespace XCam {
 
+class SmartAnalysisSync {
+public:
+    explicit SmartAnalysisSync (uint32_t count)
+        : _remain (count)
+    {}
+    void done () {
+        SmartLock locker (_mutex);
+        XCAM_ASSERT (_remain > 0);
+        if (--_remain == 0)
+            _cond.broadcast ();
+    }
+    void wait () {
+        SmartLock locker (_mutex);
+        while (_remain > 0)
+            _cond.wait (_mutex);
+    }
+
+private:
+    XCAM_DEAD_COPY (SmartAnalysisSync);
+
+private:
+    Mutex       _mutex;
+    Cond        _cond;
+    uint32_t    _remain;
+};
+
+class SmartAnalysisJob
+    : public ThreadPool::UserData
+{
+public:
+    SmartAnalysisJob (
+        const SmartPtr<SmartAnalysisHandler> &handler,
+        const SmartPtr<VideoBuffer> &buffer,
+        const SmartPtr<SmartAnalysisSync> &sync)
+        : _handler (handler)
+        , _buffer (buffer)
+        , _sync (sync)
+        , _error (XCAM_RETURN_NO_ERROR)
+    {}
+
+    virtual XCamReturn run () {
+        _error = _handler->analyze (_buffer, _results);
+        return _error;
+    }
+    virtual void done (XCamReturn err) {
+        XCAM_UNUSED (err);
+        _buffer.release ();
+        _sync->done ();
+    }
+
+    const SmartPtr<SmartAnalysisHandler> &get_handler () const {
+        return _handler;
+    }
+    X3aResultList &get_results () {
+        return _results;
+    }
+    XCamReturn get_error () const {
+        return _error;
+    }
+
+private:
+    SmartPtr<SmartAnalysisHandler>  _handler;
+    SmartPtr<VideoBuffer>           _buffer;
+    SmartPtr<SmartAnalysisSync>     _sync;
+    X3aResultList                   _results;
+    XCamReturn                      _error;
+};
+
+// input mapped once on analyzer thread, handlers running in parallel share the mapping
+// instead of mapping one buffer concurrently, which DRM and USRPTR buffers do not allow
+class SmartMappedBuffer
+    : public VideoBuffer
+{
+public:
+    SmartMappedBuffer (const SmartPtr<VideoBuffer> &buffer, uint8_t *mem)
+        : VideoBuffer (buffer->get_video_info (), buffer->get_timestamp ())
+        , _buffer (buffer)
+        , _mem (mem)
+    {
+        XCAM_ASSERT (mem);
+    }
+
+    virtual uint8_t *map () {
+        return _mem;
+    }
+    virtual bool unmap () {
+        return true;
+    }
+    virtual int get_fd () {
+        return _buffer->get_fd ();
+    }
+
+private:
+    XCAM_DEAD_COPY (SmartMappedBuffer);
+
+private:
+    SmartPtr<VideoBuffer>   _buffer;
+    uint8_t                *_mem;
+};
+
 SmartAnalyzer::SmartAnalyzer (const char *name)
     : XAnalyzer (name)
+    , _parallel_mode (false)
+    , _max_threads (0)
+    , _scaler_creator (NULL)
 {
     XCAM_OBJ_PROFILING_INIT;
 }
@@ -49,6 +153,37 @@ SmartAnalyzer::add_handler (SmartPtr<SmartAnalysisHandler> handler)
     return ret;
 }
 
+bool
+SmartAnalyzer::set_parallel_mode (bool enable, uint32_t max_threads)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, !_threads.ptr (), false,
+        "smart analyzer(%s) set parallel mode failed, it's already initialized", XCAM_STR (get_name ()));
+
+    _parallel_mode = enable;
+    _max_threads = max_threads;
+    return true;
+}
+
+XCamReturn
+SmartAnalyzer::set_frame_skip (const char *handler_name, uint32_t frame_skip)
+{
+    XCAM_ASSERT (handler_name);
+
+    SmartHandlerList::iterator i_handler = _handlers.begin ();
+    for (; i_handler != _handlers.end ();  ++i_handler)
+    {
+        SmartPtr<SmartAnalysisHandler> handler = *i_handler;
+        if (handler->get_name () && !strcmp (handler->get_name (), handler_name)) {
+            handler->set_frame_skip (frame_skip);
+            return XCAM_RETURN_NO_ERROR;
+        }
+    }
+
+    XCAM_LOG_WARNING ("smart analyzer can't find handler(%s) to set frame skip", handler_name);
+    return XCAM_RETURN_ERROR_PARAM;
+}
+
 XCamReturn
 SmartAnalyzer::create_handlers ()
 {
@@ -82,12 +217,38 @@ SmartAnalyzer::internal_init (uint32_t width, uint32_t height, double framerate)
         }
     }
 
+    if (_parallel_mode && _handlers.size () > 1) {
+        // analyzer thread runs one of the handlers itself
+        uint32_t thread_count = _handlers.size () - 1;
+        if (_max_threads && _max_threads < thread_count)
+            thread_count = _max_threads;
+
+        _threads = new ThreadPool ("smart-analyzer-thrs");
+        XCAM_ASSERT (_threads.ptr ());
+        _threads->set_role (ThreadRoleAnalyzer);
+        _threads->set_threads (thread_count, thread_count);
+        XCamReturn ret = _threads->start ();
+        if (!xcam_ret_is_ok (ret)) {
+            XCAM_LOG_WARNING ("smart analyzer start threads failed, fall back to serial mode");
+            _threads.release ();
+        }
+    }
+
     return XCAM_RETURN_NO_ERROR;
 }
 
 XCamReturn
 SmartAnalyzer::internal_deinit ()
 {
+    if (_threads.ptr ()) {
+        _threads->stop ();
+        _threads.release ();
+    }
+
+    for (ScalerMap::iterator i_scaler = _scalers.begin (); i_scaler != _scalers.end (); ++i_scaler)
+        i_scaler->second->terminate ();
+    _scalers.clear ();
+
     SmartHandlerList::iterator i_handler = _handlers.begin ();
     for (; i_handler != _handlers.end ();  ++i_handler)
     {
@@ -134,7 +295,6 @@ SmartAnalyzer::analyze (const SmartPtr<VideoBuffer> &buffer)
 {
     XCAM_OBJ_PROFILING_START;
 
-    XCamReturn ret = XCAM_RETURN_NO_ERROR;
     X3aResultList results;
 
     if (!buffer.ptr ()) {
@@ -142,26 +302,169 @@ SmartAnalyzer::analyze (const SmartPtr<VideoBuffer> &buffer)
         return XCAM_RETURN_ERROR_PARAM;
     }
 
+    SmartHandlerList active_handlers;
+    BufferArray inputs;
+    ScaledBufferMap scaled;
     SmartHandlerList::iterator i_handler = _handlers.begin ();
     for (; i_handler != _handlers.end ();  ++i_handler)
     {
         SmartPtr<SmartAnalysisHandler> handler = *i_handler;
-        if (!handler->is_valid ())
+        if (!handler->is_valid () || !handler->check_frame_skip ())
             continue;
+        active_handlers.push_back (handler);
+        inputs.push_back (get_handler_input (handler, buffer, scaled));
+    }
+
+    if (_threads.ptr () && active_handlers.size () > 1)
+        analyze_parallel (active_handlers, inputs, results);
+    else
+        analyze_serial (active_handlers, inputs, results);
+
+    if (!results.empty ()) {
+        set_results_timestamp (results, buffer->get_timestamp ());
+        notify_calculation_done (results);
+    }
+
+    XCAM_OBJ_PROFILING_END ("smart analysis", XCAM_OBJ_DUR_FRAME_NUM);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SmartPtr<VideoBuffer>
+SmartAnalyzer::get_handler_input (
+    const SmartPtr<SmartAnalysisHandler> &handler, const SmartPtr<VideoBuffer> &buffer,
+    ScaledBufferMap &scaled)
+{
+    uint32_t width = 0, height = 0;
+    if (!_scaler_creator || !handler->get_analysis_size (width, height))
+        return buffer;
+
+    const VideoBufferInfo &info = buffer->get_video_info ();
+    ScaleSize size (XCAM_ALIGN_UP (width, 2), XCAM_ALIGN_UP (height, 2));
+    if (info.format != V4L2_PIX_FMT_NV12 || size.first > info.width || size.second > info.height ||
+            (size.first == info.width && size.second == info.height))
+        return buffer;
+
+    ScaledBufferMap::iterator i_buf = scaled.find (size);
+    if (i_buf != scaled.end ())
+        return i_buf->second;
+
+    SmartPtr<VideoBuffer> scaled_buf = scale_buffer (size, buffer);
+    if (!scaled_buf.ptr ()) {
+        XCAM_LOG_WARNING (
+            "smart analyzer scale frame to %dx%d for handler(%s) failed, feed full frame",
+            size.first, size.second, XCAM_STR (handler->get_name ()));
+        scaled_buf = buffer;
+    }
+    scaled[size] = scaled_buf;
+
+    return scaled_buf;
+}
+
+SmartPtr<VideoBuffer>
+SmartAnalyzer::scale_buffer (const ScaleSize &size, const SmartPtr<VideoBuffer> &buffer)
+{
+    XCAM_ASSERT (_scaler_creator);
+
+    SmartPtr<ImageHandler> &scaler = _scalers[size];
+    if (!scaler.ptr ()) {
+        scaler = _scaler_creator (size.first, size.second);
+        XCAM_FAIL_RETURN (
+            WARNING, scaler.ptr (), NULL,
+            "smart analyzer create scaler(%dx%d) failed", size.first, size.second);
+    }
+
+    SmartPtr<ImageHandler::Parameters> param = new ImageHandler::Parameters (buffer);
+    XCamReturn ret = scaler->execute_buffer (param, true);
+    XCAM_FAIL_RETURN (
+        WARNING, xcam_ret_is_ok (ret) && param->out_buf.ptr (), NULL,
+        "smart analyzer scaler(%s) execute failed", XCAM_STR (scaler->get_name ()));
+
+    return param->out_buf;
+}
+
+XCamReturn
+SmartAnalyzer::analyze_serial (
+    const SmartHandlerList &handlers, const BufferArray &inputs, X3aResultList &results)
+{
+    XCAM_ASSERT (handlers.size () == inputs.size ());
 
-        ret = handler->analyze (buffer, results);
+    SmartHandlerList::const_iterator i_handler = handlers.begin ();
+    for (uint32_t idx = 0; i_handler != handlers.end ();  ++i_handler, ++idx)
+    {
+        SmartPtr<SmartAnalysisHandler> handler = *i_handler;
+        XCamReturn ret = handler->analyze (inputs[idx], results);
         if (ret != XCAM_RETURN_NO_ERROR && ret != XCAM_RETURN_BYPASS) {
             XCAM_LOG_WARNING ("smart analyzer analyze handler(%s) context failed", XCAM_STR(handler->get_name()));
             handler->destroy_context ();
         }
     }
 
-    if (!results.empty ()) {
-        set_results_timestamp (results, buffer->get_timestamp ());
-        notify_calculation_done (results);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SmartAnalyzer::analyze_parallel (
+    const SmartHandlerList &handlers, const BufferArray &inputs, X3aResultList &results)
+{
+    XCAM_ASSERT (_threads.ptr ());
+    XCAM_ASSERT (handlers.size () == inputs.size ());
+
+    // handlers may share one input, map each distinct input once
+    BufferArray mapped_inputs;
+    std::map<VideoBuffer *, SmartPtr<VideoBuffer> > mapped;
+    for (uint32_t i = 0; i < inputs.size (); ++i) {
+        SmartPtr<VideoBuffer> &mapped_buf = mapped[inputs[i].ptr ()];
+        if (!mapped_buf.ptr ()) {
+            uint8_t *mem = inputs[i]->map ();
+            if (!mem) {
+                mapped.erase (inputs[i].ptr ());
+                break;
+            }
+            mapped_buf = new SmartMappedBuffer (inputs[i], mem);
+        }
+        mapped_inputs.push_back (mapped_buf);
     }
 
-    XCAM_OBJ_PROFILING_END ("smart analysis", XCAM_OBJ_DUR_FRAME_NUM);
+    if (mapped_inputs.size () != inputs.size ()) {
+        XCAM_LOG_WARNING ("smart analyzer map input failed, run handlers one by one");
+        for (std::map<VideoBuffer *, SmartPtr<VideoBuffer> >::iterator i = mapped.begin (); i != mapped.end (); ++i)
+            i->first->unmap ();
+        return analyze_serial (handlers, inputs, results);
+    }
+
+    SmartPtr<SmartAnalysisSync> sync = new SmartAnalysisSync (handlers.size ());
+    std::vector<SmartPtr<SmartAnalysisJob> > jobs;
+    SmartHandlerList::const_iterator i_handler = handlers.begin ();
+    for (uint32_t idx = 0; i_handler != handlers.end ();  ++i_handler, ++idx)
+        jobs.push_back (new SmartAnalysisJob (*i_handler, mapped_inputs[idx], sync));
+
+    // first job runs on analyzer thread, others go to the pool
+    for (uint32_t i = 1; i < jobs.size (); ++i) {
+        if (!xcam_ret_is_ok (_threads->queue (jobs[i]))) {
+            XCAM_LOG_WARNING (
+                "smart analyzer queue handler(%s) failed, run it in place",
+                XCAM_STR (jobs[i]->get_handler ()->get_name ()));
+            jobs[i]->done (jobs[i]->run ());
+        }
+    }
+    jobs[0]->done (jobs[0]->run ());
+    sync->wait ();
+
+    for (std::map<VideoBuffer *, SmartPtr<VideoBuffer> >::iterator i = mapped.begin (); i != mapped.end (); ++i)
+        i->first->unmap ();
+
+    // merge results in handler priority order, all of them belong to the same frame
+    for (uint32_t i = 0; i < jobs.size (); ++i) {
+        XCamReturn ret = jobs[i]->get_error ();
+        if (ret != XCAM_RETURN_NO_ERROR && ret != XCAM_RETURN_BYPASS) {
+            SmartPtr<SmartAnalysisHandler> handler = jobs[i]->get_handler ();
+            XCAM_LOG_WARNING ("smart analyzer analyze handler(%s) context failed", XCAM_STR(handler->get_name()));
+            handler->destroy_context ();
+            continue;
+        }
+        results.splice (results.end (), jobs[i]->get_results ());
+    }
 
     return XCAM_RETURN_NO_ERROR;
 }
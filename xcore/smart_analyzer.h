@@ -24,10 +24,17 @@
 #include <xcam_analyzer.h>
 #include <smart_analysis_handler.h>
 #include <x3a_result_factory.h>
+#include <image_handler.h>
+#include <map>
+#include <vector>
 
 namespace XCam {
 
 class VideoBuffer;
+class ThreadPool;
+
+// create a scaler which outputs width x height NV12 frames
+typedef SmartPtr<ImageHandler> (*SmartScalerCreator) (uint32_t width, uint32_t height);
 
 class SmartAnalyzer
     : public XAnalyzer
@@ -40,6 +47,20 @@ public:
     XCamReturn update_params (XCamSmartAnalysisParam &params);
     void post_smart_results (X3aResultList &results, int64_t timestamp);
 
+    // run handlers of one frame concurrently on a thread pool, need be set before init
+    // max_threads 0 means one thread for each handler
+    bool set_parallel_mode (bool enable, uint32_t max_threads = 0);
+    bool is_parallel_mode () const {
+        return _parallel_mode;
+    }
+    XCamReturn set_frame_skip (const char *handler_name, uint32_t frame_skip);
+
+    // handlers requesting a smaller resolution get frames scaled by creator's scalers,
+    // one scaled buffer per distinct size is shared by handlers; full frames are fed if not set
+    void set_scaler_creator (SmartScalerCreator creator) {
+        _scaler_creator = creator;
+    }
+
 protected:
     virtual XCamReturn create_handlers ();
     virtual XCamReturn release_handlers ();
@@ -49,11 +70,30 @@ protected:
     virtual XCamReturn analyze (const SmartPtr<VideoBuffer> &buffer);
 
 private:
+    typedef std::vector<SmartPtr<VideoBuffer> > BufferArray;
+    typedef std::pair<uint32_t, uint32_t> ScaleSize;
+    typedef std::map<ScaleSize, SmartPtr<ImageHandler> > ScalerMap;
+    typedef std::map<ScaleSize, SmartPtr<VideoBuffer> > ScaledBufferMap;
+
+    SmartPtr<VideoBuffer> get_handler_input (
+        const SmartPtr<SmartAnalysisHandler> &handler, const SmartPtr<VideoBuffer> &buffer,
+        ScaledBufferMap &scaled);
+    SmartPtr<VideoBuffer> scale_buffer (const ScaleSize &size, const SmartPtr<VideoBuffer> &buffer);
+    XCamReturn analyze_serial (
+        const SmartHandlerList &handlers, const BufferArray &inputs, X3aResultList &results);
+    XCamReturn analyze_parallel (
+        const SmartHandlerList &handlers, const BufferArray &inputs, X3aResultList &results);
+
     XCAM_DEAD_COPY (SmartAnalyzer);
 
 private:
-    SmartHandlerList   _handlers;
-    X3aResultList      _results;
+    SmartHandlerList      _handlers;
+    X3aResultList         _results;
+    bool                  _parallel_mode;
+    uint32_t              _max_threads;
+    SmartPtr<ThreadPool>  _threads;
+    SmartScalerCreator    _scaler_creator;
+    ScalerMap             _scalers;
 
     XCAM_OBJ_PROFILING_DEFINES;
 
@@ -133,9 +133,10 @@ SmartAnalyzerLoader::load_symbol (void* handle)
         XCAM_LOG_WARNING ("get symbol version is:0x%04x, but expect:0x%04x",
                           desc->version, xcam_version ());
     }
-    if (desc->size < sizeof (XCamSmartAnalysisDescription)) {
-        XCAM_LOG_DEBUG ("get symbol failed, XCamSmartAnalysisDescription size is:%" PRIu32 ", but expect:%" PRIuS,
-                        desc->size, sizeof (XCamSmartAnalysisDescription));
+    // plugins built before resolution/frame_interval were appended are still accepted
+    if (desc->size < XCAM_SMART_ANALYSIS_DESCRIPTION_MIN_SIZE) {
+        XCAM_LOG_DEBUG ("get symbol failed, XCamSmartAnalysisDescription size is:%" PRIu32 ", but expect:%" PRIu32,
+                        desc->size, XCAM_SMART_ANALYSIS_DESCRIPTION_MIN_SIZE);
         return NULL;
     }
 
@@ -0,0 +1,219 @@
+/*
+ * spsc_queue.h - single producer single consumer queue
+ *
+ *  Copyright (c) 2026 libXCam contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SPSC_QUEUE_H
+#define XCAM_SPSC_QUEUE_H
+
+#include <base/xcam_defs.h>
+#include <base/xcam_common.h>
+#include <smartptr.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <atomic>
+#include <vector>
+
+#define XCAM_SPSC_QUEUE_DEFAULT_CAPACITY 32
+#define XCAM_SPSC_QUEUE_CACHE_LINE 64
+
+namespace XCam {
+
+/*
+ * bounded ring queue, lock-free for one producer thread and one consumer thread.
+ * pop blocks on a futex only when the queue is empty, push never blocks and
+ * fails when the queue is full. slots are preallocated, push/pop do not allocate.
+ */
+template<class OBj>
+class SpscQueue {
+public:
+    typedef SmartPtr<OBj> ObjPtr;
+
+    explicit SpscQueue (uint32_t capacity = XCAM_SPSC_QUEUE_DEFAULT_CAPACITY);
+    ~SpscQueue () {}
+
+    // producer only
+    inline bool push (const ObjPtr &obj);
+
+    /*
+     * consumer only
+     * timeout, -1,  wait until wakeup
+     *         >=0,  wait for @timeout microsseconds
+    */
+    inline ObjPtr pop (int32_t timeout = -1);
+
+    uint32_t size () const {
+        return _tail.load (std::memory_order_acquire) - _head.load (std::memory_order_acquire);
+    }
+    bool is_empty () const {
+        return size () == 0;
+    }
+    uint32_t get_capacity () const {
+        return _mask + 1;
+    }
+
+    void wakeup () {
+        _seq.fetch_add (1, std::memory_order_seq_cst);
+        futex_wake (INT32_MAX);
+    }
+    void pause_pop () {
+        _pop_paused.store (true, std::memory_order_seq_cst);
+        wakeup ();
+    }
+    void resume_pop () {
+        _pop_paused.store (false, std::memory_order_seq_cst);
+    }
+
+    // consumer only, or when both sides stopped
+    inline void clear ();
+
+private:
+    inline bool try_pop (ObjPtr &obj);
+    inline int futex_wait (int32_t val, int32_t timeout);
+    void futex_wake (int32_t count) {
+        syscall (SYS_futex, (int32_t *)&_seq, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+    }
+
+    XCAM_DEAD_COPY (SpscQueue);
+
+private:
+    std::vector<ObjPtr>        _slots;
+    uint32_t                   _mask;
+    // head is written by consumer, tail by producer, pad them to different cache lines
+    std::atomic<uint32_t>      _head;
+    uint8_t                    _head_pad[XCAM_SPSC_QUEUE_CACHE_LINE];
+    std::atomic<uint32_t>      _tail;
+    uint8_t                    _tail_pad[XCAM_SPSC_QUEUE_CACHE_LINE];
+    std::atomic<int32_t>       _seq;
+    std::atomic<int32_t>       _waiters;
+    std::atomic<bool>          _pop_paused;
+};
+
+template<class OBj>
+SpscQueue<OBj>::SpscQueue (uint32_t capacity)
+    : _mask (0)
+    , _head (0)
+    , _tail (0)
+    , _seq (0)
+    , _waiters (0)
+    , _pop_paused (false)
+{
+    static_assert (sizeof (std::atomic<int32_t>) == sizeof (int32_t), "futex word need be 32 bits");
+
+    uint32_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+    _slots.resize (size);
+    _mask = size - 1;
+}
+
+template<class OBj>
+bool
+SpscQueue<OBj>::push (const ObjPtr &obj)
+{
+    const uint32_t tail = _tail.load (std::memory_order_relaxed);
+    if (tail - _head.load (std::memory_order_acquire) > _mask)
+        return false;
+
+    _slots[tail & _mask] = obj;
+    _tail.store (tail + 1, std::memory_order_seq_cst);
+
+    _seq.fetch_add (1, std::memory_order_seq_cst);
+    if (_waiters.load (std::memory_order_seq_cst) > 0)
+        futex_wake (1);
+    return true;
+}
+
+template<class OBj>
+bool
+SpscQueue<OBj>::try_pop (ObjPtr &obj)
+{
+    const uint32_t head = _head.load (std::memory_order_relaxed);
+    if (head == _tail.load (std::memory_order_acquire))
+        return false;
+
+    ObjPtr &slot = _slots[head & _mask];
+    obj = slot;
+    slot.release ();
+    _head.store (head + 1, std::memory_order_release);
+    return true;
+}
+
+template<class OBj>
+int
+SpscQueue<OBj>::futex_wait (int32_t val, int32_t timeout)
+{
+    struct timespec ts;
+    struct timespec *pts = NULL;
+    if (timeout >= 0) {
+        ts.tv_sec = timeout / 1000000;
+        ts.tv_nsec = (timeout % 1000000) * 1000;
+        pts = &ts;
+    }
+
+    if (syscall (SYS_futex, (int32_t *)&_seq, FUTEX_WAIT_PRIVATE, val, pts, NULL, 0) == 0)
+        return 0;
+    return errno;
+}
+
+template<class OBj>
+typename SpscQueue<OBj>::ObjPtr
+SpscQueue<OBj>::pop (int32_t timeout)
+{
+    ObjPtr obj;
+    int code = 0;
+
+    while (!_pop_paused.load (std::memory_order_acquire)) {
+        if (try_pop (obj))
+            return obj;
+        if (code == ETIMEDOUT)
+            break;
+
+        // register as waiter before sampling seq, producer then either changes seq or wakes us
+        _waiters.fetch_add (1, std::memory_order_seq_cst);
+        const int32_t seq = _seq.load (std::memory_order_seq_cst);
+        if (is_empty () && !_pop_paused.load (std::memory_order_seq_cst))
+            code = futex_wait (seq, timeout);
+        _waiters.fetch_sub (1, std::memory_order_seq_cst);
+
+        if (code != 0 && code != ETIMEDOUT && code != EAGAIN && code != EINTR) {
+            XCAM_LOG_ERROR ("spsc queue pop failed, code:%d", code);
+            return NULL;
+        }
+    }
+
+    if (code == ETIMEDOUT) {
+        XCAM_LOG_DEBUG ("spsc queue pop timeout");
+    }
+    return NULL;
+}
+
+template<class OBj>
+void
+SpscQueue<OBj>::clear ()
+{
+    ObjPtr obj;
+    while (try_pop (obj))
+        obj.release ();
+}
+
+};
+#endif //XCAM_SPSC_QUEUE_H
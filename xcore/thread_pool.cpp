@@ -30,7 +30,7 @@ class UserThread
 {
 public:
     UserThread (const SmartPtr<ThreadPool> &pool, const char *name)
-        : Thread (name)
+        : Thread (name, pool->get_role ())
         , _pool (pool)
     {}
 
@@ -106,6 +106,8 @@ ThreadPool::ThreadPool (const char *name)
     , _allocated_threads (0)
     , _free_threads (0)
     , _running (false)
+    , _role (ThreadRoleWorker)
+    , _attr_set (false)
 {
     if (name)
         _name = strndup (name, XCAM_MAX_STR_SIZE);
@@ -118,6 +120,21 @@ ThreadPool::~ThreadPool ()
     xcam_free (_name);
 }
 
+void
+ThreadPool::set_role (ThreadRole role)
+{
+    SmartLock locker (_mutex);
+    _role = role;
+}
+
+void
+ThreadPool::set_thread_attr (const ThreadAttr &attr)
+{
+    SmartLock locker (_mutex);
+    _attr = attr;
+    _attr_set = true;
+}
+
 bool
 ThreadPool::set_threads (uint32_t min, uint32_t max)
 {
@@ -216,6 +233,8 @@ ThreadPool::create_user_thread_unsafe ()
     snprintf (name, 255, "%s-%d", XCAM_STR (get_name()), _allocated_threads);
     SmartPtr<UserThread> thread = new UserThread (this, name);
     XCAM_ASSERT (thread.ptr ());
+    if (_attr_set)
+        thread->set_attr (_attr);
     XCAM_FAIL_RETURN (
         ERROR, thread.ptr () && thread->start (), XCAM_RETURN_ERROR_THREAD,
         "ThreadPool(%s) create user thread failed by starting error", XCAM_STR (get_name()));
@@ -55,6 +55,13 @@ public:
     }
     bool is_running ();
 
+    // thread role and attributes, applied to threads created after the call
+    void set_role (ThreadRole role);
+    ThreadRole get_role () const {
+        return _role;
+    }
+    void set_thread_attr (const ThreadAttr &attr);
+
     XCamReturn start ();
     XCamReturn stop ();
     XCamReturn queue (const SmartPtr<UserData> &data);
@@ -75,6 +82,9 @@ private:
     bool                    _running;
     UserThreadList          _thread_list;
     Mutex                   _mutex;
+    ThreadRole              _role;
+    ThreadAttr              _attr;
+    bool                    _attr_set;
 
     SafeList<UserData>      _data_queue;
 };
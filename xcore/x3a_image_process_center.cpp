@@ -113,7 +113,9 @@ X3aImageProcessCenter::put_buffer (SmartPtr<VideoBuffer> &buf)
 
     ImageProcessorList::iterator i_pro = _image_processors.begin ();
     SmartPtr<ImageProcessor> &processor = *i_pro;
-    if (processor->push_buffer (buf) != XCAM_RETURN_NO_ERROR)
+    // BYPASS, buffer dropped by a full processor queue
+    XCamReturn ret = processor->push_buffer (buf);
+    if (ret != XCAM_RETURN_NO_ERROR && ret != XCAM_RETURN_BYPASS)
         return false;
     return true;
 }
@@ -203,7 +205,7 @@ X3aImageProcessCenter::process_buffer_done (ImageProcessor *processor, const Sma
         SmartPtr<VideoBuffer> cur_buf = buf;
         XCAM_ASSERT (next_processor.ptr());
         XCamReturn ret = next_processor->push_buffer (cur_buf);
-        if (ret != XCAM_RETURN_NO_ERROR) {
+        if (ret != XCAM_RETURN_NO_ERROR && ret != XCAM_RETURN_BYPASS) {
             XCAM_LOG_ERROR ("processor(%s) failed in push_buffer", next_processor->get_name());
         }
         return;
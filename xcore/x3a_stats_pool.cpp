@@ -21,6 +21,7 @@
 #include "x3a_stats_pool.h"
 
 #define XCAM_3A_STATS_DEFAULT_BIT_DEPTH 8
+#define XCAM_3A_STATS_DEFAULT_GRID_SIZE 16
 
 namespace XCam {
 
@@ -70,6 +71,7 @@ X3aStats::get_stats ()
 
 X3aStatsPool::X3aStatsPool ()
     : _bit_depth (XCAM_3A_STATS_DEFAULT_BIT_DEPTH)
+    , _grid_size (XCAM_3A_STATS_DEFAULT_GRID_SIZE)
 {
 }
 
@@ -82,7 +84,8 @@ X3aStatsPool::set_stats_info (const XCam3AStatsInfo &info)
 bool
 X3aStatsPool::fixate_video_info (VideoBufferInfo &info)
 {
-    const uint32_t grid = 16;
+    const uint32_t grid = _grid_size;
+    XCAM_ASSERT (grid);
 
     _stats_info.aligned_width = (info.width + grid - 1) / grid;
     _stats_info.aligned_height = (info.height + grid - 1) / grid;
@@ -70,6 +70,9 @@ public:
     void set_bit_depth (uint32_t bit_depth) {
         _bit_depth = bit_depth;
     }
+    void set_grid_pixel_size (uint32_t grid_size) {
+        _grid_size = grid_size;
+    }
     void set_stats_info (const XCam3AStatsInfo &info);
 
 protected:
@@ -83,6 +86,7 @@ private:
 private:
     XCam3AStatsInfo    _stats_info;
     uint32_t           _bit_depth;
+    uint32_t           _grid_size;
 };
 
 };
@@ -26,7 +26,7 @@
 namespace XCam {
 
 AnalyzerThread::AnalyzerThread (XAnalyzer *analyzer)
-    : Thread ("AnalyzerThread")
+    : Thread ("AnalyzerThread", ThreadRoleAnalyzer)
     , _analyzer (analyzer)
 {}
 
@@ -38,7 +38,12 @@ AnalyzerThread::~AnalyzerThread ()
 bool
 AnalyzerThread::push_stats (const SmartPtr<VideoBuffer> &buffer)
 {
-    _stats_queue.push (buffer);
+    // stats queue is bounded, drop the new stats and keep the poll thread running,
+    // analyzer catches up with the queued ones
+    if (!_stats_queue.push (buffer)) {
+        XCAM_LOG_WARNING (
+            "analyzer(%s) stats queue is full, drop stats", XCAM_STR (_analyzer->get_name ()));
+    }
     return true;
 }
 
@@ -27,6 +27,7 @@
 #include <xcam_thread.h>
 #include <video_buffer.h>
 #include <safe_list.h>
+#include <spsc_queue.h>
 
 namespace XCam {
 
@@ -53,7 +54,8 @@ protected:
 
 private:
     XAnalyzer              *_analyzer;
-    SafeList<VideoBuffer>   _stats_queue;
+    // stats are pushed by poll thread only
+    SpscQueue<VideoBuffer>  _stats_queue;
 };
 
 class AnalyzerCallback {
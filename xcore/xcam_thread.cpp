@@ -21,11 +21,24 @@
 #include "xcam_thread.h"
 #include "xcam_mutex.h"
 #include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 
 namespace XCam {
 
-Thread::Thread (const char *name)
+static Mutex        thread_config_mutex;
+static ThreadConfig thread_config;
+
+static const char *thread_role_names[ThreadRoleCount] = {
+    "default", "capture", "analyzer", "processor", "worker", "background"
+};
+
+Thread::Thread (const char *name, ThreadRole role)
     : _name (NULL)
+    , _role (role)
+    , _attr_set (false)
     , _thread_id (0)
     , _started (false)
     , _stopped (true)
@@ -40,6 +53,100 @@ Thread::~Thread ()
         xcam_free (_name);
 }
 
+void
+Thread::set_config (const ThreadConfig &config)
+{
+    SmartLock locker (thread_config_mutex);
+    thread_config = config;
+}
+
+ThreadConfig
+Thread::get_config ()
+{
+    SmartLock locker (thread_config_mutex);
+    return thread_config;
+}
+
+void
+Thread::set_attr (const ThreadAttr &attr)
+{
+    SmartLock locker (_mutex);
+    _attr = attr;
+    _attr_set = true;
+}
+
+void
+Thread::apply_attr ()
+{
+    ThreadAttr attr;
+    {
+        SmartLock locker (_mutex);
+        if (_attr_set)
+            attr = _attr;
+        else {
+            SmartLock config_locker (thread_config_mutex);
+            XCAM_ASSERT (_role < ThreadRoleCount);
+            attr = thread_config.attrs[_role];
+        }
+    }
+
+    pthread_t self = pthread_self ();
+    int ret = 0;
+
+    if (attr.policy != ThreadSchedDefault) {
+        int policy = (attr.policy == ThreadSchedFifo) ? SCHED_FIFO :
+                     ((attr.policy == ThreadSchedRR) ? SCHED_RR : SCHED_OTHER);
+        struct sched_param param;
+        xcam_mem_clear (param);
+        if (policy != SCHED_OTHER) {
+            param.sched_priority = XCAM_CLAMP (
+                attr.priority, sched_get_priority_min (policy), sched_get_priority_max (policy));
+        }
+        ret = pthread_setschedparam (self, policy, &param);
+        if (ret != 0) {
+            XCAM_LOG_WARNING (
+                "Thread(%s) role:%s set sched policy:%d priority:%d failed.(%d, %s)",
+                XCAM_STR(_name), thread_role_names[_role], policy, param.sched_priority, ret, strerror(ret));
+        }
+
+        // nice is per thread on linux, set it by tid
+        if (policy == SCHED_OTHER && attr.priority != 0) {
+            int nice = XCAM_CLAMP (attr.priority, -20, 19);
+            if (setpriority (PRIO_PROCESS, (id_t) syscall (SYS_gettid), nice) != 0) {
+                XCAM_LOG_WARNING (
+                    "Thread(%s) role:%s set nice:%d failed.(%d, %s)",
+                    XCAM_STR(_name), thread_role_names[_role], nice, errno, strerror(errno));
+            }
+        }
+    }
+
+#ifdef __USE_GNU
+    if (attr.cpu_mask) {
+        cpu_set_t cpus;
+        CPU_ZERO (&cpus);
+        for (uint32_t i = 0; i < 64 && i < CPU_SETSIZE; ++i) {
+            if (attr.cpu_mask & (1ULL << i))
+                CPU_SET (i, &cpus);
+        }
+        ret = pthread_setaffinity_np (self, sizeof (cpus), &cpus);
+        if (ret != 0) {
+            XCAM_LOG_WARNING (
+                "Thread(%s) role:%s set cpu affinity(0x%" PRIx64 ") failed.(%d, %s)",
+                XCAM_STR(_name), thread_role_names[_role], attr.cpu_mask, ret, strerror(ret));
+        }
+    }
+
+    char thread_name[16];
+    xcam_mem_clear (thread_name);
+    snprintf (thread_name, sizeof (thread_name), "%s:%s",
+              attr.name_prefix[0] ? attr.name_prefix : "xc", XCAM_STR(_name));
+    ret = pthread_setname_np (self, thread_name);
+    if (ret != 0) {
+        XCAM_LOG_WARNING ("Thread(%s) set name to thread_id failed.(%d, %s)", XCAM_STR(_name), ret, strerror(ret));
+    }
+#endif
+}
+
 int
 Thread::thread_func (void *user_data)
 {
@@ -51,6 +158,7 @@ Thread::thread_func (void *user_data)
         SmartLock locker(thread->_mutex);
         pthread_detach (pthread_self());
     }
+    thread->apply_attr ();
     ret = thread->started ();
 
     while (true) {
@@ -100,16 +208,6 @@ bool Thread::start ()
     _started = true;
     _stopped = false;
 
-#ifdef __USE_GNU
-    char thread_name[16];
-    xcam_mem_clear (thread_name);
-    snprintf (thread_name, sizeof (thread_name), "xc:%s", XCAM_STR(_name));
-    int ret = pthread_setname_np (_thread_id, thread_name);
-    if (ret != 0) {
-        XCAM_LOG_WARNING ("Thread(%s) set name to thread_id failed.(%d, %s)", XCAM_STR(_name), ret, strerror(ret));
-    }
-#endif
-
     return true;
 }
 
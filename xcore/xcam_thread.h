@@ -24,13 +24,73 @@
 #include <xcam_std.h>
 #include <xcam_mutex.h>
 
+#define XCAM_THREAD_NAME_PREFIX_LEN 8
+#define XCAM_THREAD_BACKGROUND_NICE 10
+
 namespace XCam {
 
+enum ThreadRole {
+    ThreadRoleDefault = 0,
+    ThreadRoleCapture,
+    ThreadRoleAnalyzer,
+    ThreadRoleProcessor,
+    ThreadRoleWorker,
+    ThreadRoleBackground,    // work off the frame critical path, e.g. feature match
+    ThreadRoleCount
+};
+
+enum ThreadSchedPolicy {
+    ThreadSchedDefault = 0,  // inherit from creator
+    ThreadSchedOther,
+    ThreadSchedFifo,
+    ThreadSchedRR
+};
+
+struct ThreadAttr {
+    ThreadSchedPolicy policy;
+    // ThreadSchedFifo/ThreadSchedRR: sched priority, ThreadSchedOther: nice value in [-20, 19]
+    // both clamped into valid range
+    int32_t           priority;
+    uint64_t          cpu_mask;    // bit N for cpu N, 0: keep inherited affinity
+    char              name_prefix[XCAM_THREAD_NAME_PREFIX_LEN]; // thread name "prefix:name", default "xc"
+
+    ThreadAttr ()
+        : policy (ThreadSchedDefault)
+        , priority (0)
+        , cpu_mask (0)
+    {
+        xcam_mem_clear (name_prefix);
+    }
+};
+
+/*
+ * process-wide thread settings, one ThreadAttr for each ThreadRole.
+ * applied when a thread starts, threads already running are not changed.
+ */
+struct ThreadConfig {
+    ThreadAttr attrs[ThreadRoleCount];
+
+    ThreadConfig () {
+        // background threads yield cpu to the frame critical path by default
+        attrs[ThreadRoleBackground].policy = ThreadSchedOther;
+        attrs[ThreadRoleBackground].priority = XCAM_THREAD_BACKGROUND_NICE;
+    }
+};
+
 class Thread {
 public:
-    Thread (const char *name = NULL);
+    Thread (const char *name = NULL, ThreadRole role = ThreadRoleDefault);
     virtual ~Thread ();
 
+    static void set_config (const ThreadConfig &config);
+    static ThreadConfig get_config ();
+
+    // override ThreadConfig of the role for this thread, call before start
+    void set_attr (const ThreadAttr &attr);
+    ThreadRole get_role () const {
+        return _role;
+    }
+
     bool start ();
     virtual bool emit_stop ();
     bool stop ();
@@ -51,9 +111,13 @@ private:
 
 private:
     static int thread_func (void *user_data);
+    void apply_attr ();
 
 private:
     char           *_name;
+    ThreadRole      _role;
+    ThreadAttr      _attr;
+    bool            _attr_set;
     pthread_t       _thread_id;
     XCam::Mutex     _mutex;
     XCam::Cond      _exit_cond;